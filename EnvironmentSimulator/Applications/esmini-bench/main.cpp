@@ -0,0 +1,705 @@
+/*
+ * esmini - Environment Simulator Minimalistic
+ * https://github.com/esmini/esmini
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) partners of Simulation Scenarios
+ * https://sites.google.com/view/simulationscenarios
+ */
+
+/*
+ * Performance benchmarks for esmini.
+ *
+ * Micro benchmarks time single RoadManager and ScenarioEngine operations on the bundled road networks. Macro benchmarks
+ * time complete scenario frames, for bundled scenarios and for generated scenarios with N vehicles. With OSI, time and
+ * heap allocations of ground truth update and serialization are measured per frame as well. Transport benchmarks
+ * compare the latency of publishing a frame until received, shared memory vs UDP loopback.
+ * Results are printed and written to a JSON file. Use scripts/compare_bench.py to check for regressions against a
+ * baseline result file.
+ */
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "playerbase.hpp"
+#include "RoadManager.hpp"
+#include "CommonMini.hpp"
+#include "Profiler.hpp"
+#include "SharedMemory.hpp"
+#include "UDP.hpp"
+#ifdef _USE_OSI
+#include "OSIReporter.hpp"
+#endif  // _USE_OSI
+
+using namespace roadmanager;
+using namespace scenarioengine;
+
+#define BENCH_DEFAULT_SAMPLES     15
+#define BENCH_DEFAULT_SAMPLE_TIME 0.01   // target duration of each micro benchmark sample, in seconds
+#define BENCH_MAX_FRAMES          600    // max number of frames per macro benchmark
+#define BENCH_N_POINTS            1000   // number of precalculated inputs per micro benchmark
+#define BENCH_TIMESTEP            0.05
+#define BENCH_TRANSPORT_FRAMES    200    // number of frames per transport benchmark
+#define BENCH_TRANSPORT_SIZE      65536  // frame size of transport benchmarks, in bytes
+#define BENCH_DEFAULT_UDP_PORT    "48210"
+
+const char* esmini_git_rev(void);  // see CommonMini
+
+// count heap allocations, for the allocations per frame benchmarks
+static std::atomic<int64_t> n_heap_allocations(0);
+
+void* operator new(size_t size)
+{
+    n_heap_allocations.fetch_add(1, std::memory_order_relaxed);
+    void* p = malloc(size > 0 ? size : 1);
+    if (p == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    free(p);
+}
+
+typedef struct
+{
+    std::string name;
+    std::string unit;
+    int64_t     iterations;  // number of measured operations
+    double      median;
+    double      mean;
+    double      min;
+    double      p90;
+    double      max;
+} BenchResult;
+
+class Bench
+{
+public:
+    Bench(std::string filter, int n_samples, double sample_time) : n_samples_(n_samples), sample_time_(sample_time)
+    {
+        for (auto& part : SplitString(filter, '/'))
+        {
+            if (!part.empty())
+            {
+                filter_.push_back(part);
+            }
+        }
+    }
+
+    /**
+        Check benchmark name against the filter, a sequence of whole /-separated name parts, "*" matching any part
+        E.g. "generated_10" selects "frame/generated_10" but not "frame/generated_100"
+        @param name Benchmark name
+    */
+    bool Selected(const std::string& name)
+    {
+        std::vector<std::string> parts = SplitString(name, '/');
+
+        for (size_t start = 0; start + filter_.size() <= parts.size(); start++)
+        {
+            size_t i = 0;
+            while (i < filter_.size() && (filter_[i] == "*" || filter_[i] == parts[start + i]))
+            {
+                i++;
+            }
+            if (i == filter_.size())
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /**
+        Check if any benchmark of a group is selected, e.g. to skip expensive setup
+        @param names Benchmark names, without suffix
+        @param suffix Common suffix of the names, e.g. "/e6mini"
+    */
+    bool SelectedAny(const std::vector<std::string>& names, const std::string& suffix)
+    {
+        return std::any_of(names.begin(), names.end(), [&](const std::string& name) { return Selected(name + suffix); });
+    }
+
+    /**
+        Time an operation. The number of calls per sample is calibrated to reach the sample time.
+        @param name Unique name of the benchmark
+        @param op Operation to measure
+    */
+    void Micro(const std::string& name, const std::function<void()>& op)
+    {
+        if (!Selected(name))
+        {
+            return;
+        }
+
+        // warm up and calibrate
+        int64_t batch = 1;
+        int64_t duration;
+        while (true)
+        {
+            duration = Time(op, batch);
+            if (duration > static_cast<int64_t>(1E8 * sample_time_) || batch > (1 << 28))
+            {
+                break;
+            }
+            batch *= 2;
+        }
+        batch = MAX(1, static_cast<int64_t>(static_cast<double>(batch) * 1E9 * sample_time_ / static_cast<double>(MAX(1, duration))));
+
+        std::vector<double> samples;
+        for (int i = 0; i < n_samples_; i++)
+        {
+            samples.push_back(static_cast<double>(Time(op, batch)) / static_cast<double>(batch));
+        }
+        Add(name, "ns/op", samples, batch * n_samples_);
+    }
+
+    /**
+        Time each frame of a scenario, until it ends or max number of frames
+        @param name Unique name of the benchmark
+        @param args esmini arguments, e.g. --osc <file>
+    */
+    void Frames(const std::string& name, std::vector<std::string> args)
+    {
+        if (!Selected(name))
+        {
+            return;
+        }
+
+        std::vector<std::string> all_args = {"esmini", "--headless", "--disable_stdout", "--disable_log", "--fixed_timestep", "0.05"};
+        all_args.insert(all_args.end(), args.begin(), args.end());
+        std::vector<const char*> argv;
+        for (auto& arg : all_args)
+        {
+            argv.push_back(arg.c_str());
+        }
+
+        ScenarioPlayer* player = new ScenarioPlayer(static_cast<int>(argv.size()), const_cast<char**>(argv.data()));
+        if (player->Init() != 0)
+        {
+            printf("%s: Failed to initialize player\n", name.c_str());
+            delete player;
+            return;
+        }
+
+        std::vector<double> samples;
+        while (!player->IsQuitRequested() && samples.size() < BENCH_MAX_FRAMES)
+        {
+            int64_t start = SE_Profiler::Now();
+            player->Frame(BENCH_TIMESTEP);
+            samples.push_back(static_cast<double>(SE_Profiler::Now() - start));
+        }
+        delete player;
+
+        Add(name, "ns/frame", samples, static_cast<int64_t>(samples.size()));
+    }
+
+    void Add(const std::string& name, const std::string& unit, std::vector<double>& samples, int64_t iterations)
+    {
+        if (samples.empty())
+        {
+            return;
+        }
+
+        std::sort(samples.begin(), samples.end());
+
+        BenchResult r;
+        r.name       = name;
+        r.unit       = unit;
+        r.iterations = iterations;
+        r.median     = samples[samples.size() / 2];
+        r.min        = samples.front();
+        r.max        = samples.back();
+        r.p90        = samples[MIN(samples.size() - 1, samples.size() * 9 / 10)];
+        r.mean       = 0.0;
+        for (double s : samples)
+        {
+            r.mean += s / static_cast<double>(samples.size());
+        }
+        results_.push_back(r);
+
+        printf("%-48s %12.1f %-8s (min %.1f, p90 %.1f, n %lld)\n",
+               r.name.c_str(),
+               r.median,
+               r.unit.c_str(),
+               r.min,
+               r.p90,
+               static_cast<long long>(r.iterations));
+        fflush(stdout);
+    }
+
+    int WriteJSON(const std::string& filename)
+    {
+        FILE* file = FileOpen(filename.c_str(), "w");
+        if (file == nullptr)
+        {
+            printf("Failed to open %s\n", filename.c_str());
+            return -1;
+        }
+
+        fprintf(file, "{\n  \"esmini_git_rev\": \"%s\",\n  \"benchmarks\": [\n", esmini_git_rev());
+        for (size_t i = 0; i < results_.size(); i++)
+        {
+            const BenchResult& r = results_[i];
+            fprintf(file,
+                    "    {\"name\": \"%s\", \"unit\": \"%s\", \"iterations\": %lld, \"median\": %.3f, \"mean\": %.3f, \"min\": %.3f, "
+                    "\"p90\": %.3f, \"max\": %.3f}%s\n",
+                    r.name.c_str(),
+                    r.unit.c_str(),
+                    static_cast<long long>(r.iterations),
+                    r.median,
+                    r.mean,
+                    r.min,
+                    r.p90,
+                    r.max,
+                    i + 1 < results_.size() ? "," : "");
+        }
+        fprintf(file, "  ]\n}\n");
+        fclose(file);
+
+        return 0;
+    }
+
+private:
+    static int64_t Time(const std::function<void()>& op, int64_t n)
+    {
+        int64_t start = SE_Profiler::Now();
+        for (int64_t i = 0; i < n; i++)
+        {
+            op();
+        }
+        return SE_Profiler::Now() - start;
+    }
+
+    std::vector<std::string> filter_;
+    int                      n_samples_;
+    double                   sample_time_;
+    std::vector<BenchResult> results_;
+};
+
+// Random lane position on any driving lane of the loaded road network
+static bool RandomLanePosition(std::mt19937& gen, Position& pos)
+{
+    OpenDrive* od = Position::GetOpenDrive();
+
+    for (int attempt = 0; attempt < 100; attempt++)
+    {
+        Road*  road    = od->GetRoadByIdx(static_cast<int>(gen() % static_cast<unsigned int>(od->GetNumOfRoads())));
+        double s       = std::uniform_real_distribution<double>(0.0, road->GetLength())(gen);
+        int    n_lanes = road->GetNumberOfDrivingLanes(s);
+
+        if (n_lanes > 0)
+        {
+            Lane* lane = road->GetDrivingLaneByIdx(s, static_cast<int>(gen() % static_cast<unsigned int>(n_lanes)));
+            pos.SetLanePos(road->GetId(), lane->GetId(), s, 0.0);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void RoadManagerBenchmarks(Bench& bench, const std::string& resources, const std::string& map)
+{
+    std::string prefix = "rm/";
+    std::string suffix = "/" + FileNameWithoutExtOf(map);
+
+    if (!bench.SelectedAny({prefix + "xyz2trackpos_random", prefix + "xyz2trackpos_path", prefix + "movealongs", prefix + "delta"}, suffix))
+    {
+        return;
+    }
+
+    if (!Position::LoadOpenDrive((resources + "/xodr/" + map).c_str()))
+    {
+        printf("Failed to load %s\n", map.c_str());
+        return;
+    }
+
+    std::mt19937 gen(0);  // same inputs every run
+    Position     pos;
+    int          index = 0;
+
+    // random points around the road network, i.e. global search
+    std::vector<std::array<double, 2>> points;
+    for (int i = 0; i < BENCH_N_POINTS && RandomLanePosition(gen, pos); i++)
+    {
+        std::uniform_real_distribution<double> noise(-2.0, 2.0);
+        points.push_back({pos.GetX() + noise(gen), pos.GetY() + noise(gen)});
+    }
+    bench.Micro(prefix + "xyz2trackpos_random" + suffix,
+                [&]()
+                {
+                    pos.XYZ2TrackPos(points[static_cast<unsigned int>(index)][0], points[static_cast<unsigned int>(index)][1], 0.0);
+                    index = (index + 1) % static_cast<int>(points.size());
+                });
+
+    // points along a path, typical for a moving entity updated each frame
+    points.clear();
+    RandomLanePosition(gen, pos);
+    for (int i = 0; i < BENCH_N_POINTS; i++)
+    {
+        if (static_cast<int>(pos.MoveAlongS(1.0)) < 0)
+        {
+            RandomLanePosition(gen, pos);
+        }
+        points.push_back({pos.GetX(), pos.GetY()});
+    }
+    index = 0;
+    bench.Micro(prefix + "xyz2trackpos_path" + suffix,
+                [&]()
+                {
+                    pos.XYZ2TrackPos(points[static_cast<unsigned int>(index)][0], points[static_cast<unsigned int>(index)][1], 0.0);
+                    index = (index + 1) % static_cast<int>(points.size());
+                });
+
+    RandomLanePosition(gen, pos);
+    Position start = pos;
+    bench.Micro(prefix + "movealongs" + suffix,
+                [&]()
+                {
+                    if (static_cast<int>(pos.MoveAlongS(0.5)) < 0)
+                    {
+                        pos = start;
+                    }
+                });
+
+    // pairs of positions 10 - 100 m apart along the road network
+    std::vector<std::pair<Position, Position>> pairs;
+    for (int i = 0; i < BENCH_N_POINTS / 10 && RandomLanePosition(gen, pos); i++)
+    {
+        Position pos_b = pos;
+        if (static_cast<int>(pos_b.MoveAlongS(std::uniform_real_distribution<double>(10.0, 100.0)(gen))) >= 0)
+        {
+            pairs.push_back({pos, pos_b});
+        }
+    }
+    index = 0;
+    PositionDiff diff;
+    bench.Micro(prefix + "delta" + suffix,
+                [&]()
+                {
+                    pairs[static_cast<unsigned int>(index)].first.Delta(&pairs[static_cast<unsigned int>(index)].second, diff);
+                    index = (index + 1) % static_cast<int>(pairs.size());
+                });
+}
+
+/**
+    Write a straight road with n_lanes driving lanes in positive direction, and a scenario with n_vehicles spread over
+    the lanes, all driving with default controller until the end of the road or scenario
+    @return Filename of the scenario
+*/
+static std::string GenerateScenario(int n_vehicles, int n_lanes)
+{
+    std::string name       = "bench_generated_" + std::to_string(n_vehicles);
+    int         per_lane   = (n_vehicles + n_lanes - 1) / n_lanes;
+    double      spacing    = 25.0;
+    double      road_length = per_lane * spacing + 1500.0;
+
+    std::ofstream odr(name + ".xodr");
+    odr << "<?xml version=\"1.0\" standalone=\"yes\"?>\n<OpenDRIVE>\n";
+    odr << "  <header revMajor=\"1\" revMinor=\"4\" name=\"" << name << "\" version=\"1.00\"/>\n";
+    odr << "  <road name=\"road\" length=\"" << road_length << "\" id=\"1\" junction=\"-1\">\n";
+    odr << "    <planView>\n      <geometry s=\"0\" x=\"0\" y=\"0\" hdg=\"0\" length=\"" << road_length << "\"><line/></geometry>\n";
+    odr << "    </planView>\n    <lanes>\n      <laneSection s=\"0\">\n";
+    odr << "        <center><lane id=\"0\" type=\"none\" level=\"false\"/></center>\n        <right>\n";
+    for (int i = 1; i <= n_lanes; i++)
+    {
+        odr << "          <lane id=\"" << -i << "\" type=\"driving\" level=\"false\"><width sOffset=\"0\" a=\"3.5\" b=\"0\" c=\"0\" d=\"0\"/></lane>\n";
+    }
+    odr << "        </right>\n      </laneSection>\n    </lanes>\n  </road>\n</OpenDRIVE>\n";
+    odr.close();
+
+    std::ofstream osc(name + ".xosc");
+    osc << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<OpenSCENARIO>\n";
+    osc << "  <FileHeader revMajor=\"1\" revMinor=\"0\" date=\"2024-01-01T00:00:00\" description=\"" << name << "\" author=\"esmini-bench\"/>\n";
+    osc << "  <ParameterDeclarations/>\n  <CatalogLocations/>\n";
+    osc << "  <RoadNetwork><LogicFile filepath=\"" << name << ".xodr\"/></RoadNetwork>\n  <Entities>\n";
+    for (int i = 0; i < n_vehicles; i++)
+    {
+        osc << "    <ScenarioObject name=\"V" << i << "\">\n";
+        osc << "      <Vehicle name=\"car\" vehicleCategory=\"car\">\n";
+        osc << "        <BoundingBox><Center x=\"1.4\" y=\"0.0\" z=\"0.9\"/><Dimensions width=\"2.0\" length=\"5.0\" height=\"1.8\"/></BoundingBox>\n";
+        osc << "        <Performance maxSpeed=\"70\" maxAcceleration=\"10\" maxDeceleration=\"10\"/>\n";
+        osc << "        <Axles>\n";
+        osc << "          <FrontAxle maxSteering=\"0.5\" wheelDiameter=\"0.8\" trackWidth=\"1.7\" positionX=\"2.9\" positionZ=\"0.4\"/>\n";
+        osc << "          <RearAxle maxSteering=\"0\" wheelDiameter=\"0.8\" trackWidth=\"1.7\" positionX=\"0\" positionZ=\"0.4\"/>\n";
+        osc << "        </Axles>\n        <Properties/>\n      </Vehicle>\n    </ScenarioObject>\n";
+    }
+    osc << "  </Entities>\n  <Storyboard>\n    <Init>\n      <Actions>\n";
+    for (int i = 0; i < n_vehicles; i++)
+    {
+        osc << "        <Private entityRef=\"V" << i << "\">\n";
+        osc << "          <PrivateAction><TeleportAction><Position><LanePosition roadId=\"1\" laneId=\"" << -(i % n_lanes + 1)
+            << "\" offset=\"0\" s=\"" << 10.0 + (i / n_lanes) * spacing << "\"/></Position></TeleportAction></PrivateAction>\n";
+        osc << "          <PrivateAction><LongitudinalAction><SpeedAction>\n";
+        osc << "            <SpeedActionDynamics dynamicsShape=\"step\" dynamicsDimension=\"time\" value=\"0\"/>\n";
+        osc << "            <SpeedActionTarget><AbsoluteTargetSpeed value=\"" << 20.0 + (i % 5) << "\"/></SpeedActionTarget>\n";
+        osc << "          </SpeedAction></LongitudinalAction></PrivateAction>\n";
+        osc << "        </Private>\n";
+    }
+    osc << "      </Actions>\n    </Init>\n";
+    osc << "    <StopTrigger><ConditionGroup><Condition name=\"stop\" delay=\"0\" conditionEdge=\"rising\">\n";
+    osc << "      <ByValueCondition><SimulationTimeCondition value=\"" << BENCH_MAX_FRAMES * BENCH_TIMESTEP
+        << "\" rule=\"greaterThan\"/></ByValueCondition>\n";
+    osc << "    </Condition></ConditionGroup></StopTrigger>\n  </Storyboard>\n</OpenSCENARIO>\n";
+    osc.close();
+
+    return name + ".xosc";
+}
+
+static void RemoveGeneratedScenario(const std::string& filename)
+{
+    std::remove(filename.c_str());
+    std::remove((FileNameWithoutExtOf(filename) + ".xodr").c_str());
+}
+
+#ifdef _USE_OSI
+/**
+    Time update and serialization of OSI ground truth, and count heap allocations, per frame of a scenario
+    First frames, including static ground truth and creation of moving objects, are not measured
+*/
+static void OSIGroundTruthBenchmark(Bench& bench, const std::string& filename, const std::string& suffix)
+{
+    if (!bench.SelectedAny({"osi_gt", "osi_gt_allocs"}, suffix))
+    {
+        return;
+    }
+
+    const char*     args[] = {"esmini", "--osc", filename.c_str(), "--headless", "--disable_stdout", "--disable_log"};
+    ScenarioPlayer* player = new ScenarioPlayer(static_cast<int>(sizeof(args) / sizeof(char*)), const_cast<char**>(args));
+    if (player->Init() != 0)
+    {
+        printf("osi_gt%s: Failed to initialize player\n", suffix.c_str());
+        delete player;
+        return;
+    }
+
+    std::vector<double> time_samples;
+    std::vector<double> alloc_samples;
+    int                 size = 0;
+    for (int frame = 0; frame < BENCH_MAX_FRAMES / 4 && !player->IsQuitRequested(); frame++)
+    {
+        player->Frame(BENCH_TIMESTEP);
+
+        int64_t allocs_start = n_heap_allocations.load(std::memory_order_relaxed);
+        int64_t start        = SE_Profiler::Now();
+        player->osiReporter->UpdateOSIGroundTruth(player->scenarioGateway->objectState_);
+        player->osiReporter->GetOSIGroundTruth(&size);
+        if (frame > 1)
+        {
+            time_samples.push_back(static_cast<double>(SE_Profiler::Now() - start));
+            alloc_samples.push_back(static_cast<double>(n_heap_allocations.load(std::memory_order_relaxed) - allocs_start));
+        }
+    }
+    delete player;
+
+    bench.Add("osi_gt" + suffix, "ns/frame", time_samples, static_cast<int64_t>(time_samples.size()));
+    bench.Add("osi_gt_allocs" + suffix, "allocs/frame", alloc_samples, static_cast<int64_t>(alloc_samples.size()));
+}
+#endif  // _USE_OSI
+
+static void ScenarioBenchmarks(Bench& bench, const std::string& resources)
+{
+    const char* scenarios[] = {"cut-in.xosc", "highway_merge_advanced.xosc", "ltap-od.xosc", "swarm.xosc", "synchronize.xosc"};
+
+    for (auto& scenario : scenarios)
+    {
+        bench.Frames("frame/" + FileNameWithoutExtOf(scenario), {"--osc", resources + "/xosc/" + scenario, "--seed", "0"});
+    }
+
+    for (int n_vehicles : {10, 100, 500})
+    {
+        std::string suffix = "/generated_" + std::to_string(n_vehicles);
+        if (!bench.SelectedAny({"frame", "frame_collision", "frame_osi", "osi_gt", "osi_gt_allocs", "collision"}, suffix))
+        {
+            continue;
+        }
+
+        std::string filename = GenerateScenario(n_vehicles, 4);
+
+        bench.Frames("frame" + suffix, {"--osc", filename});
+        bench.Frames("frame_collision" + suffix, {"--osc", filename, "--collision"});
+#ifdef _USE_OSI
+        bench.Frames("frame_osi" + suffix, {"--osc", filename, "--osi_file", "bench.osi"});
+        std::remove("bench.osi");
+        OSIGroundTruthBenchmark(bench, filename, suffix);
+#endif  // _USE_OSI
+
+        if (bench.Selected("collision" + suffix))
+        {
+            const char*     args[] = {"esmini", "--osc", filename.c_str(), "--headless", "--disable_stdout", "--disable_log", "--collision"};
+            ScenarioPlayer* player = new ScenarioPlayer(static_cast<int>(sizeof(args) / sizeof(char*)), const_cast<char**>(args));
+            if (player->Init() == 0)
+            {
+                bench.Micro("collision" + suffix, [&]() { player->scenarioEngine->DetectCollisions(); });
+            }
+            delete player;
+        }
+
+        RemoveGeneratedScenario(filename);
+    }
+}
+
+// Receive one frame sent by UDPFrameSender
+static int ReceiveUDPFrame(UDPServer& server, std::vector<char>& frame)
+{
+    struct
+    {
+        UDPFrameSender::UDPFragmentHeader header;
+        char                              data[UDP_DEFAULT_FRAGMENT_SIZE];
+    } buf;
+
+    size_t received = 0;
+    do
+    {
+        if (server.Receive(reinterpret_cast<char*>(&buf), sizeof(buf)) <= 0)
+        {
+            return -1;
+        }
+        frame.resize(received + buf.header.datasize);
+        memcpy(&frame[received], buf.data, buf.header.datasize);
+        received += buf.header.datasize;
+    } while (buf.header.counter > 0);
+
+    return 0;
+}
+
+/**
+    Time from publishing a frame until it's received by another party on the same host, shared memory vs UDP loopback
+    @param port UDP port to use for the loopback transport
+*/
+static void TransportBenchmarks(Bench& bench, unsigned short int port)
+{
+    std::string       suffix = "/" + std::to_string(BENCH_TRANSPORT_SIZE / 1024) + "kB";
+    std::vector<char> data(BENCH_TRANSPORT_SIZE);
+    std::vector<char> buf;
+
+    for (size_t i = 0; i < data.size(); i++)
+    {
+        data[i] = static_cast<char>(i);
+    }
+
+#ifndef _WIN32
+    if (bench.Selected("transport_shm" + suffix))
+    {
+        SharedMemoryWriter  writer("esmini_bench_" + std::to_string(SE_getSystemTime()));
+        SharedMemoryReader  reader(writer.GetName());
+        SharedMemoryFrame   frame;
+        std::vector<double> samples;
+
+        for (int i = 0; i < BENCH_TRANSPORT_FRAMES; i++)
+        {
+            int64_t start = SE_Profiler::Now();
+            if (writer.Write(data.data(), data.size()) == 0 || reader.Open() != 0 || reader.Read(buf, frame) != 0)
+            {
+                printf("transport_shm%s: Failed to transfer frame\n", suffix.c_str());
+                return;
+            }
+            samples.push_back(static_cast<double>(SE_Profiler::Now() - start));
+        }
+        bench.Add("transport_shm" + suffix, "ns/frame", samples, static_cast<int64_t>(samples.size()));
+    }
+#endif  // _WIN32
+
+    if (bench.Selected("transport_udp" + suffix))
+    {
+        UDPServer           server(port, 500);
+        UDPFrameSender      sender(port, "127.0.0.1");
+        std::vector<double> samples;
+
+        if (server.GetStatus() != 0 || sender.GetStatus() != 0)
+        {
+            printf("transport_udp%s: Failed to open UDP port %d, see --udp_port\n", suffix.c_str(), port);
+            return;
+        }
+        sender.SetSendBufferSize(4 * BENCH_TRANSPORT_SIZE);
+
+        for (int i = 0; i < BENCH_TRANSPORT_FRAMES; i++)
+        {
+            int64_t start = SE_Profiler::Now();
+            if (sender.Send(data.data(), data.size()) != 0 || ReceiveUDPFrame(server, buf) != 0 || buf.size() != data.size())
+            {
+                printf("transport_udp%s: Failed to transfer frame\n", suffix.c_str());
+                return;
+            }
+            samples.push_back(static_cast<double>(SE_Profiler::Now() - start));
+        }
+        bench.Add("transport_udp" + suffix, "ns/frame", samples, static_cast<int64_t>(samples.size()));
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    SE_Options& opt = SE_Env::Inst().GetOptions();
+    opt.Reset();
+
+    opt.AddOption("filter", "Run only benchmarks with matching /-separated name parts, * = any, e.g. \"rm\" or \"frame/generated_10\"", "pattern");
+    opt.AddOption("help", "Show this help message");
+    opt.AddOption("json", "Result file", "filename", "esmini-bench.json");
+    opt.AddOption("osc", "Additional scenario to run frame benchmark on, e.g. from generate_scaling_scenario.py (repeatable)", "filename");
+    opt.AddOption("quick", "Fewer and shorter samples, for a quick check");
+    opt.AddOption("resources", "Path to esmini resources folder", "path", "../resources");
+    opt.AddOption("udp_port", "Port for the UDP transport benchmark", "port", BENCH_DEFAULT_UDP_PORT);
+
+    if (opt.ParseArgs(argc, argv) != 0 || opt.GetOptionSet("help"))
+    {
+        opt.PrintUsage();
+        return -1;
+    }
+
+    // copy all options, players created by the benchmarks use the same options instance
+    std::string filter      = opt.GetOptionArg("filter");
+    std::string json        = opt.IsOptionArgumentSet("json") ? opt.GetOptionArg("json") : "esmini-bench.json";
+    std::string resources   = opt.IsOptionArgumentSet("resources") ? opt.GetOptionArg("resources") : DirNameOf(argv[0]) + "/../resources";
+    bool        quick       = opt.GetOptionSet("quick");
+    int         udp_port    = atoi(opt.IsOptionArgumentSet("udp_port") ? opt.GetOptionArg("udp_port").c_str() : BENCH_DEFAULT_UDP_PORT);
+    Bench       bench(filter, quick ? 5 : BENCH_DEFAULT_SAMPLES, quick ? 0.2 * BENCH_DEFAULT_SAMPLE_TIME : BENCH_DEFAULT_SAMPLE_TIME);
+
+    std::vector<std::string> scenarios;
+    for (int i = 0; !opt.GetOptionArg("osc", i).empty(); i++)
+    {
+        scenarios.push_back(opt.GetOptionArg("osc", i));
+    }
+
+    Logger::Inst().SetCallback(0);
+    SE_Env::Inst().SetLogFilePath("");
+
+    for (auto& map : {"e6mini.xodr", "fabriksgatan.xodr", "multi_intersections.xodr", "soderleden.xodr", "curves_elevation.xodr"})
+    {
+        RoadManagerBenchmarks(bench, resources, map);
+    }
+
+    ScenarioBenchmarks(bench, resources);
+
+    for (auto& scenario : scenarios)
+    {
+        bench.Frames("frame/" + FileNameWithoutExtOf(scenario), {"--osc", scenario});
+    }
+
+    TransportBenchmarks(bench, static_cast<unsigned short int>(udp_port));
+
+    return bench.WriteJSON(json);
+}
@@ -66,7 +66,7 @@ static int execute_scenario(int argc, char* argv[])
     // Initialize ImPlot
     std::unique_ptr<Plot> plot;
 
-    if (opt.GetOptionSet("plot"))
+    if (opt.GetOptionSet("plot") && !player->IsBatchMode())
     {
         // Create and run plot in a separate thread as default
         plot = std::make_unique<Plot>(player->scenarioEngine, opt.GetOptionArg("plot") == "synchronous");
@@ -79,6 +79,7 @@ static int execute_scenario(int argc, char* argv[])
         if (player->GetFixedTimestep() > SMALL_NUMBER)
         {
             dt = player->GetFixedTimestep();
+            player->pacer_.Wait();  // no-op unless --realtime_factor
         }
         else
         {
@@ -88,9 +89,13 @@ static int execute_scenario(int argc, char* argv[])
         retval = player->Frame(dt);
 
 #ifdef _USE_IMPLOT
-        if (plot != nullptr && plot->IsModeSynchronuous())
+        if (plot != nullptr)
         {
-            plot->Frame();
+            plot->Publish();
+            if (plot->IsModeSynchronuous())
+            {
+                plot->Frame();
+            }
         }
 #endif  // _USE_IMPLOT
     }
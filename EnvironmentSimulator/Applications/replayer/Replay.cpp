@@ -10,6 +10,20 @@
  * https://sites.google.com/view/simulationscenarios
  */
 
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <queue>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include "Replay.hpp"
 #include "ScenarioGateway.hpp"
 #include "CommonMini.hpp"
@@ -17,16 +31,202 @@
 
 using namespace scenarioengine;
 
-Replay::Replay(std::string filename, bool clean) : time_(0.0), index_(0), repeat_(false), clean_(clean)
+DatFile::DatFile(std::string filename) : data_(nullptr), size_(0), n_entries_(0)
 {
-    file_.open(filename, std::ofstream::binary);
-    if (file_.fail())
+#ifdef _WIN32
+    map_handle_  = nullptr;
+    file_handle_ = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file_handle_ == INVALID_HANDLE_VALUE)
     {
         LOG("Cannot open file: %s", filename.c_str());
         throw std::invalid_argument(std::string("Cannot open file: ") + filename);
     }
 
-    file_.read(reinterpret_cast<char*>(&header_), sizeof(header_));
+    LARGE_INTEGER file_size;
+    if (GetFileSizeEx(file_handle_, &file_size))
+    {
+        size_ = static_cast<size_t>(file_size.QuadPart);
+    }
+
+    if (size_ >= sizeof(DatHeader))
+    {
+        map_handle_ = CreateFileMappingA(file_handle_, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (map_handle_ != nullptr)
+        {
+            data_ = static_cast<const char*>(MapViewOfFile(map_handle_, FILE_MAP_READ, 0, 0, 0));
+        }
+    }
+#else
+    fd_ = open(filename.c_str(), O_RDONLY);
+    if (fd_ < 0)
+    {
+        LOG("Cannot open file: %s", filename.c_str());
+        throw std::invalid_argument(std::string("Cannot open file: ") + filename);
+    }
+
+    struct stat file_stat;
+    if (fstat(fd_, &file_stat) == 0)
+    {
+        size_ = static_cast<size_t>(file_stat.st_size);
+    }
+
+    if (size_ >= sizeof(DatHeader))
+    {
+        void* addr = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+        if (addr != MAP_FAILED)
+        {
+            data_ = static_cast<const char*>(addr);
+        }
+    }
+#endif
+
+    if (data_ == nullptr)
+    {
+        Unmap();
+        LOG("Failed to map file: %s", filename.c_str());
+        throw std::invalid_argument(std::string("Failed to map file: ") + filename);
+    }
+
+    memcpy(&header_, data_, sizeof(header_));
+    n_entries_ = (size_ - sizeof(DatHeader)) / sizeof(ObjectStateStructDat);  // any incomplete last entry is ignored
+}
+
+DatFile::~DatFile()
+{
+    Unmap();
+}
+
+void DatFile::Unmap()
+{
+#ifdef _WIN32
+    if (data_ != nullptr)
+    {
+        UnmapViewOfFile(data_);
+    }
+    if (map_handle_ != nullptr)
+    {
+        CloseHandle(map_handle_);
+    }
+    if (file_handle_ != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(file_handle_);
+    }
+    map_handle_  = nullptr;
+    file_handle_ = INVALID_HANDLE_VALUE;
+#else
+    if (data_ != nullptr)
+    {
+        munmap(const_cast<char*>(data_), size_);
+    }
+    if (fd_ >= 0)
+    {
+        close(fd_);
+    }
+    fd_ = -1;
+#endif
+    data_ = nullptr;
+}
+
+float DatFile::GetTimestamp(size_t index)
+{
+    float timestamp;
+    memcpy(&timestamp,
+           data_ + sizeof(DatHeader) + index * sizeof(ObjectStateStructDat) + offsetof(ObjectStateStructDat, info) +
+               offsetof(ObjectInfoStructDat, timeStamp),
+           sizeof(timestamp));
+    return timestamp;
+}
+
+void DatFile::GetState(size_t index, ObjectStateStructDat* state)
+{
+    memcpy(state, data_ + sizeof(DatHeader) + index * sizeof(ObjectStateStructDat), sizeof(ObjectStateStructDat));
+}
+
+DatFrameCursor::DatFrameCursor(std::string filename) : filename_(filename), dat_file_(filename), next_(0), last_timestamp_(-LARGE_NUMBERF)
+{
+}
+
+void DatFrameCursor::SkipDecreasingTimestamps()
+{
+    while (next_ < dat_file_.GetNumberOfEntries() && dat_file_.GetTimestamp(next_) < last_timestamp_)
+    {
+        next_++;
+    }
+}
+
+bool DatFrameCursor::NextFrame()
+{
+    frame_.clear();
+
+    if (!HasNextFrame())
+    {
+        return false;
+    }
+
+    float timestamp = dat_file_.GetTimestamp(next_);
+    for (; next_ < dat_file_.GetNumberOfEntries(); next_++)
+    {
+        float entry_timestamp = dat_file_.GetTimestamp(next_);
+        if (entry_timestamp < last_timestamp_)
+        {
+            continue;
+        }
+        else if (!NEAR_NUMBERSF(entry_timestamp, timestamp))
+        {
+            break;
+        }
+
+        ReplayEntry entry;
+        dat_file_.GetState(next_, &entry.state);
+        entry.odometer  = 0.0;
+        last_timestamp_ = entry_timestamp;
+
+        // Keep the latest instance of entries with same timestamp
+        for (size_t i = 0; i < frame_.size(); i++)
+        {
+            if (frame_[i].state.info.id == entry.state.info.id)
+            {
+                frame_.erase(frame_.begin() + static_cast<std::ptrdiff_t>(i));
+                break;
+            }
+        }
+        frame_.push_back(entry);
+    }
+
+    SkipDecreasingTimestamps();
+
+    return true;
+}
+
+Replay::Replay(std::string filename, bool clean, ReadMode mode)
+    : time_(0.0),
+      index_(0),
+      repeat_(false),
+      clean_(clean),
+      frames_sorted_(true),
+      sorted_end_(0),
+      slots_first_(0),
+      slots_end_(0),
+      window_first_(0)
+{
+    if (mode == ReadMode::STREAM)
+    {
+        // timestamp order is verified on demand, see EntriesSorted()
+        dat_file_ = std::make_unique<DatFile>(filename);
+        header_   = dat_file_->header_;
+    }
+    else
+    {
+        file_.open(filename, std::ofstream::binary);
+        if (file_.fail())
+        {
+            LOG("Cannot open file: %s", filename.c_str());
+            throw std::invalid_argument(std::string("Cannot open file: ") + filename);
+        }
+
+        file_.read(reinterpret_cast<char*>(&header_), sizeof(header_));
+    }
+
     LOG("Recording %s opened. dat version: %d odr: %s model: %s",
         FileNameOf(filename).c_str(),
         header_.version,
@@ -41,41 +241,39 @@ Replay::Replay(std::string filename, bool clean) : time_(0.0), index_(0), repeat
                      DAT_FILE_FORMAT_VERSION);
     }
 
-    if (header_.version != DAT_FILE_FORMAT_VERSION)
+    if (mode == ReadMode::LOAD_ALL)
     {
-        LOG_AND_QUIT("Version mismatch. %s is version %d while supported version is %d. Please re-create dat file.",
-                     filename.c_str(),
-                     header_.version,
-                     DAT_FILE_FORMAT_VERSION);
-    }
+        while (!file_.eof())
+        {
+            ReplayEntry data;
 
-    while (!file_.eof())
-    {
-        ReplayEntry data;
+            file_.read(reinterpret_cast<char*>(&data.state), sizeof(data.state));
 
-        file_.read(reinterpret_cast<char*>(&data.state), sizeof(data.state));
+            if (!file_.eof())
+            {
+                data_.push_back(data);
+            }
+        }
 
-        if (!file_.eof())
+        if (clean_)
         {
-            data_.push_back(data);
+            CleanEntries(data_);
         }
-    }
 
-    if (clean_)
-    {
-        CleanEntries(data_);
+        BuildIndex();
     }
 
-    if (data_.size() > 0)
+    if (GetNumberOfEntries() > 0)
     {
         // Register first entry timestamp as starting time
-        time_       = data_[0].state.info.timeStamp;
+        time_       = GetTimestampByIndex(0);
         startTime_  = time_;
         startIndex_ = 0;
 
-        // Register last entry timestamp as stop time
-        stopTime_  = data_.back().state.info.timeStamp;
-        stopIndex_ = static_cast<unsigned int>(FindIndexAtTimestamp(stopTime_));
+        // Register last entry timestamp as stop time. When streaming, the stop index is looked up on first use,
+        // since it depends on the order of all entries.
+        stopTime_  = GetTimestampByIndex(static_cast<unsigned int>(GetNumberOfEntries()) - 1);
+        stopIndex_ = dat_file_ != nullptr ? REPLAY_INDEX_UNRESOLVED : static_cast<unsigned int>(FindIndexAtTimestamp(stopTime_));
     }
 }
 
@@ -83,20 +281,21 @@ Replay::Replay(const std::string directory, const std::string scenario, std::str
     : time_(0.0),
       index_(0),
       repeat_(false),
-      create_datfile_(create_datfile)
+      create_datfile_(create_datfile),
+      frames_sorted_(true),
+      sorted_end_(0),
+      slots_first_(0),
+      slots_end_(0),
+      window_first_(0)
 {
     GetReplaysFromDirectory(directory, scenario);
-    std::vector<std::pair<std::string, std::vector<ReplayEntry>>> scenarioData;
+    std::vector<std::unique_ptr<DatFrameCursor>> scenarioData;
 
     for (size_t i = 0; i < scenarios_.size(); i++)
     {
-        file_.open(scenarios_[i], std::ofstream::binary);
-        if (file_.fail())
-        {
-            LOG("Cannot open file: %s", scenarios_[i].c_str());
-            throw std::invalid_argument(std::string("Cannot open file: ") + scenarios_[i]);
-        }
-        file_.read(reinterpret_cast<char*>(&header_), sizeof(header_));
+        // files are mapped and read frame by frame during merge, nothing is loaded here
+        std::unique_ptr<DatFrameCursor> cursor = std::make_unique<DatFrameCursor>(scenarios_[i]);
+        header_                                = cursor->GetHeader();
         LOG("Recording %s opened. dat version: %d odr: %s model: %s",
             FileNameOf(scenarios_[i]).c_str(),
             header_.version,
@@ -110,21 +309,13 @@ Replay::Replay(const std::string directory, const std::string scenario, std::str
                          header_.version,
                          DAT_FILE_FORMAT_VERSION);
         }
-        while (!file_.eof())
-        {
-            ReplayEntry entry;
-
-            file_.read(reinterpret_cast<char*>(&entry.state), sizeof(entry.state));
 
-            if (!file_.eof())
-            {
-                data_.push_back(entry);
-            }
+        if (!cursor->HasNextFrame())
+        {
+            LOG("No entries in %s, skipping", scenarios_[i].c_str());
+            continue;
         }
-        // pair <scenario name, scenario data>
-        scenarioData.push_back(std::make_pair(scenarios_[i], data_));
-        data_ = {};
-        file_.close();
+        scenarioData.push_back(std::move(cursor));
     }
 
     if (scenarioData.size() < 2)
@@ -133,25 +324,26 @@ Replay::Replay(const std::string directory, const std::string scenario, std::str
     }
 
     // Scenario with smallest start time first
-    std::sort(scenarioData.begin(),
-              scenarioData.end(),
-              [](const auto& sce1, const auto& sce2) { return sce1.second[0].state.info.timeStamp < sce2.second[0].state.info.timeStamp; });
+    std::stable_sort(scenarioData.begin(),
+                     scenarioData.end(),
+                     [](const auto& sce1, const auto& sce2) { return sce1->GetNextTimestamp() < sce2->GetNextTimestamp(); });
 
     // Log which scenario belongs to what ID-group (0, 100, 200 etc.)
     for (size_t i = 0; i < scenarioData.size(); i++)
     {
-        std::string scenario_tmp = scenarioData[i].first;
-        LOG("Scenarios corresponding to IDs (%d:%d): %s", i * 100, (i + 1) * 100 - 1, FileNameOf(scenario_tmp.c_str()).c_str());
+        LOG("Scenarios corresponding to IDs (%d:%d): %s", i * 100, (i + 1) * 100 - 1, FileNameOf(scenarioData[i]->filename_).c_str());
     }
 
-    // Ensure increasing timestamps. Remove any other entries.
-    for (auto& sce : scenarioData)
+    if (!create_datfile_.empty())
     {
-        CleanEntries(sce.second);
+        // Write merged entries directly to file, without keeping them in memory
+        CreateMergedDatfile(scenarioData, create_datfile_);
+        return;
     }
 
-    // Build remaining data in order.
+    // Build merged data in order.
     BuildData(scenarioData);
+    BuildIndex();
 
     if (data_.size() > 0)
     {
@@ -164,11 +356,6 @@ Replay::Replay(const std::string directory, const std::string scenario, std::str
         stopTime_  = data_.back().state.info.timeStamp;
         stopIndex_ = static_cast<unsigned int>(FindIndexAtTimestamp(stopTime_));
     }
-
-    if (!create_datfile_.empty())
-    {
-        CreateMergedDatfile(create_datfile_);
-    }
 }
 
 // Browse through replay-folder and appends strings of absolute path to matching scenario
@@ -250,6 +437,10 @@ void Replay::GoToEnd()
     }
     else
     {
+        if (stopIndex_ == REPLAY_INDEX_UNRESOLVED)
+        {
+            stopIndex_ = static_cast<unsigned int>(FindIndexAtTimestamp(stopTime_));
+        }
         index_ = stopIndex_;
         time_  = stopTime_;
     }
@@ -269,7 +460,7 @@ void Replay::GoToTime(double time, bool stop_at_next_frame)
         }
         else
         {
-            index_ = static_cast<unsigned int>(FindIndexAtTimestamp(time, static_cast<int>(index_)));
+            index_ = static_cast<unsigned int>(FindIndexAtTimestamp(time));
             time_  = time;
         }
     }
@@ -280,11 +471,11 @@ void Replay::GoToTime(double time, bool stop_at_next_frame)
         if (time > time_)
         {
             next_index = FindNextTimestamp();
-            if (next_index > index_ && time > static_cast<double>(data_[next_index].state.info.timeStamp) &&
-                static_cast<double>(data_[next_index].state.info.timeStamp) <= GetStopTime())
+            if (next_index > index_ && time > static_cast<double>(GetTimestampByIndex(static_cast<unsigned int>(next_index))) &&
+                static_cast<double>(GetTimestampByIndex(static_cast<unsigned int>(next_index))) <= GetStopTime())
             {
                 index_ = static_cast<unsigned int>(next_index);
-                time_  = data_[index_].state.info.timeStamp;
+                time_  = GetTimestampByIndex(index_);
             }
             else
             {
@@ -301,10 +492,10 @@ void Replay::GoToTime(double time, bool stop_at_next_frame)
         else if (time < time_)
         {
             next_index = FindPreviousTimestamp();
-            if (next_index < index_ && time < static_cast<double>(data_[next_index].state.info.timeStamp))
+            if (next_index < index_ && time < static_cast<double>(GetTimestampByIndex(static_cast<unsigned int>(next_index))))
             {
                 index_ = static_cast<unsigned int>(next_index);
-                time_  = data_[index_].state.info.timeStamp;
+                time_  = GetTimestampByIndex(index_);
             }
             else
             {
@@ -328,30 +519,26 @@ void Replay::GoToDeltaTime(double dt, bool stop_at_next_frame)
 
 int Replay::GoToNextFrame()
 {
-    float ctime = data_[index_].state.info.timeStamp;
-    for (size_t i = index_ + 1; i < data_.size(); i++)
+    unsigned int index = FindNextTimestamp();
+    if (index == index_)
     {
-        if (data_[i].state.info.timeStamp > ctime)
-        {
-            GoToTime(data_[i].state.info.timeStamp);
-            return static_cast<int>(i);
-        }
+        return -1;
     }
-    return -1;
+
+    GoToTime(GetTimestampByIndex(index));
+    return static_cast<int>(index);
 }
 
 void Replay::GoToPreviousFrame()
 {
     if (index_ > 0)
     {
-        GoToTime(data_[index_ - 1].state.info.timeStamp);
+        GoToTime(GetTimestampByIndex(index_ - 1));
     }
 }
 
-int Replay::FindIndexAtTimestamp(double timestamp, int startSearchIndex)
+int Replay::FindIndexAtTimestamp(double timestamp)
 {
-    int i = 0;
-
     if (timestamp > stopTime_)
     {
         GoToEnd();
@@ -362,47 +549,211 @@ int Replay::FindIndexAtTimestamp(double timestamp, int startSearchIndex)
         return static_cast<int>(index_);
     }
 
-    if (timestamp < time_)
+    if (GetNumberOfEntries() == 0)
     {
-        // start search from beginning
-        startSearchIndex = 0;
+        return -1;
     }
 
-    for (i = startSearchIndex; i < static_cast<int>(data_.size()); i++)
+    if (dat_file_ != nullptr)
     {
-        if (static_cast<double>(data_[static_cast<unsigned int>(i)].state.info.timeStamp) >= timestamp)
+        unsigned int n = static_cast<unsigned int>(GetNumberOfEntries());
+
+        if (frames_sorted_)
         {
-            break;
+            // binary search directly in the recording for first entry at or after given timestamp
+            unsigned int lo = 0;
+            unsigned int hi = n;
+            while (lo < hi)
+            {
+                unsigned int mid = lo + (hi - lo) / 2;
+                if (static_cast<double>(GetTimestampByIndex(mid)) < timestamp)
+                {
+                    lo = mid + 1;
+                }
+                else
+                {
+                    hi = mid;
+                }
+            }
+
+            // same result as the linear search below if all entries up to the found one are in order
+            if (EntriesSorted(MIN(lo + 1, n)) && (lo == 0 || static_cast<double>(GetTimestampByIndex(lo - 1)) < timestamp))
+            {
+                return static_cast<int>(FindFrameStart(MIN(lo, n - 1)));
+            }
+        }
+
+        // timestamps not monotonic (uncleaned data), fall back to search from start
+        for (unsigned int i = 0; i < n; i++)
+        {
+            if (static_cast<double>(GetTimestampByIndex(i)) >= timestamp)
+            {
+                return static_cast<int>(i);
+            }
         }
+
+        return static_cast<int>(FindFrameStart(n - 1));
+    }
+
+    std::vector<ReplayFrame>::iterator it;
+    if (frames_sorted_)
+    {
+        // binary search for first frame at or after given timestamp
+        it = std::lower_bound(frames_.begin(),
+                              frames_.end(),
+                              timestamp,
+                              [](const ReplayFrame& frame, double t) { return static_cast<double>(frame.timestamp) < t; });
+    }
+    else
+    {
+        // timestamps not monotonic (uncleaned data), fall back to search from start
+        it = std::find_if(frames_.begin(),
+                          frames_.end(),
+                          [timestamp](const ReplayFrame& frame) { return static_cast<double>(frame.timestamp) >= timestamp; });
+    }
+
+    if (it == frames_.end())
+    {
+        return static_cast<int>(frames_.back().first);
     }
 
-    return MIN(i, static_cast<int>(data_.size()) - 1);
+    return static_cast<int>(it->first);
 }
 
-unsigned int Replay::FindNextTimestamp(bool wrap)
+int Replay::FindFrameOfIndex(unsigned int index)
+{
+    // frames are always ordered by entry index, find last frame starting at or before index
+    auto it = std::upper_bound(frames_.begin(), frames_.end(), index, [](unsigned int i, const ReplayFrame& frame) { return i < frame.first; });
+
+    return static_cast<int>(it - frames_.begin()) - 1;
+}
+
+unsigned int Replay::FindFrameStart(unsigned int index)
 {
-    unsigned int index = index_ + 1;
-    for (; index < data_.size(); index++)
+    if (dat_file_ != nullptr && !EntriesSorted(index + 1))
     {
-        if (data_[index].state.info.timeStamp > data_[index_].state.info.timeStamp)
+        // a frame is a sequence of entries with same timestamp, as in BuildIndex()
+        float timestamp = GetTimestampByIndex(index);
+        while (index > 0 && GetTimestampByIndex(index - 1) == timestamp)
         {
-            break;
+            index--;
         }
+        return index;
     }
+    else if (dat_file_ != nullptr)
+    {
+        // entries are sorted by timestamp, search backwards for first entry with same timestamp
+        float        timestamp = GetTimestampByIndex(index);
+        unsigned int lo        = 0;
+        unsigned int hi        = index;
+        while (lo < hi)
+        {
+            unsigned int mid = lo + (hi - lo) / 2;
+            if (GetTimestampByIndex(mid) < timestamp)
+            {
+                lo = mid + 1;
+            }
+            else
+            {
+                hi = mid;
+            }
+        }
+        return lo;
+    }
+
+    return frames_[static_cast<unsigned int>(FindFrameOfIndex(index))].first;
+}
 
-    if (index >= data_.size())
+unsigned int Replay::FindFrameEnd(unsigned int index)
+{
+    if (dat_file_ != nullptr)
     {
-        if (wrap)
+        float        timestamp = GetTimestampByIndex(index);
+        unsigned int n         = static_cast<unsigned int>(GetNumberOfEntries());
+
+        if (frames_sorted_)
         {
-            return 0;
+            // search forward for first entry with later timestamp
+            unsigned int lo = index + 1;
+            unsigned int hi = n;
+            while (lo < hi)
+            {
+                unsigned int mid = lo + (hi - lo) / 2;
+                if (GetTimestampByIndex(mid) > timestamp)
+                {
+                    hi = mid;
+                }
+                else
+                {
+                    lo = mid + 1;
+                }
+            }
+
+            // same result as the linear search below if all entries up to the found one are in order
+            if (EntriesSorted(MIN(lo + 1, n)) && GetTimestampByIndex(lo - 1) <= timestamp)
+            {
+                return lo;
+            }
         }
-        else
+
+        index++;
+        while (index < n && GetTimestampByIndex(index) == timestamp)
         {
-            return index_;  // stay on current index
+            index++;
         }
+        return index;
     }
 
-    return index;
+    const ReplayFrame& frame = frames_[static_cast<unsigned int>(FindFrameOfIndex(index))];
+
+    return frame.first + frame.count;
+}
+
+bool Replay::EntriesSorted(unsigned int end)
+{
+    // extend the verified range as needed, i.e. at most one pass over the recording in total
+    while (frames_sorted_ && sorted_end_ < end)
+    {
+        if (sorted_end_ > 0 && GetTimestampByIndex(sorted_end_) < GetTimestampByIndex(sorted_end_ - 1))
+        {
+            frames_sorted_ = false;
+        }
+        sorted_end_++;
+    }
+
+    return frames_sorted_;
+}
+
+float Replay::GetTimestampByIndex(unsigned int index)
+{
+    if (dat_file_ != nullptr)
+    {
+        return dat_file_->GetTimestamp(index);
+    }
+
+    return data_[index].state.info.timeStamp;
+}
+
+unsigned int Replay::FindNextTimestamp(bool wrap)
+{
+    if (index_ < GetNumberOfEntries())
+    {
+        float timestamp = GetTimestampByIndex(index_);
+        for (unsigned int i = FindFrameEnd(index_); i < GetNumberOfEntries(); i = FindFrameEnd(i))
+        {
+            if (GetTimestampByIndex(i) > timestamp)
+            {
+                return i;
+            }
+        }
+    }
+
+    if (wrap)
+    {
+        return 0;
+    }
+
+    return index_;  // stay on current index
 }
 
 unsigned int Replay::FindPreviousTimestamp(bool wrap)
@@ -413,7 +764,7 @@ unsigned int Replay::FindPreviousTimestamp(bool wrap)
     {
         if (wrap)
         {
-            index = static_cast<int>(data_.size()) - 1;
+            index = static_cast<int>(GetNumberOfEntries()) - 1;
         }
         else
         {
@@ -421,34 +772,128 @@ unsigned int Replay::FindPreviousTimestamp(bool wrap)
         }
     }
 
-    for (int i = index - 1; i >= 0; i--)
+    if (index < 0)
+    {
+        return 0;
+    }
+
+    // go to the first entry of the frame
+    return FindFrameStart(static_cast<unsigned int>(index));
+}
+
+size_t Replay::GetNumberOfEntries()
+{
+    if (dat_file_ != nullptr)
+    {
+        return dat_file_->GetNumberOfEntries();
+    }
+
+    return data_.size();
+}
+
+size_t Replay::GetNumberOfFrames()
+{
+    if (dat_file_ != nullptr)
     {
-        // go backwards until we identify the first entry with same timestamp
-        if (data_[static_cast<unsigned int>(i)].state.info.timeStamp < data_[static_cast<unsigned int>(index)].state.info.timeStamp)
+        size_t n_frames = 0;
+        for (unsigned int i = 0; i < GetNumberOfEntries(); i = FindFrameEnd(i))
         {
-            break;
+            n_frames++;
         }
-        index = i;
+        return n_frames;
+    }
+
+    return frames_.size();
+}
+
+void Replay::FillWindow(unsigned int first, unsigned int end)
+{
+    end = MIN(MAX(end, first + REPLAY_WINDOW_SIZE), static_cast<unsigned int>(GetNumberOfEntries()));
+
+    if (first >= window_first_ && end <= window_first_ + window_.size())
+    {
+        return;  // already decoded
     }
 
-    return static_cast<unsigned int>(index);
+    window_.resize(end - first);
+    for (unsigned int i = 0; i < window_.size(); i++)
+    {
+        dat_file_->GetState(first + i, &window_[i].state);
+        window_[i].odometer = 0.0;
+    }
+    window_first_ = first;
+}
+
+ReplayEntry* Replay::GetEntryByIndex(unsigned int index)
+{
+    if (dat_file_ == nullptr)
+    {
+        return &data_[index];
+    }
+
+    if (index < window_first_ || index >= window_first_ + window_.size())
+    {
+        // decode from start of the frame, so that complete frame is available in the window
+        unsigned int first = FindFrameStart(index);
+        FillWindow(first, FindFrameEnd(index));
+    }
+
+    return &window_[index - window_first_];
 }
 
 ReplayEntry* Replay::GetEntry(int id)
 {
-    // Read all vehicles at current timestamp
-    float timestamp = data_[index_].state.info.timeStamp;
-    int   i         = 0;
-    while (index_ + static_cast<unsigned int>(i) < data_.size() && !(data_[index_ + static_cast<unsigned int>(i)].state.info.timeStamp > timestamp))
+    if (id < 0 || index_ >= GetNumberOfEntries())
+    {
+        return nullptr;
+    }
+
+    if (index_ < slots_first_ || index_ >= slots_end_)
     {
-        if (data_[index_ + static_cast<unsigned int>(i)].state.info.id == id)
+        // current index has moved to another frame, update id -> entry table
+        for (size_t i = 0; i < slot_ids_.size(); i++)
+        {
+            slots_[static_cast<unsigned int>(slot_ids_[i])] = -1;
+        }
+        slot_ids_.clear();
+
+        slots_first_ = FindFrameStart(index_);
+        slots_end_   = FindFrameEnd(index_);
+
+        if (dat_file_ != nullptr)
         {
-            return &data_[index_ + static_cast<unsigned int>(i)];
+            FillWindow(slots_first_, slots_end_);
         }
-        i++;
+
+        for (unsigned int i = slots_first_; i < slots_end_; i++)
+        {
+            int entry_id = GetEntryByIndex(i)->state.info.id;
+
+            if (entry_id < 0)
+            {
+                continue;
+            }
+
+            if (static_cast<unsigned int>(entry_id) >= slots_.size())
+            {
+                slots_.resize(static_cast<unsigned int>(entry_id) + 1, -1);
+            }
+
+            // in case of multiple entries for same object, pick first one
+            if (slots_[static_cast<unsigned int>(entry_id)] == -1)
+            {
+                slots_[static_cast<unsigned int>(entry_id)] = static_cast<int>(i);
+                slot_ids_.push_back(entry_id);
+            }
+        }
+    }
+
+    if (static_cast<unsigned int>(id) >= slots_.size() || slots_[static_cast<unsigned int>(id)] < 0)
+    {
+        return nullptr;
     }
 
-    return nullptr;
+    return GetEntryByIndex(static_cast<unsigned int>(slots_[static_cast<unsigned int>(id)]));
 }
 
 ObjectStateStructDat* Replay::GetState(int id)
@@ -486,6 +931,33 @@ void Replay::SetStopTime(double time)
     stopIndex_ = static_cast<unsigned int>(FindIndexAtTimestamp(stopTime_));
 }
 
+void Replay::BuildIndex()
+{
+    frames_.clear();
+    frames_sorted_ = true;
+
+    // invalidate current frame id -> entry table
+    slots_.clear();
+    slot_ids_.clear();
+    slots_first_ = 0;
+    slots_end_   = 0;
+
+    for (unsigned int i = 0; i < data_.size(); i++)
+    {
+        float timestamp = data_[i].state.info.timeStamp;
+
+        if (frames_.empty() || timestamp != frames_.back().timestamp)
+        {
+            if (!frames_.empty() && timestamp < frames_.back().timestamp)
+            {
+                frames_sorted_ = false;
+            }
+            frames_.push_back({timestamp, i, 0});
+        }
+        frames_.back().count++;
+    }
+}
+
 void Replay::CleanEntries(std::vector<ReplayEntry>& entries)
 {
     for (unsigned int i = 0; i < entries.size() - 1; i++)
@@ -509,79 +981,72 @@ void Replay::CleanEntries(std::vector<ReplayEntry>& entries)
     }
 }
 
-void Replay::BuildData(std::vector<std::pair<std::string, std::vector<ReplayEntry>>>& scenarios)
+void Replay::MergeScenarios(std::vector<std::unique_ptr<DatFrameCursor>>& scenarios, const std::function<void(ReplayEntry&)>& output)
 {
-    // Keep track of current index of each scenario
-    std::vector<int> cur_idx;
-    std::vector<int> next_idx;
+    // k-way merge on timestamp. Each step outputs the current frame of all ongoing scenarios, so that scenarios
+    // with different time steps are sampled at the union of all timestamps. A scenario joins at its first
+    // timestamp and leaves once its last frame has been output.
+    typedef std::pair<float, size_t> QueueItem;  // <timestamp of next frame, scenario index>
+    std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> queue;
+    std::vector<bool>                                                               active(scenarios.size(), false);
 
     for (size_t j = 0; j < scenarios.size(); j++)
     {
-        cur_idx.push_back(0);
-        next_idx.push_back(0);
+        if (scenarios[j]->HasNextFrame())
+        {
+            queue.push(std::make_pair(scenarios[j]->GetNextTimestamp(), j));
+        }
     }
 
-    // Set scenario ID-group (0, 100, 200 etc.)
-    for (size_t j = 0; j < scenarios.size(); j++)
+    while (!queue.empty())
     {
-        for (size_t k = 0; k < scenarios[j].second.size(); k++)
+        float timestamp = queue.top().first;
+
+        // step all scenarios which have reached their next frame
+        while (!queue.empty() && static_cast<double>(queue.top().first) < static_cast<double>(timestamp) + SMALL_NUMBER)
         {
-            // Set scenario ID-group (0, 100, 200 etc.)
-            scenarios[j].second[k].state.info.id += static_cast<int>(j) * 100;
+            size_t j = queue.top().second;
+            queue.pop();
+
+            scenarios[j]->NextFrame();
+            active[j] = true;
+
+            if (scenarios[j]->HasNextFrame())
+            {
+                queue.push(std::make_pair(scenarios[j]->GetNextTimestamp(), j));
+            }
         }
-    }
 
-    // Populate data_ based on first (with lowest timestamp) scenario
-    double cur_timestamp = static_cast<double>(scenarios[0].second[0].state.info.timeStamp);
-    while (cur_timestamp < LARGE_NUMBER - SMALL_NUMBER)
-    {
-        // populate entries if all scenarios at current time step
-        double min_time_stamp = LARGE_NUMBER;
         for (size_t j = 0; j < scenarios.size(); j++)
         {
-            if (next_idx[j] != -1)
+            if (!active[j])
             {
-                unsigned int k = static_cast<unsigned int>(cur_idx[j]);
-                for (; k < scenarios[j].second.size() && static_cast<double>(scenarios[j].second[k].state.info.timeStamp) < cur_timestamp + 1e-6; k++)
-                {
-                    // push entry with modified timestamp
-                    scenarios[j].second[k].state.info.timeStamp = static_cast<float>(cur_timestamp);
-                    data_.push_back(scenarios[j].second[k]);
-                }
+                continue;
+            }
 
-                if (k < scenarios[j].second.size())
-                {
-                    next_idx[j] = static_cast<int>(k);
-                    if (static_cast<double>(scenarios[j].second[k].state.info.timeStamp) < min_time_stamp)
-                    {
-                        min_time_stamp = static_cast<double>(scenarios[j].second[k].state.info.timeStamp);
-                    }
-                }
-                else
-                {
-                    next_idx[j] = -1;
-                }
+            for (size_t k = 0; k < scenarios[j]->frame_.size(); k++)
+            {
+                // output entry with modified timestamp and scenario ID-group (0, 100, 200 etc.)
+                ReplayEntry entry          = scenarios[j]->frame_[k];
+                entry.state.info.timeStamp = timestamp;
+                entry.state.info.id += static_cast<int>(j) * 100;
+                output(entry);
             }
-        }
 
-        if (min_time_stamp < LARGE_NUMBER - SMALL_NUMBER)
-        {
-            for (size_t j = 0; j < scenarios.size(); j++)
+            if (!scenarios[j]->HasNextFrame())
             {
-                if (next_idx[j] > 0 && static_cast<double>(scenarios[j].second[static_cast<unsigned int>(next_idx[j])].state.info.timeStamp) <
-                                           min_time_stamp + SMALL_NUMBER)
-                {
-                    // time has reached next entry, step this scenario
-                    cur_idx[j] = next_idx[j];
-                }
+                active[j] = false;
             }
         }
-
-        cur_timestamp = min_time_stamp;
     }
 }
 
-void Replay::CreateMergedDatfile(const std::string filename)
+void Replay::BuildData(std::vector<std::unique_ptr<DatFrameCursor>>& scenarios)
+{
+    MergeScenarios(scenarios, [this](ReplayEntry& entry) { data_.push_back(entry); });
+}
+
+void Replay::CreateMergedDatfile(std::vector<std::unique_ptr<DatFrameCursor>>& scenarios, const std::string filename)
 {
     std::ofstream data_file_;
     data_file_.open(filename, std::ofstream::binary);
@@ -593,12 +1058,7 @@ void Replay::CreateMergedDatfile(const std::string filename)
 
     data_file_.write(reinterpret_cast<char*>(&header_), sizeof(header_));
 
-    if (data_file_.is_open())
-    {
-        // Write status to file - for later replay
-        for (size_t i = 0; i < data_.size(); i++)
-        {
-            data_file_.write(reinterpret_cast<char*>(&data_[i].state), sizeof(data_[i].state));
-        }
-    }
-}
\ No newline at end of file
+    // Write status to file - for later replay
+    MergeScenarios(scenarios,
+                   [&data_file_](ReplayEntry& entry) { data_file_.write(reinterpret_cast<char*>(&entry.state), sizeof(entry.state)); });
+}
@@ -14,25 +14,127 @@
 
 #include <string>
 #include <fstream>
+#include <functional>
+#include <memory>
 #include "CommonMini.hpp"
 #include "ScenarioGateway.hpp"
 
 namespace scenarioengine
 {
+#define REPLAY_WINDOW_SIZE      1024        // number of entries decoded at a time in streaming mode
+#define REPLAY_INDEX_UNRESOLVED 0xffffffff  // index not looked up yet, see Replay::GoToEnd()
+
     typedef struct
     {
         ObjectStateStructDat state;
         double               odometer;
     } ReplayEntry;
 
+    typedef struct
+    {
+        float        timestamp;
+        unsigned int first;  // index of first entry in data_
+        unsigned int count;  // number of entries sharing the timestamp
+    } ReplayFrame;
+
+    /**
+        Read-only memory mapped view of a .dat recording file
+        Entries are fixed size records following the header, copied out on request
+    */
+    class DatFile
+    {
+    public:
+        DatHeader header_;
+
+        DatFile(std::string filename);
+        ~DatFile();
+
+        size_t GetNumberOfEntries()
+        {
+            return n_entries_;
+        }
+        float GetTimestamp(size_t index);
+        int   GetId(size_t index);
+        void  GetState(size_t index, ObjectStateStructDat* state);
+
+    private:
+        void Unmap();
+
+        const char* data_;
+        size_t      size_;
+        size_t      n_entries_;
+#ifdef _WIN32
+        void* file_handle_;
+        void* map_handle_;
+#else
+        int fd_;
+#endif
+    };
+
+    /**
+        Sequential reader of a .dat recording, one frame (entries sharing timestamp) at a time
+        Entries with decreasing timestamps are skipped and only the latest instance of an object within a frame is kept
+    */
+    class DatFrameCursor
+    {
+    public:
+        std::string              filename_;
+        std::vector<ReplayEntry> frame_;  // entries of current frame
+
+        DatFrameCursor(std::string filename);
+
+        DatHeader& GetHeader()
+        {
+            return dat_file_.header_;
+        }
+        bool HasNextFrame()
+        {
+            return next_ < dat_file_.GetNumberOfEntries();
+        }
+        float GetNextTimestamp()
+        {
+            return dat_file_.GetTimestamp(next_);
+        }
+        bool NextFrame();  // read next frame into frame_, returns false if no more frames
+
+    private:
+        DatFile dat_file_;
+        size_t  next_;            // index of first entry of next frame
+        float   last_timestamp_;  // timestamp of last accepted entry
+
+        void SkipDecreasingTimestamps();
+    };
+
     class Replay
     {
     public:
+        enum class ReadMode
+        {
+            LOAD_ALL,  // read all entries into data_
+            STREAM     // map file and decode entries on demand
+        };
+
         DatHeader                header_;
         std::vector<ReplayEntry> data_;
 
-        Replay(std::string filename, bool clean);
-        // Replay(const std::string directory, const std::string scenario, bool clean);
+        /**
+                Open a recording
+                @param filename .dat file
+                @param clean If true remove entries with decreasing timestamps and duplicates within a frame
+                @param mode STREAM maps the file and decodes entries on demand instead of loading all entries into
+                   data_. Opening does not read the entries and memory consumption is bounded.
+                   Clean flag is ignored and odometer is not calculated. Frames are found by binary search. The
+                   timestamp order is verified lazily, up to the furthest entry a search depends on. On the first
+                   decreasing timestamp searches fall back to linear, giving same frames as LOAD_ALL mode.
+        */
+        Replay(std::string filename, bool clean, ReadMode mode = ReadMode::LOAD_ALL);
+        /**
+                Open and merge all recordings of a scenario found in a directory (and its sub directories)
+                The recordings are merged frame by frame, streamed from file, object ids offset by 100 per scenario
+                @param directory Where to look for .dat files
+                @param scenario Part of filename to look for
+                @param create_datfile If not empty merged data is written directly to this file instead of data_
+        */
         Replay(const std::string directory, const std::string scenario, std::string create_datfile);
         ~Replay();
 
@@ -53,6 +155,8 @@ namespace scenarioengine
         unsigned int          FindPreviousTimestamp(bool wrap = false);
         ReplayEntry*          GetEntry(int id);
         ObjectStateStructDat* GetState(int id);
+        size_t                GetNumberOfEntries();
+        ReplayEntry*          GetEntryByIndex(unsigned int index);  // streaming mode: valid until entries outside window are requested
         void                  SetStartTime(double time);
         void                  SetStopTime(double time);
         double                GetStartTime()
@@ -75,9 +179,20 @@ namespace scenarioengine
         {
             repeat_ = repeat;
         }
+        size_t GetNumberOfFrames();
+        bool   IsStreaming()
+        {
+            return dat_file_ != nullptr;
+        }
         void CleanEntries(std::vector<ReplayEntry>& entries);
-        void BuildData(std::vector<std::pair<std::string, std::vector<ReplayEntry>>>& scenarios);
-        void CreateMergedDatfile(const std::string filename);
+        void BuildData(std::vector<std::unique_ptr<DatFrameCursor>>& scenarios);
+        void CreateMergedDatfile(std::vector<std::unique_ptr<DatFrameCursor>>& scenarios, const std::string filename);
+
+        /**
+                Create frame index from data_, grouping entries with same timestamp
+                Needs to be called whenever data_ has been modified
+        */
+        void BuildIndex();
 
     private:
         std::ifstream            file_;
@@ -91,8 +206,25 @@ namespace scenarioengine
         bool                     repeat_;
         bool                     clean_;
         std::string              create_datfile_;
+        std::vector<ReplayFrame> frames_;         // frame index, one element per unique timestamp
+        bool                     frames_sorted_;  // true if frame timestamps are strictly increasing
+        unsigned int             sorted_end_;     // streaming mode: entries before this index verified in order
+        std::vector<int>         slots_;          // object id -> entry index for entries in current frame
+        std::vector<int>         slot_ids_;       // ids registered in slots_, for fast reset
+        unsigned int             slots_first_;    // first entry index of frame mapped by slots_
+        unsigned int             slots_end_;      // entry index after last entry of frame mapped by slots_
+        std::unique_ptr<DatFile> dat_file_;       // set in streaming mode only
+        std::vector<ReplayEntry> window_;         // decoded entries in streaming mode
+        unsigned int             window_first_;   // entry index of first element in window_
 
-        int FindIndexAtTimestamp(double timestamp, int startSearchIndex = 0);
+        int          FindIndexAtTimestamp(double timestamp);
+        int          FindFrameOfIndex(unsigned int index);
+        unsigned int FindFrameStart(unsigned int index);
+        unsigned int FindFrameEnd(unsigned int index);
+        float        GetTimestampByIndex(unsigned int index);
+        bool         EntriesSorted(unsigned int end);
+        void         FillWindow(unsigned int first, unsigned int end);
+        void         MergeScenarios(std::vector<std::unique_ptr<DatFrameCursor>>& scenarios, const std::function<void(ReplayEntry&)>& output);
     };
 
 }  // namespace scenarioengine
\ No newline at end of file
@@ -2,38 +2,21 @@
 #define COLLISION_HPP
 
 #include "CommonMini.hpp"
+#include "ScenarioGateway.hpp"
 
-typedef struct
+void updateCorners(const scenarioengine::ObjectPositionStructDat& pos,
+                   const scenarioengine::OSCBoundingBox&          bounding_box,
+                   std::vector<SE_Vector>&                        corners)
 {
-    int                            id;
-    std::string                    name;
-    viewer::EntityModel*           entityModel;
-    struct ObjectPositionStructDat pos;
-    osg::ref_ptr<osg::Vec3Array>   trajPoints;
-    viewer::PolyLine*              trajectory;
-    float                          wheel_angle;
-    float                          wheel_rotation;
-    bool                           visible;
-    OSCBoundingBox                 bounding_box;
-    std::vector<SE_Vector>         corners;
-    std::vector<int>               overlap_entity_ids;
-} ScenarioEntity;
-
-void updateCorners(ScenarioEntity& entity)
-{
-    SE_Vector bb_center(entity.bounding_box.center_.x_, entity.bounding_box.center_.y_);
-    SE_Vector bb_dim(entity.bounding_box.dimensions_.length_, entity.bounding_box.dimensions_.width_);
-
-    SE_Vector front_right =
-        SE_Vector(entity.pos.x, entity.pos.y) + SE_Vector(bb_center.x() + bb_dim.x() / 2.0, bb_center.y() - bb_dim.y() / 2.0).Rotate(entity.pos.h);
-    SE_Vector front_left =
-        SE_Vector(entity.pos.x, entity.pos.y) + SE_Vector(bb_center.x() + bb_dim.x() / 2.0, bb_center.y() + bb_dim.y() / 2.0).Rotate(entity.pos.h);
-    SE_Vector rear_left =
-        SE_Vector(entity.pos.x, entity.pos.y) + SE_Vector(bb_center.x() - bb_dim.x() / 2.0, bb_center.y() + bb_dim.y() / 2.0).Rotate(entity.pos.h);
-    SE_Vector rear_right =
-        SE_Vector(entity.pos.x, entity.pos.y) + SE_Vector(bb_center.x() - bb_dim.x() / 2.0, bb_center.y() - bb_dim.y() / 2.0).Rotate(entity.pos.h);
-
-    entity.corners = {front_right, front_left, rear_left, rear_right};
+    SE_Vector bb_center(bounding_box.center_.x_, bounding_box.center_.y_);
+    SE_Vector bb_dim(bounding_box.dimensions_.length_, bounding_box.dimensions_.width_);
+
+    SE_Vector front_right = SE_Vector(pos.x, pos.y) + SE_Vector(bb_center.x() + bb_dim.x() / 2.0, bb_center.y() - bb_dim.y() / 2.0).Rotate(pos.h);
+    SE_Vector front_left = SE_Vector(pos.x, pos.y) + SE_Vector(bb_center.x() + bb_dim.x() / 2.0, bb_center.y() + bb_dim.y() / 2.0).Rotate(pos.h);
+    SE_Vector rear_left = SE_Vector(pos.x, pos.y) + SE_Vector(bb_center.x() - bb_dim.x() / 2.0, bb_center.y() + bb_dim.y() / 2.0).Rotate(pos.h);
+    SE_Vector rear_right = SE_Vector(pos.x, pos.y) + SE_Vector(bb_center.x() - bb_dim.x() / 2.0, bb_center.y() - bb_dim.y() / 2.0).Rotate(pos.h);
+
+    corners = {front_right, front_left, rear_left, rear_right};
 }
 
 SE_Vector calculate_normalized_axis_projection(const SE_Vector& current_SE_Vector, const SE_Vector& next_SE_Vector)
@@ -81,36 +64,36 @@ bool is_overlapping(const std::vector<double>& projections_a, const std::vector<
     return true;
 }
 
-bool separating_axis_intersect(const ScenarioEntity& ego, const ScenarioEntity& target)
+bool separating_axis_intersect(const std::vector<SE_Vector>& ego_corners, const std::vector<SE_Vector>& target_corners)
 {
-    for (size_t i = 0; i < ego.corners.size(); i++)
+    for (size_t i = 0; i < ego_corners.size(); i++)
     {
-        SE_Vector current_point = ego.corners[i];
-        SE_Vector next_point(ego.corners[(i + 1) % ego.corners.size()].x(), ego.corners[(i + 1) % ego.corners.size()].y());
+        SE_Vector current_point = ego_corners[i];
+        SE_Vector next_point(ego_corners[(i + 1) % ego_corners.size()].x(), ego_corners[(i + 1) % ego_corners.size()].y());
 
         SE_Vector axis_normalized = calculate_normalized_axis_projection(current_point, next_point);
 
         std::vector<double> projections_a;
         std::vector<double> projections_b;
 
-        compute_projections(ego.corners, target.corners, axis_normalized, projections_a, projections_b);
+        compute_projections(ego_corners, target_corners, axis_normalized, projections_a, projections_b);
         if (!is_overlapping(projections_a, projections_b))
         {
             return false;
         }
     }
 
-    for (size_t i = 0; i < target.corners.size(); i++)
+    for (size_t i = 0; i < target_corners.size(); i++)
     {
-        SE_Vector current_point(target.corners[i]);
-        SE_Vector next_point(target.corners[(i + 1) % target.corners.size()].x(), target.corners[(i + 1) % target.corners.size()].y());
+        SE_Vector current_point(target_corners[i]);
+        SE_Vector next_point(target_corners[(i + 1) % target_corners.size()].x(), target_corners[(i + 1) % target_corners.size()].y());
 
         SE_Vector axis_normalized = calculate_normalized_axis_projection(current_point, next_point);
 
         std::vector<double> projections_a;
         std::vector<double> projections_b;
 
-        compute_projections(ego.corners, target.corners, axis_normalized, projections_a, projections_b);
+        compute_projections(ego_corners, target_corners, axis_normalized, projections_a, projections_b);
         if (!is_overlapping(projections_a, projections_b))
         {
             return false;
@@ -120,4 +103,33 @@ bool separating_axis_intersect(const ScenarioEntity& ego, const ScenarioEntity&
     return true;  // Intersects
 }
 
+// Shortest distance between two bounding boxes given by their corners, 0 if overlapping
+double bounding_box_distance(const std::vector<SE_Vector>& corners_a, const std::vector<SE_Vector>& corners_b)
+{
+    if (separating_axis_intersect(corners_a, corners_b))
+    {
+        return 0.0;
+    }
+
+    double min_dist = LARGE_NUMBER;
+    for (size_t i = 0; i < corners_a.size(); i++)
+    {
+        const SE_Vector& a0 = corners_a[i];
+        const SE_Vector& a1 = corners_a[(i + 1) % corners_a.size()];
+
+        for (size_t j = 0; j < corners_b.size(); j++)
+        {
+            const SE_Vector& b0 = corners_b[j];
+            const SE_Vector& b1 = corners_b[(j + 1) % corners_b.size()];
+
+            // corner of a to edge of b, and corner of b to edge of a
+            double dist_a = DistanceFromPointToEdge2D(a0.x(), a0.y(), b0.x(), b0.y(), b1.x(), b1.y(), nullptr, nullptr);
+            double dist_b = DistanceFromPointToEdge2D(b0.x(), b0.y(), a0.x(), a0.y(), a1.x(), a1.y(), nullptr, nullptr);
+            min_dist      = MIN(min_dist, MIN(dist_a, dist_b));
+        }
+    }
+
+    return min_dist;
+}
+
 #endif
\ No newline at end of file
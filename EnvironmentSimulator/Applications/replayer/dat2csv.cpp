@@ -11,33 +11,381 @@
  */
 
 /*
- * This application uses the Replay class to read and binary recordings and print content in ascii format to stdout
+ * This application uses the Replay class to read binary recordings and print content in ascii format to CSV files
+ * Any number of files, directories and filename patterns (wildcards * and ?) can be given. Files are processed in
+ * parallel, each one streamed in bounded memory. Optionally key performance indicators (collisions, minimum gap and
+ * time-to-collision with respect to ego) are calculated and aggregated into one table for all files.
+ * CSV files of recordings with same name get the parent directory name as prefix, e.g. run1_sim.csv.
  */
 
 #include <clocale>
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
 
 #include "Replay.hpp"
 #include "CommonMini.hpp"
+#include "collision.hpp"
+#include "dirent.h"
 
 using namespace scenarioengine;
 
-#define MAX_LINE_LEN 2048
+#define MAX_LINE_LEN    2048
+#define GHOST_CTRL_TYPE 100  // control type 100 indicates ghost
 
-int main(int argc, char** argv)
+typedef struct
 {
-    Replay*     player;
-    static char line[MAX_LINE_LEN];
+    std::string  filename;
+    int          status;  // 0 = OK, -1 = failed to read
+    unsigned int n_entries;
+    unsigned int n_frames;
+    double       start_time;
+    double       stop_time;
+    int          n_collisions;  // number of times any two (non ghost) objects started to overlap
+    double       min_gap;       // closest distance between ego and any other object bounding box
+    double       min_gap_time;
+    double       min_ttc;  // minimum time-to-collision of ego to any object ahead in its path
+    double       min_ttc_time;
+} RecordingKPI;
 
-    std::setlocale(LC_ALL, "C.UTF-8");
+typedef struct
+{
+    std::vector<std::string>  files;
+    std::vector<std::string>  csv_files;  // output filename per recording
+    std::vector<RecordingKPI> kpi;
+    size_t                    next_file;
+    std::mutex                mutex;
+    bool                      csv;
+    bool                      calc_kpi;
+    int                       ego_id;
+    std::string               output_dir;
+} BatchJob;
+
+typedef struct
+{
+    ObjectStateStructDat   state;
+    std::vector<SE_Vector> corners;
+} FrameObject;
+
+static bool MatchPattern(const char* pattern, const char* str)
+{
+    // simple wildcard matching, '*' any sequence of characters and '?' any single character
+    if (*pattern == '\0')
+    {
+        return *str == '\0';
+    }
+    else if (*pattern == '*')
+    {
+        return MatchPattern(pattern + 1, str) || (*str != '\0' && MatchPattern(pattern, str + 1));
+    }
+    else if (*str != '\0' && (*pattern == '?' || *pattern == *str))
+    {
+        return MatchPattern(pattern + 1, str + 1);
+    }
+
+    return false;
+}
+
+static void AddFiles(std::string arg, std::vector<std::string>& files)
+{
+    std::string dir     = DirNameOf(arg);
+    std::string pattern = FileNameOf(arg);
+    DIR*        directory;
+
+    if ((directory = opendir(arg.c_str())) != nullptr)
+    {
+        // argument is a directory, pick all .dat files in it
+        dir     = arg;
+        pattern = "*.dat";
+    }
+    else if (arg.find_first_of("*?") == std::string::npos)
+    {
+        files.push_back(arg);
+        return;
+    }
+    else if ((directory = opendir(dir.empty() ? "." : dir.c_str())) == nullptr)
+    {
+        printf("Failed to open directory %s\n", dir.c_str());
+        return;
+    }
+
+    std::vector<std::string> matches;
+    struct dirent*           file;
+    while ((file = readdir(directory)) != nullptr)
+    {
+        if (file->d_type != DT_DIR && MatchPattern(pattern.c_str(), file->d_name))
+        {
+            matches.push_back(dir.empty() ? file->d_name : dir + (dir.back() == '/' ? "" : "/") + file->d_name);
+        }
+    }
+    closedir(directory);
+
+    std::sort(matches.begin(), matches.end());
+    files.insert(files.end(), matches.begin(), matches.end());
+}
+
+static void ProcessFrame(std::vector<FrameObject>& objects, std::set<std::pair<int, int>>& overlaps, int ego_id, RecordingKPI& kpi)
+{
+    std::set<std::pair<int, int>> new_overlaps;
+    FrameObject*                  ego = nullptr;
+
+    for (size_t i = 0; i < objects.size(); i++)
+    {
+        updateCorners(objects[i].state.pos, objects[i].state.info.boundingbox, objects[i].corners);
+        if (objects[i].state.info.id == ego_id)
+        {
+            ego = &objects[i];
+        }
+    }
+
+    for (size_t i = 0; i < objects.size(); i++)
+    {
+        for (size_t j = i + 1; j < objects.size(); j++)
+        {
+            if (separating_axis_intersect(objects[i].corners, objects[j].corners))
+            {
+                std::pair<int, int> pair = std::make_pair(objects[i].state.info.id, objects[j].state.info.id);
+                if (overlaps.find(pair) == overlaps.end())
+                {
+                    kpi.n_collisions++;  // new overlap, register collision
+                }
+                new_overlaps.insert(pair);
+            }
+        }
+    }
+    overlaps.swap(new_overlaps);
+
+    if (ego == nullptr)
+    {
+        return;
+    }
+
+    const ObjectStateStructDat& ego_state = ego->state;
+    double                      ego_h     = static_cast<double>(ego_state.pos.h);
+
+    for (size_t i = 0; i < objects.size(); i++)
+    {
+        if (&objects[i] == ego)
+        {
+            continue;
+        }
+
+        const ObjectStateStructDat& state = objects[i].state;
+
+        double gap = bounding_box_distance(ego->corners, objects[i].corners);
+        if (gap < kpi.min_gap)
+        {
+            kpi.min_gap      = gap;
+            kpi.min_gap_time = static_cast<double>(state.info.timeStamp);
+        }
+
+        // time-to-collision, considering objects ahead and laterally overlapping the path of ego
+        double dx      = static_cast<double>(state.pos.x - ego_state.pos.x);
+        double dy      = static_cast<double>(state.pos.y - ego_state.pos.y);
+        double x_local = dx * cos(ego_h) + dy * sin(ego_h);
+        double y_local = -dx * sin(ego_h) + dy * cos(ego_h);
+        double long_gap = x_local + static_cast<double>(state.info.boundingbox.center_.x_ - ego_state.info.boundingbox.center_.x_) -
+                          static_cast<double>(state.info.boundingbox.dimensions_.length_ + ego_state.info.boundingbox.dimensions_.length_) / 2.0;
+        double lat_limit = static_cast<double>(state.info.boundingbox.dimensions_.width_ + ego_state.info.boundingbox.dimensions_.width_) / 2.0;
+        double closing_speed =
+            static_cast<double>(ego_state.info.speed) - static_cast<double>(state.info.speed) * cos(static_cast<double>(state.pos.h) - ego_h);
+
+        if (long_gap > 0.0 && fabs(y_local) < lat_limit && closing_speed > SMALL_NUMBER && long_gap / closing_speed < kpi.min_ttc)
+        {
+            kpi.min_ttc      = long_gap / closing_speed;
+            kpi.min_ttc_time = static_cast<double>(state.info.timeStamp);
+        }
+    }
+}
+
+static int SetCSVFilenames(BatchJob& job)
+{
+    // all CSV files go into the same directory, add parent directory name to recordings sharing same filename
+    std::map<std::string, int> n_names;
+    for (size_t i = 0; i < job.files.size(); i++)
+    {
+        n_names[FileNameWithoutExtOf(job.files[i])]++;
+    }
+
+    std::map<std::string, size_t> csv_names;  // csv filename -> index of recording
+    job.csv_files.clear();
+    for (size_t i = 0; i < job.files.size(); i++)
+    {
+        std::string name = FileNameWithoutExtOf(job.files[i]);
+        if (n_names[name] > 1)
+        {
+            std::string parent = FileNameOf(DirNameOf(job.files[i]));
+            if (!parent.empty() && parent != "." && parent != "..")
+            {
+                name = parent + "_" + name;
+            }
+        }
+        name += ".csv";
+
+        if (job.csv && csv_names.find(name) != csv_names.end())
+        {
+            printf("Recordings %s and %s would both be written to %s, please rename or process separately\n",
+                   job.files[csv_names[name]].c_str(),
+                   job.files[i].c_str(),
+                   name.c_str());
+            return -1;
+        }
+        csv_names[name] = i;
+
+        if (!job.output_dir.empty())
+        {
+            name = CombineDirectoryPathAndFilepath(job.output_dir, name);
+        }
+        job.csv_files.push_back(name);
+    }
+
+    return 0;
+}
+
+static int ProcessFile(BatchJob& job, const std::string& filename, const std::string& csv_filename, RecordingKPI& kpi)
+{
+    char          line[MAX_LINE_LEN];  // not static, called from several threads
+    std::ofstream file;
+    Replay*       player;
 
-    if (argc < 2)
+    kpi.filename     = filename;
+    kpi.status       = -1;
+    kpi.n_entries    = 0;
+    kpi.n_frames     = 0;
+    kpi.start_time   = 0.0;
+    kpi.stop_time    = 0.0;
+    kpi.n_collisions = 0;
+    kpi.min_gap      = LARGE_NUMBER;
+    kpi.min_gap_time = 0.0;
+    kpi.min_ttc      = LARGE_NUMBER;
+    kpi.min_ttc_time = 0.0;
+
+    // Create replayer object for parsing the binary data file
+    try
+    {
+        // map the file and decode entries on demand, keeping memory bounded regardless of file size
+        player = new Replay(filename, false, Replay::ReadMode::STREAM);
+    }
+    catch (const std::exception& e)
     {
-        printf("Usage: %s <filename>\n", argv[0]);
+        printf("%s\n", e.what());
         return -1;
     }
 
-    std::string   filename = FileNameWithoutExtOf(argv[1]) + ".csv";
+    if (job.csv)
+    {
+        file.open(csv_filename);
+        if (!file.is_open())
+        {
+            printf("Failed to create file %s\n", csv_filename.c_str());
+            delete player;
+            return -1;
+        }
+
+        // First output header and CSV labels
+        snprintf(line,
+                 MAX_LINE_LEN,
+                 "Version: %d, OpenDRIVE: %s, 3DModel: %s\n",
+                 player->header_.version,
+                 player->header_.odr_filename,
+                 player->header_.model_filename);
+        file << line;
+        snprintf(line, MAX_LINE_LEN, "time, id, name, x, y, z, h, p, r, speed, wheel_angle, wheel_rot\n");
+        file << line;
+    }
+
+    // Then go through all entries, frame by frame
+    std::vector<FrameObject>      frame;
+    std::set<std::pair<int, int>> overlaps;
+    for (unsigned int i = 0; i < player->GetNumberOfEntries(); i++)
+    {
+        ObjectStateStructDat* state = &player->GetEntryByIndex(i)->state;
+
+        if (job.calc_kpi)
+        {
+            if (!frame.empty() && state->info.timeStamp > frame.back().state.info.timeStamp)
+            {
+                ProcessFrame(frame, overlaps, job.ego_id, kpi);
+                frame.clear();
+                kpi.n_frames++;
+            }
+
+            if (state->info.ctrl_type != GHOST_CTRL_TYPE && state->info.visibilityMask != 0)
+            {
+                frame.push_back({*state, {}});
+            }
+        }
+
+        if (job.csv)
+        {
+            // Output all entries with comma separated values
+            snprintf(line,
+                     MAX_LINE_LEN,
+                     "%.3f, %d, %s, %.3f, %.3f, %.3f, %.3f, %.3f, %.3f, %.3f, %.3f, %.3f\n",
+                     static_cast<double>(state->info.timeStamp),
+                     state->info.id,
+                     state->info.name,
+                     static_cast<double>(state->pos.x),
+                     static_cast<double>(state->pos.y),
+                     static_cast<double>(state->pos.z),
+                     static_cast<double>(state->pos.h),
+                     static_cast<double>(state->pos.p),
+                     static_cast<double>(state->pos.r),
+                     static_cast<double>(state->info.speed),
+                     static_cast<double>(state->info.wheel_angle),
+                     static_cast<double>(state->info.wheel_rot));
+
+            file << line;
+        }
+    }
+
+    if (job.calc_kpi && !frame.empty())
+    {
+        ProcessFrame(frame, overlaps, job.ego_id, kpi);
+        kpi.n_frames++;
+    }
+
+    kpi.status     = 0;
+    kpi.n_entries  = static_cast<unsigned int>(player->GetNumberOfEntries());
+    kpi.start_time = player->GetStartTime();
+    kpi.stop_time  = player->GetStopTime();
+
+    if (job.csv)
+    {
+        file.close();
+    }
+
+    delete player;
+
+    return 0;
+}
+
+static void Worker(BatchJob* job)
+{
+    while (true)
+    {
+        size_t index;
+        {
+            std::lock_guard<std::mutex> lock(job->mutex);
+            if (job->next_file >= job->files.size())
+            {
+                return;
+            }
+            index = job->next_file++;
+        }
+
+        // each worker writes to its own preallocated result, keeping output order deterministic
+        ProcessFile(*job, job->files[index], job->csv_files[index], job->kpi[index]);
+    }
+}
+
+static int WriteKPITable(BatchJob& job, std::string filename)
+{
+    static char   line[MAX_LINE_LEN];
     std::ofstream file;
+
     file.open(filename);
     if (!file.is_open())
     {
@@ -45,53 +393,138 @@ int main(int argc, char** argv)
         return -1;
     }
 
-    // Create replayer object for parsing the binary data file
-    try
+    file << "file, status, entries, frames, start_time, stop_time, collisions, min_gap, min_gap_time, min_ttc, min_ttc_time\n";
+    for (size_t i = 0; i < job.kpi.size(); i++)
     {
-        player = new Replay(argv[1], false);
+        RecordingKPI& kpi = job.kpi[i];
+
+        // missing values (e.g. no ego or no objects ahead) are left empty
+        snprintf(line,
+                 MAX_LINE_LEN,
+                 "%s, %d, %u, %u, %.3f, %.3f, %d, ",
+                 kpi.filename.c_str(),
+                 kpi.status,
+                 kpi.n_entries,
+                 kpi.n_frames,
+                 kpi.start_time,
+                 kpi.stop_time,
+                 kpi.n_collisions);
+        file << line;
+
+        if (kpi.min_gap < LARGE_NUMBER - SMALL_NUMBER)
+        {
+            snprintf(line, MAX_LINE_LEN, "%.3f, %.3f, ", kpi.min_gap, kpi.min_gap_time);
+            file << line;
+        }
+        else
+        {
+            file << ", , ";
+        }
+
+        if (kpi.min_ttc < LARGE_NUMBER - SMALL_NUMBER)
+        {
+            snprintf(line, MAX_LINE_LEN, "%.3f, %.3f\n", kpi.min_ttc, kpi.min_ttc_time);
+            file << line;
+        }
+        else
+        {
+            file << ", \n";
+        }
     }
-    catch (const std::exception& e)
+    file.close();
+
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    SE_Options               opt;
+    BatchJob                 job;
+    std::vector<std::string> option_args = {"--ego", "--kpi", "--output_dir", "--threads"};  // options followed by a value
+
+    std::setlocale(LC_ALL, "C.UTF-8");
+
+    opt.AddOption("ego", "Id of object to measure gap and time-to-collision from", "id", "0");
+    opt.AddOption("kpi", "Calculate key performance indicators and write table for all files", "filename");
+    opt.AddOption("no_csv", "Skip creating CSV file per recording");
+    opt.AddOption("output_dir", "Directory for the CSV files (default = current directory)", "path");
+    opt.AddOption("threads", "Number of files to process in parallel (default = number of cores)", "number");
+
+    if (opt.ParseArgs(argc, argv) != 0 || opt.HasUnknownArgs())
     {
-        printf("%s", e.what());
+        opt.PrintUnknownArgs();
+        opt.PrintUsage();
         return -1;
     }
 
-    // First output header and CSV labels
-    snprintf(line,
-             MAX_LINE_LEN,
-             "Version: %d, OpenDRIVE: %s, 3DModel: %s\n",
-             player->header_.version,
-             player->header_.odr_filename,
-             player->header_.model_filename);
-    file << line;
-    snprintf(line, MAX_LINE_LEN, "time, id, name, x, y, z, h, p, r, speed, wheel_angle, wheel_rot\n");
-    file << line;
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::find(option_args.begin(), option_args.end(), argv[i]) != option_args.end())
+        {
+            i++;  // skip option value
+        }
+        else if (strncmp(argv[i], "--", 2))
+        {
+            AddFiles(argv[i], job.files);
+        }
+    }
 
-    // Then output all entries with comma separated values
-    for (size_t i = 0; i < player->data_.size(); i++)
+    if (job.files.empty())
     {
-        ObjectStateStructDat* state = &player->data_[i].state;
+        printf("Usage: %s [options] <filename | directory | pattern> ...\n", argv[0]);
+        printf("  e.g. %s sim.dat\n", argv[0]);
+        printf("       %s --kpi kpi.csv --no_csv results/*.dat\n", argv[0]);
+        opt.PrintUsage();
+        return -1;
+    }
 
-        snprintf(line,
-                 MAX_LINE_LEN,
-                 "%.3f, %d, %s, %.3f, %.3f, %.3f, %.3f, %.3f, %.3f, %.3f, %.3f, %.3f\n",
-                 static_cast<double>(state->info.timeStamp),
-                 state->info.id,
-                 state->info.name,
-                 static_cast<double>(state->pos.x),
-                 static_cast<double>(state->pos.y),
-                 static_cast<double>(state->pos.z),
-                 static_cast<double>(state->pos.h),
-                 static_cast<double>(state->pos.p),
-                 static_cast<double>(state->pos.r),
-                 static_cast<double>(state->info.speed),
-                 static_cast<double>(state->info.wheel_angle),
-                 static_cast<double>(state->info.wheel_rot));
+    job.next_file  = 0;
+    job.csv        = !opt.GetOptionSet("no_csv");
+    job.calc_kpi   = opt.GetOptionSet("kpi");
+    job.ego_id     = strtoi(opt.GetOptionArg("ego"));
+    job.output_dir = opt.GetOptionArg("output_dir");
+    job.kpi.resize(job.files.size());
 
-        file << line;
+    if (SetCSVFilenames(job) != 0)
+    {
+        return -1;
     }
 
-    file.close();
+    unsigned int n_threads = std::thread::hardware_concurrency();
+    if (opt.GetOptionSet("threads"))
+    {
+        n_threads = static_cast<unsigned int>(MAX(1, strtoi(opt.GetOptionArg("threads"))));
+    }
+    n_threads = MAX(1, MIN(n_threads, static_cast<unsigned int>(job.files.size())));
 
-    delete player;
-}
\ No newline at end of file
+    std::vector<std::thread> workers;
+    for (unsigned int i = 0; i < n_threads; i++)
+    {
+        workers.push_back(std::thread(Worker, &job));
+    }
+    for (size_t i = 0; i < workers.size(); i++)
+    {
+        workers[i].join();
+    }
+
+    int n_failed = 0;
+    for (size_t i = 0; i < job.kpi.size(); i++)
+    {
+        if (job.kpi[i].status != 0)
+        {
+            n_failed++;
+        }
+    }
+
+    if (job.calc_kpi && WriteKPITable(job, opt.GetOptionArg("kpi")) != 0)
+    {
+        return -1;
+    }
+
+    if (job.files.size() > 1)
+    {
+        printf("Processed %d files (%d failed) using %u threads\n", static_cast<int>(job.files.size()), n_failed, n_threads);
+    }
+
+    return n_failed > 0 ? -1 : 0;
+}
@@ -36,6 +36,24 @@ using namespace scenarioengine;
 #define GHOST_CTRL_TYPE       100  // control type 100 indicates ghost
 #define JUMP_DELTA_TIME_LARGE 1.0
 #define JUMP_DELTA_TIME_SMALL 0.1
+#define MAX_TRAJ_POINTS       10000  // per entity in streaming mode, decimate to bound memory
+
+typedef struct
+{
+    int                            id;
+    std::string                    name;
+    viewer::EntityModel*           entityModel;
+    struct ObjectPositionStructDat pos;
+    osg::ref_ptr<osg::Vec3Array>   trajPoints;
+    double                         trajPointDist;  // min distance between trajectory points
+    viewer::PolyLine*              trajectory;
+    float                          wheel_angle;
+    float                          wheel_rotation;
+    bool                           visible;
+    OSCBoundingBox                 bounding_box;
+    std::vector<SE_Vector>         corners;
+    std::vector<int>               overlap_entity_ids;
+} ScenarioEntity;
 
 static const double     stepSize       = 0.01;
 static const double     maxStepSize    = 0.1;
@@ -114,9 +132,9 @@ int ParseEntities(viewer::Viewer* viewer, Replay* player)
     };
     std::map<int, OdoInfo> odo_info;  // temporary keep track of entity odometers
 
-    for (int i = 0; i < static_cast<int>(player->data_.size()); i++)
+    for (unsigned int i = 0; i < player->GetNumberOfEntries(); i++)
     {
-        ReplayEntry*          entry = &player->data_[static_cast<unsigned int>(i)];
+        ReplayEntry*          entry = player->GetEntryByIndex(i);
         ObjectStateStructDat* state = &entry->state;
         OdoInfo               odo_entry;
 
@@ -139,6 +157,7 @@ int ParseEntities(viewer::Viewer* viewer, Replay* player)
 
             new_sc.id             = state->info.id;
             new_sc.trajPoints     = 0;
+            new_sc.trajPointDist  = minTrajPointDist;
             new_sc.pos            = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0, 0, 0.0f, 0.0f, 0.0f};
             new_sc.trajectory     = nullptr;
             new_sc.wheel_angle    = 0.0f;
@@ -204,7 +223,7 @@ int ParseEntities(viewer::Viewer* viewer, Replay* player)
             if (sc->trajPoints->size() > 2 && GetLengthOfLine2D(state->pos.x,
                                                                 state->pos.y,
                                                                 (*sc->trajPoints)[sc->trajPoints->size() - 2][0],
-                                                                (*sc->trajPoints)[sc->trajPoints->size() - 2][1]) < minTrajPointDist)
+                                                                (*sc->trajPoints)[sc->trajPoints->size() - 2][1]) < sc->trajPointDist)
             {
                 // Replace last point until distance is above threshold
                 sc->trajPoints->back() = osg::Vec3f(static_cast<float>(static_cast<double>(state->pos.x) - viewer->origin_[0]),
@@ -216,9 +235,27 @@ int ParseEntities(viewer::Viewer* viewer, Replay* player)
                 sc->trajPoints->push_back(osg::Vec3f(static_cast<float>(static_cast<double>(state->pos.x) - viewer->origin_[0]),
                                                      static_cast<float>(static_cast<double>(state->pos.y) - viewer->origin_[1]),
                                                      state->pos.z + static_cast<float>(z_offset)));
+
+                if (player->IsStreaming() && sc->trajPoints->size() >= MAX_TRAJ_POINTS)
+                {
+                    // keep every second point and double the point distance from now on
+                    unsigned int n = static_cast<unsigned int>(sc->trajPoints->size() + 1) / 2;
+                    for (unsigned int j = 1; j < n; j++)
+                    {
+                        (*sc->trajPoints)[j] = (*sc->trajPoints)[2 * j];
+                    }
+                    sc->trajPoints->resize(n);
+                    sc->trajPointDist *= 2;
+                }
             }
         }
 
+        if (player->IsStreaming())
+        {
+            // entry is a temporary copy in streaming mode, odometer not available
+            continue;
+        }
+
         // calculate odometer
         odo_entry    = odo_info[sc->id];
         double delta = GetLengthOfLine2D(odo_entry.x, odo_entry.y, state->pos.x, state->pos.y);
@@ -389,6 +426,7 @@ int main(int argc, char** argv)
     opt.AddOption("save_merged", "Save merged data into one dat file, instead of viewing", "filename");
     opt.AddOption("start_time", "Start playing at timestamp", "ms");
     opt.AddOption("stop_time", "Stop playing at timestamp (set equal to time_start for single frame)", "ms");
+    opt.AddOption("stream", "Read recording on demand instead of loading all of it, for huge files (no odometer info, simplified trajectories)");
     opt.AddOption("text_scale", "Scale screen overlay text", "factor", "1.0");
     opt.AddOption("time_scale", "Playback speed scale factor (1.0 == normal)", "factor");
     opt.AddOption("view_mode", "Entity visualization: \"model\"(default)/\"boundingbox\"/\"both\"", "view_mode");
@@ -458,7 +496,9 @@ int main(int argc, char** argv)
                 LOG("\"--saved_merged\" works only in combination with \"--dir\" argument, combining multiple dat files");
                 return -1;
             }
-            player = std::make_unique<Replay>(opt.GetOptionArg("file"), true);
+            player = std::make_unique<Replay>(opt.GetOptionArg("file"),
+                                              true,
+                                              opt.GetOptionSet("stream") ? Replay::ReadMode::STREAM : Replay::ReadMode::LOAD_ALL);
         }
     }
     catch (const std::exception& e)
@@ -823,23 +863,22 @@ int main(int argc, char** argv)
             viewer->ClearNodeMaskBits(viewer::NodeMask::NODE_MASK_TRAJECTORY_LINES);
         }
 
+        float first_timestamp = player->GetEntryByIndex(0)->state.info.timeStamp;
+        float last_timestamp  = player->GetEntryByIndex(static_cast<unsigned int>(player->GetNumberOfEntries()) - 1)->state.info.timeStamp;
+
         std::string start_time_str = opt.GetOptionArg("start_time");
         if (!start_time_str.empty())
         {
             double startTime = 1E-3 * strtod(start_time_str);
-            if (static_cast<float>(startTime) < player->data_[0].state.info.timeStamp)
+            if (static_cast<float>(startTime) < first_timestamp)
             {
-                printf("Specified start time (%.2f) < first timestamp (%.2f), adapting.\n",
-                       startTime,
-                       static_cast<double>(player->data_[0].state.info.timeStamp));
-                startTime = static_cast<double>(player->data_[0].state.info.timeStamp);
+                printf("Specified start time (%.2f) < first timestamp (%.2f), adapting.\n", startTime, static_cast<double>(first_timestamp));
+                startTime = static_cast<double>(first_timestamp);
             }
-            else if (static_cast<float>(startTime) > player->data_.back().state.info.timeStamp)
+            else if (static_cast<float>(startTime) > last_timestamp)
             {
-                printf("Specified start time (%.2f) > last timestamp (%.2f), adapting.\n",
-                       startTime,
-                       static_cast<double>(player->data_.back().state.info.timeStamp));
-                startTime = static_cast<double>(player->data_.back().state.info.timeStamp);
+                printf("Specified start time (%.2f) > last timestamp (%.2f), adapting.\n", startTime, static_cast<double>(last_timestamp));
+                startTime = static_cast<double>(last_timestamp);
             }
             player->SetStartTime(startTime);
             player->GoToTime(startTime);
@@ -849,19 +888,15 @@ int main(int argc, char** argv)
         if (!stop_time_str.empty())
         {
             double stopTime = 1E-3 * strtod(stop_time_str);
-            if (static_cast<float>(stopTime) > player->data_.back().state.info.timeStamp)
+            if (static_cast<float>(stopTime) > last_timestamp)
             {
-                printf("Specified stop time (%.2f) > last timestamp (%.2f), adapting.\n",
-                       stopTime,
-                       static_cast<double>(player->data_.back().state.info.timeStamp));
-                stopTime = static_cast<double>(player->data_.back().state.info.timeStamp);
+                printf("Specified stop time (%.2f) > last timestamp (%.2f), adapting.\n", stopTime, static_cast<double>(last_timestamp));
+                stopTime = static_cast<double>(last_timestamp);
             }
-            else if (static_cast<float>(stopTime) < player->data_[0].state.info.timeStamp)
+            else if (static_cast<float>(stopTime) < first_timestamp)
             {
-                printf("Specified stop time (%.2f) < first timestamp (%.2f), adapting.\n",
-                       stopTime,
-                       static_cast<double>(player->data_[0].state.info.timeStamp));
-                stopTime = static_cast<double>(player->data_[0].state.info.timeStamp);
+                printf("Specified stop time (%.2f) < first timestamp (%.2f), adapting.\n", stopTime, static_cast<double>(first_timestamp));
+                stopTime = static_cast<double>(first_timestamp);
             }
             player->SetStopTime(stopTime);
         }
@@ -1017,7 +1052,7 @@ int main(int argc, char** argv)
                         {
                             if (static_cast<int>(i) != ghost_idx)  // Ignore ghost
                             {
-                                updateCorners(scenarioEntity[i]);
+                                updateCorners(scenarioEntity[i].pos, scenarioEntity[i].bounding_box, scenarioEntity[i].corners);
                             }
                         }
 
@@ -1034,7 +1069,7 @@ int main(int argc, char** argv)
                                     continue;
                                 }
 
-                                if (separating_axis_intersect(scenarioEntity[i], scenarioEntity[j]))
+                                if (separating_axis_intersect(scenarioEntity[i].corners, scenarioEntity[j].corners))
                                 {
                                     if (std::find(scenarioEntity[i].overlap_entity_ids.begin(),
                                                   scenarioEntity[i].overlap_entity_ids.end(),
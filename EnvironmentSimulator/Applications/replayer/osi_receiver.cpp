@@ -18,6 +18,8 @@
 #include "osi_object.pb.h"
 #include "osi_sensorview.pb.h"
 #include "osi_version.pb.h"
+#include "SharedMemory.hpp"
+#include "TraceFile.hpp"
 #include <signal.h>
 
 #ifndef _WINDOWS
@@ -70,10 +72,100 @@ static void signal_handler(int s)
     quit = true;
 }
 
+static void PrintGroundTruth(osi3::GroundTruth& gt)
+{
+    // Print timestamp
+    printf("timestamp: %.2f\n",
+           static_cast<double>(gt.mutable_timestamp()->seconds()) + 1E-9 * static_cast<double>(gt.mutable_timestamp()->nanos()));
+
+    // Print object id, position, orientation and velocity
+    for (int i = 0; i < gt.mutable_moving_object()->size(); i++)
+    {
+        printf(" obj id %d pos (%.2f, %.2f, %.2f) orientation (%.2f, %.2f, %.2f) velocity (%.2f, %.2f, %.2f) \n",
+               static_cast<int>(gt.mutable_moving_object(i)->mutable_id()->value()),
+               gt.mutable_moving_object(i)->mutable_base()->mutable_position()->x(),
+               gt.mutable_moving_object(i)->mutable_base()->mutable_position()->y(),
+               gt.mutable_moving_object(i)->mutable_base()->mutable_position()->z(),
+               gt.mutable_moving_object(i)->mutable_base()->mutable_orientation()->yaw(),
+               gt.mutable_moving_object(i)->mutable_base()->mutable_orientation()->pitch(),
+               gt.mutable_moving_object(i)->mutable_base()->mutable_orientation()->roll(),
+               gt.mutable_moving_object(i)->mutable_base()->mutable_velocity()->x(),
+               gt.mutable_moving_object(i)->mutable_base()->mutable_velocity()->y(),
+               gt.mutable_moving_object(i)->mutable_base()->mutable_velocity()->z());
+    }
+}
+
+static int ReceiveSharedMemory(std::string name)
+{
+    SharedMemoryReader reader(name);
+    SharedMemoryFrame  frame;
+    uint64_t           last_frame = 0;
+    osi3::GroundTruth  gt;
+
+    printf("Waiting for OSI messages in shared memory %s. Press Ctrl-C to quit.\n", reader.GetName().c_str());
+
+    while (!quit)
+    {
+        if (reader.GetStatus() != 0 && reader.Open() != 0)
+        {
+            // writer not started yet
+            Sleep(100);
+            continue;
+        }
+
+        if (reader.GetGeneration() == last_frame)
+        {
+            // No new message, wait for a little while before polling again
+            Sleep(1);
+            continue;
+        }
+
+        // parse in place, without copying the message out of the shared memory
+        if (reader.GetLatest(frame) == 0 && gt.ParseFromArray(frame.data, static_cast<int>(frame.size)) && reader.IsValid(frame))
+        {
+            if (last_frame > 0 && frame.frame > last_frame + 1)
+            {
+                printf("skipped %d frame(s)\n", static_cast<int>(frame.frame - last_frame - 1));
+            }
+            last_frame = frame.frame;
+            PrintGroundTruth(gt);
+        }
+    }
+
+    return 0;
+}
+
+static int ReadTraceFile(std::string filename)
+{
+    TraceFileReader   reader;
+    std::vector<char> buf;
+    unsigned int      size;
+    osi3::GroundTruth gt;
+
+    if (reader.Open(filename) != 0)
+    {
+        printf("Failed to open %s\n", filename.c_str());
+        return -1;
+    }
+
+    // sequence of message size followed by message, same for compressed and plain files
+    while (!quit && reader.Read(&size, sizeof(size)) == sizeof(size))
+    {
+        buf.resize(size);
+        if (reader.Read(buf.data(), size) != static_cast<int>(size))
+        {
+            printf("Unexpected end of file %s\n", filename.c_str());
+            return -1;
+        }
+        gt.ParseFromArray(buf.data(), static_cast<int>(size));
+        PrintGroundTruth(gt);
+    }
+
+    return 0;
+}
+
 int main(int argc, char* argv[])
 {
-    (void)argc;
-    (void)argv;
     static SE_SOCKET          sock;
     struct sockaddr_in        server_addr;
     struct sockaddr_in        sender_addr;
@@ -94,6 +186,23 @@ int main(int argc, char* argv[])
     // Setup signal handler to catch Ctrl-C
     signal(SIGINT, signal_handler);
 
+    if (argc > 2 && !strcmp(argv[1], "--shm"))
+    {
+        return ReceiveSharedMemory(argv[2]);
+    }
+    else if (argc > 2 && !strcmp(argv[1], "--file"))
+    {
+        return ReadTraceFile(argv[2]);
+    }
+    else if (argc > 1)
+    {
+        printf("Usage: %s [--shm <name> | --file <filename>]\n", argv[0]);
+        printf("  default: receive OSI ground truth over UDP on port %d\n", OSI_OUT_PORT);
+        printf("  --shm <name>: read OSI ground truth from shared memory, see esmini option --osi_shm\n");
+        printf("  --file <filename>: read OSI ground truth from .osi trace file, compressed or not\n");
+        return -1;
+    }
+
 #ifdef _WIN32
     WSADATA wsa_data;
     int     iResult = WSAStartup(MAKEWORD(2, 2), &wsa_data);
@@ -165,26 +274,7 @@ int main(int argc, char* argv[])
         if (retval > 0)
         {
             gt.ParseFromArray(large_buf, receivedDataBytes);
-
-            // Print timestamp
-            printf("timestamp: %.2f\n",
-                   static_cast<double>(gt.mutable_timestamp()->seconds()) + 1E-9 * static_cast<double>(gt.mutable_timestamp()->nanos()));
-
-            // Print object id, position, orientation and velocity
-            for (int i = 0; i < gt.mutable_moving_object()->size(); i++)
-            {
-                printf(" obj id %d pos (%.2f, %.2f, %.2f) orientation (%.2f, %.2f, %.2f) velocity (%.2f, %.2f, %.2f) \n",
-                       static_cast<int>(gt.mutable_moving_object(i)->mutable_id()->value()),
-                       gt.mutable_moving_object(i)->mutable_base()->mutable_position()->x(),
-                       gt.mutable_moving_object(i)->mutable_base()->mutable_position()->y(),
-                       gt.mutable_moving_object(i)->mutable_base()->mutable_position()->z(),
-                       gt.mutable_moving_object(i)->mutable_base()->mutable_orientation()->yaw(),
-                       gt.mutable_moving_object(i)->mutable_base()->mutable_orientation()->pitch(),
-                       gt.mutable_moving_object(i)->mutable_base()->mutable_orientation()->roll(),
-                       gt.mutable_moving_object(i)->mutable_base()->mutable_velocity()->x(),
-                       gt.mutable_moving_object(i)->mutable_base()->mutable_velocity()->y(),
-                       gt.mutable_moving_object(i)->mutable_base()->mutable_velocity()->z());
-            }
+            PrintGroundTruth(gt);
         }
         else
         {
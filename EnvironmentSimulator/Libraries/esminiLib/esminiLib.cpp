@@ -12,9 +12,13 @@
 
 #include <string>
 #include <clocale>
+#include <mutex>
+#include <cstddef>
+#include <cstring>
 
 #include "CommonMini.hpp"
 #include "playerbase.hpp"
+#include "Profiler.hpp"
 #include "esminiLib.hpp"
 #include "IdealSensor.hpp"
 #include "Entities.hpp"
@@ -60,6 +64,42 @@ static std::vector<SE_ObjCallback> objCallback;
 // List of 3D models populated from any found found model_ids.txt file
 static std::map<int, std::string> entity_model_map_;
 
+// All instances, the default one and contexts, are serialized by this lock, see SE_Context. Every SE_* function takes
+// it, also when no context exists, since a context may be created by another thread at any time. Uncontended it costs
+// an atomic operation per call. The SE_Inject* functions are the exception, see InjectAction().
+static std::recursive_mutex instance_mutex;
+
+#define LOCK_INSTANCE() std::lock_guard<std::recursive_mutex> instance_lock(instance_mutex)
+
+// Player server of the default instance, for the SE_Inject* functions. The lock is only held for setting the pointer
+// and for pushing to the lock free queue, so injection never waits for a step. The player is not deleted before the
+// pointer has been reset, see resetScenario().
+static std::mutex    injection_mutex;
+static PlayerServer *default_player_server = nullptr;
+
+static void SetInjectionTarget(PlayerServer *server)
+{
+    if (SE_Env::Bound() == nullptr)
+    {
+        std::lock_guard<std::mutex> lock(injection_mutex);
+        default_player_server = server;
+    }
+}
+
+// Queue action at the player server of the default instance, or of the context bound to the calling thread
+template <typename F>
+static int InjectAction(F inject)
+{
+    if (SE_Env::Bound() != nullptr)
+    {
+        // a context is bound to the calling thread, which hence holds the instance lock
+        return player != nullptr ? inject(player->player_server_.get()) : -1;
+    }
+
+    std::lock_guard<std::mutex> lock(injection_mutex);
+    return default_player_server != nullptr ? inject(default_player_server) : -1;
+}
+
 static void log_callback(const char *str)
 {
     if (logToConsole)
@@ -72,6 +112,7 @@ static void resetScenario(void)
 {
     if (player != nullptr)
     {
+        SetInjectionTarget(nullptr);
         delete player;
         player = nullptr;
         SE_Env::Inst().ClearModelFilenames();
@@ -128,38 +169,16 @@ static void ConvertArguments()
     LOG("Player arguments: %s", argument_list.c_str());
 }
 
+// the gateway state table is handed out as is, see SE_GetObjectStateTable()
+static_assert(sizeof(ObjectStateTableEntry) == sizeof(SE_ScenarioObjectState), "State table layout mismatch");
+static_assert(offsetof(ObjectStateTableEntry, roadId) == offsetof(SE_ScenarioObjectState, roadId), "State table layout mismatch");
+static_assert(offsetof(ObjectStateTableEntry, visibilityMask) == offsetof(SE_ScenarioObjectState, visibilityMask), "State table layout mismatch");
+
 static void copyStateFromScenarioGateway(SE_ScenarioObjectState *state, ObjectStateStruct *gw_state)
 {
-    state->id        = gw_state->info.id;
-    state->model_id  = gw_state->info.model_id;
-    state->ctrl_type = gw_state->info.ctrl_type;
-    //	strncpy(state->name, gw_state->info.name, NAME_LEN);
-    state->timestamp      = static_cast<float>(gw_state->info.timeStamp);
-    state->x              = static_cast<float>(gw_state->pos.GetX());
-    state->y              = static_cast<float>(gw_state->pos.GetY());
-    state->z              = static_cast<float>(gw_state->pos.GetZ());
-    state->h              = static_cast<float>(gw_state->pos.GetH());
-    state->p              = static_cast<float>(gw_state->pos.GetP());
-    state->r              = static_cast<float>(gw_state->pos.GetR());
-    state->speed          = static_cast<float>(gw_state->info.speed);
-    state->roadId         = gw_state->pos.GetTrackId();
-    state->junctionId     = gw_state->pos.GetJunctionId();
-    state->t              = static_cast<float>(gw_state->pos.GetT());
-    state->laneId         = gw_state->pos.GetLaneId();
-    state->s              = static_cast<float>(gw_state->pos.GetS());
-    state->laneOffset     = static_cast<float>(gw_state->pos.GetOffset());
-    state->centerOffsetX  = gw_state->info.boundingbox.center_.x_;
-    state->centerOffsetY  = gw_state->info.boundingbox.center_.y_;
-    state->centerOffsetZ  = gw_state->info.boundingbox.center_.z_;
-    state->width          = gw_state->info.boundingbox.dimensions_.width_;
-    state->length         = gw_state->info.boundingbox.dimensions_.length_;
-    state->height         = gw_state->info.boundingbox.dimensions_.height_;
-    state->objectType     = gw_state->info.obj_type;
-    state->objectCategory = gw_state->info.obj_category;
-    // assume first wheel is on front axle and steering
-    state->wheel_angle    = gw_state->info.wheel_data.size() > 0 ? static_cast<float>(gw_state->info.wheel_data[0].h) : 0.0f;
-    state->wheel_rot      = gw_state->info.wheel_data.size() > 0 ? static_cast<float>(gw_state->info.wheel_data[0].p) : 0.0f;
-    state->visibilityMask = gw_state->info.visibilityMask;
+    ObjectStateTableEntry entry;
+    ScenarioGateway::GetStateTableEntry(*gw_state, entry);
+    memcpy(state, &entry, sizeof(entry));
 }
 
 static void copyWheelDataFromScenarioGateway(SE_WheelData *wheeldata, ObjectStateStruct *gw_state, int wheel_index)
@@ -456,6 +475,8 @@ static int InitScenario()
             resetScenario();
             return -1;
         }
+
+        SetInjectionTarget(player->player_server_.get());
     }
     catch (const std::exception &e)
     {
@@ -467,81 +488,189 @@ static int InitScenario()
     return 0;
 }
 
+// Simulation instance in addition to the default one, which lives in the static variables above. For the duration of
+// each context call the state of the context is swapped with those, hence all SE_* functions operate on the bound
+// context. This only works serialized, under instance_mutex. Engine singletons not covered here, e.g. Logger,
+// CSV_Logger, OSCParameterDistribution and the controller and OSI statics, are shared by all instances.
+struct SE_Context
+{
+    ScenarioPlayer                     *player = nullptr;
+    char                              **argv   = nullptr;
+    int                                 argc   = 0;
+    std::vector<std::string>            args_v;
+    std::vector<SE_ObjCallback>         objCallback;
+    __int64                             time_stamp = 0;
+    Parameters                          parameters;
+    Parameters                          variables;
+    void (*conditionCallback)(const char *name, double timestamp)                              = nullptr;
+    void (*stateChangeCallback)(const char *name, int type, int state, const char *full_path) = nullptr;
+#ifdef _USE_OSI
+    OSIReporter *osi_reporter = nullptr;
+#endif
+    SE_Env                 env;  // bound while the context is, including its road network
+    roadmanager::OpenDrive odr;
+    int                    depth    = 0;  // number of nested bindings
+    SE_Env                *prev_env = nullptr;
+};
+
+static void SwapContextState(SE_Context *ctx)
+{
+    std::swap(player, ctx->player);
+    std::swap(argv_, ctx->argv);
+    std::swap(argc_, ctx->argc);
+    std::swap(args_v, ctx->args_v);
+    std::swap(objCallback, ctx->objCallback);
+    std::swap(time_stamp, ctx->time_stamp);
+    std::swap(ScenarioReader::parameters, ctx->parameters);
+    std::swap(ScenarioReader::variables, ctx->variables);
+    std::swap(OSCCondition::conditionCallback, ctx->conditionCallback);
+    std::swap(StoryBoardElement::stateChangeCallback, ctx->stateChangeCallback);
+#ifdef _USE_OSI
+    std::swap(StoryBoardElement::osi_reporter_, ctx->osi_reporter);
+#endif
+}
+
+// caller holds instance_mutex
+static void BindContext(SE_Context *ctx)
+{
+    if (ctx->depth++ == 0)
+    {
+        SwapContextState(ctx);
+        ctx->prev_env = SE_Env::Bind(&ctx->env);
+    }
+}
+
+static void UnbindContext(SE_Context *ctx)
+{
+    if (--ctx->depth == 0)
+    {
+        SE_Env::Bind(ctx->prev_env);
+        SwapContextState(ctx);
+    }
+}
+
+class ContextScope
+{
+public:
+    explicit ContextScope(SE_Context *ctx) : lock_(instance_mutex), ctx_(ctx)
+    {
+        BindContext(ctx_);
+    }
+    ~ContextScope()
+    {
+        UnbindContext(ctx_);
+    }
+
+private:
+    std::lock_guard<std::recursive_mutex> lock_;
+    SE_Context                           *ctx_;
+};
+
 extern "C"
 {
     SE_DLL_API int SE_AddPath(const char *path)
     {
+        LOCK_INSTANCE();
+
         SE_Env::Inst().AddPath(path);
         return 0;
     }
 
     SE_DLL_API void SE_ClearPaths()
     {
+        LOCK_INSTANCE();
+
         SE_Env::Inst().ClearPaths();
     }
 
     SE_DLL_API void SE_SetLogFilePath(const char *logFilePath)
     {
+        LOCK_INSTANCE();
+
         SE_Env::Inst().SetLogFilePath(logFilePath);
     }
 
     SE_DLL_API void SE_SetDatFilePath(const char *datFilePath)
     {
+        LOCK_INSTANCE();
+
         SE_Env::Inst().SetDatFilePath(datFilePath);
     }
 
     SE_DLL_API unsigned int SE_GetSeed()
     {
+        LOCK_INSTANCE();
+
         return SE_Env::Inst().GetRand().GetSeed();
     }
 
     SE_DLL_API void SE_SetSeed(unsigned int seed)
     {
+        LOCK_INSTANCE();
+
         SE_Env::Inst().GetRand().SetSeed(seed);
     }
 
     SE_DLL_API int SE_SetOption(const char *name)
     {
+        LOCK_INSTANCE();
+
         return SE_Env::Inst().GetOptions().SetOptionValue(name, "");
     }
 
     SE_DLL_API int SE_SetOptionValue(const char *name, const char *value)
     {
+        LOCK_INSTANCE();
+
         return SE_Env::Inst().GetOptions().SetOptionValue(name, value);
     }
 
     SE_DLL_API int SE_SetParameterDistribution(const char *filename)
     {
+        LOCK_INSTANCE();
+
         return OSCParameterDistribution::Inst().Load(filename);
     }
 
     SE_DLL_API void SE_ResetParameterDistribution()
     {
+        LOCK_INSTANCE();
+
         OSCParameterDistribution::Inst().Reset();
     }
 
     SE_DLL_API int SE_GetNumberOfPermutations()
     {
+        LOCK_INSTANCE();
+
         return static_cast<int>(OSCParameterDistribution::Inst().GetNumPermutations());
     }
 
     SE_DLL_API int SE_SelectPermutation(int index)
     {
+        LOCK_INSTANCE();
+
         return OSCParameterDistribution::Inst().SetRequestedIndex(static_cast<unsigned int>(index));
     }
 
     SE_DLL_API int SE_GetPermutationIndex()
     {
+        LOCK_INSTANCE();
+
         return OSCParameterDistribution::Inst().GetIndex();
     }
 
     SE_DLL_API void SE_SetWindowPosAndSize(int x, int y, int w, int h)
     {
+        LOCK_INSTANCE();
+
         winDim = {x, y, w, h};
     }
 
     SE_DLL_API int SE_SetOSITolerances(double maxLongitudinalDistance, double maxLateralDeviation)
     {
+        LOCK_INSTANCE();
+
         SE_Env::Inst().SetOSIMaxLongitudinalDistance(maxLongitudinalDistance);
         SE_Env::Inst().SetOSIMaxLateralDeviation(maxLateralDeviation);
         return 0;
@@ -549,6 +678,8 @@ extern "C"
 
     SE_DLL_API int SE_InitWithArgs(int argc, const char *argv[])
     {
+        LOCK_INSTANCE();
+
         resetScenario();
 
         if (argv && !strncmp(argv[0], "--", 2))
@@ -614,6 +745,8 @@ extern "C"
 
     SE_DLL_API int SE_InitWithString(const char *oscAsXMLString, int disable_ctrls, int use_viewer, int threads, int record)
     {
+        LOCK_INSTANCE();
+
 #ifndef _USE_OSG
         if (use_viewer)
         {
@@ -639,11 +772,15 @@ extern "C"
 
     SE_DLL_API void SE_RegisterParameterDeclarationCallback(void (*fnPtr)(void *), void *user_data)
     {
+        LOCK_INSTANCE();
+
         RegisterParameterDeclarationCallback(fnPtr, user_data);
     }
 
     SE_DLL_API int SE_Init(const char *oscFilename, int disable_ctrls, int use_viewer, int threads, int record)
     {
+        LOCK_INSTANCE();
+
 #ifndef _USE_OSG
         if (use_viewer)
         {
@@ -678,6 +815,8 @@ extern "C"
 
     SE_DLL_API int SE_GetQuitFlag()
     {
+        LOCK_INSTANCE();
+
         int quit_flag = -1;
 
         if (player != nullptr)
@@ -697,6 +836,8 @@ extern "C"
 
     SE_DLL_API int SE_GetPauseFlag()
     {
+        LOCK_INSTANCE();
+
         int pause_flag = -1;
 
         if (player != nullptr)
@@ -716,6 +857,8 @@ extern "C"
 
     SE_DLL_API const char *SE_GetODRFilename()
     {
+        LOCK_INSTANCE();
+
         static std::string returnString;
         if (player == nullptr)
         {
@@ -727,6 +870,8 @@ extern "C"
 
     SE_DLL_API const char *SE_GetSceneGraphFilename()
     {
+        LOCK_INSTANCE();
+
         static std::string returnString;
 
         if (player == nullptr)
@@ -740,6 +885,8 @@ extern "C"
 
     SE_DLL_API int SE_GetNumberOfParameters()
     {
+        LOCK_INSTANCE();
+
         if (player == nullptr)
         {
             return -1;
@@ -750,6 +897,8 @@ extern "C"
 
     SE_DLL_API const char *SE_GetParameterName(int index, int *type)
     {
+        LOCK_INSTANCE();
+
         static std::string returnString;
 
         if (player == nullptr)
@@ -764,6 +913,8 @@ extern "C"
 
     SE_DLL_API int SE_GetNumberOfVariables()
     {
+        LOCK_INSTANCE();
+
         if (player == nullptr)
         {
             return -1;
@@ -774,6 +925,8 @@ extern "C"
 
     SE_DLL_API const char *SE_GetVariableName(int index, int *type)
     {
+        LOCK_INSTANCE();
+
         static std::string returnString;
 
         if (player == nullptr)
@@ -788,6 +941,8 @@ extern "C"
 
     SE_DLL_API int SE_GetNumberOfProperties(int index)
     {
+        LOCK_INSTANCE();
+
         if (player != nullptr && index >= 0 && index < player->scenarioGateway->getNumberOfObjects())
         {
             return player->GetNumberOfProperties(index);
@@ -798,6 +953,8 @@ extern "C"
 
     SE_DLL_API const char *SE_GetObjectPropertyName(int index, int propertyIndex)
     {
+        LOCK_INSTANCE();
+
         if (player != nullptr && index >= 0 && index < player->scenarioGateway->getNumberOfObjects())
         {
             int number = player->GetNumberOfProperties(index);
@@ -812,6 +969,8 @@ extern "C"
 
     SE_DLL_API const char *SE_GetObjectPropertyValue(int index, const char *objectPropertyName)
     {
+        LOCK_INSTANCE();
+
         if (player != nullptr && index >= 0 && index < player->scenarioGateway->getNumberOfObjects())
         {
             for (int i = 0; i < player->GetNumberOfProperties(index); i++)
@@ -828,106 +987,148 @@ extern "C"
 
     SE_DLL_API int SE_SetParameter(SE_Parameter parameter)
     {
+        LOCK_INSTANCE();
+
         return ScenarioReader::parameters.setParameterValue(parameter.name, parameter.value);
     }
 
     SE_DLL_API int SE_GetParameter(SE_Parameter *parameter)
     {
+        LOCK_INSTANCE();
+
         return ScenarioReader::parameters.getParameterValue(parameter->name, parameter->value);
     }
 
     SE_DLL_API int SE_GetParameterInt(const char *parameterName, int *value)
     {
+        LOCK_INSTANCE();
+
         return ScenarioReader::parameters.getParameterValueInt(parameterName, *value);
     }
 
     SE_DLL_API int SE_GetParameterDouble(const char *parameterName, double *value)
     {
+        LOCK_INSTANCE();
+
         return ScenarioReader::parameters.getParameterValueDouble(parameterName, *value);
     }
 
     SE_DLL_API int SE_GetParameterString(const char *parameterName, const char **value)
     {
+        LOCK_INSTANCE();
+
         return ScenarioReader::parameters.getParameterValueString(parameterName, *value);
     }
 
     SE_DLL_API int SE_GetParameterBool(const char *parameterName, bool *value)
     {
+        LOCK_INSTANCE();
+
         return ScenarioReader::parameters.getParameterValueBool(parameterName, *value);
     }
 
     SE_DLL_API int SE_SetParameterInt(const char *parameterName, int value)
     {
+        LOCK_INSTANCE();
+
         return ScenarioReader::parameters.setParameterValue(parameterName, value);
     }
 
     SE_DLL_API int SE_SetParameterDouble(const char *parameterName, double value)
     {
+        LOCK_INSTANCE();
+
         return ScenarioReader::parameters.setParameterValue(parameterName, value);
     }
 
     SE_DLL_API int SE_SetParameterString(const char *parameterName, const char *value)
     {
+        LOCK_INSTANCE();
+
         return ScenarioReader::parameters.setParameterValue(parameterName, value);
     }
 
     SE_DLL_API int SE_SetParameterBool(const char *parameterName, bool value)
     {
+        LOCK_INSTANCE();
+
         return ScenarioReader::parameters.setParameterValue(parameterName, value);
     }
 
     SE_DLL_API int SE_SetVariable(SE_Variable variable)
     {
+        LOCK_INSTANCE();
+
         return ScenarioReader::variables.setParameterValue(variable.name, variable.value);
     }
 
     SE_DLL_API int SE_GetVariable(SE_Variable *variable)
     {
+        LOCK_INSTANCE();
+
         return ScenarioReader::variables.getParameterValue(variable->name, variable->value);
     }
 
     SE_DLL_API int SE_GetVariableInt(const char *variableName, int *value)
     {
+        LOCK_INSTANCE();
+
         return ScenarioReader::variables.getParameterValueInt(variableName, *value);
     }
 
     SE_DLL_API int SE_GetVariableDouble(const char *variableName, double *value)
     {
+        LOCK_INSTANCE();
+
         return ScenarioReader::variables.getParameterValueDouble(variableName, *value);
     }
 
     SE_DLL_API int SE_GetVariableString(const char *variableName, const char **value)
     {
+        LOCK_INSTANCE();
+
         return ScenarioReader::variables.getParameterValueString(variableName, *value);
     }
 
     SE_DLL_API int SE_GetVariableBool(const char *variableName, bool *value)
     {
+        LOCK_INSTANCE();
+
         return ScenarioReader::variables.getParameterValueBool(variableName, *value);
     }
 
     SE_DLL_API int SE_SetVariableInt(const char *variableName, int value)
     {
+        LOCK_INSTANCE();
+
         return ScenarioReader::variables.setParameterValue(variableName, value);
     }
 
     SE_DLL_API int SE_SetVariableDouble(const char *variableName, double value)
     {
+        LOCK_INSTANCE();
+
         return ScenarioReader::variables.setParameterValue(variableName, value);
     }
 
     SE_DLL_API int SE_SetVariableString(const char *variableName, const char *value)
     {
+        LOCK_INSTANCE();
+
         return ScenarioReader::variables.setParameterValue(variableName, value);
     }
 
     SE_DLL_API int SE_SetVariableBool(const char *variableName, bool value)
     {
+        LOCK_INSTANCE();
+
         return ScenarioReader::variables.setParameterValue(variableName, value);
     }
 
     SE_DLL_API void *SE_GetODRManager()
     {
+        LOCK_INSTANCE();
+
         if (player != nullptr)
         {
             return (void *)player->GetODRManager();
@@ -938,22 +1139,84 @@ extern "C"
 
     SE_DLL_API void SE_Close()
     {
+        LOCK_INSTANCE();
+
         resetScenario();
         RegisterParameterDeclarationCallback(nullptr, nullptr);
     }
 
     SE_DLL_API void SE_LogToConsole(bool mode)
     {
+        LOCK_INSTANCE();
+
         logToConsole = mode;
     }
 
     SE_DLL_API void SE_CollisionDetection(bool mode)
     {
+        LOCK_INSTANCE();
+
         SE_Env::Inst().SetCollisionDetection(mode);
     }
 
+    SE_DLL_API int SE_GetPerfCounters(SE_PerfCounters *counters)
+    {
+        LOCK_INSTANCE();
+
+        static_assert(SE_PERF_N_PHASES == static_cast<int>(SE_Profiler::Phase::N_PHASES), "SE_PERF_N_PHASES not in sync with profiler");
+
+        if (counters == nullptr)
+        {
+            return -1;
+        }
+
+        counters->frames                  = static_cast<unsigned long long>(SE_Profiler::GetCounter(SE_Profiler::Counter::FRAMES));
+        counters->entities                = static_cast<unsigned long long>(SE_Profiler::GetCounter(SE_Profiler::Counter::ENTITIES));
+        counters->xyz2trackpos_calls      = static_cast<unsigned long long>(SE_Profiler::GetCounter(SE_Profiler::Counter::XYZ2TRACKPOS));
+        counters->xyz2trackpos_full_scans = static_cast<unsigned long long>(SE_Profiler::GetCounter(SE_Profiler::Counter::XYZ2TRACKPOS_FULL_SCAN));
+        counters->delta_calls             = static_cast<unsigned long long>(SE_Profiler::GetCounter(SE_Profiler::Counter::DELTA));
+        counters->road_path_expansions    = static_cast<unsigned long long>(SE_Profiler::GetCounter(SE_Profiler::Counter::ROAD_PATH_EXPANSIONS));
+        counters->collision_pair_tests    = static_cast<unsigned long long>(SE_Profiler::GetCounter(SE_Profiler::Counter::COLLISION_PAIR_TESTS));
+        counters->osi_bytes_serialized    = static_cast<unsigned long long>(SE_Profiler::GetCounter(SE_Profiler::Counter::OSI_BYTES_SERIALIZED));
+        counters->osi_bytes_sent          = static_cast<unsigned long long>(SE_Profiler::GetCounter(SE_Profiler::Counter::OSI_BYTES_SENT));
+        counters->log_lines               = static_cast<unsigned long long>(SE_Profiler::GetCounter(SE_Profiler::Counter::LOG_LINES));
+
+        for (int i = 0; i < SE_PERF_N_PHASES; i++)
+        {
+            counters->phase_time[i] = 1E-9 * static_cast<double>(SE_Profiler::GetPhaseTime(static_cast<SE_Profiler::Phase>(i)));
+        }
+
+        return 0;
+    }
+
+    SE_DLL_API void SE_PerfPhaseTiming(bool mode)
+    {
+        SE_Profiler::SetPhaseTiming(mode);
+    }
+
+    SE_DLL_API void SE_ResetPerfCounters()
+    {
+        LOCK_INSTANCE();
+
+        SE_Profiler::ResetCounters();
+    }
+
+    SE_DLL_API const char *SE_GetPerfPhaseName(int index)
+    {
+        LOCK_INSTANCE();
+
+        if (index < 0 || index >= SE_PERF_N_PHASES)
+        {
+            return nullptr;
+        }
+
+        return SE_Profiler::PhaseName(static_cast<SE_Profiler::Phase>(index));
+    }
+
     SE_DLL_API int SE_Step()
     {
+        LOCK_INSTANCE();
+
         if (player != nullptr)
         {
             player->SetFixedTimestep(-1.0);
@@ -968,6 +1231,8 @@ extern "C"
 
     SE_DLL_API int SE_StepDT(float dt)
     {
+        LOCK_INSTANCE();
+
         if (player != nullptr)
         {
             player->SetFixedTimestep(dt);
@@ -982,6 +1247,8 @@ extern "C"
 
     SE_DLL_API float SE_GetSimulationTime()
     {
+        LOCK_INSTANCE();
+
         if (player == nullptr)
         {
             return 0.0f;
@@ -992,6 +1259,8 @@ extern "C"
 
     SE_DLL_API double SE_GetSimulationTimeDouble()
     {
+        LOCK_INSTANCE();
+
         if (player == nullptr)
         {
             return 0.0;
@@ -1002,6 +1271,8 @@ extern "C"
 
     SE_DLL_API float SE_GetSimTimeStep()
     {
+        LOCK_INSTANCE();
+
         if (player == nullptr)
         {
             return 0.0f;
@@ -1012,6 +1283,8 @@ extern "C"
 
     SE_DLL_API void SE_SetObjectPositionMode(int object_id, SE_PositionModeType type, int mode)
     {
+        LOCK_INSTANCE();
+
         if (player != nullptr)
         {
             Object *obj = nullptr;
@@ -1026,6 +1299,8 @@ extern "C"
 
     SE_DLL_API void SE_SetObjectPositionModeDefault(int object_id, SE_PositionModeType type)
     {
+        LOCK_INSTANCE();
+
         if (player != nullptr)
         {
             Object *obj = nullptr;
@@ -1040,6 +1315,8 @@ extern "C"
 
     SE_DLL_API int SE_AddObject(const char *object_name, int object_type, int object_category, int object_role, int model_id)
     {
+        LOCK_INSTANCE();
+
         SE_OSCBoundingBox bb = {{0.0, 0.0, 0.0}, {0.0, 0.0, 0.0}};
         return SE_AddObjectWithBoundingBox(object_name,
                                            object_type,
@@ -1058,6 +1335,8 @@ extern "C"
                                                SE_OSCBoundingBox bounding_box,
                                                int               scale_mode)
     {
+        LOCK_INSTANCE();
+
         int object_id = -1;
 
         // Add missing object
@@ -1146,6 +1425,8 @@ extern "C"
 
     SE_DLL_API int SE_DeleteObject(int object_id)
     {
+        LOCK_INSTANCE();
+
         Object *obj = nullptr;
         if (getObjectById(object_id, obj) == -1)
         {
@@ -1171,6 +1452,8 @@ extern "C"
 
     SE_DLL_API int SE_ReportObjectPos(int object_id, float timestamp, float x, float y, float z, float h, float p, float r)
     {
+        LOCK_INSTANCE();
+
         Object *obj = nullptr;
         if (getObjectById(object_id, obj) == -1)
         {
@@ -1184,6 +1467,8 @@ extern "C"
 
     SE_DLL_API int SE_ReportObjectPosMode(int object_id, float timestamp, float x, float y, float z, float h, float p, float r, int mode)
     {
+        LOCK_INSTANCE();
+
         Object *obj = nullptr;
         if (getObjectById(object_id, obj) == -1)
         {
@@ -1197,6 +1482,8 @@ extern "C"
 
     SE_DLL_API int SE_ReportObjectPosXYH(int object_id, float timestamp, float x, float y, float h)
     {
+        LOCK_INSTANCE();
+
         Object *obj = nullptr;
         if (getObjectById(object_id, obj) == -1)
         {
@@ -1210,6 +1497,8 @@ extern "C"
 
     SE_DLL_API int SE_ReportObjectRoadPos(int object_id, float timestamp, id_t roadId, int laneId, float laneOffset, float s)
     {
+        LOCK_INSTANCE();
+
         Object *obj = nullptr;
         if (getObjectById(object_id, obj) == -1)
         {
@@ -1223,6 +1512,8 @@ extern "C"
 
     SE_DLL_API int SE_ReportObjectSpeed(int object_id, float speed)
     {
+        LOCK_INSTANCE();
+
         Object *obj = nullptr;
         if (getObjectById(object_id, obj) == -1)
         {
@@ -1235,6 +1526,8 @@ extern "C"
 
     SE_DLL_API int SE_ReportObjectLateralPosition(int object_id, float t)
     {
+        LOCK_INSTANCE();
+
         Object *obj = nullptr;
         if (getObjectById(object_id, obj) == -1)
         {
@@ -1265,6 +1558,8 @@ extern "C"
 
     SE_DLL_API int SE_ReportObjectLateralLanePosition(int object_id, int laneId, float laneOffset)
     {
+        LOCK_INSTANCE();
+
         (void)laneId;
         Object *obj = nullptr;
         if (getObjectById(object_id, obj) == -1)
@@ -1297,6 +1592,8 @@ extern "C"
 
     SE_DLL_API int SE_ReportObjectVel(int object_id, float timestamp, float x_vel, float y_vel, float z_vel)
     {
+        LOCK_INSTANCE();
+
         (void)timestamp;
         Object *obj = nullptr;
         if (getObjectById(object_id, obj) == -1)
@@ -1312,6 +1609,8 @@ extern "C"
 
     SE_DLL_API int SE_ReportObjectAngularVel(int object_id, float timestamp, float h_rate, float p_rate, float r_rate)
     {
+        LOCK_INSTANCE();
+
         (void)timestamp;
         Object *obj = nullptr;
         if (getObjectById(object_id, obj) == -1)
@@ -1327,6 +1626,8 @@ extern "C"
 
     SE_DLL_API int SE_ReportObjectAcc(int object_id, float timestamp, float x_acc, float y_acc, float z_acc)
     {
+        LOCK_INSTANCE();
+
         (void)timestamp;
         Object *obj = nullptr;
         if (getObjectById(object_id, obj) == -1)
@@ -1342,6 +1643,8 @@ extern "C"
 
     SE_DLL_API int SE_ReportObjectAngularAcc(int object_id, float timestamp, float h_acc, float p_acc, float r_acc)
     {
+        LOCK_INSTANCE();
+
         (void)timestamp;
         Object *obj = nullptr;
         if (getObjectById(object_id, obj) == -1)
@@ -1357,6 +1660,8 @@ extern "C"
 
     SE_DLL_API int SE_ReportObjectWheelStatus(int object_id, float rotation, float angle)
     {
+        LOCK_INSTANCE();
+
         Object *obj = nullptr;
         if (getObjectById(object_id, obj) == -1)
         {
@@ -1370,6 +1675,8 @@ extern "C"
 
     SE_DLL_API int SE_SetSnapLaneTypes(int object_id, int laneTypes)
     {
+        LOCK_INSTANCE();
+
         Object *obj = nullptr;
         if (getObjectById(object_id, obj) == -1)
         {
@@ -1390,6 +1697,8 @@ extern "C"
 
     SE_DLL_API int SE_SetLockOnLane(int object_id, bool mode)
     {
+        LOCK_INSTANCE();
+
         Object *obj = nullptr;
         if (getObjectById(object_id, obj) == -1)
         {
@@ -1410,6 +1719,8 @@ extern "C"
 
     SE_DLL_API int SE_GetNumberOfObjects()
     {
+        LOCK_INSTANCE();
+
         if (player == nullptr)
         {
             return -1;
@@ -1420,6 +1731,8 @@ extern "C"
 
     SE_DLL_API int SE_GetId(int index)
     {
+        LOCK_INSTANCE();
+
         if (player == nullptr || index < 0 || index >= player->scenarioGateway->getNumberOfObjects())
         {
             return -1;
@@ -1430,6 +1743,8 @@ extern "C"
 
     SE_DLL_API int SE_GetIdByName(const char *name)
     {
+        LOCK_INSTANCE();
+
         if (player == nullptr)
         {
             return -1;
@@ -1448,24 +1763,133 @@ extern "C"
 
     SE_DLL_API int SE_GetObjectState(int object_id, SE_ScenarioObjectState *state)
     {
-        scenarioengine::ObjectState obj_state;
+        LOCK_INSTANCE();
 
         if (player == nullptr)
         {
             return -1;
         }
 
-        if (player->scenarioGateway->getObjectStateById(object_id, obj_state) != -1)
+        // read directly from the gateway, no need for a temporary copy of the state
+        scenarioengine::ObjectState *obj_state = player->scenarioGateway->getObjectStatePtrById(object_id);
+        if (obj_state != nullptr)
         {
-            copyStateFromScenarioGateway(state, &obj_state.state_);
+            copyStateFromScenarioGateway(state, &obj_state->state_);
             return 0;
         }
 
         return -1;
     }
 
+    SE_DLL_API int SE_GetAllObjectStates(SE_ScenarioObjectState *buf, int capacity)
+    {
+        LOCK_INSTANCE();
+
+        if (player == nullptr || buf == nullptr)
+        {
+            return -1;
+        }
+
+        int n = MIN(capacity, player->scenarioGateway->getNumberOfObjects());
+        for (int i = 0; i < n; i++)
+        {
+            copyStateFromScenarioGateway(&buf[i], &player->scenarioGateway->getObjectStatePtrByIdx(i)->state_);
+        }
+
+        return MAX(n, 0);
+    }
+
+    SE_DLL_API int SE_GetAllObjectStatesSoA(SE_ObjectStatesSoA *states, int capacity)
+    {
+        LOCK_INSTANCE();
+
+        if (player == nullptr || states == nullptr)
+        {
+            return -1;
+        }
+
+        int n = MIN(capacity, player->scenarioGateway->getNumberOfObjects());
+        for (int i = 0; i < n; i++)
+        {
+            ObjectStateStruct *gw_state = &player->scenarioGateway->getObjectStatePtrByIdx(i)->state_;
+
+            if (states->id)
+            {
+                states->id[i] = gw_state->info.id;
+            }
+            if (states->x)
+            {
+                states->x[i] = static_cast<float>(gw_state->pos.GetX());
+            }
+            if (states->y)
+            {
+                states->y[i] = static_cast<float>(gw_state->pos.GetY());
+            }
+            if (states->z)
+            {
+                states->z[i] = static_cast<float>(gw_state->pos.GetZ());
+            }
+            if (states->h)
+            {
+                states->h[i] = static_cast<float>(gw_state->pos.GetH());
+            }
+            if (states->p)
+            {
+                states->p[i] = static_cast<float>(gw_state->pos.GetP());
+            }
+            if (states->r)
+            {
+                states->r[i] = static_cast<float>(gw_state->pos.GetR());
+            }
+            if (states->speed)
+            {
+                states->speed[i] = static_cast<float>(gw_state->info.speed);
+            }
+            if (states->roadId)
+            {
+                states->roadId[i] = gw_state->pos.GetTrackId();
+            }
+            if (states->laneId)
+            {
+                states->laneId[i] = gw_state->pos.GetLaneId();
+            }
+            if (states->s)
+            {
+                states->s[i] = static_cast<float>(gw_state->pos.GetS());
+            }
+            if (states->t)
+            {
+                states->t[i] = static_cast<float>(gw_state->pos.GetT());
+            }
+        }
+
+        return MAX(n, 0);
+    }
+
+    SE_DLL_API const SE_ScenarioObjectState *SE_GetObjectStateTable(int *number_of_objects)
+    {
+        LOCK_INSTANCE();
+
+        int n = 0;
+
+        const ObjectStateTableEntry *table = nullptr;
+        if (player != nullptr)
+        {
+            table = player->scenarioGateway->GetStateTable(n);
+        }
+
+        if (number_of_objects != nullptr)
+        {
+            *number_of_objects = n;
+        }
+
+        return reinterpret_cast<const SE_ScenarioObjectState *>(table);
+    }
+
     SE_DLL_API int SE_GetObjectRouteStatus(int object_id)
     {
+        LOCK_INSTANCE();
+
         if (player != nullptr)
         {
             Object *obj = player->scenarioEngine->entities_.GetObjectById(object_id);
@@ -1488,6 +1912,8 @@ extern "C"
 
     SE_DLL_API int SE_GetObjectInLaneType(int object_id)
     {
+        LOCK_INSTANCE();
+
         Object *obj = nullptr;
         if (getObjectById(object_id, obj) == -1)
         {
@@ -1499,6 +1925,8 @@ extern "C"
 
     SE_DLL_API int SE_GetOverrideActionStatus(int object_id, SE_OverrideActionList *list)
     {
+        LOCK_INSTANCE();
+
         Object *obj = nullptr;
         if (getObjectById(object_id, obj) == -1)
         {
@@ -1511,6 +1939,8 @@ extern "C"
 
     SE_DLL_API const char *SE_GetObjectTypeName(int object_id)
     {
+        LOCK_INSTANCE();
+
         static std::string returnString;
         Object            *obj = nullptr;
         if (getObjectById(object_id, obj) == -1)
@@ -1524,6 +1954,8 @@ extern "C"
 
     SE_DLL_API const char *SE_GetObjectName(int object_id)
     {
+        LOCK_INSTANCE();
+
         static std::string returnString;
         Object            *obj = nullptr;
         if (getObjectById(object_id, obj) == -1)
@@ -1536,6 +1968,8 @@ extern "C"
 
     SE_DLL_API const char *SE_GetObjectModelFileName(int object_id)
     {
+        LOCK_INSTANCE();
+
         static std::string returnString;
         Object            *obj = nullptr;
         if (getObjectById(object_id, obj) == -1)
@@ -1548,6 +1982,8 @@ extern "C"
 
     SE_DLL_API int SE_OpenOSISocket(const char *ipaddr)
     {
+        LOCK_INSTANCE();
+
 #ifdef _USE_OSI
         if (player == nullptr)
         {
@@ -1564,6 +2000,8 @@ extern "C"
 
     SE_DLL_API const char *SE_GetOSIGroundTruth(int *size)
     {
+        LOCK_INSTANCE();
+
 #ifdef _USE_OSI
         if (player != nullptr)
         {
@@ -1579,6 +2017,8 @@ extern "C"
 
     SE_DLL_API const char *SE_GetOSIGroundTruthRaw()
     {
+        LOCK_INSTANCE();
+
 #ifdef _USE_OSI
         if (player != nullptr)
         {
@@ -1591,6 +2031,8 @@ extern "C"
 
     SE_DLL_API const char *SE_GetOSITrafficCommandRaw()
     {
+        LOCK_INSTANCE();
+
 #ifdef _USE_OSI
         if (player != nullptr)
         {
@@ -1603,6 +2045,8 @@ extern "C"
 
     SE_DLL_API int SE_SetOSISensorDataRaw(const char *sensordata)
     {
+        LOCK_INSTANCE();
+
         (void)sensordata;
 
 #ifdef _USE_OSI
@@ -1630,6 +2074,8 @@ extern "C"
 
     SE_DLL_API const char *SE_GetOSIRoadLane(int *size, int object_id)
     {
+        LOCK_INSTANCE();
+
 #ifdef _USE_OSI
         if (player != nullptr)
         {
@@ -1647,6 +2093,8 @@ extern "C"
 
     SE_DLL_API const char *SE_GetOSILaneBoundary(int *size, int global_id)
     {
+        LOCK_INSTANCE();
+
 #ifdef _USE_OSI
         if (player != nullptr)
         {
@@ -1664,6 +2112,8 @@ extern "C"
 
     SE_DLL_API void SE_GetOSILaneBoundaryIds(int object_id, SE_LaneBoundaryId *ids)
     {
+        LOCK_INSTANCE();
+
 #ifdef _USE_OSI
         if (player != nullptr)
         {
@@ -1687,6 +2137,8 @@ extern "C"
 
     SE_DLL_API int SE_ClearOSIGroundTruth()
     {
+        LOCK_INSTANCE();
+
 #ifdef _USE_OSI
         if (player != nullptr)
         {
@@ -1699,6 +2151,8 @@ extern "C"
 
     SE_DLL_API int SE_UpdateOSIGroundTruth()
     {
+        LOCK_INSTANCE();
+
 #ifdef _USE_OSI
         if (player != nullptr)
         {
@@ -1711,6 +2165,8 @@ extern "C"
 
     SE_DLL_API int SE_UpdateOSIStaticGroundTruth()
     {
+        LOCK_INSTANCE();
+
 #ifdef _USE_OSI
         if (player != nullptr)
         {
@@ -1723,6 +2179,8 @@ extern "C"
 
     SE_DLL_API int SE_UpdateOSIDynamicGroundTruth(bool reportGhost)
     {
+        LOCK_INSTANCE();
+
 #ifdef _USE_OSI
         if (player != nullptr)
         {
@@ -1737,6 +2195,8 @@ extern "C"
 
     SE_DLL_API int SE_UpdateOSITrafficCommand()
     {
+        LOCK_INSTANCE();
+
 #ifdef _USE_OSI
         if (player != nullptr)
         {
@@ -1749,6 +2209,8 @@ extern "C"
 
     SE_DLL_API const char *SE_GetOSISensorDataRaw()
     {
+        LOCK_INSTANCE();
+
 #ifdef _USE_OSI
         if (player != nullptr)
         {
@@ -1761,6 +2223,8 @@ extern "C"
 
     SE_DLL_API int SE_OSISetTimeStamp(unsigned long long int nanoseconds)
     {
+        LOCK_INSTANCE();
+
 #ifdef _USE_OSI
         if (player != nullptr)
         {
@@ -1776,16 +2240,22 @@ extern "C"
 
     SE_DLL_API void SE_LogMessage(const char *message)
     {
+        LOCK_INSTANCE();
+
         LOG(message);
     }
 
     SE_DLL_API void SE_CloseLogFile()
     {
+        LOCK_INSTANCE();
+
         Logger::Inst().CloseLogFile();
     }
 
     SE_DLL_API int SE_ObjectHasGhost(int object_id)
     {
+        LOCK_INSTANCE();
+
         Object *obj = nullptr;
         if (getObjectById(object_id, obj) == -1)
         {
@@ -1797,6 +2267,8 @@ extern "C"
 
     SE_DLL_API int SE_GetObjectGhostId(int object_id)
     {
+        LOCK_INSTANCE();
+
         Object *obj = nullptr;
         if (getObjectById(object_id, obj) == -1)
         {
@@ -1814,6 +2286,8 @@ extern "C"
 
     SE_DLL_API int SE_GetObjectGhostState(int object_id, SE_ScenarioObjectState *state)
     {
+        LOCK_INSTANCE();
+
         Object *ghost = nullptr;
         Object *obj   = nullptr;
         if (getObjectById(object_id, obj) == -1)
@@ -1825,9 +2299,12 @@ extern "C"
 
         if (ghost)
         {
-            scenarioengine::ObjectState obj_state;
-            player->scenarioGateway->getObjectStateById(ghost->id_, obj_state);
-            copyStateFromScenarioGateway(state, &obj_state.state_);
+            scenarioengine::ObjectState *obj_state = player->scenarioGateway->getObjectStatePtrById(ghost->id_);
+            if (obj_state == nullptr)
+            {
+                return -1;
+            }
+            copyStateFromScenarioGateway(state, &obj_state->state_);
         }
         else
         {
@@ -1839,6 +2316,8 @@ extern "C"
 
     SE_DLL_API int SE_GetSpeedUnit()
     {
+        LOCK_INSTANCE();
+
         roadmanager::OpenDrive *odr = roadmanager::Position::GetOpenDrive();
         if (odr != nullptr)
         {
@@ -1850,6 +2329,8 @@ extern "C"
 
     SE_DLL_API int SE_GetObjectNumberOfCollisions(int object_id)
     {
+        LOCK_INSTANCE();
+
         Object *obj = nullptr;
 
         if (getObjectById(object_id, obj) == -1)
@@ -1862,6 +2343,8 @@ extern "C"
 
     SE_DLL_API int SE_GetObjectCollision(int object_id, int index)
     {
+        LOCK_INSTANCE();
+
         Object *obj = nullptr;
 
         if (getObjectById(object_id, obj) == -1)
@@ -1879,6 +2362,8 @@ extern "C"
 
     SE_DLL_API float SE_GetObjectAcceleration(int object_id)
     {
+        LOCK_INSTANCE();
+
         if (player != nullptr)
         {
             Object *obj = player->scenarioEngine->entities_.GetObjectById(object_id);
@@ -1893,6 +2378,8 @@ extern "C"
 
     SE_DLL_API int SE_GetObjectAccelerationGlobalXYZ(int object_id, float *acc_x, float *acc_y, float *acc_z)
     {
+        LOCK_INSTANCE();
+
         if (player != nullptr)
         {
             Object *obj = player->scenarioEngine->entities_.GetObjectById(object_id);
@@ -1919,6 +2406,8 @@ extern "C"
 
     SE_DLL_API int SE_GetObjectAccelerationLocalLatLong(int object_id, float *acc_lat, float *acc_long)
     {
+        LOCK_INSTANCE();
+
         if (player != nullptr)
         {
             Object *obj = player->scenarioEngine->entities_.GetObjectById(object_id);
@@ -1941,6 +2430,8 @@ extern "C"
 
     SE_DLL_API int SE_GetObjectNumberOfWheels(int object_id)
     {
+        LOCK_INSTANCE();
+
         scenarioengine::ObjectState gw_obj_state;
 
         if (player->scenarioGateway->getObjectStateById(object_id, gw_obj_state) != -1)
@@ -1953,6 +2444,8 @@ extern "C"
 
     SE_DLL_API int SE_GetObjectWheelData(int object_id, int wheel_index, SE_WheelData *wheeldata)
     {
+        LOCK_INSTANCE();
+
         scenarioengine::ObjectState gw_obj_state;
 
         if (player->scenarioGateway->getObjectStateById(object_id, gw_obj_state) != -1)
@@ -1994,6 +2487,8 @@ extern "C"
 
     SE_DLL_API int SE_GetObjectStates(int *nObjects, SE_ScenarioObjectState *state)
     {
+        LOCK_INSTANCE();
+
         int i;
         *nObjects = 0;
 
@@ -2013,6 +2508,8 @@ extern "C"
 
     SE_DLL_API int SE_AddObjectSensor(int object_id, float x, float y, float z, float h, float rangeNear, float rangeFar, float fovH, int maxObj)
     {
+        LOCK_INSTANCE();
+
         Object *obj = nullptr;
 
         if (player == nullptr)
@@ -2030,6 +2527,8 @@ extern "C"
 
     SE_DLL_API int SE_GetNumberOfObjectSensors()
     {
+        LOCK_INSTANCE();
+
         if (player == nullptr)
         {
             return -1;
@@ -2040,6 +2539,8 @@ extern "C"
 
     SE_DLL_API int SE_ViewSensorData(int object_id)
     {
+        LOCK_INSTANCE();
+
         Object *obj = nullptr;
         if (getObjectById(object_id, obj) == -1)
         {
@@ -2054,6 +2555,8 @@ extern "C"
 
     SE_DLL_API void SE_DisableOSIFile()
     {
+        LOCK_INSTANCE();
+
         SE_Env::Inst().DisableOSIFile();
 
         if (player != nullptr)
@@ -2064,6 +2567,8 @@ extern "C"
 
     SE_DLL_API void SE_EnableOSIFile(const char *filename)
     {
+        LOCK_INSTANCE();
+
         SE_Env::Inst().EnableOSIFile(filename == nullptr ? "" : filename);
 
         if (player != nullptr)
@@ -2074,6 +2579,8 @@ extern "C"
 
     SE_DLL_API void SE_FlushOSIFile()
     {
+        LOCK_INSTANCE();
+
 #ifdef _USE_OSI
         if (player != nullptr && player->osiReporter != nullptr)
         {
@@ -2084,6 +2591,8 @@ extern "C"
 
     SE_DLL_API int SE_FetchSensorObjectList(int sensor_id, int *list)
     {
+        LOCK_INSTANCE();
+
         if (player != nullptr)
         {
             if (sensor_id < 0 || sensor_id >= static_cast<int>(player->sensor.size()))
@@ -2109,6 +2618,8 @@ extern "C"
                                             int          lookAheadMode,
                                             bool         inRoadDrivingDirection)
     {
+        LOCK_INSTANCE();
+
         Object *obj = nullptr;
         if (getObjectById(object_id, obj) == -1)
         {
@@ -2131,6 +2642,8 @@ extern "C"
 
     SE_DLL_API int SE_GetRoadInfoAlongGhostTrail(int object_id, float lookahead_distance, SE_RoadInfo *data, float *speed_ghost, float *timestamp)
     {
+        LOCK_INSTANCE();
+
         Object *obj = nullptr;
         if (getObjectById(object_id, obj) == -1)
         {
@@ -2147,6 +2660,8 @@ extern "C"
 
     SE_DLL_API int SE_GetRoadInfoGhostTrailTime(int object_id, float time, SE_RoadInfo *data, float *speed_ghost)
     {
+        LOCK_INSTANCE();
+
         Object *obj = nullptr;
         if (getObjectById(object_id, obj) == -1)
         {
@@ -2163,6 +2678,8 @@ extern "C"
 
     SE_DLL_API int SE_GetDistanceToObject(int object_a_id, int object_b_id, bool free_space, SE_PositionDiff *pos_diff)
     {
+        LOCK_INSTANCE();
+
         bool obj_found = false;
 
         Object *obj_a = nullptr;
@@ -2216,6 +2733,8 @@ extern "C"
 
     SE_DLL_API void SE_RegisterObjectCallback(int object_id, void (*fnPtr)(SE_ScenarioObjectState *, void *), void *user_data)
     {
+        LOCK_INSTANCE();
+
         SE_ObjCallback cb;
         cb.id   = object_id;
         cb.func = fnPtr;
@@ -2225,16 +2744,22 @@ extern "C"
 
     SE_DLL_API void SE_RegisterConditionCallback(void (*fnPtr)(const char *name, double timestamp))
     {
+        LOCK_INSTANCE();
+
         OSCCondition::conditionCallback = fnPtr;
     }
 
     SE_DLL_API void SE_RegisterStoryBoardElementStateChangeCallback(void (*fnPtr)(const char *name, int type, int state, const char *full_path))
     {
+        LOCK_INSTANCE();
+
         StoryBoardElement::stateChangeCallback = fnPtr;
     }
 
     SE_DLL_API int SE_GetNumberOfRoadSigns(id_t road_id)
     {
+        LOCK_INSTANCE();
+
         if (player != nullptr)
         {
             roadmanager::Road *road = player->odr_manager->GetRoadById(road_id);
@@ -2248,6 +2773,8 @@ extern "C"
 
     SE_DLL_API int SE_GetRoadSign(id_t road_id, int index, SE_RoadSign *road_sign)
     {
+        LOCK_INSTANCE();
+
         static std::string returnString;
 
         if (player != nullptr)
@@ -2289,6 +2816,8 @@ extern "C"
 
     SE_DLL_API int SE_GetNumberOfRoadSignValidityRecords(id_t road_id, int index)
     {
+        LOCK_INSTANCE();
+
         if (player != nullptr)
         {
             roadmanager::Road *road = player->odr_manager->GetRoadById(road_id);
@@ -2304,6 +2833,8 @@ extern "C"
 
     SE_DLL_API int SE_GetRoadSignValidityRecord(id_t road_id, int signIndex, int validityIndex, SE_RoadObjValidity *validity)
     {
+        LOCK_INSTANCE();
+
         if (player != nullptr)
         {
             roadmanager::Road *road = player->odr_manager->GetRoadById(road_id);
@@ -2324,6 +2855,8 @@ extern "C"
 
     SE_DLL_API const char *SE_GetRoadIdString(id_t road_id)
     {
+        LOCK_INSTANCE();
+
         if (player != nullptr)
         {
             roadmanager::Road *road = player->odr_manager->GetRoadById(road_id);
@@ -2338,6 +2871,8 @@ extern "C"
 
     SE_DLL_API id_t SE_GetRoadIdFromString(const char *road_id_str)
     {
+        LOCK_INSTANCE();
+
         if (player != nullptr)
         {
             roadmanager::Road *road = player->odr_manager->GetRoadByIdStr(road_id_str);
@@ -2352,6 +2887,8 @@ extern "C"
 
     SE_DLL_API const char *SE_GetJunctionIdString(id_t junction_id)
     {
+        LOCK_INSTANCE();
+
         if (player != nullptr)
         {
             roadmanager::Junction *junction = player->odr_manager->GetJunctionById(junction_id);
@@ -2366,6 +2903,8 @@ extern "C"
 
     SE_DLL_API id_t SE_GetJunctionIdFromString(const char *junction_id_str)
     {
+        LOCK_INSTANCE();
+
         if (player != nullptr)
         {
             roadmanager::Junction *junction = player->odr_manager->GetJunctionByIdStr(junction_id_str);
@@ -2380,6 +2919,8 @@ extern "C"
 
     SE_DLL_API void SE_ViewerShowFeature(int featureType, bool enable)
     {
+        LOCK_INSTANCE();
+
 #ifdef _USE_OSG
         if (player != nullptr && player->viewer_)
         {
@@ -2394,12 +2935,16 @@ extern "C"
     // Simple vehicle
     SE_DLL_API void *SE_SimpleVehicleCreate(float x, float y, float h, float length, float speed)
     {
+        LOCK_INSTANCE();
+
         vehicle::Vehicle *v = new vehicle::Vehicle(x, y, h, length, speed);
         return (void *)v;
     }
 
     SE_DLL_API void SE_SimpleVehicleDelete(void *handleSimpleVehicle)
     {
+        LOCK_INSTANCE();
+
         if (handleSimpleVehicle)
         {
             delete ((vehicle::Vehicle *)handleSimpleVehicle);
@@ -2409,6 +2954,8 @@ extern "C"
 
     SE_DLL_API void SE_SimpleVehicleControlBinary(void *handleSimpleVehicle, double dt, int throttle, int steering)
     {
+        LOCK_INSTANCE();
+
         if (handleSimpleVehicle == 0)
         {
             return;
@@ -2419,6 +2966,8 @@ extern "C"
 
     SE_DLL_API void SE_SimpleVehicleControlAnalog(void *handleSimpleVehicle, double dt, double throttle, double steering)
     {
+        LOCK_INSTANCE();
+
         if (handleSimpleVehicle == 0)
         {
             return;
@@ -2429,6 +2978,8 @@ extern "C"
 
     SE_DLL_API void SE_SimpleVehicleSetSpeed(void *handleSimpleVehicle, float speed)
     {
+        LOCK_INSTANCE();
+
         if (handleSimpleVehicle == 0)
         {
             return;
@@ -2439,6 +2990,8 @@ extern "C"
 
     SE_DLL_API void SE_SimpleVehicleSetThrottleDisabled(void *handleSimpleVehicle, bool disabled)
     {
+        LOCK_INSTANCE();
+
         if (handleSimpleVehicle == 0)
         {
             return;
@@ -2449,6 +3002,8 @@ extern "C"
 
     SE_DLL_API void SE_SimpleVehicleSetSteeringDisabled(void *handleSimpleVehicle, bool disabled)
     {
+        LOCK_INSTANCE();
+
         if (handleSimpleVehicle == 0)
         {
             return;
@@ -2459,6 +3014,8 @@ extern "C"
 
     SE_DLL_API void SE_SimpleVehicleControlTarget(void *handleSimpleVehicle, double dt, double target_speed, double heading_to_target)
     {
+        LOCK_INSTANCE();
+
         if (handleSimpleVehicle == 0)
         {
             return;
@@ -2469,6 +3026,8 @@ extern "C"
 
     SE_DLL_API void SE_SimpleVehicleSetMaxSpeed(void *handleSimpleVehicle, float speed)
     {
+        LOCK_INSTANCE();
+
         if (handleSimpleVehicle == 0)
         {
             return;
@@ -2478,6 +3037,8 @@ extern "C"
 
     SE_DLL_API void SE_SimpleVehicleSetMaxAcceleration(void *handleSimpleVehicle, float maxAcceleration)
     {
+        LOCK_INSTANCE();
+
         if (handleSimpleVehicle == 0)
         {
             return;
@@ -2487,6 +3048,8 @@ extern "C"
 
     SE_DLL_API void SE_SimpleVehicleSetMaxDeceleration(void *handleSimpleVehicle, float maxDeceleration)
     {
+        LOCK_INSTANCE();
+
         if (handleSimpleVehicle == 0)
         {
             return;
@@ -2496,6 +3059,8 @@ extern "C"
 
     SE_DLL_API void SE_SimpleVehicleSetEngineBrakeFactor(void *handleSimpleVehicle, float engineBrakeFactor)
     {
+        LOCK_INSTANCE();
+
         if (handleSimpleVehicle == 0)
         {
             return;
@@ -2505,6 +3070,8 @@ extern "C"
 
     SE_DLL_API void SE_SimpleVehicleSteeringScale(void *handleSimpleVehicle, float steeringScale)
     {
+        LOCK_INSTANCE();
+
         if (handleSimpleVehicle == 0)
         {
             return;
@@ -2514,6 +3081,8 @@ extern "C"
 
     SE_DLL_API void SE_SimpleVehicleSteeringReturnFactor(void *handleSimpleVehicle, float steeringReturnFactor)
     {
+        LOCK_INSTANCE();
+
         if (handleSimpleVehicle == 0)
         {
             return;
@@ -2523,6 +3092,8 @@ extern "C"
 
     SE_DLL_API void SE_SimpleVehicleSteeringRate(void *handleSimpleVehicle, float steeringRate)
     {
+        LOCK_INSTANCE();
+
         if (handleSimpleVehicle == 0)
         {
             return;
@@ -2532,6 +3103,8 @@ extern "C"
 
     SE_DLL_API void SE_SimpleVehicleGetState(void *handleSimpleVehicle, SE_SimpleVehicleState *state)
     {
+        LOCK_INSTANCE();
+
         if (handleSimpleVehicle == 0)
         {
             return;
@@ -2548,6 +3121,8 @@ extern "C"
 
     SE_DLL_API int SE_SaveImagesToRAM(bool state)
     {
+        LOCK_INSTANCE();
+
 #ifdef _USE_OSG
         // prioritize setting via player, else update environment variable for next run
         if (player)
@@ -2567,6 +3142,8 @@ extern "C"
 
     SE_DLL_API int SE_SaveImagesToFile(int nrOfFrames)
     {
+        LOCK_INSTANCE();
+
 #ifdef _USE_OSG
         if (player)
         {
@@ -2580,6 +3157,8 @@ extern "C"
 
     SE_DLL_API int SE_FetchImage(SE_Image *img)
     {
+        LOCK_INSTANCE();
+
 #ifdef _USE_OSG
         if (player)
         {
@@ -2604,6 +3183,8 @@ extern "C"
 
     SE_DLL_API void SE_RegisterImageCallback(void (*fnPtr)(SE_Image *, void *), void *user_data)
     {
+        LOCK_INSTANCE();
+
 #ifdef _USE_OSG
         RegisterImageCallback((viewer::ImageCallbackFunc)fnPtr, user_data);  // ensure SE_Image and OffScrImage is compatible
 #else
@@ -2615,17 +3196,23 @@ extern "C"
     SE_DLL_API int
     SE_WritePPMImage(const char *filename, int width, int height, const unsigned char *data, int pixelSize, int pixelFormat, bool upsidedown)
     {
+        LOCK_INSTANCE();
+
         return SE_WritePPM(filename, width, height, data, pixelSize, pixelFormat, upsidedown);
     }
 
     SE_DLL_API int
     SE_WriteTGAImage(const char *filename, int width, int height, const unsigned char *data, int pixelSize, int pixelFormat, bool upsidedown)
     {
+        LOCK_INSTANCE();
+
         return SE_WriteTGA(filename, width, height, data, pixelSize, pixelFormat, upsidedown);
     }
 
     SE_DLL_API int SE_AddCustomCamera(double x, double y, double z, double h, double p)
     {
+        LOCK_INSTANCE();
+
 #ifdef _USE_OSG
         if (player)
         {
@@ -2643,6 +3230,8 @@ extern "C"
 
     SE_DLL_API int SE_AddCustomFixedCamera(double x, double y, double z, double h, double p)
     {
+        LOCK_INSTANCE();
+
 #ifdef _USE_OSG
         if (player)
         {
@@ -2660,6 +3249,8 @@ extern "C"
 
     SE_DLL_API int SE_AddCustomAimingCamera(double x, double y, double z)
     {
+        LOCK_INSTANCE();
+
 #ifdef _USE_OSG
         if (player)
         {
@@ -2675,6 +3266,8 @@ extern "C"
 
     SE_DLL_API int SE_AddCustomFixedAimingCamera(double x, double y, double z)
     {
+        LOCK_INSTANCE();
+
 #ifdef _USE_OSG
         if (player)
         {
@@ -2690,6 +3283,8 @@ extern "C"
 
     SE_DLL_API int SE_AddCustomFixedTopCamera(double x, double y, double z, double rot)
     {
+        LOCK_INSTANCE();
+
 #ifdef _USE_OSG
         if (player)
         {
@@ -2706,6 +3301,8 @@ extern "C"
 
     SE_DLL_API int SE_SetCameraMode(int mode)
     {
+        LOCK_INSTANCE();
+
 #ifdef _USE_OSG
         if (player && player->viewer_)
         {
@@ -2720,6 +3317,8 @@ extern "C"
 
     SE_DLL_API int SE_SetCameraObjectFocus(int object_id)
     {
+        LOCK_INSTANCE();
+
 #ifdef _USE_OSG
         if (player && player->viewer_)
         {
@@ -2740,6 +3339,8 @@ extern "C"
 
     SE_DLL_API int SE_GetNumberOfRoutePoints(int object_id)
     {
+        LOCK_INSTANCE();
+
         Object *obj = nullptr;
         if (getObjectById(object_id, obj) == -1)
         {
@@ -2758,6 +3359,8 @@ extern "C"
 
     SE_DLL_API int SE_GetRoutePoint(int object_id, int route_index, SE_RouteInfo *routeinfo)
     {
+        LOCK_INSTANCE();
+
         Object *obj = nullptr;
         if (getObjectById(object_id, obj) == -1)
         {
@@ -2799,6 +3402,8 @@ extern "C"
 
     SE_DLL_API float SE_GetRouteTotalLength(int object_id)
     {
+        LOCK_INSTANCE();
+
         Object *obj = nullptr;
         if (getObjectById(object_id, obj) == -1)
         {
@@ -2815,37 +3420,213 @@ extern "C"
         return 0.0f;
     }
 
-    SE_DLL_API void SE_InjectSpeedAction(SE_SpeedActionStruct *action)
+    SE_DLL_API int SE_InjectSpeedAction(SE_SpeedActionStruct *action)
     {
-        if (player)
+        return InjectAction([action](PlayerServer *server) { return server->InjectSpeedAction(*((SpeedActionStruct *)action)); });
+    }
+
+    SE_DLL_API int SE_InjectLaneChangeAction(SE_LaneChangeActionStruct *action)
+    {
+        return InjectAction([action](PlayerServer *server) { return server->InjectLaneChangeAction(*((LaneChangeActionStruct *)action)); });
+    }
+
+    SE_DLL_API int SE_InjectLaneOffsetAction(SE_LaneOffsetActionStruct *action)
+    {
+        return InjectAction([action](PlayerServer *server) { return server->InjectLaneOffsetAction(*((LaneOffsetActionStruct *)action)); });
+    }
+
+    SE_DLL_API bool SE_InjectedActionOngoing(int action_type)
+    {
+        LOCK_INSTANCE();
+
+        if (player != nullptr)
+        {
+            return player->player_server_->InjectedActionOngoing(action_type);
+        }
+
+        return false;
+    }
+
+    SE_DLL_API SE_Context *SE_CreateContext()
+    {
+        LOCK_INSTANCE();
+
+        SE_Context *ctx = new SE_Context;
+        ctx->env        = SE_Env::Inst();  // inherit paths and settings of the default instance
+        ctx->env.SetRoadNetwork(&ctx->odr);
+        ctx->env.SetLogFilePath("");  // log goes to the logfile of the default instance, if any
+
+        return ctx;
+    }
+
+    SE_DLL_API void SE_DestroyContext(SE_Context *ctx)
+    {
+        if (ctx == nullptr)
         {
-            player->player_server_->InjectSpeedAction(*((SpeedActionStruct *)action));
+            return;
         }
+
+        LOCK_INSTANCE();
+        {
+            ContextScope scope(ctx);
+            resetScenario();
+        }
+        delete ctx;
     }
 
-    SE_DLL_API void SE_InjectLaneChangeAction(SE_LaneChangeActionStruct *action)
+    SE_DLL_API int SE_BeginContext(SE_Context *ctx)
     {
-        if (player)
+        if (ctx == nullptr)
         {
-            player->player_server_->InjectLaneChangeAction(*((LaneChangeActionStruct *)action));
+            return -1;
         }
+
+        instance_mutex.lock();
+        BindContext(ctx);
+
+        return 0;
     }
 
-    SE_DLL_API void SE_InjectLaneOffsetAction(SE_LaneOffsetActionStruct *action)
+    SE_DLL_API void SE_EndContext(SE_Context *ctx)
     {
-        if (player)
+        if (ctx == nullptr)
         {
-            player->player_server_->InjectLaneOffsetAction(*((LaneOffsetActionStruct *)action));
+            return;
         }
+
+        UnbindContext(ctx);
+        instance_mutex.unlock();
     }
 
-    SE_DLL_API bool SE_InjectedActionOngoing(int action_type)
+    SE_DLL_API int SE_InitCtx(SE_Context *ctx, const char *oscFilename, int disable_ctrls, int record)
     {
-        if (player)
+        if (ctx == nullptr)
         {
-            return player->player_server_->InjectedActionOngoing(action_type);
+            return -1;
         }
 
-        return false;
+        ContextScope scope(ctx);
+        return SE_Init(oscFilename, disable_ctrls, 0, 0, record);
+    }
+
+    SE_DLL_API int SE_InitWithArgsCtx(SE_Context *ctx, int argc, const char *argv[])
+    {
+        if (ctx == nullptr)
+        {
+            return -1;
+        }
+
+        ContextScope scope(ctx);
+        return SE_InitWithArgs(argc, argv);
+    }
+
+    SE_DLL_API int SE_StepCtx(SE_Context *ctx)
+    {
+        if (ctx == nullptr)
+        {
+            return -1;
+        }
+
+        ContextScope scope(ctx);
+        return SE_Step();
+    }
+
+    SE_DLL_API int SE_StepDTCtx(SE_Context *ctx, float dt)
+    {
+        if (ctx == nullptr)
+        {
+            return -1;
+        }
+
+        ContextScope scope(ctx);
+        return SE_StepDT(dt);
+    }
+
+    SE_DLL_API int SE_GetQuitFlagCtx(SE_Context *ctx)
+    {
+        if (ctx == nullptr)
+        {
+            return -1;
+        }
+
+        ContextScope scope(ctx);
+        return SE_GetQuitFlag();
+    }
+
+    SE_DLL_API double SE_GetSimulationTimeDoubleCtx(SE_Context *ctx)
+    {
+        if (ctx == nullptr)
+        {
+            return 0.0;
+        }
+
+        ContextScope scope(ctx);
+        return SE_GetSimulationTimeDouble();
+    }
+
+    SE_DLL_API int SE_GetNumberOfObjectsCtx(SE_Context *ctx)
+    {
+        if (ctx == nullptr)
+        {
+            return -1;
+        }
+
+        ContextScope scope(ctx);
+        return SE_GetNumberOfObjects();
+    }
+
+    SE_DLL_API int SE_GetIdCtx(SE_Context *ctx, int index)
+    {
+        if (ctx == nullptr)
+        {
+            return -1;
+        }
+
+        ContextScope scope(ctx);
+        return SE_GetId(index);
+    }
+
+    SE_DLL_API int SE_GetObjectStateCtx(SE_Context *ctx, int object_id, SE_ScenarioObjectState *state)
+    {
+        if (ctx == nullptr)
+        {
+            return -1;
+        }
+
+        ContextScope scope(ctx);
+        return SE_GetObjectState(object_id, state);
+    }
+
+    SE_DLL_API int SE_GetParameterDoubleCtx(SE_Context *ctx, const char *parameterName, double *value)
+    {
+        if (ctx == nullptr)
+        {
+            return -1;
+        }
+
+        ContextScope scope(ctx);
+        return SE_GetParameterDouble(parameterName, value);
+    }
+
+    SE_DLL_API int SE_SetParameterDoubleCtx(SE_Context *ctx, const char *parameterName, double value)
+    {
+        if (ctx == nullptr)
+        {
+            return -1;
+        }
+
+        ContextScope scope(ctx);
+        return SE_SetParameterDouble(parameterName, value);
+    }
+
+    SE_DLL_API int SE_GetVariableDoubleCtx(SE_Context *ctx, const char *variableName, double *value)
+    {
+        if (ctx == nullptr)
+        {
+            return -1;
+        }
+
+        ContextScope scope(ctx);
+        return SE_GetVariableDouble(variableName, value);
     }
 }
@@ -57,6 +57,42 @@ typedef struct
     int   visibilityMask;  // bitmask according to Object::Visibility (1 = Graphics, 2 = Traffic, 4 = Sensors)
 } SE_ScenarioObjectState;
 
+// Object states in structure of arrays layout, see SE_GetAllObjectStatesSoA(). Arrays are provided by the caller, each of
+// at least capacity elements. Set a pointer to NULL to skip that attribute.
+typedef struct
+{
+    int   *id;
+    float *x;
+    float *y;
+    float *z;
+    float *h;
+    float *p;
+    float *r;
+    float *speed;
+    id_t  *roadId;
+    int   *laneId;
+    float *s;
+    float *t;
+} SE_ObjectStatesSoA;
+
+#define SE_PERF_N_PHASES 15  // number of frame phases, see SE_GetPerfPhaseName()
+
+// Performance counters, accumulated since start or SE_ResetPerfCounters(), see SE_GetPerfCounters()
+typedef struct
+{
+    unsigned long long frames;                        // scenario frames
+    unsigned long long entities;                      // number of entities in last frame
+    unsigned long long xyz2trackpos_calls;            // conversions from world to road coordinates
+    unsigned long long xyz2trackpos_full_scans;       // conversions not resolved around last position, searching all roads
+    unsigned long long delta_calls;                   // road network distance calculations between two positions
+    unsigned long long road_path_expansions;          // nodes expanded by road network path searches
+    unsigned long long collision_pair_tests;          // object pairs checked by collision detection
+    unsigned long long osi_bytes_serialized;          // serialized OSI ground truth
+    unsigned long long osi_bytes_sent;                // OSI ground truth sent over UDP
+    unsigned long long log_lines;                     // log entries written to file or callback
+    double             phase_time[SE_PERF_N_PHASES];  // accumulated time per frame phase, in seconds, see SE_PerfPhaseTiming()
+} SE_PerfCounters;
+
 typedef struct
 {
     float x;  // global x coordinate of position
@@ -311,6 +347,8 @@ typedef enum
     SE_UPDATE = 2   // Used by controllers updating the position
 } SE_PositionModeType;
 
+typedef struct SE_Context SE_Context;  // Additional simulation instance, see SE_CreateContext()
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -524,6 +562,33 @@ extern "C"
     */
     SE_DLL_API void SE_CollisionDetection(bool mode);
 
+    /**
+            Get performance counters, e.g. number of frames and time spent in each frame phase. Counters are always
+            on and shared by all esmini instances in the process. Phase times are only accumulated while phase timing
+            is on, see SE_PerfPhaseTiming().
+            @param counters Struct to be filled in
+            @return 0 if successful, -1 if not
+    */
+    SE_DLL_API int SE_GetPerfCounters(SE_PerfCounters *counters);
+
+    /**
+            Enable or disable accumulation of time per frame phase, off by default to keep frame overhead minimal
+            @param mode true=enable, false=disable
+    */
+    SE_DLL_API void SE_PerfPhaseTiming(bool mode);
+
+    /**
+            Set all performance counters to zero
+    */
+    SE_DLL_API void SE_ResetPerfCounters();
+
+    /**
+            Get name of a frame phase, as in SE_PerfCounters::phase_time
+            @param index Index of phase, 0 .. SE_PERF_N_PHASES-1
+            @return Name of phase, e.g. "controllers", NULL if index out of range
+    */
+    SE_DLL_API const char *SE_GetPerfPhaseName(int index);
+
     /**
             Get simulation time in seconds - float (32 bit) precision
     */
@@ -998,6 +1063,32 @@ extern "C"
     */
     SE_DLL_API int SE_GetObjectState(int object_id, SE_ScenarioObjectState *state);
 
+    /**
+            Get the state of all objects in one call, in same order as SE_GetId()
+            @param buf Array of SE_ScenarioObjectState structs to be filled in
+            @param capacity Number of elements in buf
+            @return Number of states written, i.e. min(capacity, number of objects), -1 on error
+    */
+    SE_DLL_API int SE_GetAllObjectStates(SE_ScenarioObjectState *buf, int capacity);
+
+    /**
+            Get main attributes of all objects in one call, in same order as SE_GetId(), into separate arrays
+            @param states Struct of destination arrays, NULL pointers are skipped
+            @param capacity Number of elements in each array
+            @return Number of states written, i.e. min(capacity, number of objects), -1 on error
+    */
+    SE_DLL_API int SE_GetAllObjectStatesSoA(SE_ObjectStatesSoA *states, int capacity);
+
+    /**
+            Get a read-only table of all object states, in same order as SE_GetId(). The table is owned by the scenario
+            gateway and refreshed at end of each step from the first call on, hence this function does not copy any
+            states. Objects reported or removed between steps are reflected from next step. The pointer is valid until
+            the number of objects changes, SE_Close() or next scenario is loaded.
+            @param number_of_objects Number of elements in the returned table
+            @return Pointer to first object state, NULL if no objects or error
+    */
+    SE_DLL_API const SE_ScenarioObjectState *SE_GetObjectStateTable(int *number_of_objects);
+
     /**
             Get the object route status
             @param object_id Id of the object
@@ -1721,29 +1812,111 @@ extern "C"
     SE_DLL_API float SE_GetRouteTotalLength(int object_id);
 
     /**
-            Inject a speed action
+            Inject a speed action. Thread safe and never waits for an ongoing step, the action is queued and added to the
+            scenario at start of next step. Targets the default instance, or the context bound by SE_BeginContext().
             @param action Struct including needed info for the action, see SE_SpeedActionStruct definition
+            @return 0 if successful, -1 if no scenario is loaded or the queue is full
     */
-    SE_DLL_API void SE_InjectSpeedAction(SE_SpeedActionStruct *action);
+    SE_DLL_API int SE_InjectSpeedAction(SE_SpeedActionStruct *action);
 
     /**
-            Inject a lane change action
+            Inject a lane change action. Thread safe and never waits for an ongoing step, the action is queued and added to the
+            scenario at start of next step. Targets the default instance, or the context bound by SE_BeginContext().
             @param action Struct including needed info for the action, see SE_LaneChangeActionStruct definition
+            @return 0 if successful, -1 if no scenario is loaded or the queue is full
     */
-    SE_DLL_API void SE_InjectLaneChangeAction(SE_LaneChangeActionStruct *action);
+    SE_DLL_API int SE_InjectLaneChangeAction(SE_LaneChangeActionStruct *action);
 
     /**
-            Inject a lane offset action
+            Inject a lane offset action. Thread safe and never waits for an ongoing step, the action is queued and added to the
+            scenario at start of next step. Targets the default instance, or the context bound by SE_BeginContext().
             @param action Struct including needed info for the action, see SE_LaneOffsetActionStruct definition
+            @return 0 if successful, -1 if no scenario is loaded or the queue is full
     */
-    SE_DLL_API void SE_InjectLaneOffsetAction(SE_LaneOffsetActionStruct *action);
+    SE_DLL_API int SE_InjectLaneOffsetAction(SE_LaneOffsetActionStruct *action);
 
     /**
-            Check whether any injected action is ongoing
+            Check whether any injected action is ongoing. Unlike the SE_Inject* functions it waits for any ongoing step.
             @param action_type Type of action, see esmini Action.hpp::ActionType enum. Set to -1 to check for any action.
     */
     SE_DLL_API bool SE_InjectedActionOngoing(int action_type);
 
+    /**
+            Create an additional simulation instance (context), besides the default one (serialized multi-instance).
+            A context has its own scenario, road network, parameters, variables, callbacks and environment. The
+            environment is initially a copy of the default one, e.g. paths and options, except that no logfile is created.
+            While a context is used its state is swapped into the global state of the library, hence contexts are not
+            independent simulators. They keep several scenarios loaded in one process, e.g. to avoid startup cost
+            between runs, but do not step in parallel: All SE_* calls, on any instance and also when no context
+            exists, are serialized by one process wide lock. Instances can be used from any thread, but only one
+            executes at a time. Callbacks run with the lock held, so they must not wait for other threads calling SE_*
+            functions. For parallel simulations use one process per instance.
+            Shared by all instances: Logger and CSV logger, parameter distribution, controller and OSI statics.
+            Limitations: No viewer, each context loads its own road network, and OSI as well as parameter distributions
+            are only supported by the default instance.
+            @return Handle of the context, NULL on failure
+    */
+    SE_DLL_API SE_Context *SE_CreateContext();
+
+    /**
+            Close any scenario of the context, and release it
+            @param ctx Handle of the context
+    */
+    SE_DLL_API void SE_DestroyContext(SE_Context *ctx);
+
+    /**
+            Make all following SE_* calls from the calling thread operate on given context, until SE_EndContext().
+            SE_* calls from other threads wait meanwhile. Use for functions that lack a context (Ctx) variant.
+            @param ctx Handle of the context
+            @return 0 if successful, -1 if not
+    */
+    SE_DLL_API int SE_BeginContext(SE_Context *ctx);
+
+    /**
+            Return to the default instance, see SE_BeginContext()
+            @param ctx Handle of the context
+    */
+    SE_DLL_API void SE_EndContext(SE_Context *ctx);
+
+    /**
+            Initialize the scenario engine of a context, see SE_Init(). Always without viewer.
+            @param ctx Handle of the context
+            @param oscFilename Path to the OpenSCENARIO file
+            @param disable_ctrls 1=Any controller will be disabled 0=Controllers applied according to OSC file
+            @param record Create recording for later playback 0=no recording 1=recording
+            @return 0 if successful, -1 if not
+    */
+    SE_DLL_API int SE_InitCtx(SE_Context *ctx, const char *oscFilename, int disable_ctrls, int record);
+
+    /**
+            Initialize the scenario engine of a context, see SE_InitWithArgs()
+            @param ctx Handle of the context
+            @return 0 if successful, -1 if not
+    */
+    SE_DLL_API int SE_InitWithArgsCtx(SE_Context *ctx, int argc, const char *argv[]);
+
+    /**
+            Step the simulation of a context, see SE_Step() and SE_StepDT()
+            @param ctx Handle of the context
+            @return 0 if successful, -1 if not
+    */
+    SE_DLL_API int SE_StepCtx(SE_Context *ctx);
+    SE_DLL_API int SE_StepDTCtx(SE_Context *ctx, float dt);
+
+    /**
+            Context variants of SE_GetQuitFlag(), SE_GetSimulationTimeDouble(), SE_GetNumberOfObjects(), SE_GetId(),
+            SE_GetObjectState(), SE_GetParameterDouble(), SE_SetParameterDouble() and SE_GetVariableDouble()
+            @param ctx Handle of the context
+    */
+    SE_DLL_API int    SE_GetQuitFlagCtx(SE_Context *ctx);
+    SE_DLL_API double SE_GetSimulationTimeDoubleCtx(SE_Context *ctx);
+    SE_DLL_API int    SE_GetNumberOfObjectsCtx(SE_Context *ctx);
+    SE_DLL_API int    SE_GetIdCtx(SE_Context *ctx, int index);
+    SE_DLL_API int    SE_GetObjectStateCtx(SE_Context *ctx, int object_id, SE_ScenarioObjectState *state);
+    SE_DLL_API int    SE_GetParameterDoubleCtx(SE_Context *ctx, const char *parameterName, double *value);
+    SE_DLL_API int    SE_SetParameterDoubleCtx(SE_Context *ctx, const char *parameterName, double value);
+    SE_DLL_API int    SE_GetVariableDoubleCtx(SE_Context *ctx, const char *variableName, double *value);
+
 #ifdef __cplusplus
 }
 #endif
@@ -27,12 +27,16 @@
 #include <arpa/inet.h>
 #include <netdb.h>  /* Needed for getaddrinfo() and freeaddrinfo() */
 #include <unistd.h> /* Needed for close() */
+#include <sys/resource.h>
 #else
 #include <winsock2.h>
 #include <Ws2tcpip.h>
+#include <windows.h>
+#include <psapi.h>
 #endif
 
 #include "CommonMini.hpp"
+#include "Profiler.hpp"
 
 // #define DEBUG_TRACE
 
@@ -734,7 +738,7 @@ double SE_getSimTimeStep(__int64& time_stamp, double min_time_step, double max_t
         }
         else if (dt < min_time_step)  // avoid CPU rush, sleep for a while
         {
-            SE_sleep(static_cast<unsigned int>(static_cast<int>(min_time_step - dt) * 1000));
+            SE_sleep(static_cast<unsigned int>((min_time_step - dt) * 1000));
             now = SE_getSystemTime();
             dt  = static_cast<double>(now - time_stamp) * 0.001;
         }
@@ -744,6 +748,29 @@ double SE_getSimTimeStep(__int64& time_stamp, double min_time_step, double max_t
     return dt;
 }
 
+unsigned long long SE_getPeakMemoryUsage()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    {
+        return static_cast<unsigned long long>(counters.PeakWorkingSetSize);
+    }
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+    {
+        return 0;
+    }
+#ifdef __APPLE__
+    return static_cast<unsigned long long>(usage.ru_maxrss);  // bytes
+#else
+    return static_cast<unsigned long long>(usage.ru_maxrss) * 1024;  // kilobytes
+#endif
+#endif
+}
+
 std::vector<std::string> SplitString(const std::string& s, char separator)
 {
     std::vector<std::string> output;
@@ -1279,6 +1306,11 @@ void Logger::Log(bool quit, bool trace, char const* file, char const* func, int
         callback_(complete_entry);
     }
 
+    if (file_.is_open() || callback_)
+    {
+        SE_Profiler::Count(SE_Profiler::Counter::LOG_LINES);
+    }
+
     va_end(args);
 
     mutex_.Unlock();
@@ -1359,12 +1391,31 @@ void Logger::LogVersion()
         callback_(message);
 }
 
+static thread_local SE_Env* bound_env_ = nullptr;
+
 SE_Env& SE_Env::Inst()
 {
+    if (bound_env_ != nullptr)
+    {
+        return *bound_env_;
+    }
+
     static SE_Env instance_;
     return instance_;
 }
 
+SE_Env* SE_Env::Bind(SE_Env* env)
+{
+    SE_Env* previous = bound_env_;
+    bound_env_       = env;
+    return previous;
+}
+
+SE_Env* SE_Env::Bound()
+{
+    return bound_env_;
+}
+
 void SE_Env::SetLogFilePath(std::string logFilePath)
 {
     logFilePath_ = logFilePath;
@@ -93,6 +93,9 @@ __int64 SE_getSystemTime();
 void    SE_sleep(unsigned int msec);
 double  SE_getSimTimeStep(__int64& time_stamp, double min_time_step, double max_time_step);
 
+// Peak resident memory (RSS) of the process so far, in bytes (0 if not available)
+unsigned long long SE_getPeakMemoryUsage();
+
 // Useful types
 enum class KeyType  // copy key enums from OSG GUIEventAdapter
 {
@@ -1172,6 +1175,11 @@ private:
     std::mt19937 gen_;
 };
 
+namespace roadmanager
+{
+    class OpenDrive;
+}
+
 class SE_Env
 {
 public:
@@ -1185,12 +1193,27 @@ public:
           collisionDetection_(false),
           saveImagesToRAM_(false),
           ghost_mode_(GhostMode::NORMAL),
-          ghost_headstart_(0.0)
+          ghost_headstart_(0.0),
+          road_network_(nullptr)
     {
     }
 
     static SE_Env& Inst();
 
+    /**
+        Make Inst() return given environment for calls from the calling thread, e.g. one per simulation instance.
+        SE_TaskPool and SE_Pipeline run the work of the calling thread with the same environment bound.
+        @param env Environment to use, or nullptr for the default one
+        @return Previously bound environment, nullptr if none
+    */
+    static SE_Env* Bind(SE_Env* env);
+
+    /**
+        Environment bound to the calling thread, see Bind()
+        @return Bound environment, nullptr if none (i.e. default)
+    */
+    static SE_Env* Bound();
+
     void SetOSIMaxLongitudinalDistance(double maxLongitudinalDistance)
     {
         osiMaxLongitudinalDistance_ = maxLongitudinalDistance;
@@ -1332,6 +1355,20 @@ public:
         return opt;
     };
 
+    /**
+        Road network of a bound environment, returned by roadmanager::Position::GetOpenDrive()
+        @param road_network Road network, nullptr for the default one
+    */
+    void SetRoadNetwork(roadmanager::OpenDrive* road_network)
+    {
+        road_network_ = road_network;
+    }
+
+    roadmanager::OpenDrive* GetRoadNetwork()
+    {
+        return road_network_;
+    }
+
 private:
     std::vector<std::string>   paths_;
     double                     osiMaxLongitudinalDistance_;
@@ -1348,6 +1385,7 @@ private:
     GhostMode                  ghost_mode_;
     double                     ghost_headstart_;
     SE_Options                 opt;
+    roadmanager::OpenDrive*    road_network_;
 };
 
 /**
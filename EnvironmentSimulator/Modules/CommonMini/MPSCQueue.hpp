@@ -0,0 +1,135 @@
+/*
+ * esmini - Environment Simulator Minimalistic
+ * https://github.com/esmini/esmini
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) partners of Simulation Scenarios
+ * https://sites.google.com/view/simulationscenarios
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+
+/**
+    Bounded lock-free queue for many producer threads and one consumer thread, e.g. network and API threads handing
+    over messages to the simulation thread. All elements are allocated up front, Push() and Pop() only copy values.
+    A producer never waits for the consumer, if the queue is full the element is rejected. Each slot has a sequence
+    number telling whether it is free for writing or holds a completed element for reading (D. Vyukov's bounded queue).
+*/
+template <class T>
+class SE_MPSCQueue
+{
+public:
+    /**
+        @param capacity Max number of elements, rounded up to nearest power of two
+    */
+    explicit SE_MPSCQueue(size_t capacity) : dequeue_pos_(0), enqueue_pos_(0), n_rejected_(0)
+    {
+        size_t size = 2;
+        while (size < capacity)
+        {
+            size *= 2;
+        }
+        mask_ = size - 1;
+        cells_.reset(new Cell[size]);
+        for (size_t i = 0; i < size; i++)
+        {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+        Producer, any thread: Add element to the queue
+        @return true if successful, false if queue is full
+    */
+    bool Push(const T& value)
+    {
+        Cell*  cell;
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+
+        while (true)
+        {
+            cell          = &cells_[pos & mask_];
+            size_t   seq  = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+
+            if (diff == 0)
+            {
+                // slot free, try to claim it
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                // slot still holds an element not yet consumed, one lap behind
+                n_rejected_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            else
+            {
+                // another producer claimed the slot, retry with updated position
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->value = value;
+        cell->sequence.store(pos + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    /**
+        Consumer, single thread only: Get oldest element
+        @return true if an element was returned, false if queue is empty
+    */
+    bool Pop(T& value)
+    {
+        Cell*    cell = &cells_[dequeue_pos_ & mask_];
+        size_t   seq  = cell->sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(dequeue_pos_ + 1);
+
+        if (diff < 0)
+        {
+            // empty, or the producer of next element has not yet finished writing it
+            return false;
+        }
+
+        value = cell->value;
+        cell->sequence.store(dequeue_pos_ + mask_ + 1, std::memory_order_release);
+        dequeue_pos_++;
+
+        return true;
+    }
+
+    size_t GetCapacity()
+    {
+        return mask_ + 1;
+    }
+
+    unsigned int GetNumberOfRejected()  // elements not added since queue was full
+    {
+        return n_rejected_.load(std::memory_order_relaxed);
+    }
+
+private:
+    typedef struct
+    {
+        std::atomic<size_t> sequence;
+        T                   value;
+    } Cell;
+
+    std::unique_ptr<Cell[]>         cells_;
+    size_t                          mask_;
+    alignas(64) size_t              dequeue_pos_;  // owned by consumer, separate cache line from producers
+    alignas(64) std::atomic<size_t> enqueue_pos_;  // shared by producers
+    std::atomic<unsigned int>       n_rejected_;
+};
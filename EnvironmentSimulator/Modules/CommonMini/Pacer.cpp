@@ -0,0 +1,124 @@
+/*
+ * esmini - Environment Simulator Minimalistic
+ * https://github.com/esmini/esmini
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) partners of Simulation Scenarios
+ * https://sites.google.com/view/simulationscenarios
+ */
+
+#include <thread>
+#include <errno.h>
+#ifdef __linux__
+#include <time.h>
+#endif
+
+#include "Pacer.hpp"
+#include "CommonMini.hpp"
+
+using namespace std::chrono;
+
+SE_Pacer::SE_Pacer()
+{
+    Stop();
+}
+
+void SE_Pacer::Start(double period, double rt_factor, double spin_time)
+{
+    Stop();
+
+    if (period < SMALL_NUMBER || rt_factor < SMALL_NUMBER)
+    {
+        return;
+    }
+
+    period_    = duration_cast<nanoseconds>(duration<double>(period / rt_factor));
+    spin_time_ = duration_cast<nanoseconds>(duration<double>(MAX(0.0, spin_time)));
+}
+
+void SE_Pacer::Stop()
+{
+    period_      = nanoseconds(0);
+    spin_time_   = nanoseconds(0);
+    started_     = false;
+    n_steps_     = 0;
+    n_waits_     = 0;
+    n_overruns_  = 0;
+    jitter_sum_  = 0.0;
+    jitter_max_  = 0.0;
+    overrun_max_ = 0.0;
+}
+
+void SE_Pacer::SleepUntil(steady_clock::time_point t)
+{
+#ifdef __linux__
+    // steady_clock is based on CLOCK_MONOTONIC
+    nanoseconds     ns   = t.time_since_epoch();
+    seconds         secs = duration_cast<seconds>(ns);
+    struct timespec ts;
+    ts.tv_sec  = secs.count();
+    ts.tv_nsec = (ns - secs).count();
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR)
+    {
+    }
+#else
+    std::this_thread::sleep_until(t);
+#endif
+}
+
+void SE_Pacer::Wait()
+{
+    if (!IsActive())
+    {
+        return;
+    }
+
+    steady_clock::time_point now = steady_clock::now();
+    n_steps_++;
+
+    if (!started_)
+    {
+        started_ = true;
+        next_    = now + period_;
+        return;
+    }
+
+    if (now > next_)
+    {
+        // step took longer than the period, start over from now
+        n_overruns_++;
+        overrun_max_ = MAX(overrun_max_, duration<double>(now - next_).count());
+        next_        = now + period_;
+        return;
+    }
+
+    if (next_ - now > spin_time_)
+    {
+        SleepUntil(next_ - spin_time_);
+    }
+
+    while ((now = steady_clock::now()) < next_)
+    {
+        // spin the last part, sleep wake-up latency is often larger than the precision needed
+    }
+
+    double jitter = duration<double>(now - next_).count();
+    jitter_sum_ += jitter;
+    jitter_max_ = MAX(jitter_max_, jitter);
+    n_waits_++;
+
+    next_ += period_;
+}
+
+void SE_Pacer::LogStatistics()
+{
+    LOG("Pacing: %u steps, %u overruns (max %.3f ms), wake-up jitter mean %.1f us max %.1f us",
+        n_steps_,
+        n_overruns_,
+        1e3 * GetMaxOverrun(),
+        1e6 * GetMeanJitter(),
+        1e6 * GetMaxJitter());
+}
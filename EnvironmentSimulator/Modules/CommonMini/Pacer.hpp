@@ -0,0 +1,87 @@
+/*
+ * esmini - Environment Simulator Minimalistic
+ * https://github.com/esmini/esmini
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) partners of Simulation Scenarios
+ * https://sites.google.com/view/simulationscenarios
+ */
+
+#pragma once
+
+#include <chrono>
+
+#define SE_PACER_DEFAULT_SPIN_TIME 0.0002  // seconds of busy-waiting before each deadline
+
+/**
+    Paces a loop to a fixed period in real time, e.g. for hardware-in-the-loop. Deadlines are absolute, based on
+    steady_clock, so that errors do not accumulate. The thread sleeps until shortly before each deadline and then
+    busy-waits the remaining time for precision. If a deadline has already passed (overrun) the schedule is restarted
+    from current time instead of trying to catch up.
+*/
+class SE_Pacer
+{
+public:
+    SE_Pacer();
+
+    /**
+        Start pacing. First call to Wait() returns immediately and defines time zero.
+        @param period Simulation time per step in seconds
+        @param rt_factor Real time factor, e.g. 2.0 = run twice as fast as real time
+        @param spin_time Time in seconds to busy-wait before each deadline, 0 = sleep only
+    */
+    void Start(double period, double rt_factor = 1.0, double spin_time = SE_PACER_DEFAULT_SPIN_TIME);
+    void Stop();
+    bool IsActive()
+    {
+        return period_.count() > 0;
+    }
+
+    /**
+        Wait until start of next period. Returns immediately if not active.
+    */
+    void Wait();
+
+    /**
+        Log number of steps, overruns and wake-up jitter
+    */
+    void LogStatistics();
+
+    unsigned int GetNumberOfSteps()
+    {
+        return n_steps_;
+    }
+    unsigned int GetNumberOfOverruns()
+    {
+        return n_overruns_;
+    }
+    double GetMeanJitter()  // mean deviation from deadline when waking up, in seconds
+    {
+        return n_waits_ > 0 ? jitter_sum_ / n_waits_ : 0.0;
+    }
+    double GetMaxJitter()
+    {
+        return jitter_max_;
+    }
+    double GetMaxOverrun()  // in seconds
+    {
+        return overrun_max_;
+    }
+
+private:
+    void SleepUntil(std::chrono::steady_clock::time_point t);
+
+    std::chrono::nanoseconds              period_;
+    std::chrono::nanoseconds              spin_time_;
+    std::chrono::steady_clock::time_point next_;
+    bool                                  started_;
+    unsigned int                          n_steps_;
+    unsigned int                          n_waits_;
+    unsigned int                          n_overruns_;
+    double                                jitter_sum_;
+    double                                jitter_max_;
+    double                                overrun_max_;
+};
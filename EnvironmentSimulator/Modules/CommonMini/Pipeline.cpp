@@ -0,0 +1,104 @@
+/*
+ * esmini - Environment Simulator Minimalistic
+ * https://github.com/esmini/esmini
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) partners of Simulation Scenarios
+ * https://sites.google.com/view/simulationscenarios
+ */
+
+#include "Pipeline.hpp"
+#include "CommonMini.hpp"
+
+SE_Pipeline::SE_Pipeline() : max_depth_(SE_PIPELINE_DEFAULT_DEPTH), n_in_flight_(0), quit_(false), n_jobs_(0), n_stalls_(0)
+{
+}
+
+SE_Pipeline::~SE_Pipeline()
+{
+    Stop();
+}
+
+void SE_Pipeline::Start(int max_depth)
+{
+    Stop();
+
+    max_depth_ = MAX(1, max_depth);
+    quit_      = false;
+    worker_    = std::thread(&SE_Pipeline::Worker, this);
+}
+
+void SE_Pipeline::Stop()
+{
+    if (!IsActive())
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        quit_ = true;
+    }
+    cv_.notify_all();
+
+    // worker empties the queue before quitting
+    worker_.join();
+}
+
+void SE_Pipeline::Worker()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true)
+    {
+        cv_.wait(lock, [this] { return quit_ || !queue_.empty(); });
+
+        if (queue_.empty())
+        {
+            break;
+        }
+
+        std::function<void()> job = std::move(queue_.front().second);
+        SE_Env*               env = SE_Env::Bind(queue_.front().first);
+        queue_.pop_front();
+        lock.unlock();
+
+        job();
+        SE_Env::Bind(env);
+
+        lock.lock();
+        n_in_flight_--;
+        done_cv_.notify_all();
+    }
+}
+
+void SE_Pipeline::Submit(std::function<void()> job)
+{
+    if (!IsActive())
+    {
+        n_jobs_++;
+        job();
+        return;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (n_in_flight_ >= max_depth_)
+        {
+            n_stalls_++;
+            done_cv_.wait(lock, [this] { return n_in_flight_ < max_depth_; });
+        }
+        queue_.emplace_back(SE_Env::Bound(), std::move(job));
+        n_in_flight_++;
+        n_jobs_++;
+    }
+    cv_.notify_one();
+}
+
+void SE_Pipeline::Flush()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [this] { return n_in_flight_ == 0; });
+}
@@ -0,0 +1,88 @@
+/*
+ * esmini - Environment Simulator Minimalistic
+ * https://github.com/esmini/esmini
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) partners of Simulation Scenarios
+ * https://sites.google.com/view/simulationscenarios
+ */
+
+
+#pragma once
+
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <utility>
+
+class SE_Env;
+
+#define SE_PIPELINE_DEFAULT_DEPTH 4  // default max number of jobs queued or running
+
+/**
+    Runs jobs on one worker thread, strictly in the order they were submitted. Intended for output of a finished frame,
+    e.g. file writing, while the next frame is simulated. Jobs must only use data captured at submission, never live
+    simulation state. Submit() blocks while max depth jobs are in flight, which bounds memory use and latency.
+    When not started, jobs are executed directly in the calling thread. Jobs run with the environment of the submitting
+    thread bound, see SE_Env::Bind().
+*/
+class SE_Pipeline
+{
+public:
+    SE_Pipeline();
+    ~SE_Pipeline();
+
+    /**
+        Start worker thread
+        @param max_depth Max number of jobs queued or running, at least 1
+    */
+    void Start(int max_depth = SE_PIPELINE_DEFAULT_DEPTH);
+
+    /**
+        Finish all submitted jobs, then stop worker thread. Following jobs are executed directly.
+    */
+    void Stop();
+    bool IsActive()
+    {
+        return worker_.joinable();
+    }
+
+    /**
+        Add job to the end of the queue, wait first if max depth is reached
+        @param job Job function, will be executed on worker thread
+    */
+    void Submit(std::function<void()> job);
+
+    /**
+        Wait for all submitted jobs to finish
+    */
+    void Flush();
+
+    unsigned int GetNumberOfJobs()
+    {
+        return n_jobs_;
+    }
+    unsigned int GetNumberOfStalls()  // number of times Submit() had to wait for the worker
+    {
+        return n_stalls_;
+    }
+
+private:
+    void Worker();
+
+    std::thread                                           worker_;
+    std::mutex                                            mutex_;
+    std::condition_variable                               cv_;
+    std::condition_variable                               done_cv_;
+    std::deque<std::pair<SE_Env*, std::function<void()>>> queue_;  // job and environment bound to submitting thread
+    int                                                   max_depth_;
+    int                                                   n_in_flight_;  // queued or running
+    bool                                                  quit_;
+    unsigned int                                          n_jobs_;
+    unsigned int                                          n_stalls_;
+};
@@ -0,0 +1,418 @@
+/*
+ * esmini - Environment Simulator Minimalistic
+ * https://github.com/esmini/esmini
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) partners of Simulation Scenarios
+ * https://sites.google.com/view/simulationscenarios
+ */
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+
+#include "Profiler.hpp"
+#include "CommonMini.hpp"
+
+std::atomic<bool>    SE_Profiler::enabled_(false);
+std::atomic<bool>    SE_Profiler::phase_timing_(false);
+std::atomic<bool>    SE_Profiler::timing_(false);
+std::atomic<int64_t> SE_Profiler::counters_[static_cast<int>(Counter::N_COUNTERS)];
+std::atomic<int64_t> SE_Profiler::phase_time_[static_cast<int>(Phase::N_PHASES)];
+
+static const char* phase_names[] = {"frame",
+                                    "gateway_sync",
+                                    "storyboard",
+                                    "default_controller",
+                                    "controllers",
+                                    "trailers",
+                                    "collision_detection",
+                                    "ground_truth",
+                                    "record",
+                                    "csv_log",
+                                    "sensors",
+                                    "osi",
+                                    "osi_static_gt",
+                                    "osi_dynamic_gt",
+                                    "viewer"};
+
+static_assert(sizeof(phase_names) / sizeof(phase_names[0]) == static_cast<size_t>(SE_Profiler::Phase::N_PHASES), "Missing phase name");
+
+static const char* counter_names[] = {"frames",
+                                      "entities",
+                                      "xyz2trackpos",
+                                      "xyz2trackpos_full_scan",
+                                      "delta",
+                                      "road_path_expansions",
+                                      "collision_pair_tests",
+                                      "osi_bytes_serialized",
+                                      "osi_bytes_sent",
+                                      "log_lines"};
+
+static_assert(sizeof(counter_names) / sizeof(counter_names[0]) == static_cast<size_t>(SE_Profiler::Counter::N_COUNTERS), "Missing counter name");
+
+static int GetThreadIndex()
+{
+    // small sequential thread ids for the trace, in order of first use
+    static std::atomic<int> counter(0);
+    thread_local int        index = ++counter;
+    return index;
+}
+
+static int BucketIndex(int64_t value)
+{
+    // log-linear buckets: exact below PROFILER_SUB_BUCKETS, then PROFILER_SUB_BUCKETS buckets per power of two
+    if (value < PROFILER_SUB_BUCKETS)
+    {
+        return value < 0 ? 0 : static_cast<int>(value);
+    }
+
+    int exponent = 0;
+    for (uint64_t v = static_cast<uint64_t>(value); v > 1; v >>= 1)
+    {
+        exponent++;
+    }
+    int sub = static_cast<int>((value >> (exponent - 3)) & (PROFILER_SUB_BUCKETS - 1));
+
+    return (exponent - 2) * PROFILER_SUB_BUCKETS + sub;
+}
+
+static int64_t BucketMidValue(int index)
+{
+    if (index < PROFILER_SUB_BUCKETS)
+    {
+        return index;
+    }
+
+    int     exponent = index / PROFILER_SUB_BUCKETS + 2;
+    int64_t width    = static_cast<int64_t>(1) << (exponent - 3);
+    int64_t lower    = (PROFILER_SUB_BUCKETS + index % PROFILER_SUB_BUCKETS) * width;
+
+    return lower + width / 2;
+}
+
+SE_Profiler::SE_Profiler()
+{
+    Reset();
+}
+
+SE_Profiler& SE_Profiler::Inst()
+{
+    static SE_Profiler instance;
+    return instance;
+}
+
+int64_t SE_Profiler::Now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+const char* SE_Profiler::PhaseName(Phase phase)
+{
+    return phase_names[static_cast<int>(phase)];
+}
+
+const char* SE_Profiler::CounterName(Counter counter)
+{
+    return counter_names[static_cast<int>(counter)];
+}
+
+void SE_Profiler::ResetCounters()
+{
+    for (int i = 0; i < static_cast<int>(Counter::N_COUNTERS); i++)
+    {
+        counters_[i].store(0, std::memory_order_relaxed);
+    }
+    for (int i = 0; i < static_cast<int>(Phase::N_PHASES); i++)
+    {
+        phase_time_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void SE_Profiler::LogCounters()
+{
+    // read values first, since logging itself increments the log lines counter
+    int64_t counters[static_cast<int>(Counter::N_COUNTERS)];
+    for (int i = 0; i < static_cast<int>(Counter::N_COUNTERS); i++)
+    {
+        counters[i] = GetCounter(static_cast<Counter>(i));
+    }
+
+    int64_t frame_time = GetPhaseTime(Phase::FRAME);
+    int64_t frames     = counters[static_cast<int>(Counter::FRAMES)];
+
+    LOG("Perf: %-24s %16s %12s", "counter", "total", "per frame");
+    for (int i = 0; i < static_cast<int>(Counter::N_COUNTERS); i++)
+    {
+        if (static_cast<Counter>(i) == Counter::ENTITIES || static_cast<Counter>(i) == Counter::FRAMES)
+        {
+            LOG("Perf: %-24s %16" PRId64, CounterName(static_cast<Counter>(i)), counters[i]);
+        }
+        else
+        {
+            LOG("Perf: %-24s %16" PRId64 " %12.1f",
+                CounterName(static_cast<Counter>(i)),
+                counters[i],
+                frames > 0 ? static_cast<double>(counters[i]) / static_cast<double>(frames) : 0.0);
+        }
+    }
+
+    LOG("Perf: %-24s %16s %12s %8s", "phase", "total (ms)", "mean (us)", "share");
+    for (int i = 0; i < static_cast<int>(Phase::N_PHASES); i++)
+    {
+        int64_t phase_time = GetPhaseTime(static_cast<Phase>(i));
+        if (phase_time > 0)
+        {
+            LOG("Perf: %-24s %16.3f %12.1f %7.1f%%",
+                PhaseName(static_cast<Phase>(i)),
+                1E-6 * static_cast<double>(phase_time),
+                frames > 0 ? 1E-3 * static_cast<double>(phase_time) / static_cast<double>(frames) : 0.0,
+                frame_time > 0 ? 100.0 * static_cast<double>(phase_time) / static_cast<double>(frame_time) : 0.0);
+        }
+    }
+}
+
+void SE_Profiler::Reset()
+{
+    for (int i = 0; i < static_cast<int>(Phase::N_PHASES); i++)
+    {
+        frame_sum_[i]      = 0;
+        frame_hit_[i]      = false;
+        stats_[i].count    = 0;
+        stats_[i].sum      = 0;
+        stats_[i].min      = 0;
+        stats_[i].max      = 0;
+        stats_[i].buckets.assign(PROFILER_N_BUCKETS, 0);
+    }
+    trace_.clear();
+    start_time_ = Now();
+}
+
+void SE_Profiler::Enable(std::string filename, std::string trace_filename)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Reset();
+    filename_       = filename;
+    trace_filename_ = trace_filename;
+    enabled_        = true;
+    timing_         = true;
+}
+
+void SE_Profiler::Disable()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!enabled_)
+    {
+        return;
+    }
+    enabled_ = false;
+    timing_  = phase_timing_.load();
+
+    if (!filename_.empty())
+    {
+        WriteStatistics();
+    }
+
+    if (!trace_filename_.empty())
+    {
+        WriteTrace();
+    }
+}
+
+void SE_Profiler::SetPhaseTiming(bool mode)
+{
+    std::lock_guard<std::mutex> lock(Inst().mutex_);
+
+    phase_timing_ = mode;
+    timing_       = mode || enabled_;
+}
+
+void SE_Profiler::AddSample(PhaseStats& stats, int64_t duration)
+{
+    if (stats.count == 0 || duration < stats.min)
+    {
+        stats.min = duration;
+    }
+    if (duration > stats.max)
+    {
+        stats.max = duration;
+    }
+    stats.count++;
+    stats.sum += duration;
+    stats.buckets[static_cast<size_t>(BucketIndex(duration))]++;
+}
+
+void SE_Profiler::Register(Phase phase, int64_t start, int64_t duration)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!enabled_)
+    {
+        return;
+    }
+
+    if (!trace_filename_.empty())
+    {
+        if (trace_.size() < PROFILER_MAX_TRACE_EVENTS)
+        {
+            trace_.push_back({phase, GetThreadIndex(), start, duration});
+        }
+        else if (trace_.size() == PROFILER_MAX_TRACE_EVENTS)
+        {
+            LOG("Profiler: Max number of trace events (%d) reached, skipping the rest", PROFILER_MAX_TRACE_EVENTS);
+            trace_.push_back({phase, -1, 0, 0});  // marker, not written
+        }
+    }
+
+    if (phase == Phase::FRAME)
+    {
+        // frame done, register accumulated time of each phase executed during the frame
+        for (int i = 0; i < static_cast<int>(Phase::N_PHASES); i++)
+        {
+            if (frame_hit_[i])
+            {
+                AddSample(stats_[i], frame_sum_[i]);
+                frame_sum_[i] = 0;
+                frame_hit_[i] = false;
+            }
+        }
+        AddSample(stats_[static_cast<int>(Phase::FRAME)], duration);
+    }
+    else
+    {
+        frame_sum_[static_cast<int>(phase)] += duration;
+        frame_hit_[static_cast<int>(phase)] = true;
+    }
+}
+
+int64_t SE_Profiler::GetPercentile(Phase phase, double percentile)
+{
+    PhaseStats& stats = stats_[static_cast<int>(phase)];
+
+    if (stats.count == 0)
+    {
+        return 0;
+    }
+
+    int64_t rank = static_cast<int64_t>(ceil(percentile / 100.0 * static_cast<double>(stats.count)));
+    rank         = MAX(1, MIN(rank, stats.count));
+
+    int64_t n = 0;
+    for (int i = 0; i < PROFILER_N_BUCKETS; i++)
+    {
+        n += stats.buckets[static_cast<size_t>(i)];
+        if (n >= rank)
+        {
+            return MAX(stats.min, MIN(stats.max, BucketMidValue(i)));
+        }
+    }
+
+    return stats.max;
+}
+
+int SE_Profiler::WriteStatistics()
+{
+    std::ofstream file;
+    char          line[1024];
+
+    file.open(filename_);
+    if (!file.is_open())
+    {
+        LOG("Profiler: Failed to open %s", filename_.c_str());
+        return -1;
+    }
+
+    // all durations in microseconds
+    snprintf(line,
+             sizeof(line),
+             "{\n  \"frames\": %" PRId64 ",\n  \"duration\": %.3f,\n  \"unit\": \"us\",\n  \"phases\": [\n",
+             stats_[static_cast<int>(Phase::FRAME)].count,
+             1E-3 * static_cast<double>(Now() - start_time_));
+    file << line;
+
+    LOG("Profiler: %-20s %10s %10s %10s %10s %10s (us)", "phase", "frames", "mean", "p50", "p99", "max");
+
+    bool first = true;
+    for (int i = 0; i < static_cast<int>(Phase::N_PHASES); i++)
+    {
+        PhaseStats& stats = stats_[i];
+        Phase       phase = static_cast<Phase>(i);
+
+        if (stats.count == 0)
+        {
+            continue;
+        }
+
+        double mean = 1E-3 * static_cast<double>(stats.sum) / static_cast<double>(stats.count);
+        double p50  = 1E-3 * static_cast<double>(GetPercentile(phase, 50.0));
+        double p99  = 1E-3 * static_cast<double>(GetPercentile(phase, 99.0));
+        double max  = 1E-3 * static_cast<double>(stats.max);
+
+        snprintf(line,
+                 sizeof(line),
+                 "%s    {\"name\": \"%s\", \"frames\": %" PRId64 ", \"total\": %.3f, \"mean\": %.3f, \"min\": %.3f, \"p50\": %.3f, \"p99\": %.3f, "
+                 "\"max\": %.3f}",
+                 first ? "" : ",\n",
+                 PhaseName(phase),
+                 stats.count,
+                 1E-3 * static_cast<double>(stats.sum),
+                 mean,
+                 1E-3 * static_cast<double>(stats.min),
+                 p50,
+                 p99,
+                 max);
+        file << line;
+        first = false;
+
+        LOG("Profiler: %-20s %10" PRId64 " %10.1f %10.1f %10.1f %10.1f", PhaseName(phase), stats.count, mean, p50, p99, max);
+    }
+    file << "\n  ]\n}\n";
+    file.close();
+
+    LOG("Profiler: Statistics written to %s", filename_.c_str());
+
+    return 0;
+}
+
+int SE_Profiler::WriteTrace()
+{
+    std::ofstream file;
+    char          line[256];
+
+    file.open(trace_filename_);
+    if (!file.is_open())
+    {
+        LOG("Profiler: Failed to open %s", trace_filename_.c_str());
+        return -1;
+    }
+
+    // Chrome trace-event format, complete events (ph X) with timestamps in microseconds
+    file << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+    for (size_t i = 0; i < trace_.size(); i++)
+    {
+        if (trace_[i].thread < 0)
+        {
+            continue;
+        }
+        snprintf(line,
+                 sizeof(line),
+                 "%s{\"name\": \"%s\", \"cat\": \"esmini\", \"ph\": \"X\", \"pid\": 1, \"tid\": %d, \"ts\": %.3f, \"dur\": %.3f}",
+                 i == 0 ? "" : ",\n",
+                 PhaseName(trace_[i].phase),
+                 trace_[i].thread,
+                 1E-3 * static_cast<double>(trace_[i].start - start_time_),
+                 1E-3 * static_cast<double>(trace_[i].duration));
+        file << line;
+    }
+    file << "\n]}\n";
+    file.close();
+
+    LOG("Profiler: Trace with %d events written to %s", static_cast<int>(MIN(trace_.size(), static_cast<size_t>(PROFILER_MAX_TRACE_EVENTS))), trace_filename_.c_str());
+
+    return 0;
+}
@@ -0,0 +1,225 @@
+/*
+ * esmini - Environment Simulator Minimalistic
+ * https://github.com/esmini/esmini
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) partners of Simulation Scenarios
+ * https://sites.google.com/view/simulationscenarios
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <inttypes.h>
+
+#define PROFILER_SUB_BUCKETS      8  // histogram resolution, buckets per power of two (~9% relative error)
+#define PROFILER_N_BUCKETS        (64 * PROFILER_SUB_BUCKETS)
+#define PROFILER_MAX_TRACE_EVENTS 2000000  // limit memory use of trace, about 50 MB
+
+/**
+    Frame phase profiler and performance counters
+    Phases are timed by SE_ProfileScope objects. Time spent in a phase is summed over each frame, i.e. until the
+    FRAME scope ends, and the frame total is added to the histogram of the phase.
+    Phase timing alone, see SetPhaseTiming(), only adds the durations to the accumulated phase times. When neither
+    profiling nor phase timing is on, which is the default, a scope does nothing but check a flag.
+    Counters are always on. Counters and accumulated phase times are shared by all players of the process. They are
+    updated with relaxed atomic operations, so they can be incremented from any thread at the cost of a few nanoseconds.
+*/
+class SE_Profiler
+{
+public:
+    enum class Phase
+    {
+        FRAME,                // complete player frame
+        GATEWAY_SYNC,         // transfer of object states between gateway and entities
+        STORYBOARD,           // storyboard and injected actions step
+        DEFAULT_CONTROLLER,   // default object motion
+        CONTROLLERS,          // step of assigned controllers
+        TRAILERS,             // trailer update
+        COLLISION_DETECTION,  // collision detection
+        GROUND_TRUTH,         // prepareGroundTruth
+        RECORD,               // write states to .dat file
+        CSV_LOG,              // CSV logger
+        SENSORS,              // object sensor update
+        OSI,                  // OSI ground truth and sensor data
+        OSI_STATIC_GT,        // OSI static ground truth, i.e. road network and stationary objects (part of OSI)
+        OSI_DYNAMIC_GT,       // OSI moving objects and other dynamic ground truth (part of OSI)
+        VIEWER,               // viewer update
+        N_PHASES
+    };
+
+    enum class Counter
+    {
+        FRAMES,                  // scenario frames
+        ENTITIES,                // number of entities in last frame, not accumulated
+        XYZ2TRACKPOS,            // calls to Position::XYZ2TrackPos()
+        XYZ2TRACKPOS_FULL_SCAN,  // XYZ2TrackPos() calls not resolved around last position, falling back to search all roads
+        DELTA,                   // calls to Position::Delta()
+        ROAD_PATH_EXPANSIONS,    // nodes expanded by RoadPath searches, e.g. from Delta()
+        COLLISION_PAIR_TESTS,    // object pairs checked by collision detection
+        OSI_BYTES_SERIALIZED,    // serialized OSI ground truth
+        OSI_BYTES_SENT,          // OSI ground truth sent over UDP, excluding dropped frames
+        LOG_LINES,               // log entries written to file or callback
+        N_COUNTERS
+    };
+
+    static SE_Profiler& Inst();
+
+    static bool IsEnabled()
+    {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+    static bool IsTiming()  // profiling or phase timing on, checked by all scopes, also in worker threads
+    {
+        return timing_.load(std::memory_order_relaxed);
+    }
+
+    /**
+        Accumulate time per phase also when profiling is not enabled, e.g. for SE_GetPerfCounters()
+        @param mode true=on, false=off
+    */
+    static void SetPhaseTiming(bool mode);
+    static bool GetPhaseTiming()
+    {
+        return phase_timing_.load(std::memory_order_relaxed);
+    }
+
+    /**
+        Start profiling
+        @param filename Where to write the phase statistics (JSON) when disabled, empty = collect only
+        @param trace_filename If not empty, also write each phase execution in Chrome trace-event format
+    */
+    void Enable(std::string filename, std::string trace_filename = "");
+
+    /**
+        Stop profiling and write results to file(s)
+    */
+    void Disable();
+
+    static int64_t     Now();  // steady clock, nanoseconds
+    static const char* PhaseName(Phase phase);
+    static const char* CounterName(Counter counter);
+
+    static void Count(Counter counter, int64_t n = 1)
+    {
+        counters_[static_cast<int>(counter)].fetch_add(n, std::memory_order_relaxed);
+    }
+    static void SetCounter(Counter counter, int64_t value)
+    {
+        counters_[static_cast<int>(counter)].store(value, std::memory_order_relaxed);
+    }
+    static int64_t GetCounter(Counter counter)
+    {
+        return counters_[static_cast<int>(counter)].load(std::memory_order_relaxed);
+    }
+    static void AddPhaseTime(Phase phase, int64_t duration)
+    {
+        phase_time_[static_cast<int>(phase)].fetch_add(duration, std::memory_order_relaxed);
+    }
+    static int64_t GetPhaseTime(Phase phase)  // accumulated time since start or reset, nanoseconds
+    {
+        return phase_time_[static_cast<int>(phase)].load(std::memory_order_relaxed);
+    }
+    static void AddPhase(Phase phase, int64_t start, int64_t duration)  // accumulate, and register if profiling
+    {
+        AddPhaseTime(phase, duration);
+        if (IsEnabled())
+        {
+            Inst().Register(phase, start, duration);
+        }
+    }
+
+    /**
+        Set all counters and accumulated phase times to zero. Does not affect the profiler statistics.
+    */
+    static void ResetCounters();
+
+    /**
+        Log all counters and accumulated phase times
+    */
+    static void LogCounters();
+
+    void    Register(Phase phase, int64_t start, int64_t duration);
+    int64_t GetPercentile(Phase phase, double percentile);
+    int64_t GetMax(Phase phase)
+    {
+        return stats_[static_cast<int>(phase)].max;
+    }
+    int64_t GetCount(Phase phase)
+    {
+        return stats_[static_cast<int>(phase)].count;
+    }
+    int64_t GetSum(Phase phase)  // total time spent in phase, nanoseconds
+    {
+        return stats_[static_cast<int>(phase)].sum;
+    }
+
+private:
+    typedef struct
+    {
+        int64_t              count;
+        int64_t              sum;
+        int64_t              min;
+        int64_t              max;
+        std::vector<int64_t> buckets;
+    } PhaseStats;
+
+    typedef struct
+    {
+        Phase   phase;
+        int     thread;
+        int64_t start;
+        int64_t duration;
+    } TraceEvent;
+
+    SE_Profiler();
+
+    void Reset();
+    void AddSample(PhaseStats& stats, int64_t duration);
+    int  WriteStatistics();
+    int  WriteTrace();
+
+    static std::atomic<bool>    enabled_;
+    static std::atomic<bool>    phase_timing_;
+    static std::atomic<bool>    timing_;  // enabled_ || phase_timing_
+    static std::atomic<int64_t> counters_[static_cast<int>(Counter::N_COUNTERS)];
+    static std::atomic<int64_t> phase_time_[static_cast<int>(Phase::N_PHASES)];
+    std::mutex                  mutex_;
+    std::string                 filename_;
+    std::string                 trace_filename_;
+    int64_t                     start_time_;
+    int64_t                     frame_sum_[static_cast<int>(Phase::N_PHASES)];
+    bool                        frame_hit_[static_cast<int>(Phase::N_PHASES)];
+    PhaseStats                  stats_[static_cast<int>(Phase::N_PHASES)];
+    std::vector<TraceEvent>     trace_;
+};
+
+class SE_ProfileScope
+{
+public:
+    SE_ProfileScope(SE_Profiler::Phase phase) : phase_(phase), active_(SE_Profiler::IsTiming()), start_(active_ ? SE_Profiler::Now() : 0)
+    {
+    }
+    ~SE_ProfileScope()
+    {
+        if (active_)
+        {
+            SE_Profiler::AddPhase(phase_, start_, SE_Profiler::Now() - start_);
+        }
+    }
+
+private:
+    SE_Profiler::Phase phase_;
+    bool               active_;
+    int64_t            start_;
+};
+
+#define SE_PROFILE_CONCAT2(a, b) a##b
+#define SE_PROFILE_CONCAT(a, b)  SE_PROFILE_CONCAT2(a, b)
+#define SE_PROFILE_SCOPE(phase)  SE_ProfileScope SE_PROFILE_CONCAT(profile_scope_, __LINE__)(SE_Profiler::Phase::phase)
@@ -0,0 +1,334 @@
+/*
+ * esmini - Environment Simulator Minimalistic
+ * https://github.com/esmini/esmini
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) partners of Simulation Scenarios
+ * https://sites.google.com/view/simulationscenarios
+ */
+
+#include <string.h>
+#include <chrono>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "SharedMemory.hpp"
+#include "CommonMini.hpp"
+
+static_assert(sizeof(SharedMemoryHeader) == 64, "Unexpected shared memory header size");
+static_assert(sizeof(SharedMemorySlot) == 64, "Unexpected shared memory slot size");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "Lock free 64 bit atomics needed for shared memory");
+
+static int64_t SteadyClockNow()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+SharedMemoryBase::SharedMemoryBase(std::string name) : fd_(-1), mem_(nullptr), mem_size_(0), header_(nullptr)
+{
+    name_ = (name.empty() || name[0] != '/') ? "/" + name : name;
+}
+
+SharedMemoryBase::~SharedMemoryBase()
+{
+    Unmap();
+}
+
+void SharedMemoryBase::Unmap()
+{
+#ifndef _WIN32
+    if (mem_ != nullptr)
+    {
+        munmap(mem_, mem_size_);
+    }
+    if (fd_ >= 0)
+    {
+        close(fd_);
+    }
+#endif
+    mem_      = nullptr;
+    mem_size_ = 0;
+    header_   = nullptr;
+    fd_       = -1;
+}
+
+SharedMemorySlot* SharedMemoryBase::GetSlot(int index)
+{
+    return reinterpret_cast<SharedMemorySlot*>(mem_ + sizeof(SharedMemoryHeader)) + index;
+}
+
+char* SharedMemoryBase::GetSlotData(int index)
+{
+    return mem_ + sizeof(SharedMemoryHeader) + header_->n_slots * sizeof(SharedMemorySlot) + static_cast<size_t>(index) * header_->slot_size;
+}
+
+SharedMemoryWriter::SharedMemoryWriter(std::string name, int n_slots)
+    : SharedMemoryBase(name),
+      n_slots_(MAX(2, n_slots)),
+      frame_(0)
+{
+}
+
+SharedMemoryWriter::~SharedMemoryWriter()
+{
+    if (mem_ != nullptr)
+    {
+        Unmap();
+#ifndef _WIN32
+        shm_unlink(name_.c_str());
+#endif
+    }
+}
+
+int SharedMemoryWriter::Create(size_t slot_size)
+{
+#ifdef _WIN32
+    (void)slot_size;
+    LOG("Shared memory not supported on this platform");
+    return -1;
+#else
+    // round up to multiple of cache line size
+    slot_size = (slot_size + 63) & ~static_cast<size_t>(63);
+    if (slot_size > UINT32_MAX)
+    {
+        LOG("Shared memory slot size %.0f exceeds max %u", static_cast<double>(slot_size), UINT32_MAX);
+        return -1;
+    }
+
+    size_t size = sizeof(SharedMemoryHeader) + static_cast<size_t>(n_slots_) * (sizeof(SharedMemorySlot) + slot_size);
+
+    // remove any stale object from a previous session
+    shm_unlink(name_.c_str());
+
+    if ((fd_ = shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644)) < 0)
+    {
+        LOG("Failed to create shared memory %s: %s", name_.c_str(), strerror(errno));
+        return -1;
+    }
+
+    if (ftruncate(fd_, static_cast<off_t>(size)) != 0)
+    {
+        LOG("Failed to size shared memory %s: %s", name_.c_str(), strerror(errno));
+        Unmap();
+        shm_unlink(name_.c_str());
+        return -1;
+    }
+
+    void* mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (mem == MAP_FAILED)
+    {
+        LOG("Failed to map shared memory %s: %s", name_.c_str(), strerror(errno));
+        Unmap();
+        shm_unlink(name_.c_str());
+        return -1;
+    }
+
+    // ftruncate fills with zeros, so all counters start at zero
+    mem_                = static_cast<char*>(mem);
+    mem_size_           = size;
+    header_             = reinterpret_cast<SharedMemoryHeader*>(mem_);
+    header_->n_slots    = static_cast<uint32_t>(n_slots_);
+    header_->slot_size  = static_cast<uint32_t>(slot_size);
+    header_->version    = SHM_VERSION;
+    header_->generation.store(frame_, std::memory_order_relaxed);  // continue frame numbering if re-created
+    header_->magic.store(SHM_MAGIC, std::memory_order_release);     // set last, readers check it before anything else
+
+    LOG("Shared memory %s created, %d slots of %d bytes", name_.c_str(), n_slots_, static_cast<int>(slot_size));
+
+    return 0;
+#endif
+}
+
+void SharedMemoryWriter::Retire()
+{
+#ifndef _WIN32
+    // readers keep their mapping of the retired object until they see the cleared magic number
+    header_->magic.store(0, std::memory_order_release);
+    Unmap();
+    shm_unlink(name_.c_str());
+#endif
+}
+
+uint64_t SharedMemoryWriter::Write(const char* data, size_t size)
+{
+    if (mem_ != nullptr && size > header_->slot_size)
+    {
+        LOG("Shared memory frame size %.0f exceeds slot size %u, re-creating %s with larger slots",
+            static_cast<double>(size),
+            header_->slot_size,
+            name_.c_str());
+        Retire();
+    }
+
+    if (mem_ == nullptr && Create(MAX(2 * size, static_cast<size_t>(SHM_MIN_SLOT_SIZE))) != 0)
+    {
+        return 0;
+    }
+
+    uint64_t          frame = ++frame_;
+    int               index = static_cast<int>(frame % header_->n_slots);
+    SharedMemorySlot* slot  = GetSlot(index);
+    uint64_t          seq   = slot->seq.load(std::memory_order_relaxed);
+
+    // odd sequence number tells the slot is being written
+    slot->seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    memcpy(GetSlotData(index), data, size);
+    slot->frame.store(frame, std::memory_order_relaxed);
+    slot->size.store(size, std::memory_order_relaxed);
+    slot->timestamp.store(SteadyClockNow(), std::memory_order_relaxed);
+
+    slot->seq.store(seq + 2, std::memory_order_release);
+    header_->generation.store(frame, std::memory_order_release);
+
+    return frame;
+}
+
+SharedMemoryReader::SharedMemoryReader(std::string name) : SharedMemoryBase(name)
+{
+}
+
+int SharedMemoryReader::Open()
+{
+#ifdef _WIN32
+    LOG("Shared memory not supported on this platform");
+    return -1;
+#else
+    if (mem_ != nullptr)
+    {
+        return 0;
+    }
+
+    if ((fd_ = shm_open(name_.c_str(), O_RDONLY, 0)) < 0)
+    {
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(fd_, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(SharedMemoryHeader))
+    {
+        Unmap();
+        return -1;
+    }
+
+    void* mem = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd_, 0);
+    if (mem == MAP_FAILED)
+    {
+        LOG("Failed to map shared memory %s: %s", name_.c_str(), strerror(errno));
+        Unmap();
+        return -1;
+    }
+
+    mem_      = static_cast<char*>(mem);
+    mem_size_ = static_cast<size_t>(st.st_size);
+    header_   = reinterpret_cast<SharedMemoryHeader*>(mem_);
+
+    if (header_->magic.load(std::memory_order_acquire) != SHM_MAGIC || header_->version != SHM_VERSION ||
+        mem_size_ < sizeof(SharedMemoryHeader) + header_->n_slots * (sizeof(SharedMemorySlot) + static_cast<size_t>(header_->slot_size)))
+    {
+        // not initialized yet, or incompatible
+        Unmap();
+        return -1;
+    }
+
+    return 0;
+#endif
+}
+
+int SharedMemoryReader::Refresh()
+{
+    if (mem_ != nullptr && header_->magic.load(std::memory_order_acquire) != SHM_MAGIC)
+    {
+        // retired by the writer, replaced by a new object with larger slots
+        Unmap();
+        return Open();
+    }
+
+    return mem_ == nullptr ? -1 : 0;
+}
+
+uint64_t SharedMemoryReader::GetGeneration()
+{
+    return Refresh() != 0 ? 0 : header_->generation.load(std::memory_order_acquire);
+}
+
+int SharedMemoryReader::GetLatest(SharedMemoryFrame& frame)
+{
+    if (Refresh() != 0)
+    {
+        return -1;
+    }
+
+    for (int i = 0; i < SHM_MAX_READ_ATTEMPTS; i++)
+    {
+        uint64_t generation = header_->generation.load(std::memory_order_acquire);
+        if (generation == 0)
+        {
+            return -1;
+        }
+
+        int               index = static_cast<int>(generation % header_->n_slots);
+        SharedMemorySlot* slot  = GetSlot(index);
+        uint64_t          seq   = slot->seq.load(std::memory_order_acquire);
+
+        if (seq & 1)
+        {
+            // being written, i.e. the writer has lapped the ring since the generation counter was read
+            continue;
+        }
+
+        frame.frame     = slot->frame.load(std::memory_order_relaxed);
+        frame.size      = slot->size.load(std::memory_order_relaxed);
+        frame.timestamp = slot->timestamp.load(std::memory_order_relaxed);
+        frame.data      = GetSlotData(index);
+        frame.seq       = seq;
+        frame.slot      = index;
+
+        if (frame.frame == generation && frame.size <= header_->slot_size && IsValid(frame))
+        {
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+bool SharedMemoryReader::IsValid(const SharedMemoryFrame& frame)
+{
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return GetSlot(frame.slot)->seq.load(std::memory_order_relaxed) == frame.seq;
+}
+
+int SharedMemoryReader::Read(std::vector<char>& buf, SharedMemoryFrame& frame)
+{
+    for (int i = 0; i < SHM_MAX_READ_ATTEMPTS; i++)
+    {
+        if (GetLatest(frame) != 0)
+        {
+            return -1;
+        }
+
+        if (buf.size() < frame.size)
+        {
+            buf.resize(frame.size);
+        }
+        memcpy(buf.data(), frame.data, frame.size);
+
+        if (IsValid(frame))
+        {
+            frame.data = buf.data();
+            return 0;
+        }
+    }
+
+    return -1;
+}
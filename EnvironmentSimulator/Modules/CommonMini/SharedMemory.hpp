@@ -0,0 +1,173 @@
+/*
+ * esmini - Environment Simulator Minimalistic
+ * https://github.com/esmini/esmini
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) partners of Simulation Scenarios
+ * https://sites.google.com/view/simulationscenarios
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <inttypes.h>
+
+#define SHM_MAGIC             0x53454d53  // "SMES"
+#define SHM_VERSION           1
+#define SHM_DEFAULT_N_SLOTS   4
+#define SHM_MIN_SLOT_SIZE     (4 * 1024 * 1024)
+#define SHM_MAX_READ_ATTEMPTS 100
+
+/*
+    Shared memory transport of the latest frame from one writer to any number of readers on the same host
+    Frames are written into a ring of slots, round robin. Each slot is guarded by a sequence lock, i.e. a counter
+    which is odd while the slot is being written. A generation counter tells the number of the latest complete frame.
+    The writer never waits for readers, instead a reader detects when a frame was overwritten while read. Since the
+    writer only returns to a slot after filling all the others, a reader has n_slots - 1 frame periods to finish.
+    If a frame does not fit into the slots, the writer retires the shared memory object, by clearing its magic number,
+    and creates a new one with larger slots under the same name. Readers detect this and map the new object.
+
+    Memory layout: SharedMemoryHeader, n_slots * SharedMemorySlot, n_slots * slot_size data bytes
+*/
+
+typedef struct
+{
+    std::atomic<uint32_t> magic;       // SHM_MAGIC when initialized, 0 when retired
+    uint32_t              version;
+    uint32_t              n_slots;
+    uint32_t              slot_size;   // max frame size in bytes
+    std::atomic<uint64_t> generation;  // number of latest complete frame, 0 = none yet
+    char                  padding[40];
+} SharedMemoryHeader;
+
+typedef struct
+{
+    std::atomic<uint64_t> seq;        // sequence lock, odd while slot is being written
+    std::atomic<uint64_t> frame;      // frame number
+    std::atomic<uint64_t> size;       // frame size in bytes
+    std::atomic<int64_t>  timestamp;  // steady clock time (ns) when the frame was published
+    char                  padding[32];
+} SharedMemorySlot;
+
+typedef struct
+{
+    const char* data;       // points into shared memory, valid until overwritten, see SharedMemoryReader::IsValid()
+    uint64_t    size;       // size in bytes
+    uint64_t    frame;      // frame number, increasing by one per written frame
+    int64_t     timestamp;  // steady clock time (ns) when the frame was published
+    uint64_t    seq;        // sequence number of the slot when read
+    int         slot;       // slot index
+} SharedMemoryFrame;
+
+class SharedMemoryBase
+{
+public:
+    int GetStatus()
+    {
+        return mem_ == nullptr ? -1 : 0;
+    }  // -1 = NOK, 0 = OK
+    std::string GetName()
+    {
+        return name_;
+    }
+
+protected:
+    SharedMemoryBase(std::string name);
+    ~SharedMemoryBase();
+
+    void              Unmap();
+    SharedMemorySlot* GetSlot(int index);
+    char*             GetSlotData(int index);
+
+    std::string         name_;  // POSIX shared memory object name, starting with '/'
+    int                 fd_;
+    char*               mem_;
+    size_t              mem_size_;
+    SharedMemoryHeader* header_;
+};
+
+class SharedMemoryWriter : public SharedMemoryBase
+{
+public:
+    /**
+        @param name Name of the shared memory object, e.g. "esmini_osi"
+        @param n_slots Number of frames in the ring buffer, at least 2
+    */
+    SharedMemoryWriter(std::string name, int n_slots = SHM_DEFAULT_N_SLOTS);
+    ~SharedMemoryWriter();
+
+    /**
+        Publish a frame. The shared memory is created on first write, with slots sized to fit frames of at least
+        twice the size of the first one (but minimum SHM_MIN_SLOT_SIZE). It's re-created whenever a larger frame
+        comes, with twice the size of that frame.
+        @param data Frame data
+        @param size Frame size in bytes
+        @return Frame number (>0) if successful, 0 if not
+    */
+    uint64_t Write(const char* data, size_t size);
+
+private:
+    int  Create(size_t slot_size);
+    void Retire();
+
+    int      n_slots_;
+    uint64_t frame_;  // number of latest written frame
+};
+
+class SharedMemoryReader : public SharedMemoryBase
+{
+public:
+    /**
+        @param name Name of the shared memory object, same as given to the writer
+    */
+    SharedMemoryReader(std::string name);
+    ~SharedMemoryReader()
+    {
+    }
+
+    /**
+        Map the shared memory. Call repeatedly until successful if the writer has not yet published any frame.
+        @return 0 if successful, -1 if not (yet) available
+    */
+    int Open();
+
+    /**
+        Number of latest published frame, 0 if none. Maps the new shared memory object if the writer has replaced it.
+    */
+    uint64_t GetGeneration();
+
+    /**
+        Get the latest frame without copying it. The data can be accessed in place, but might get overwritten at any
+        time after n_slots - 1 new frames. Check with IsValid() after use of the data, e.g. parsing, and discard any
+        result if not valid anymore. If the writer has replaced the shared memory object, it's mapped, and any
+        previously fetched frame must not be accessed anymore.
+        @param frame Frame info, including pointer to data
+        @return 0 if successful, -1 if no frame available
+    */
+    int GetLatest(SharedMemoryFrame& frame);
+
+    /**
+        Check whether a frame fetched by GetLatest() is still intact
+    */
+    bool IsValid(const SharedMemoryFrame& frame);
+
+    /**
+        Copy the latest frame
+        @param buf Buffer to copy frame data into, resized as needed
+        @param frame Frame info, data pointing into buf
+        @return 0 if successful, -1 if no frame available
+    */
+    int Read(std::vector<char>& buf, SharedMemoryFrame& frame);
+
+private:
+    /**
+        Check whether the writer has retired the mapped shared memory object, if so map the new one
+        @return 0 if mapped, -1 if not (yet) available
+    */
+    int Refresh();
+};
@@ -0,0 +1,153 @@
+/*
+ * esmini - Environment Simulator Minimalistic
+ * https://github.com/esmini/esmini
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) partners of Simulation Scenarios
+ * https://sites.google.com/view/simulationscenarios
+ */
+
+#include "TaskPool.hpp"
+#include "CommonMini.hpp"
+
+static thread_local bool in_task = false;  // true while executing a task, to run nested jobs sequentially
+
+SE_TaskPool& SE_TaskPool::Inst()
+{
+    static SE_TaskPool instance;
+    return instance;
+}
+
+SE_TaskPool::SE_TaskPool() : n_threads_(1), func_(nullptr), env_(nullptr), n_tasks_(0), next_task_(0), n_busy_workers_(0), job_counter_(0), quit_(false)
+{
+    SetNumberOfThreads(0);
+}
+
+SE_TaskPool::~SE_TaskPool()
+{
+    StopWorkers();
+}
+
+void SE_TaskPool::SetNumberOfThreads(int n_threads)
+{
+    std::lock_guard<std::mutex> job_lock(job_mutex_);
+
+    if (n_threads < 1)
+    {
+        n_threads = MIN(MAX(1, static_cast<int>(std::thread::hardware_concurrency())), SE_TASK_POOL_MAX_THREADS);
+    }
+
+    if (n_threads != n_threads_)
+    {
+        // workers are restarted on next use
+        StopWorkers();
+        n_threads_ = n_threads;
+    }
+}
+
+void SE_TaskPool::StartWorkers()
+{
+    quit_ = false;
+    for (int i = 0; i < n_threads_ - 1; i++)
+    {
+        workers_.push_back(std::thread(&SE_TaskPool::Worker, this));
+    }
+}
+
+void SE_TaskPool::StopWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        quit_ = true;
+    }
+    cv_.notify_all();
+
+    for (auto& worker : workers_)
+    {
+        worker.join();
+    }
+    workers_.clear();
+}
+
+void SE_TaskPool::RunTasks()
+{
+    bool nested = in_task;
+    in_task     = true;
+
+    for (int i = next_task_.fetch_add(1); i < n_tasks_; i = next_task_.fetch_add(1))
+    {
+        (*func_)(i);
+    }
+
+    in_task = nested;
+}
+
+void SE_TaskPool::Worker()
+{
+    uint64_t job_done = 0;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true)
+    {
+        cv_.wait(lock, [&] { return quit_ || job_counter_ != job_done; });
+
+        if (quit_)
+        {
+            break;
+        }
+
+        job_done    = job_counter_;
+        SE_Env* env = SE_Env::Bind(env_);
+        lock.unlock();
+
+        RunTasks();
+        SE_Env::Bind(env);
+
+        lock.lock();
+        if (--n_busy_workers_ == 0)
+        {
+            done_cv_.notify_all();
+        }
+    }
+}
+
+void SE_TaskPool::ParallelFor(int n_tasks, const std::function<void(int)>& func)
+{
+    std::unique_lock<std::mutex> job_lock(job_mutex_, std::defer_lock);
+
+    if (n_tasks < 2 || n_threads_ < 2 || in_task || !job_lock.try_lock())
+    {
+        // not worth it, or pool busy
+        for (int i = 0; i < n_tasks; i++)
+        {
+            func(i);
+        }
+        return;
+    }
+
+    if (workers_.empty())
+    {
+        StartWorkers();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        func_           = &func;
+        env_            = SE_Env::Bound();
+        n_tasks_        = n_tasks;
+        n_busy_workers_ = static_cast<int>(workers_.size());
+        next_task_.store(0);
+        job_counter_++;
+    }
+    cv_.notify_all();
+
+    RunTasks();
+
+    // all tasks are picked, wait for workers to finish theirs
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [this] { return n_busy_workers_ == 0; });
+    func_ = nullptr;
+}
@@ -0,0 +1,77 @@
+/*
+ * esmini - Environment Simulator Minimalistic
+ * https://github.com/esmini/esmini
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) partners of Simulation Scenarios
+ * https://sites.google.com/view/simulationscenarios
+ */
+
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <inttypes.h>
+
+class SE_Env;
+
+#define SE_TASK_POOL_MAX_THREADS 8  // default limit, can be changed by SetNumberOfThreads()
+
+/**
+    Pool of worker threads for independent tasks within a frame, e.g. per sensor processing.
+    Workers are started on first use. The calling thread takes part in the work, and ParallelFor() returns when all
+    tasks are done. Calls from within a task, or while another ParallelFor() is running, are executed sequentially.
+    Workers run the tasks with the environment of the calling thread bound, see SE_Env::Bind().
+*/
+class SE_TaskPool
+{
+public:
+    static SE_TaskPool& Inst();
+    ~SE_TaskPool();
+
+    /**
+        Set max number of threads, including the calling thread
+        @param n_threads Number of threads, 1 = run all tasks in calling thread, 0 = default (number of cores, but max
+        SE_TASK_POOL_MAX_THREADS)
+    */
+    void SetNumberOfThreads(int n_threads);
+    int  GetNumberOfThreads()
+    {
+        return n_threads_;
+    }
+
+    /**
+        Run func(0) .. func(n_tasks - 1), in parallel. Tasks are picked in order, but might finish in any order.
+        @param n_tasks Number of tasks
+        @param func Task function, given task index
+    */
+    void ParallelFor(int n_tasks, const std::function<void(int)>& func);
+
+private:
+    SE_TaskPool();
+    void StartWorkers();
+    void StopWorkers();
+    void Worker();
+    void RunTasks();
+
+    int                             n_threads_;
+    std::vector<std::thread>        workers_;
+    std::mutex                      job_mutex_;  // one job at a time
+    std::mutex                      mutex_;
+    std::condition_variable         cv_;
+    std::condition_variable         done_cv_;
+    const std::function<void(int)>* func_;
+    SE_Env*                         env_;  // environment bound to the calling thread
+    int                             n_tasks_;
+    std::atomic<int>                next_task_;
+    int                             n_busy_workers_;
+    uint64_t                        job_counter_;
+    bool                            quit_;
+};
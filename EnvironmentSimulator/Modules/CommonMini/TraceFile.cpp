@@ -0,0 +1,478 @@
+/*
+ * esmini - Environment Simulator Minimalistic
+ * https://github.com/esmini/esmini
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) partners of Simulation Scenarios
+ * https://sites.google.com/view/simulationscenarios
+ */
+
+#include <string.h>
+
+#include "TraceFile.hpp"
+#include "CommonMini.hpp"
+
+#define LZ4_MIN_MATCH     4
+#define LZ4_LAST_LITERALS 5   // last bytes of a block are always literals
+#define LZ4_MF_LIMIT      12  // last match must start at least this number of bytes before end of block
+#define LZ4_MAX_OFFSET    65535
+#define LZ4_HASH_BITS     14
+
+static inline uint32_t Read32(const unsigned char* p)
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint32_t Hash32(uint32_t v)
+{
+    return (v * 2654435761U) >> (32 - LZ4_HASH_BITS);
+}
+
+static inline unsigned char* WriteLength(unsigned char* op, int length)
+{
+    for (; length >= 255; length -= 255)
+    {
+        *op++ = 255;
+    }
+    *op++ = static_cast<unsigned char>(length);
+    return op;
+}
+
+int LZ4CompressBound(int size)
+{
+    return size + size / 255 + 16;
+}
+
+int LZ4CompressBlock(const char* src, int size, char* dst)
+{
+    const unsigned char* in     = reinterpret_cast<const unsigned char*>(src);
+    unsigned char*       op     = reinterpret_cast<unsigned char*>(dst);
+    int                  anchor = 0;
+    int                  pos    = 0;
+
+    if (size > LZ4_MF_LIMIT)
+    {
+        std::vector<int> table(1 << LZ4_HASH_BITS, -1);
+        int              mf_limit    = size - LZ4_MF_LIMIT;
+        int              match_limit = size - LZ4_LAST_LITERALS;
+        int              misses      = 0;
+
+        while (pos <= mf_limit)
+        {
+            uint32_t seq = Read32(in + pos);
+            uint32_t h   = Hash32(seq);
+            int      ref = table[h];
+            table[h]     = pos;
+
+            if (ref < 0 || pos - ref > LZ4_MAX_OFFSET || Read32(in + ref) != seq)
+            {
+                // skip faster through data that does not compress
+                pos += 1 + (misses++ >> 6);
+                continue;
+            }
+            misses = 0;
+
+            int length = LZ4_MIN_MATCH;
+            while (pos + length < match_limit && in[ref + length] == in[pos + length])
+            {
+                length++;
+            }
+
+            // sequence: token, literal length, literals, offset, match length
+            unsigned char* token       = op++;
+            int            lit_length  = pos - anchor;
+            int            match_extra = length - LZ4_MIN_MATCH;
+
+            *token = static_cast<unsigned char>((MIN(lit_length, 15) << 4) | MIN(match_extra, 15));
+            if (lit_length >= 15)
+            {
+                op = WriteLength(op, lit_length - 15);
+            }
+            memcpy(op, in + anchor, static_cast<size_t>(lit_length));
+            op += lit_length;
+            *op++ = static_cast<unsigned char>((pos - ref) & 0xff);
+            *op++ = static_cast<unsigned char>((pos - ref) >> 8);
+            if (match_extra >= 15)
+            {
+                op = WriteLength(op, match_extra - 15);
+            }
+
+            pos += length;
+            anchor = pos;
+        }
+    }
+
+    // last sequence, literals only
+    int lit_length = size - anchor;
+    *op++          = static_cast<unsigned char>(MIN(lit_length, 15) << 4);
+    if (lit_length >= 15)
+    {
+        op = WriteLength(op, lit_length - 15);
+    }
+    memcpy(op, in + anchor, static_cast<size_t>(lit_length));
+    op += lit_length;
+
+    return static_cast<int>(op - reinterpret_cast<unsigned char*>(dst));
+}
+
+int LZ4DecompressBlock(const char* src, int size, char* dst, int dst_capacity)
+{
+    const unsigned char* ip     = reinterpret_cast<const unsigned char*>(src);
+    const unsigned char* iend   = ip + size;
+    unsigned char*       op     = reinterpret_cast<unsigned char*>(dst);
+    unsigned char*       ostart = op;
+    unsigned char*       oend   = op + dst_capacity;
+
+    while (ip < iend)
+    {
+        unsigned char token  = *ip++;
+        size_t        length = token >> 4;
+
+        if (length == 15)
+        {
+            unsigned char b;
+            do
+            {
+                if (ip >= iend)
+                {
+                    return -1;
+                }
+                b = *ip++;
+                length += b;
+            } while (b == 255);
+        }
+
+        if (length > static_cast<size_t>(iend - ip) || length > static_cast<size_t>(oend - op))
+        {
+            return -1;
+        }
+        memcpy(op, ip, length);
+        ip += length;
+        op += length;
+
+        if (ip >= iend)
+        {
+            break;  // last sequence has no match part
+        }
+
+        if (iend - ip < 2)
+        {
+            return -1;
+        }
+        size_t offset = static_cast<size_t>(ip[0]) | (static_cast<size_t>(ip[1]) << 8);
+        ip += 2;
+        if (offset == 0 || offset > static_cast<size_t>(op - ostart))
+        {
+            return -1;
+        }
+
+        length = token & 0xf;
+        if (length == 15)
+        {
+            unsigned char b;
+            do
+            {
+                if (ip >= iend)
+                {
+                    return -1;
+                }
+                b = *ip++;
+                length += b;
+            } while (b == 255);
+        }
+        length += LZ4_MIN_MATCH;
+
+        if (length > static_cast<size_t>(oend - op))
+        {
+            return -1;
+        }
+
+        // byte by byte, since source and destination may overlap
+        const unsigned char* match = op - offset;
+        for (size_t i = 0; i < length; i++)
+        {
+            op[i] = match[i];
+        }
+        op += length;
+    }
+
+    return static_cast<int>(op - ostart);
+}
+
+TraceFileWriter::TraceFileWriter() : file_(nullptr), compress_(false), failed_(false), busy_(false), quit_(false)
+{
+}
+
+TraceFileWriter::~TraceFileWriter()
+{
+    Close();
+}
+
+int TraceFileWriter::Open(std::string filename, bool compress)
+{
+    Close();
+
+    if ((file_ = FileOpen(filename.c_str(), "wb")) == nullptr)
+    {
+        return -1;
+    }
+
+    compress_ = compress;
+    failed_   = false;
+    busy_     = false;
+    quit_     = false;
+    front_.clear();
+    front_.reserve(TRACE_BLOCK_SIZE);
+
+    if (compress_)
+    {
+        uint32_t magic = TRACE_COMPRESSED_MAGIC;
+        if (fwrite(&magic, sizeof(magic), 1, file_) != 1)
+        {
+            fclose(file_);
+            file_ = nullptr;
+            return -1;
+        }
+    }
+
+    thread_ = std::thread(&TraceFileWriter::Run, this);
+
+    return 0;
+}
+
+void TraceFileWriter::Close()
+{
+    if (file_ == nullptr)
+    {
+        return;
+    }
+
+    Flush();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        quit_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+
+    fclose(file_);
+    file_ = nullptr;
+}
+
+int TraceFileWriter::Write(const void* data, size_t size)
+{
+    if (file_ == nullptr)
+    {
+        return -1;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    if (failed_)
+    {
+        return -1;
+    }
+
+    if (!front_.empty() && front_.size() + size > TRACE_BLOCK_SIZE)
+    {
+        Submit(lock);
+    }
+    front_.insert(front_.end(), static_cast<const char*>(data), static_cast<const char*>(data) + size);
+
+    return 0;
+}
+
+void TraceFileWriter::Flush()
+{
+    if (file_ == nullptr)
+    {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    if (!front_.empty())
+    {
+        Submit(lock);
+    }
+    cv_.wait(lock, [this] { return !busy_; });
+
+    fflush(file_);
+}
+
+void TraceFileWriter::Submit(std::unique_lock<std::mutex>& lock)
+{
+    // wait for writer thread to finish previous block, then hand over the collected one
+    cv_.wait(lock, [this] { return !busy_; });
+    std::swap(front_, back_);
+    busy_ = true;
+    cv_.notify_all();
+}
+
+void TraceFileWriter::Run()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (true)
+    {
+        cv_.wait(lock, [this] { return busy_ || quit_; });
+
+        if (!busy_)
+        {
+            break;  // quit
+        }
+
+        lock.unlock();
+        int retval = WriteBlock(back_);
+        lock.lock();
+
+        if (retval != 0)
+        {
+            LOG("Failed write trace file");
+            failed_ = true;
+        }
+        back_.clear();
+        busy_ = false;
+        cv_.notify_all();
+    }
+}
+
+int TraceFileWriter::WriteBlock(const std::vector<char>& block)
+{
+    if (!compress_)
+    {
+        return fwrite(block.data(), 1, block.size(), file_) == block.size() ? 0 : -1;
+    }
+
+    uint32_t header[2];
+    int      size = static_cast<int>(block.size());
+
+    compressed_.resize(static_cast<size_t>(LZ4CompressBound(size)));
+    int         compressed_size = LZ4CompressBlock(block.data(), size, compressed_.data());
+    const char* data            = compressed_.data();
+
+    if (compressed_size >= size)
+    {
+        // store as is
+        compressed_size = size;
+        data            = block.data();
+    }
+
+    header[0] = static_cast<uint32_t>(compressed_size);
+    header[1] = static_cast<uint32_t>(size);
+
+    if (fwrite(header, sizeof(header), 1, file_) != 1 || fwrite(data, 1, static_cast<size_t>(compressed_size), file_) != static_cast<size_t>(compressed_size))
+    {
+        return -1;
+    }
+
+    return 0;
+}
+
+int TraceFileReader::Open(std::string filename)
+{
+    Close();
+
+    if ((file_ = FileOpen(filename.c_str(), "rb")) == nullptr)
+    {
+        return -1;
+    }
+
+    uint32_t magic = 0;
+    if (fread(&magic, sizeof(magic), 1, file_) == 1 && magic == TRACE_COMPRESSED_MAGIC)
+    {
+        compressed_ = true;
+    }
+    else
+    {
+        compressed_ = false;
+        rewind(file_);
+    }
+
+    block_.clear();
+    pos_ = 0;
+
+    return 0;
+}
+
+void TraceFileReader::Close()
+{
+    if (file_ != nullptr)
+    {
+        fclose(file_);
+        file_ = nullptr;
+    }
+}
+
+int TraceFileReader::ReadBlock()
+{
+    uint32_t header[2];
+
+    if (fread(header, sizeof(header), 1, file_) != 1)
+    {
+        return 0;  // end of file
+    }
+
+    block_.resize(header[1]);
+    pos_ = 0;
+
+    if (header[0] == header[1])
+    {
+        // stored as is
+        return fread(block_.data(), 1, header[1], file_) == header[1] ? 1 : -1;
+    }
+
+    compressed_block_.resize(header[0]);
+    if (fread(compressed_block_.data(), 1, header[0], file_) != header[0] ||
+        LZ4DecompressBlock(compressed_block_.data(), static_cast<int>(header[0]), block_.data(), static_cast<int>(header[1])) !=
+            static_cast<int>(header[1]))
+    {
+        return -1;
+    }
+
+    return 1;
+}
+
+int TraceFileReader::Read(void* data, size_t size)
+{
+    if (file_ == nullptr)
+    {
+        return -1;
+    }
+
+    if (!compressed_)
+    {
+        return static_cast<int>(fread(data, 1, size, file_));
+    }
+
+    size_t n_read = 0;
+    while (n_read < size)
+    {
+        if (pos_ >= block_.size())
+        {
+            int retval = ReadBlock();
+            if (retval < 0)
+            {
+                return -1;
+            }
+            else if (retval == 0)
+            {
+                break;
+            }
+            continue;  // blocks might be empty
+        }
+
+        size_t n = MIN(size - n_read, block_.size() - pos_);
+        memcpy(static_cast<char*>(data) + n_read, block_.data() + pos_, n);
+        n_read += n;
+        pos_ += n;
+    }
+
+    return static_cast<int>(n_read);
+}
@@ -0,0 +1,156 @@
+/*
+ * esmini - Environment Simulator Minimalistic
+ * https://github.com/esmini/esmini
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) partners of Simulation Scenarios
+ * https://sites.google.com/view/simulationscenarios
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <inttypes.h>
+
+#define TRACE_COMPRESSED_MAGIC 0x315a5345  // "ESZ1"
+#define TRACE_BLOCK_SIZE       (1024 * 1024)
+
+/*
+    Trace files, e.g. OSI ground truth, are written as a stream of bytes. In compressed mode the file starts with
+    TRACE_COMPRESSED_MAGIC (4 bytes) followed by blocks, each consisting of:
+        uint32 compressed size
+        uint32 uncompressed size
+        data, in LZ4 block format, or stored as is if compressed size equals uncompressed size
+    Decompressing all blocks in order gives the original stream, same as written in uncompressed mode.
+*/
+
+/**
+    Max size of compressed data, given size of input
+*/
+int LZ4CompressBound(int size);
+
+/**
+    Compress a block of data into LZ4 block format
+    @param src Data to compress
+    @param size Size of data in bytes
+    @param dst Destination, at least LZ4CompressBound(size) bytes
+    @return Size of compressed data
+*/
+int LZ4CompressBlock(const char* src, int size, char* dst);
+
+/**
+    Decompress a block of data in LZ4 block format
+    @param src Compressed data
+    @param size Size of compressed data in bytes
+    @param dst Destination
+    @param dst_capacity Size of destination buffer
+    @return Size of decompressed data, or -1 if data is corrupt or does not fit
+*/
+int LZ4DecompressBlock(const char* src, int size, char* dst, int dst_capacity);
+
+/**
+    Writes a trace file from a background thread. Data is collected in one buffer while the other one is compressed
+    (optionally) and written to file. The caller only waits if both buffers are full.
+*/
+class TraceFileWriter
+{
+public:
+    TraceFileWriter();
+    ~TraceFileWriter();
+
+    /**
+        Create file, overwriting any existing one
+        @param filename Filename, including path
+        @param compress Compress in blocks, see format above
+        @return 0 if successful, -1 if not
+    */
+    int  Open(std::string filename, bool compress = false);
+    void Close();
+    bool IsOpen()
+    {
+        return file_ != nullptr;
+    }
+    bool IsCompressed()
+    {
+        return compress_;
+    }
+
+    /**
+        Append data to the file
+        @return 0 if successful, -1 if file not open or earlier write failed
+    */
+    int Write(const void* data, size_t size);
+
+    /**
+        Write all data collected so far to file, and wait until done
+    */
+    void Flush();
+
+private:
+    void Submit(std::unique_lock<std::mutex>& lock);
+    void Run();
+    int  WriteBlock(const std::vector<char>& block);
+
+    FILE*                   file_;
+    bool                    compress_;
+    bool                    failed_;
+    bool                    busy_;  // back buffer handed over to writer thread
+    bool                    quit_;
+    std::vector<char>       front_;  // collecting data
+    std::vector<char>       back_;   // being written
+    std::vector<char>       compressed_;
+    std::mutex              mutex_;
+    std::condition_variable cv_;
+    std::thread             thread_;
+};
+
+/**
+    Reads trace files written by TraceFileWriter, compressed or not
+*/
+class TraceFileReader
+{
+public:
+    TraceFileReader() : file_(nullptr), compressed_(false), pos_(0)
+    {
+    }
+    ~TraceFileReader()
+    {
+        Close();
+    }
+
+    /**
+        Open file, detecting whether it's compressed
+        @return 0 if successful, -1 if not
+    */
+    int  Open(std::string filename);
+    void Close();
+    bool IsCompressed()
+    {
+        return compressed_;
+    }
+
+    /**
+        Read data from the uncompressed stream
+        @param data Destination
+        @param size Number of bytes to read
+        @return Number of bytes read, less than size at end of file, -1 on error
+    */
+    int Read(void* data, size_t size);
+
+private:
+    int ReadBlock();
+
+    FILE*             file_;
+    bool              compressed_;
+    std::vector<char> block_;  // current decompressed block
+    std::vector<char> compressed_block_;
+    size_t            pos_;  // read position in block_
+};
@@ -0,0 +1,77 @@
+/*
+ * esmini - Environment Simulator Minimalistic
+ * https://github.com/esmini/esmini
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) partners of Simulation Scenarios
+ * https://sites.google.com/view/simulationscenarios
+ */
+
+#pragma once
+
+#include <atomic>
+
+/**
+    Lock-free handover of latest state from one producer thread to one consumer thread, e.g. simulation to viewer.
+    The producer fills in the write buffer and publishes it, the consumer picks up the most recently published one.
+    Neither side ever waits. Intermediate states are dropped if the consumer is slower. Buffers are reused, so any
+    memory allocated by T (e.g. vectors) is recycled.
+*/
+template <class T>
+class SE_TripleBuffer
+{
+public:
+    SE_TripleBuffer() : write_(0), middle_(1), read_(2)
+    {
+    }
+
+    /**
+        Producer: Buffer to fill in. Content is what was written the last time this buffer was used, or default.
+    */
+    T& GetWriteBuffer()
+    {
+        return buffer_[write_];
+    }
+
+    /**
+        Producer: Hand over the write buffer to the consumer
+    */
+    void Publish()
+    {
+        write_ = middle_.exchange(write_ | NEW_DATA, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    /**
+        Consumer: Switch to most recently published buffer, if any
+        @return true if there was a new buffer, false if no new data since last call
+    */
+    bool Update()
+    {
+        if (!(middle_.load(std::memory_order_acquire) & NEW_DATA))
+        {
+            return false;
+        }
+        read_ = middle_.exchange(read_, std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+
+    /**
+        Consumer: Current buffer, stays the same until next successful Update()
+    */
+    const T& GetReadBuffer()
+    {
+        return buffer_[read_];
+    }
+
+private:
+    static constexpr unsigned int INDEX_MASK = 3;
+    static constexpr unsigned int NEW_DATA   = 4;  // middle buffer published but not yet picked up
+
+    T                         buffer_[3];
+    unsigned int              write_;   // owned by producer
+    std::atomic<unsigned int> middle_;  // index of buffer in between, and NEW_DATA flag
+    unsigned int              read_;    // owned by consumer
+};
@@ -11,13 +11,17 @@
  */
 
 #include <stdio.h>
+#include <string.h>
+#include <chrono>
 
 #ifndef _WIN32
 #include <sys/time.h>
+#include <sys/uio.h>
 #endif
 
 #include "UDP.hpp"
 #include "CommonMini.hpp"
+#include "Profiler.hpp"
 
 UDPBase::UDPBase(unsigned short int port) : port_(port), sock_(SE_INVALID_SOCKET)
 {
@@ -59,6 +63,17 @@ int UDPBase::Bind(struct sockaddr_in& addr)
     return 0;
 }
 
+int UDPBase::SetSendBufferSize(int size)
+{
+    if (setsockopt(sock_, SOL_SOCKET, SO_SNDBUF, reinterpret_cast<const char*>(&size), sizeof(size)) != 0)
+    {
+        LOG("Failed to set UDP send buffer size %d", size);
+        return -1;
+    }
+
+    return 0;
+}
+
 void UDPBase::CloseGracefully()
 {
 #ifdef _WIN32
@@ -126,4 +141,239 @@ int UDPClient::Send(char* buf, unsigned int size)
     // Casting to int can cause overflow in this situation. Not a good idea.
     // Let's fix it in a way that we actually return size_t and design the flow like that
     return static_cast<int>(sendto(sock_, buf, size, 0, reinterpret_cast<struct sockaddr*>(&server_addr_), sizeof(server_addr_)));
-}
\ No newline at end of file
+}
+
+int UDPClient::SendBatch(const char* const* headers, unsigned int header_size, const char* const* data, const unsigned int* data_sizes, int n)
+{
+    n = MIN(n, UDP_MAX_BATCH_SIZE);
+
+#ifdef __linux__
+    struct mmsghdr msgs[UDP_MAX_BATCH_SIZE];
+    struct iovec   iov[UDP_MAX_BATCH_SIZE][2];
+
+    memset(msgs, 0, static_cast<size_t>(n) * sizeof(struct mmsghdr));
+    for (int i = 0; i < n; i++)
+    {
+        iov[i][0].iov_base          = const_cast<char*>(headers[i]);
+        iov[i][0].iov_len           = header_size;
+        iov[i][1].iov_base          = const_cast<char*>(data[i]);
+        iov[i][1].iov_len           = data_sizes[i];
+        msgs[i].msg_hdr.msg_name    = &server_addr_;
+        msgs[i].msg_hdr.msg_namelen = sizeof(server_addr_);
+        msgs[i].msg_hdr.msg_iov     = iov[i];
+        msgs[i].msg_hdr.msg_iovlen  = 2;
+    }
+
+    int n_sent = 0;
+    while (n_sent < n)
+    {
+        int retval = sendmmsg(sock_, &msgs[n_sent], static_cast<unsigned int>(n - n_sent), 0);
+        if (retval <= 0)
+        {
+            break;
+        }
+        n_sent += retval;
+    }
+
+    return n_sent;
+#else
+    static thread_local std::vector<char> buf;
+    int                                    n_sent = 0;
+
+    for (; n_sent < n; n_sent++)
+    {
+        unsigned int size = header_size + data_sizes[n_sent];
+        if (buf.size() < size)
+        {
+            buf.resize(size);
+        }
+        memcpy(buf.data(), headers[n_sent], header_size);
+        memcpy(buf.data() + header_size, data[n_sent], data_sizes[n_sent]);
+        if (Send(buf.data(), size) != static_cast<int>(size))
+        {
+            break;
+        }
+    }
+
+    return n_sent;
+#endif
+}
+
+UDPFrameSender::UDPFrameSender(unsigned short int port, std::string ipAddress, unsigned int fragment_size)
+    : client_(port, ipAddress),
+      fragment_size_(MAX(1, fragment_size)),
+      burst_size_(0),
+      gap_us_(0),
+      queued_size_(0),
+      queued_ready_(false),
+      busy_(false),
+      quit_(false),
+      stats_({0, 0, 0, 0.0, 0.0, 0.0})
+{
+    thread_ = std::thread(&UDPFrameSender::Run, this);
+}
+
+UDPFrameSender::~UDPFrameSender()
+{
+    // send any queued frame before quitting
+    Flush();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        quit_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+}
+
+void UDPFrameSender::SetPacing(int burst_size, int gap_us)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    burst_size_ = MAX(0, burst_size);
+    gap_us_     = MAX(0, gap_us);
+}
+
+int UDPFrameSender::Send(const char* data, size_t size)
+{
+    if (GetStatus() != 0)
+    {
+        return -1;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (queued_ready_)
+        {
+            // sender thread is still busy with an earlier frame, replace the one waiting
+            stats_.frames_dropped++;
+        }
+        if (queued_.size() < size)
+        {
+            queued_.resize(size);
+        }
+        memcpy(queued_.data(), data, size);
+        queued_size_  = size;
+        queued_ready_ = true;
+    }
+    cv_.notify_all();
+
+    return 0;
+}
+
+void UDPFrameSender::Flush()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return !queued_ready_ && !busy_; });
+}
+
+UDPFrameSender::Stats UDPFrameSender::GetStats()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void UDPFrameSender::Run()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (true)
+    {
+        cv_.wait(lock, [this] { return queued_ready_ || quit_; });
+
+        if (!queued_ready_)
+        {
+            break;  // quit
+        }
+
+        std::swap(queued_, sending_);
+        size_t size   = queued_size_;
+        queued_ready_ = false;
+        busy_         = true;
+        lock.unlock();
+
+        SendFrame(size);
+
+        lock.lock();
+        busy_ = false;
+        cv_.notify_all();
+    }
+}
+
+void UDPFrameSender::SendFrame(size_t size)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    int burst_size;
+    int gap_us;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        burst_size = burst_size_;
+        gap_us     = gap_us_;
+    }
+
+    int n_fragments = static_cast<int>((size + fragment_size_ - 1) / fragment_size_);
+    if (static_cast<int>(headers_.size()) < n_fragments)
+    {
+        headers_.resize(static_cast<size_t>(n_fragments));
+    }
+
+    const char*  header_ptrs[UDP_MAX_BATCH_SIZE];
+    const char*  data_ptrs[UDP_MAX_BATCH_SIZE];
+    unsigned int data_sizes[UDP_MAX_BATCH_SIZE];
+    int          max_batch   = burst_size > 0 ? MIN(burst_size, UDP_MAX_BATCH_SIZE) : UDP_MAX_BATCH_SIZE;
+    int          n_sent      = 0;
+    int          burst_count = 0;
+    bool         failed      = false;
+
+    while (n_sent < n_fragments && !failed)
+    {
+        int n = MIN(n_fragments - n_sent, max_batch);
+        if (burst_size > 0)
+        {
+            n = MIN(n, burst_size - burst_count);
+        }
+
+        for (int i = 0; i < n; i++)
+        {
+            int    fragment = n_sent + i;
+            size_t offset   = static_cast<size_t>(fragment) * fragment_size_;
+
+            headers_[static_cast<size_t>(fragment)].counter  = fragment == n_fragments - 1 ? -(fragment + 1) : fragment + 1;
+            headers_[static_cast<size_t>(fragment)].datasize = static_cast<unsigned int>(MIN(size - offset, static_cast<size_t>(fragment_size_)));
+            header_ptrs[i]                                   = reinterpret_cast<const char*>(&headers_[static_cast<size_t>(fragment)]);
+            data_ptrs[i]                                     = sending_.data() + offset;
+            data_sizes[i]                                    = headers_[static_cast<size_t>(fragment)].datasize;
+        }
+
+        int retval = client_.SendBatch(header_ptrs, sizeof(UDPFragmentHeader), data_ptrs, data_sizes, n);
+        if (retval != n)
+        {
+            LOG("Failed send UDP frame, %d of %d fragments sent", n_sent + MAX(0, retval), n_fragments);
+            failed = true;
+        }
+        n_sent += n;
+        burst_count += n;
+
+        if (burst_size > 0 && burst_count >= burst_size && n_sent < n_fragments)
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(gap_us));
+            burst_count = 0;
+        }
+    }
+
+    double send_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (failed)
+    {
+        stats_.frames_failed++;
+    }
+    else
+    {
+        stats_.frames_sent++;
+        SE_Profiler::Count(SE_Profiler::Counter::OSI_BYTES_SENT, static_cast<int64_t>(size));
+    }
+    stats_.send_time_last = send_time;
+    stats_.send_time_max  = MAX(stats_.send_time_max, send_time);
+    stats_.send_time_sum += send_time;
+}
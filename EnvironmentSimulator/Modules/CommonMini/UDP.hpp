@@ -13,6 +13,11 @@
 #pragma once
 
 #include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <inttypes.h>
 
 // UDP network includes
 #ifdef _WIN32
@@ -26,7 +31,9 @@
 #include <unistd.h> /* Needed for close() */
 #endif
 
-#define ESMINI_DEFAULT_INPORT 48199
+#define ESMINI_DEFAULT_INPORT     48199
+#define UDP_MAX_BATCH_SIZE        64    // max number of datagrams per system call
+#define UDP_DEFAULT_FRAGMENT_SIZE 8192  // default max payload of each fragment, excluding header
 
 #ifdef _WIN32
 typedef SOCKET SE_SOCKET;
@@ -44,6 +51,13 @@ public:
         return sock_ == SE_INVALID_SOCKET ? -1 : 0;
     }  // -1 = NOK, 0 = OK
 
+    /**
+        Set size of the socket send buffer (SO_SNDBUF)
+        @param size Requested size in bytes, the system might adjust it
+        @return 0 if successful, -1 if not
+    */
+    int SetSendBufferSize(int size);
+
 protected:
     UDPBase(unsigned short int port);
     ~UDPBase()
@@ -88,7 +102,19 @@ public:
     ~UDPClient()
     {
     }
-    int            Send(char* buf, unsigned int size);
+    int Send(char* buf, unsigned int size);
+
+    /**
+        Send a number of datagrams, each composed of a header and a data part, in as few system calls as possible
+        (sendmmsg on Linux, one send per datagram on other platforms)
+        @param headers Pointers to header of each datagram
+        @param header_size Size of each header in bytes
+        @param data Pointers to data part of each datagram
+        @param data_sizes Size of each data part in bytes
+        @param n Number of datagrams, max UDP_MAX_BATCH_SIZE
+        @return Number of datagrams successfully sent
+    */
+    int            SendBatch(const char* const* headers, unsigned int header_size, const char* const* data, const unsigned int* data_sizes, int n);
     unsigned short GetPort()
     {
         return port_;
@@ -100,4 +126,90 @@ public:
 
 private:
     std::string ipAddress_;
-};
\ No newline at end of file
+};
+
+/**
+    Sends frames, e.g. serialized OSI messages, split into datagrams on a separate thread so the caller never waits for
+    the network stack. Each datagram starts with a UDPFragmentHeader, where counter runs from 1 and is negated for the
+    last fragment of a frame. Only the most recent frame is kept in the queue, if a new frame is queued before the
+    previous one has been picked up by the sender thread, the previous one is dropped.
+*/
+class UDPFrameSender
+{
+public:
+    typedef struct
+    {
+        int          counter;   // fragment number, starting at 1, negative for last fragment of frame
+        unsigned int datasize;  // size of fragment payload in bytes
+    } UDPFragmentHeader;
+
+    typedef struct
+    {
+        uint64_t frames_sent;     // number of frames completely sent
+        uint64_t frames_dropped;  // number of frames replaced by newer frames before being sent
+        uint64_t frames_failed;   // number of frames not completely sent due to socket errors
+        double   send_time_last;  // time to send the last frame, in seconds
+        double   send_time_max;   // max time to send a frame, in seconds
+        double   send_time_sum;   // accumulated time to send all frames, in seconds
+    } Stats;
+
+    /**
+        @param port Receiver port
+        @param ipAddress Receiver IP address
+        @param fragment_size Max payload of each datagram, excluding header
+    */
+    UDPFrameSender(unsigned short int port, std::string ipAddress, unsigned int fragment_size = UDP_DEFAULT_FRAGMENT_SIZE);
+    ~UDPFrameSender();
+
+    int GetStatus()
+    {
+        return client_.GetStatus();
+    }  // -1 = NOK, 0 = OK
+
+    int SetSendBufferSize(int size)
+    {
+        return client_.SetSendBufferSize(size);
+    }
+
+    /**
+        Limit the send rate, to avoid overflowing network or receiver buffers
+        @param burst_size Number of datagrams sent back to back, 0 = no limit
+        @param gap_us Pause between bursts, in microseconds
+    */
+    void SetPacing(int burst_size, int gap_us);
+
+    /**
+        Queue a frame for sending. The data is copied, so the buffer can be reused as soon as the function returns.
+        @param data Frame data
+        @param size Frame size in bytes
+        @return 0 if successful, -1 if socket not OK
+    */
+    int Send(const char* data, size_t size);
+
+    /**
+        Wait until the queued frame, if any, has been sent
+    */
+    void Flush();
+
+    Stats GetStats();
+
+private:
+    void Run();
+    void SendFrame(size_t size);
+
+    UDPClient                      client_;
+    unsigned int                   fragment_size_;
+    int                            burst_size_;
+    int                            gap_us_;
+    std::vector<char>              queued_;   // frame waiting to be sent
+    std::vector<char>              sending_;  // frame being sent, swapped with queued_
+    size_t                         queued_size_;
+    bool                           queued_ready_;
+    bool                           busy_;
+    bool                           quit_;
+    Stats                          stats_;
+    std::vector<UDPFragmentHeader> headers_;
+    std::mutex                     mutex_;
+    std::condition_variable        cv_;
+    std::thread                    thread_;
+};
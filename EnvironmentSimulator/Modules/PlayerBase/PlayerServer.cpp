@@ -168,7 +168,7 @@ namespace scenarioengine
         }
     }
 
-    void PlayerServer::InjectSpeedAction(SpeedActionStruct &action)
+    void PlayerServer::AddSpeedAction(const SpeedActionStruct &action)
     {
         LongSpeedAction *a = new LongSpeedAction(nullptr);
         a->SetName("SpeedAction_" + std::to_string(counter_));
@@ -186,7 +186,7 @@ namespace scenarioengine
         AddAction(a);
     }
 
-    void PlayerServer::InjectLaneChangeAction(LaneChangeActionStruct &action)
+    void PlayerServer::AddLaneChangeAction(const LaneChangeActionStruct &action)
     {
         LatLaneChangeAction *a = new LatLaneChangeAction(nullptr);
         a->SetName("LaneChangeAction_" + std::to_string(counter_));
@@ -214,7 +214,7 @@ namespace scenarioengine
         AddAction(a);
     }
 
-    void PlayerServer::InjectLaneOffsetAction(LaneOffsetActionStruct &action)
+    void PlayerServer::AddLaneOffsetAction(const LaneOffsetActionStruct &action)
     {
         LatLaneOffsetAction *a = new LatLaneOffsetAction(nullptr);
         a->SetName("LaneOffsetAction_" + std::to_string(counter_));
@@ -231,8 +231,86 @@ namespace scenarioengine
         AddAction(a);
     }
 
+    int PlayerServer::QueueAction(const ActionStruct &action)
+    {
+        if (action.action_type != static_cast<int>(UDP_ACTION_TYPE::SPEED_ACTION) &&
+            action.action_type != static_cast<int>(UDP_ACTION_TYPE::LANE_CHANGE_ACTION) &&
+            action.action_type != static_cast<int>(UDP_ACTION_TYPE::LANE_OFFSET_ACTION))
+        {
+            LOG("Action of type %d can't be injected", action.action_type);
+            return -1;
+        }
+
+        // count before pushing, so that the action is reported ongoing from now on
+        n_queued_[action.action_type]++;
+        if (!queue_.Push(action))
+        {
+            n_queued_[action.action_type]--;
+            LOG("Injected action queue full (%d), skipping %s action", static_cast<int>(queue_.GetCapacity()), Type2Name(static_cast<UDP_ACTION_TYPE>(action.action_type)).c_str());
+            return -1;
+        }
+
+        return 0;
+    }
+
+    int PlayerServer::InjectSpeedAction(SpeedActionStruct &action)
+    {
+        ActionStruct a;
+        a.action_type   = static_cast<int>(UDP_ACTION_TYPE::SPEED_ACTION);
+        a.message.speed = action;
+        return QueueAction(a);
+    }
+
+    int PlayerServer::InjectLaneChangeAction(LaneChangeActionStruct &action)
+    {
+        ActionStruct a;
+        a.action_type        = static_cast<int>(UDP_ACTION_TYPE::LANE_CHANGE_ACTION);
+        a.message.laneChange = action;
+        return QueueAction(a);
+    }
+
+    int PlayerServer::InjectLaneOffsetAction(LaneOffsetActionStruct &action)
+    {
+        ActionStruct a;
+        a.action_type        = static_cast<int>(UDP_ACTION_TYPE::LANE_OFFSET_ACTION);
+        a.message.laneOffset = action;
+        return QueueAction(a);
+    }
+
+    void PlayerServer::ProcessQueue()
+    {
+        ActionStruct a;
+
+        while (queue_.Pop(a))
+        {
+            switch (a.action_type)
+            {
+                case static_cast<int>(UDP_ACTION_TYPE::SPEED_ACTION):
+                    AddSpeedAction(a.message.speed);
+                    break;
+                case static_cast<int>(UDP_ACTION_TYPE::LANE_CHANGE_ACTION):
+                    AddLaneChangeAction(a.message.laneChange);
+                    break;
+                case static_cast<int>(UDP_ACTION_TYPE::LANE_OFFSET_ACTION):
+                    AddLaneOffsetAction(a.message.laneOffset);
+                    break;
+                default:
+                    break;
+            }
+            n_queued_[a.action_type]--;
+        }
+    }
+
     bool PlayerServer::InjectedActionOngoing(int action_type)
     {
+        for (int i = 0; i < static_cast<int>(UDP_ACTION_TYPE::NR_OF_ACTIONS); i++)
+        {
+            if (n_queued_[i] > 0 && (action_type < 0 || Type2OSCActionType(static_cast<UDP_ACTION_TYPE>(i)) == static_cast<OSCAction::ActionType>(action_type)))
+            {
+                return true;
+            }
+        }
+
         if (action_type < 0)
         {
             return action_.size() > 0;
@@ -281,13 +359,10 @@ namespace scenarioengine
                 switch (buf.action_type)
                 {
                     case static_cast<int>(UDP_ACTION_TYPE::SPEED_ACTION):
-                        player->player_server_->InjectSpeedAction(buf.message.speed);
-                        break;
                     case static_cast<int>(UDP_ACTION_TYPE::LANE_CHANGE_ACTION):
-                        player->player_server_->InjectLaneChangeAction(buf.message.laneChange);
-                        break;
                     case static_cast<int>(UDP_ACTION_TYPE::LANE_OFFSET_ACTION):
-                        player->player_server_->InjectLaneOffsetAction(buf.message.laneOffset);
+                        // added to the scenario by the simulation thread at start of next frame
+                        player->player_server_->QueueAction(buf);
                         break;
                     case static_cast<int>(UDP_ACTION_TYPE::PLAY):
                         player->SetState(ScenarioPlayer::PlayerState::PLAYER_STATE_PLAYING);
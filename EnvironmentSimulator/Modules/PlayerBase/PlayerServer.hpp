@@ -16,9 +16,12 @@
 #include <stdlib.h>
 #include <errno.h>
 #include <string.h>
+#include <atomic>
 #include "Storyboard.hpp"
+#include "MPSCQueue.hpp"
 
 #define ESMINI_DEFAULT_ACTION_INPORT 48197
+#define PLAYER_SERVER_QUEUE_SIZE     256  // max number of injected actions waiting for next step
 
 namespace scenarioengine
 {
@@ -82,12 +85,21 @@ namespace scenarioengine
 
     class ScenarioPlayer;  // forward declaration
 
+    /**
+        Receives actions from UDP (see --player_server) and esminiLib SE_Inject*() functions. Actions are put in a
+        lock-free queue by the receiving thread and turned into OSC actions by the simulation thread at start of next
+        frame, see ProcessQueue(). Hence producers never wait for the simulation and vice versa.
+    */
     class PlayerServer
     {
     public:
-        PlayerServer(ScenarioPlayer* player)
+        PlayerServer(ScenarioPlayer* player) : queue_(PLAYER_SERVER_QUEUE_SIZE)
         {
             player_ = player;
+            for (auto& n : n_queued_)
+            {
+                n.store(0);
+            }
         }
         ~PlayerServer();
         void Reset()
@@ -95,11 +107,21 @@ namespace scenarioengine
             counter_ = 0;
         }
 
-        void InjectSpeedAction(SpeedActionStruct& action);
-        void InjectLaneChangeAction(LaneChangeActionStruct& action);
-        void InjectLaneOffsetAction(LaneOffsetActionStruct& action);
+        /**
+            Any thread: Queue action for injection at start of next frame
+            @return 0 if successful, -1 if queue is full or unsupported action type
+        */
+        int  QueueAction(const ActionStruct& action);
+        int  InjectSpeedAction(SpeedActionStruct& action);
+        int  InjectLaneChangeAction(LaneChangeActionStruct& action);
+        int  InjectLaneOffsetAction(LaneOffsetActionStruct& action);
         bool InjectedActionOngoing(int action_type = -1);
 
+        /**
+            Simulation thread: Create and add all queued actions
+        */
+        void ProcessQueue();
+
         int                                      AddAction(OSCAction* action);
         void                                     DeleteAction(unsigned int index);
         int                                      NumberOfActions();
@@ -115,9 +137,15 @@ namespace scenarioengine
         void Stop();
 
     private:
-        std::vector<OSCAction*> action_;
-        ScenarioPlayer*         player_;
-        unsigned int            counter_ = 0;
+        void AddSpeedAction(const SpeedActionStruct& action);
+        void AddLaneChangeAction(const LaneChangeActionStruct& action);
+        void AddLaneOffsetAction(const LaneOffsetActionStruct& action);
+
+        std::vector<OSCAction*>    action_;
+        ScenarioPlayer*            player_;
+        unsigned int               counter_ = 0;
+        SE_MPSCQueue<ActionStruct> queue_;
+        std::atomic<int>           n_queued_[static_cast<int>(UDP_ACTION_TYPE::NR_OF_ACTIONS)];  // per type, not yet processed
     };
 
 }  // namespace scenarioengine
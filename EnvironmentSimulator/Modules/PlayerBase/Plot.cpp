@@ -28,9 +28,11 @@ Plot::Plot(ScenarioEngine* scenarioengine, bool synchronous)
     }
 
     // Populate objects we want to plot and default settings for the checkbox selections
-    for (size_t i = 0; i < scenarioengine_->entities_.object_.size(); i++)
+    Publish();
+    snapshot_.Update();
+    for (size_t i = 0; i < snapshot_.GetReadBuffer().objects.size(); i++)
     {
-        plot_objects_.emplace_back(std::make_unique<PlotObject>(scenarioengine_->entities_.object_[i]));
+        plot_objects_.emplace_back(std::make_unique<PlotObject>(snapshot_.GetReadBuffer().objects[i]));
         (i == 0) ? selected_object_.push_back(true) : selected_object_.push_back(false);
     }
 
@@ -101,13 +103,47 @@ void Plot::CleanUp()
     window = nullptr;
 }
 
-void Plot::updateData(std::vector<Object*>& objects, double time)
+void Plot::Publish()
+{
+    // Called from the simulation thread, so entities can be read without locking
+    PlotSnapshot& snapshot = snapshot_.GetWriteBuffer();
+
+    snapshot.time = scenarioengine_->getSimulationTime();
+    snapshot.objects.resize(scenarioengine_->entities_.object_.size());
+
+    for (size_t i = 0; i < scenarioengine_->entities_.object_.size(); i++)
+    {
+        Object*          object = scenarioengine_->entities_.object_[i];
+        PlotObjectState& state  = snapshot.objects[i];
+        double           lat, lon;
+
+        state.name      = object->GetName();
+        state.max_acc   = static_cast<float>(object->GetMaxAcceleration());
+        state.max_decel = static_cast<float>(-object->GetMaxDeceleration());
+        state.max_speed = static_cast<float>(object->GetMaxSpeed());
+
+        object->pos_.GetVelLatLong(lat, lon);
+        state.lat_vel  = static_cast<float>(lat);
+        state.long_vel = static_cast<float>(lon);
+
+        object->pos_.GetAccLatLong(lat, lon);
+        state.lat_acc  = static_cast<float>(lat);
+        state.long_acc = static_cast<float>(lon);
+
+        state.lane_offset = static_cast<float>(object->pos_.GetOffset());
+        state.lane_id     = static_cast<float>(object->pos_.GetLaneId());
+    }
+
+    snapshot_.Publish();
+}
+
+void Plot::updateData(const PlotSnapshot& snapshot)
 {
-    if (plot_objects_.size() < scenarioengine_->entities_.object_.size())
+    if (plot_objects_.size() < snapshot.objects.size())
     {
-        for (const auto& object : scenarioengine_->entities_.object_)
+        for (const auto& object : snapshot.objects)
         {
-            const std::string name = object->GetName();
+            const std::string& name = object.name;
             auto val = std::find_if(plot_objects_.begin(), plot_objects_.end(), [&name](const auto& obj) { return obj->getName() == name; });
             if (val == plot_objects_.end())
             {
@@ -119,9 +155,9 @@ void Plot::updateData(std::vector<Object*>& objects, double time)
     // TODO:
     // else if (plot_objects_.size() > scen...)
     // should remove the checkbox and data in some smart way
-    for (size_t i = 0; i < objects.size(); i++)
+    for (size_t i = 0; i < snapshot.objects.size() && i < plot_objects_.size(); i++)
     {
-        plot_objects_[i]->updateData(objects[i], time);
+        plot_objects_[i]->updateData(snapshot.objects[i], snapshot.time);
     }
 }
 
@@ -310,9 +346,11 @@ int Plot::Frame()
     ImGui::NewFrame();
     glfwGetWindowSize(window, &window_w, &window_h);
 
-    scenarioengine_->mutex_.Lock();
-    updateData(scenarioengine_->entities_.object_, scenarioengine_->getSimulationTime());
-    scenarioengine_->mutex_.Unlock();
+    // only add data when the simulation has published a new frame
+    if (snapshot_.Update())
+    {
+        updateData(snapshot_.GetReadBuffer());
+    }
     renderPlot("Line plot");
 
     // Rendering
@@ -396,37 +434,33 @@ void Plot::glfw_error_callback(int error, const char* description)
 // Plot
 
 // PlotObject
-Plot::PlotObject::PlotObject(Object* object)
+Plot::PlotObject::PlotObject(const PlotObjectState& state)
     : time_max_(30.0f),
-      max_acc_(static_cast<float>(object->GetMaxAcceleration())),
-      max_decel_(static_cast<float>(-object->GetMaxDeceleration())),
-      max_speed_(static_cast<float>(object->GetMaxSpeed())),
-      name_(object->GetName())
+      max_acc_(state.max_acc),
+      max_decel_(state.max_decel),
+      max_speed_(state.max_speed),
+      name_(state.name)
 {
 }
 
-void Plot::PlotObject::updateData(Object* object, double time)
+void Plot::PlotObject::updateData(const PlotObjectState& state, double time)
 {
     // Update Time
     plotData[PlotCategories::Time].push_back(static_cast<float>(time));
 
     // Update Velocity Lat./Long
-    double lat_vel, long_vel;
-    object->pos_.GetVelLatLong(lat_vel, long_vel);
-    plotData[PlotCategories::LatVel].push_back(static_cast<float>(lat_vel));
-    plotData[PlotCategories::LongVel].push_back(static_cast<float>(long_vel));
+    plotData[PlotCategories::LatVel].push_back(state.lat_vel);
+    plotData[PlotCategories::LongVel].push_back(state.long_vel);
 
     // Update Lat./Long. Acceleration
-    double lat_acc, long_acc;
-    object->pos_.GetAccLatLong(lat_acc, long_acc);
-    plotData[PlotCategories::LongA].push_back(static_cast<float>(long_acc));
-    plotData[PlotCategories::LatA].push_back(static_cast<float>(lat_acc));
+    plotData[PlotCategories::LongA].push_back(state.long_acc);
+    plotData[PlotCategories::LatA].push_back(state.lat_acc);
 
     // Update Lane offset
-    plotData[PlotCategories::LaneOffset].push_back(static_cast<float>(object->pos_.GetOffset()));
+    plotData[PlotCategories::LaneOffset].push_back(state.lane_offset);
 
     // Update Lane ID
-    plotData[PlotCategories::LaneID].push_back(static_cast<float>(object->pos_.GetLaneId()));
+    plotData[PlotCategories::LaneID].push_back(state.lane_id);
 }
 
 float Plot::PlotObject::getTimeMax()
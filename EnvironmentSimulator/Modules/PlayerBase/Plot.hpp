@@ -15,6 +15,7 @@
 #include "imgui_impl_glfw.h"
 #include "imgui_impl_opengl3.h"
 #include "ScenarioEngine.hpp"
+#include "TripleBuffer.hpp"
 #include <stdio.h>
 #include <vector>
 #include <unordered_map>
@@ -52,6 +53,27 @@ enum class PlotCategories
 class Plot
 {
 public:
+    // State of an entity, copied from the scenario engine each frame
+    struct PlotObjectState
+    {
+        std::string name;
+        float       max_acc;
+        float       max_decel;
+        float       max_speed;
+        float       lat_vel;
+        float       long_vel;
+        float       lat_acc;
+        float       long_acc;
+        float       lane_offset;
+        float       lane_id;
+    };
+
+    struct PlotSnapshot
+    {
+        double                       time = 0.0;
+        std::vector<PlotObjectState> objects;
+    };
+
     Plot(ScenarioEngine* scenarioengine, bool synchronous = false);
     ~Plot();
     int  Frame();
@@ -63,7 +85,11 @@ public:
         return !thread_.joinable();
     }
 
-    void        updateData(std::vector<Object*>& objects, double dt);
+    /**
+        Hand over current state of all entities to the plot, call from simulation thread after each frame
+    */
+    void        Publish();
+    void        updateData(const PlotSnapshot& snapshot);
     void        renderPlot(const char* name);  //, float window_width, float window_height);
     void        plotLine(std::string plot_name, std::string unit, PlotCategories x, PlotCategories y, size_t lineplot_objects);
     void        adjustPlotDataAxis(const std::pair<const PlotCategories, std::vector<float>>& d, const size_t item);
@@ -77,8 +103,8 @@ private:
     {
     public:
         // PlotObject(float max_acc, float max_decel, float max_speed);
-        PlotObject(Object* object);
-        void updateData(Object* object, double time);
+        PlotObject(const PlotObjectState& state);
+        void updateData(const PlotObjectState& state, double time);
 
         // Getters
         float       getTimeMax();
@@ -134,9 +160,10 @@ private:
     float             time_axis_min_       = -5.0f;
 
     // Runtime variables
-    ScenarioEngine* scenarioengine_;
-    bool            initialized_ = false;
-    std::thread     thread_;
+    ScenarioEngine*               scenarioengine_;
+    SE_TripleBuffer<PlotSnapshot> snapshot_;  // from simulation thread, see Publish()
+    bool                          initialized_ = false;
+    std::thread                   thread_;
 };
 
 #endif  // PLOT_H
\ No newline at end of file
@@ -18,6 +18,8 @@
 #include "ScenarioEngine.hpp"
 #include "RoadManager.hpp"
 #include "CommonMini.hpp"
+#include "Profiler.hpp"
+#include "TaskPool.hpp"
 #include "Server.hpp"
 #include "playerbase.hpp"
 #include "helpText.hpp"
@@ -66,6 +68,10 @@ ScenarioPlayer::ScenarioPlayer(int argc, char* argv[])
     osiReporter          = NULL;
     disable_controllers_ = false;
     frame_counter_       = 0;
+    batch_mode_          = false;
+    batch_start_time_    = 0;
+    perf_summary_        = false;
+    phase_timing_        = false;
     scenarioEngine       = nullptr;
     osiReporter          = nullptr;
     viewer_              = nullptr;
@@ -83,6 +89,9 @@ ScenarioPlayer::ScenarioPlayer(int argc, char* argv[])
 
 ScenarioPlayer::~ScenarioPlayer()
 {
+    // finish writing any pending frames before files are closed
+    output_pipeline_.Stop();
+
     if (launch_server)
     {
         StopServer();
@@ -113,6 +122,28 @@ ScenarioPlayer::~ScenarioPlayer()
         delete s;
     }
 
+    if (batch_mode_)
+    {
+        LogBatchStatistics();
+    }
+
+    if (perf_summary_)
+    {
+        SE_Profiler::LogCounters();
+    }
+
+    // write any profiling results
+    SE_Profiler::Inst().Disable();
+    if (phase_timing_)
+    {
+        SE_Profiler::SetPhaseTiming(false);
+    }
+
+    if (pacer_.IsActive())
+    {
+        pacer_.LogStatistics();
+    }
+
     Logger::Inst().SetTimePtr(0);
     if (scenarioEngine)
     {
@@ -170,6 +201,7 @@ void ScenarioPlayer::Draw()
         {
             if (!viewer_->GetQuitRequest())
             {
+                SE_PROFILE_SCOPE(VIEWER);
                 ViewerFrame();
             }
 
@@ -189,6 +221,8 @@ int ScenarioPlayer::Frame(double timestep_s, bool server_mode)
     int         retval        = 0;
     double      ghost_solo_dt = 0.05;
 
+    SE_PROFILE_SCOPE(FRAME);
+
     if (!IsPaused() || server_mode)
     {
 #ifdef _USE_OSI
@@ -201,7 +235,16 @@ int ScenarioPlayer::Frame(double timestep_s, bool server_mode)
         {
             while (retval == 0 && SE_Env::Inst().GetGhostMode() != GhostMode::NORMAL && !IsQuitRequested())
             {
-                Draw();
+                if (!batch_mode_)
+                {
+#ifdef _USE_OSG
+                    // the snapshot takes the player mutex, never hold both
+                    scenarioEngine->mutex_.Unlock();
+                    PublishViewerSnapshot();
+                    scenarioEngine->mutex_.Lock();
+#endif
+                    Draw();
+                }
                 if (!IsPaused() && !IsQuitRequested())
                 {
                     retval = ScenarioFrame(ghost_solo_dt, false);
@@ -219,9 +262,17 @@ int ScenarioPlayer::Frame(double timestep_s, bool server_mode)
             SetState(PlayerState::PLAYER_STATE_PAUSE);
         }
         scenarioEngine->mutex_.Unlock();
+
+#ifdef _USE_OSG
+        if (!batch_mode_)
+        {
+            // after releasing the engine, the snapshot only takes the player mutex, briefly held by the viewer thread
+            PublishViewerSnapshot();
+        }
+#endif
     }
 
-    if (!server_mode)
+    if (!server_mode && !batch_mode_)
     {
         Draw();
 
@@ -260,8 +311,17 @@ int ScenarioPlayer::ScenarioFrame(double timestep_s, bool keyframe)
     int retval = 0;
     mutex.Lock();
 
+    if (player_server_)
+    {
+        // add actions injected since last frame, from network or API threads
+        player_server_->ProcessQueue();
+    }
+
     if ((retval = scenarioEngine->step(timestep_s)) == 0)
     {
+        SE_Profiler::Count(SE_Profiler::Counter::FRAMES);
+        SE_Profiler::SetCounter(SE_Profiler::Counter::ENTITIES, static_cast<int64_t>(scenarioEngine->entities_.object_.size()));
+
         if (keyframe)
         {
             // Check for any callbacks to be made
@@ -277,15 +337,29 @@ int ScenarioPlayer::ScenarioFrame(double timestep_s, bool keyframe)
             }
         }
 
-        scenarioEngine->prepareGroundTruth(timestep_s);
+        {
+            SE_PROFILE_SCOPE(GROUND_TRUTH);
+            scenarioEngine->prepareGroundTruth(timestep_s);
+        }
 
         if (SE_Env::Inst().GetGhostMode() != GhostMode::RESTART)
         {
-            scenarioGateway->WriteStatesToFile();
-
-            if (CSV_Log)
+            if (output_pipeline_.IsActive())
             {
-                UpdateCSV_Log();
+                SubmitFrameOutput();
+            }
+            else
+            {
+                {
+                    SE_PROFILE_SCOPE(RECORD);
+                    scenarioGateway->WriteStatesToFile();
+                }
+
+                if (CSV_Log)
+                {
+                    SE_PROFILE_SCOPE(CSV_LOG);
+                    UpdateCSV_Log();
+                }
             }
         }
 
@@ -304,17 +378,61 @@ int ScenarioPlayer::ScenarioFrame(double timestep_s, bool keyframe)
     return retval;
 }
 
+void ScenarioPlayer::SubmitFrameOutput()
+{
+    // Capture the output of this frame, then format and write it on the worker thread while next frame is simulated.
+    // OSI ground truth and sensor data are not pipelined, they are still updated in ScenarioPostFrame(). The OSI
+    // reporter builds its messages from the live entities, road network and sensors, not from a snapshot like the
+    // states captured here. Also API users read OSI data right after the step, e.g. SE_GetOSIGroundTruth(), so it
+    // can't lag behind the simulation.
+    std::vector<ObjectStateStructDat> dat_states;
+    std::vector<CSV_LogEntry>         csv_entries;
+
+    if (scenarioGateway->IsRecording())
+    {
+        SE_PROFILE_SCOPE(RECORD);
+        scenarioGateway->GetDatStates(dat_states);
+    }
+
+    if (CSV_Log)
+    {
+        SE_PROFILE_SCOPE(CSV_LOG);
+        GetCSV_LogEntries(csv_entries);
+    }
+
+    if (dat_states.empty() && csv_entries.empty())
+    {
+        return;
+    }
+
+    double time = scenarioEngine->getSimulationTime();
+    output_pipeline_.Submit(
+        [this, time, dat_states = std::move(dat_states), csv_entries = std::move(csv_entries)]()
+        {
+            scenarioGateway->WriteDatStatesToFile(dat_states);
+            WriteCSV_Log(time, csv_entries);
+        });
+}
+
 void ScenarioPlayer::ScenarioPostFrame()
 {
     mutex.Lock();
 
-    for (size_t i = 0; i < sensor.size(); i++)
     {
-        sensor[i]->Update();
+        SE_PROFILE_SCOPE(SENSORS);
+        if (sensor.size() > 0)
+        {
+            // one grid for all sensors, then sensors are independent
+            sensorGrid.Build(&scenarioEngine->entities_);
+            SE_TaskPool::Inst().ParallelFor(static_cast<int>(sensor.size()),
+                                            [this](int i) { sensor[static_cast<unsigned int>(i)]->Update(sensorGrid); });
+        }
     }
 #ifdef _USE_OSI
     if (NEAR_NUMBERS(scenarioEngine->getSimulationTime(), scenarioEngine->GetTrueTime()))
     {
+        SE_PROFILE_SCOPE(OSI);
+
         // Update OSI info
         if (osi_freq_ > 0)
         {
@@ -342,90 +460,209 @@ void ScenarioPlayer::ScenarioPostFrame()
 }
 
 #ifdef _USE_OSG
-void ScenarioPlayer::ViewerFrame(bool init)
+void ScenarioPlayer::PublishViewerSnapshot()
 {
     if (viewer_ == nullptr)
     {
         return;
     }
 
-    static double last_dot_time = scenarioEngine->getSimulationTime();
-    (void)last_dot_time;
+    ViewerSnapshot& snapshot     = viewerSnapshot_.GetWriteBuffer();
+    bool            road_sensors = odr_manager->GetNumOfRoads() > 0 && viewer_->GetNodeMaskBit(viewer::NodeMask::NODE_MASK_ROAD_SENSORS);
 
-    mutex.Lock();
+    mutex.Lock();  // viewer might be updating routes
+
+    snapshot.time = scenarioEngine->getSimulationTime();
+    snapshot.objects.resize(scenarioEngine->entities_.object_.size());
 
-    // remove deleted cars
-    osg::Vec4 trail_color;
-    trail_color.set(color_blue[0], color_blue[1], color_blue[2], 1.0);
-    for (size_t i = 0; i < viewer_->entities_.size() && i < scenarioEngine->entities_.object_.size(); i++)
+    for (size_t i = 0; i < scenarioEngine->entities_.object_.size(); i++)
     {
-        if (scenarioEngine->entities_.object_[i]->name_ != viewer_->entities_[i]->name_ ||
-            scenarioEngine->entities_.object_[i]->model3d_ != viewer_->entities_[i]->filename_)
+        Object*            obj   = scenarioEngine->entities_.object_[i];
+        ViewerObjectState& state = snapshot.objects[i];
+
+        state.name                 = obj->name_;
+        state.model3d              = obj->model3d_;
+        state.id                   = obj->GetId();
+        state.pos[0]               = obj->pos_.GetX();
+        state.pos[1]               = obj->pos_.GetY();
+        state.pos[2]               = obj->pos_.GetZ();
+        state.rot[0]               = obj->pos_.GetH();
+        state.rot[1]               = obj->pos_.GetP();
+        state.rot[2]               = obj->pos_.GetR();
+        state.speed                = obj->speed_;
+        state.odometer             = obj->odometer_;
+        state.wheel_angle          = obj->wheel_angle_;
+        state.wheel_rot            = obj->wheel_rot_;
+        state.road_id              = obj->pos_.GetTrackId();
+        state.lane_id              = obj->pos_.GetLaneId();
+        state.offset               = obj->pos_.GetOffset();
+        state.s                    = obj->pos_.GetS();
+        state.bb_center_x          = static_cast<double>(obj->boundingbox_.center_.x_);
+        state.sensor_pos[0]        = obj->sensor_pos_[0];
+        state.sensor_pos[1]        = obj->sensor_pos_[1];
+        state.sensor_pos[2]        = obj->sensor_pos_[2];
+        state.trail_closest_pos[0] = obj->trail_closest_pos_.x;
+        state.trail_closest_pos[1] = obj->trail_closest_pos_.y;
+        state.trail_closest_pos[2] = obj->trail_closest_pos_.z;
+        state.trajectory           = obj->pos_.GetTrajectory();
+        state.has_route            = obj->pos_.GetRoute() != nullptr;
+        state.route_changed        = obj->CheckDirtyBits(Object::DirtyBit::ROUTE);
+
+        if (road_sensors)
+        {
+            viewer::Viewer::GetRoadSensorTargets(&obj->pos_, state.road_target, state.route_target, state.lane_target);
+        }
+
+        // buffers are reused, so only append new trail vertices. Start over if the trail has been reset, e.g. ghost restart
+        const std::vector<roadmanager::TrajVertex>& vertices = obj->trail_.vertex_;
+        if (state.trail.size() > vertices.size() || (!state.trail.empty() && state.trail.back().time != vertices[state.trail.size() - 1].time))
+        {
+            state.trail.clear();
+        }
+        state.trail.insert(state.trail.end(), vertices.begin() + static_cast<std::ptrdiff_t>(state.trail.size()), vertices.end());
+    }
+
+    snapshot.sensor_hits.resize(sensor.size());
+    for (size_t i = 0; i < sensor.size(); i++)
+    {
+        ObjectSensor*        s    = sensor[i];
+        std::vector<double>& hits = snapshot.sensor_hits[i];
+
+        hits.clear();
+        for (size_t j = 0; j < static_cast<unsigned int>(s->nObj_); j++)
         {
-            // Object has most probably been deleted from the entity list
-            viewer_->RemoveCar(static_cast<int>(i));
-            i--;  // test same object again against next in viewer list
+            // compensate z for vehicle pitch angle
+            double z_add = GetLengthOfLine2D(s->hitList_[j].obj_->pos_.GetX(), s->hitList_[j].obj_->pos_.GetY(), s->host_->pos_.GetX(), s->host_->pos_.GetY()) *
+                           tan(s->host_->pos_.GetP());
+
+            hits.push_back(s->hitList_[j].x_);
+            hits.push_back(s->hitList_[j].y_);
+            hits.push_back(s->hitList_[j].z_ + z_add);
         }
     }
 
-    // Add missing cars
-    while (viewer_->entities_.size() < scenarioEngine->entities_.object_.size())
+    mutex.Unlock();
+
+    viewerSnapshot_.Publish();
+}
+
+void ScenarioPlayer::ViewerFrame(bool init)
+{
+    if (viewer_ == nullptr)
     {
-        Object* obj = scenarioEngine->entities_.object_[viewer_->entities_.size()];
-        viewer_->AddEntityModel(viewer_->CreateEntityModel(obj->model3d_,
-                                                           trail_color,
-                                                           viewer::EntityModel::EntityType::VEHICLE,
-                                                           false,
-                                                           obj->name_,
-                                                           &obj->boundingbox_,
-                                                           obj->scaleMode_));
+        return;
+    }
 
-        // Connect callback for setting transparency
-        viewer::VisibilityCallback* cb = new viewer::VisibilityCallback(obj, viewer_->entities_.back());
-        viewer_->entities_.back()->txNode_->setUpdateCallback(cb);
+    static double last_dot_time = scenarioEngine->getSimulationTime();
+    (void)last_dot_time;
 
-        InitVehicleModel(obj, static_cast<viewer::CarModel*>(viewer_->entities_.back()));
+    // latest complete state from the simulation, without waiting for it
+    viewerSnapshot_.Update();
+    const ViewerSnapshot& snapshot = viewerSnapshot_.GetReadBuffer();
+
+    bool entities_changed = init || snapshot.objects.size() != viewer_->entities_.size();
+    for (size_t i = 0; !entities_changed && i < snapshot.objects.size(); i++)
+    {
+        entities_changed = snapshot.objects[i].name != viewer_->entities_[i]->name_ || snapshot.objects[i].model3d != viewer_->entities_[i]->filename_;
     }
 
-    // remove obsolete cars
-    while (viewer_->entities_.size() > scenarioEngine->entities_.object_.size())
+    if (entities_changed)
     {
-        if (viewer_->entities_.back()->trajectory_->activeRMTrajectory_)
+        // structural changes need the live entity list
+        mutex.Lock();
+
+        // remove deleted cars
+        osg::Vec4 trail_color;
+        trail_color.set(color_blue[0], color_blue[1], color_blue[2], 1.0);
+        for (size_t i = 0; i < viewer_->entities_.size() && i < scenarioEngine->entities_.object_.size(); i++)
+        {
+            if (scenarioEngine->entities_.object_[i]->name_ != viewer_->entities_[i]->name_ ||
+                scenarioEngine->entities_.object_[i]->model3d_ != viewer_->entities_[i]->filename_)
+            {
+                // Object has most probably been deleted from the entity list
+                viewer_->RemoveCar(static_cast<int>(i));
+                i--;  // test same object again against next in viewer list
+            }
+        }
+
+        // Add missing cars
+        while (viewer_->entities_.size() < scenarioEngine->entities_.object_.size())
+        {
+            Object* obj = scenarioEngine->entities_.object_[viewer_->entities_.size()];
+            viewer_->AddEntityModel(viewer_->CreateEntityModel(obj->model3d_,
+                                                               trail_color,
+                                                               viewer::EntityModel::EntityType::VEHICLE,
+                                                               false,
+                                                               obj->name_,
+                                                               &obj->boundingbox_,
+                                                               obj->scaleMode_));
+
+            // Connect callback for setting transparency
+            viewer::VisibilityCallback* cb = new viewer::VisibilityCallback(obj, viewer_->entities_.back());
+            viewer_->entities_.back()->txNode_->setUpdateCallback(cb);
+
+            InitVehicleModel(obj, static_cast<viewer::CarModel*>(viewer_->entities_.back()));
+        }
+
+        // remove obsolete cars
+        while (viewer_->entities_.size() > scenarioEngine->entities_.object_.size())
         {
-            viewer_->entities_.back()->trajectory_->Disable();
+            if (viewer_->entities_.back()->trajectory_->activeRMTrajectory_)
+            {
+                viewer_->entities_.back()->trajectory_->Disable();
+            }
+            viewer_->RemoveCar(static_cast<int>(viewer_->entities_.size() - 1));
         }
-        viewer_->RemoveCar(static_cast<int>(viewer_->entities_.size() - 1));
+
+        mutex.Unlock();
     }
 
     if (!init)
     {
         // Visualize entities
-        for (size_t i = 0; i < scenarioEngine->entities_.object_.size(); i++)
+        for (size_t i = 0; i < snapshot.objects.size() && i < viewer_->entities_.size(); i++)
         {
-            viewer::EntityModel* entity = viewer_->entities_[i];
-            Object*              obj    = scenarioEngine->entities_.object_[i];
+            viewer::EntityModel*     entity = viewer_->entities_[i];
+            const ViewerObjectState& obj    = snapshot.objects[i];
 
-            entity->SetPosition(obj->pos_.GetX(), obj->pos_.GetY(), obj->pos_.GetZ());
-            entity->SetRotation(obj->pos_.GetH(), obj->pos_.GetP(), obj->pos_.GetR());
-
-            if (obj->pos_.GetTrajectory() && obj->pos_.GetTrajectory() != entity->trajectory_->activeRMTrajectory_)
-            {
-                entity->trajectory_->SetActiveRMTrajectory(obj->pos_.GetTrajectory());
-            }
-            else if (entity->trajectory_->activeRMTrajectory_ && !obj->pos_.GetTrajectory())
+            if (obj.name != entity->name_ || obj.model3d != entity->filename_)
             {
-                // Trajectory has been deactivated on the entity, disable visualization
-                entity->trajectory_->Disable();
+                continue;  // entity list changed after the snapshot was taken
             }
 
-            if (obj->CheckDirtyBits(Object::DirtyBit::ROUTE))
-            {
-                entity->routewaypoints_->SetWayPoints(obj->pos_.GetRoute());
-                obj->ClearDirtyBits(Object::DirtyBit::ROUTE);
-            }
-            else if (entity->routewaypoints_->group_all_wp_->getNumChildren() && obj->pos_.GetRoute() == nullptr)
+            entity->SetPosition(obj.pos[0], obj.pos[1], obj.pos[2]);
+            entity->SetRotation(obj.rot[0], obj.rot[1], obj.rot[2]);
+
+            if (obj.trajectory != entity->trajectory_->activeRMTrajectory_ || obj.route_changed ||
+                (entity->routewaypoints_->group_all_wp_->getNumChildren() && !obj.has_route))
             {
-                entity->routewaypoints_->SetWayPoints(nullptr);
+                // trajectory or route changed, update from the live object
+                mutex.Lock();
+                if (i < scenarioEngine->entities_.object_.size())
+                {
+                    Object* live_obj = scenarioEngine->entities_.object_[i];
+
+                    if (live_obj->pos_.GetTrajectory() && live_obj->pos_.GetTrajectory() != entity->trajectory_->activeRMTrajectory_)
+                    {
+                        entity->trajectory_->SetActiveRMTrajectory(live_obj->pos_.GetTrajectory());
+                    }
+                    else if (entity->trajectory_->activeRMTrajectory_ && !live_obj->pos_.GetTrajectory())
+                    {
+                        // Trajectory has been deactivated on the entity, disable visualization
+                        entity->trajectory_->Disable();
+                    }
+
+                    if (live_obj->CheckDirtyBits(Object::DirtyBit::ROUTE))
+                    {
+                        entity->routewaypoints_->SetWayPoints(live_obj->pos_.GetRoute());
+                        live_obj->ClearDirtyBits(Object::DirtyBit::ROUTE);
+                    }
+                    else if (entity->routewaypoints_->group_all_wp_->getNumChildren() && live_obj->pos_.GetRoute() == nullptr)
+                    {
+                        entity->routewaypoints_->SetWayPoints(nullptr);
+                    }
+                }
+                mutex.Unlock();
             }
 
             if (entity->IsMoving())
@@ -433,102 +670,102 @@ void ScenarioPlayer::ViewerFrame(bool init)
                 if (entity->IsVehicle())
                 {
                     viewer::CarModel* car = static_cast<viewer::CarModel*>(entity);
-                    car->UpdateWheels(obj->wheel_angle_, obj->wheel_rot_);
+                    car->UpdateWheels(obj.wheel_angle, obj.wheel_rot);
                 }
 
                 viewer::MovingModel* mov = static_cast<viewer::MovingModel*>(entity);
 
                 if (mov->steering_sensor_ && mov->steering_sensor_->IsVisible())
                 {
-                    viewer_->SensorSetPivotPos(mov->steering_sensor_, obj->pos_.GetX(), obj->pos_.GetY(), obj->pos_.GetZ());
-                    viewer_->SensorSetTargetPos(mov->steering_sensor_, obj->sensor_pos_[0], obj->sensor_pos_[1], obj->sensor_pos_[2]);
+                    viewer_->SensorSetPivotPos(mov->steering_sensor_, obj.pos[0], obj.pos[1], obj.pos[2]);
+                    viewer_->SensorSetTargetPos(mov->steering_sensor_, obj.sensor_pos[0], obj.sensor_pos[1], obj.sensor_pos[2]);
                     viewer_->UpdateSensor(mov->steering_sensor_);
                 }
                 if (mov->trail_sensor_ && mov->steering_sensor_->IsVisible())
                 {
-                    viewer_->SensorSetPivotPos(mov->trail_sensor_, obj->trail_closest_pos_.x, obj->trail_closest_pos_.y, obj->trail_closest_pos_.z);
-                    viewer_->SensorSetTargetPos(mov->trail_sensor_, obj->pos_.GetX(), obj->pos_.GetY(), obj->pos_.GetZ());
+                    viewer_->SensorSetPivotPos(mov->trail_sensor_, obj.trail_closest_pos[0], obj.trail_closest_pos[1], obj.trail_closest_pos[2]);
+                    viewer_->SensorSetTargetPos(mov->trail_sensor_, obj.pos[0], obj.pos[1], obj.pos[2]);
                     viewer_->UpdateSensor(mov->trail_sensor_);
                 }
 
-                if (odr_manager->GetNumOfRoads() > 0 && mov->road_sensor_)
+                if (odr_manager->GetNumOfRoads() > 0 && mov->road_sensor_ && viewer_->GetNodeMaskBit(viewer::NodeMask::NODE_MASK_ROAD_SENSORS))
                 {
-                    mov->ShowRouteSensor(obj->pos_.GetRoute() ? true : false);
-                    viewer_->UpdateRoadSensors(mov->road_sensor_, mov->route_sensor_, mov->lane_sensor_, &obj->pos_);
+                    mov->ShowRouteSensor(obj.has_route);
+                    viewer_->UpdateRoadSensors(mov->road_sensor_,
+                                               mov->route_sensor_,
+                                               mov->lane_sensor_,
+                                               obj.pos,
+                                               obj.road_target,
+                                               obj.route_target,
+                                               obj.lane_target);
                 }
             }
 
-            if (entity->trail_->pline_vertex_data_->size() > static_cast<unsigned int>(obj->trail_.GetNumberOfVertices()))
+            if (entity->trail_->pline_vertex_data_->size() > obj.trail.size())
             {
                 // Reset the trail, probably there has been a ghost restart
                 entity->trail_->Reset();
-                for (size_t j = 0; j < static_cast<unsigned int>(obj->trail_.GetNumberOfVertices()); j++)
-                {
-                    entity->trail_->AddPoint(obj->trail_.vertex_[j].x,
-                                             obj->trail_.vertex_[j].y,
-                                             obj->trail_.vertex_[j].z + (obj->GetId() + 1) * TRAIL_Z_OFFSET);
-                }
             }
 
-            if (static_cast<unsigned int>(obj->trail_.GetNumberOfVertices()) > entity->trail_->pline_vertex_data_->size())
+            // add any new trail vertices, there might be several since viewer may skip frames
+            for (size_t j = entity->trail_->pline_vertex_data_->size(); j < obj.trail.size(); j++)
             {
-                entity->trail_->AddPoint(obj->pos_.GetX(), obj->pos_.GetY(), obj->pos_.GetZ() + (obj->GetId() + 1) * TRAIL_Z_OFFSET);
+                entity->trail_->AddPoint(obj.trail[j].x, obj.trail[j].y, obj.trail[j].z + (obj.id + 1) * TRAIL_Z_OFFSET);
             }
 
             // on screen text following each entity
             snprintf(entity->on_screen_info_.string_,
                      sizeof(entity->on_screen_info_.string_),
                      " %s (%d) %.2fm\n %.2fkm/h road %d lane %d/%.2f s %.2f\n x %.2f y %.2f hdg %.2f\n osi x %.2f y %.2f \n|",
-                     obj->name_.c_str(),
-                     obj->GetId(),
-                     obj->odometer_,
-                     3.6 * obj->speed_,
-                     obj->pos_.GetTrackId(),
-                     obj->pos_.GetLaneId(),
-                     fabs(obj->pos_.GetOffset()) < SMALL_NUMBER ? 0 : obj->pos_.GetOffset(),
-                     obj->pos_.GetS(),
-                     obj->pos_.GetX(),
-                     obj->pos_.GetY(),
-                     obj->pos_.GetH(),
-                     obj->pos_.GetX() + static_cast<double>(obj->boundingbox_.center_.x_) * cos(obj->pos_.GetH()),
-                     obj->pos_.GetY() + static_cast<double>(obj->boundingbox_.center_.x_) * sin(obj->pos_.GetH()));
+                     obj.name.c_str(),
+                     obj.id,
+                     obj.odometer,
+                     3.6 * obj.speed,
+                     obj.road_id,
+                     obj.lane_id,
+                     fabs(obj.offset) < SMALL_NUMBER ? 0 : obj.offset,
+                     obj.s,
+                     obj.pos[0],
+                     obj.pos[1],
+                     obj.rot[0],
+                     obj.pos[0] + obj.bb_center_x * cos(obj.rot[0]),
+                     obj.pos[1] + obj.bb_center_x * sin(obj.rot[0]));
             entity->on_screen_info_.osg_text_->setText(entity->on_screen_info_.string_);
         }
 
-        for (size_t i = 0; i < sensorFrustum.size(); i++)
+        for (size_t i = 0; i < sensorFrustum.size() && i < snapshot.sensor_hits.size(); i++)
         {
-            sensorFrustum[i]->Update();
+            sensorFrustum[i]->Update(snapshot.sensor_hits[i].data(), static_cast<int>(snapshot.sensor_hits[i].size() / 3));
         }
 
         // Update info text
         static char str_buf[128];
-        if (viewer_->currentCarInFocus_ >= 0 && static_cast<unsigned int>(viewer_->currentCarInFocus_) < viewer_->entities_.size())
+        if (viewer_->currentCarInFocus_ >= 0 && static_cast<unsigned int>(viewer_->currentCarInFocus_) < snapshot.objects.size())
         {
-            Object* obj = scenarioEngine->entities_.object_[static_cast<unsigned int>(viewer_->currentCarInFocus_)];
+            const ViewerObjectState& obj = snapshot.objects[static_cast<unsigned int>(viewer_->currentCarInFocus_)];
             snprintf(str_buf,
                      sizeof(str_buf),
                      "%.2fs entity[%d]: %s (%d) %.2fkm/h %.2fm (%d, %d, %.2f, %.2f) / (%.2f, %.2f %.2f)",
-                     scenarioEngine->getSimulationTime(),
+                     snapshot.time,
                      viewer_->currentCarInFocus_,
-                     obj->name_.c_str(),
-                     obj->GetId(),
-                     3.6 * obj->speed_,
-                     obj->odometer_,
-                     obj->pos_.GetTrackId(),
-                     obj->pos_.GetLaneId(),
-                     fabs(obj->pos_.GetOffset()) < SMALL_NUMBER ? 0 : obj->pos_.GetOffset(),
-                     obj->pos_.GetS(),
-                     obj->pos_.GetX(),
-                     obj->pos_.GetY(),
-                     obj->pos_.GetH());
+                     obj.name.c_str(),
+                     obj.id,
+                     3.6 * obj.speed,
+                     obj.odometer,
+                     obj.road_id,
+                     obj.lane_id,
+                     fabs(obj.offset) < SMALL_NUMBER ? 0 : obj.offset,
+                     obj.s,
+                     obj.pos[0],
+                     obj.pos[1],
+                     obj.rot[0]);
         }
         else
         {
-            snprintf(str_buf, sizeof(str_buf), "%.2fs No entity in focus...", scenarioEngine->getSimulationTime());
+            snprintf(str_buf, sizeof(str_buf), "%.2fs No entity in focus...", snapshot.time);
         }
         viewer_->SetInfoText(str_buf);
     }
-    mutex.Unlock();
 
     if (!init)
     {
@@ -1285,6 +1522,7 @@ int ScenarioPlayer::Init()
     opt.AddOption("osc", "OpenSCENARIO filename (required) - if path includes spaces, enclose with \"\"", "filename");
     opt.AddOption("aa_mode", "Anti-alias mode=number of multisamples (subsamples, 0=off, 4=default)", "mode");
     opt.AddOption("align_routepositions", "Align t-axis of route positions to the direction of the route");
+    opt.AddOption("batch", "Run as fast as possible, no viewer or other non-essential services, print throughput statistics at end");
     opt.AddOption("bounding_boxes", "Show entities as bounding boxes (toggle modes on key ',') ");
     opt.AddOption("capture_screen", "Continuous screen capture. Warning: Many jpeg files will be created");
     opt.AddOption(
@@ -1324,19 +1562,30 @@ int ScenarioPlayer::Init()
     opt.AddOption("osg_screenshot_event_handler", "Revert to OSG default jpg images ('c'/'C' keys handler)");
 #ifdef _USE_OSI
     opt.AddOption("osi_file", "save osi trace file", "filename", DEFAULT_OSI_TRACE_FILENAME);
+    opt.AddOption("osi_file_compress", "Compress osi trace file (LZ4 blocks), see scripts/osi2csv.py or osireceiver --file for reading");
     opt.AddOption("osi_freq", "relative frequence for writing the .osi file e.g. --osi_freq=2 -> we write every two simulation steps", "frequence");
     opt.AddOption("osi_lines", "Show OSI road lines (toggle during simulation by press 'u') ");
     opt.AddOption("osi_points", "Show OSI road pointss (toggle during simulation by press 'y') ");
     opt.AddOption("osi_receiver_ip", "IP address where to send OSI UDP packages", "IP address");
+    opt.AddOption("osi_shm", "Publish OSI ground truth in shared memory with given name, for readers on same host", "name");
+    opt.AddOption("osi_static_cache", "Cache OSI static ground truth of road networks in files, reused for same OpenDRIVE", "directory");
+    opt.AddOption("osi_udp_pacing", "Limit OSI UDP send rate: Number of packages sent back to back, then pause (microseconds)", "packages,microseconds");
+    opt.AddOption("osi_udp_sndbuf", "Size of OSI UDP socket send buffer", "bytes");
 #endif
+    opt.AddOption("pacing_spin", "Together with --realtime_factor, busy-wait this long before each step for precision (0 = sleep only)", "time", "0.0002");
     opt.AddOption("param_dist", "Run variations of the scenario according to specified parameter distribution file", "filename");
     opt.AddOption("param_permutation", "Run specific permutation of parameter distribution", "index (0 .. NumberOfPermutations-1)");
     opt.AddOption("pause", "Pause simulation after initialization");
     opt.AddOption("path", "Search path prefix for assets, e.g. OpenDRIVE files (multiple occurrences supported)", "path");
+    opt.AddOption("perf_summary", "Log performance counters and time per frame phase at end, e.g. XYZ2TrackPos calls and OSI bytes");
+    opt.AddOption("pipeline", "Write recording and CSV log on a worker thread while next frame is simulated, max depth frames behind. OSI is not pipelined", "depth", "4");
     opt.AddOption("player_server", "Launch UDP server for action/command injection");
 #ifdef _USE_IMPLOT
     opt.AddOption("plot", "Show window with line-plots of interesting data", "mode (asynchronous|synchronous)", "asynchronous");
 #endif
+    opt.AddOption("profile", "Measure time spent in each frame phase, write statistics (p50/p99/max) to JSON file at end", "filename");
+    opt.AddOption("profile_trace", "Together with --profile, write all phase executions as Chrome trace events (e.g. for Perfetto)", "filename");
+    opt.AddOption("realtime_factor", "Together with --fixed_timestep, pace steps to real time scaled by factor, e.g. 2.0 = twice as fast", "factor");
     opt.AddOption("record", "Record position data into a file for later replay", "filename");
     opt.AddOption("road_features", "Show OpenDRIVE road features (\"on\", \"off\"  (default)) (toggle during simulation by press 'o') ", "mode");
     opt.AddOption("return_nr_permutations", "Return number of permutations without executing the scenario (-1 = error)");
@@ -1345,6 +1594,7 @@ int ScenarioPlayer::Init()
     opt.AddOption("seed", "Specify seed number for random generator", "number");
     opt.AddOption("sensors", "Show sensor frustums (toggle during simulation by press 'r') ");
     opt.AddOption("server", "Launch server to receive state of external Ego simulator");
+    opt.AddOption("task_threads", "Max number of threads for parallel tasks, e.g. OSI sensor views (0 = number of cores, 1 = no parallelism)", "number", "0");
     opt.AddOption("text_scale", "Scale screen overlay text", "factor", "1.0");
     opt.AddOption("threads", "Run viewer in a separate thread, parallel to scenario engine");
     opt.AddOption("trail_mode", "Show trail lines and/or dots (toggle key 'j') mode 0=None 1=lines 2=dots 3=both", "mode");
@@ -1502,6 +1752,12 @@ int ScenarioPlayer::Init()
 #endif
     }
 
+    if ((arg_str = opt.GetOptionArg("task_threads")) != "")
+    {
+        SE_TaskPool::Inst().SetNumberOfThreads(strtoi(arg_str));
+        LOG("Max number of task threads: %d", SE_TaskPool::Inst().GetNumberOfThreads());
+    }
+
     if (opt.GetOptionSet("server"))
     {
         launch_server = true;
@@ -1527,6 +1783,48 @@ int ScenarioPlayer::Init()
         LOG("No fixed timestep specified - running in realtime speed");
     }
 
+    if ((arg_str = opt.GetOptionArg("realtime_factor")) != "")
+    {
+        if (GetFixedTimestep() > SMALL_NUMBER)
+        {
+            double spin_time = SE_PACER_DEFAULT_SPIN_TIME;
+            if (opt.IsOptionArgumentSet("pacing_spin"))
+            {
+                spin_time = strtod(opt.GetOptionArg("pacing_spin"));
+            }
+            pacer_.Start(GetFixedTimestep(), strtod(arg_str), spin_time);
+            LOG("Pace fixed timesteps to real time factor %.2f", strtod(arg_str));
+        }
+        else
+        {
+            LOG("Real time factor ignored, requires --fixed_timestep");
+        }
+    }
+
+    if (opt.GetOptionSet("batch"))
+    {
+        batch_mode_ = true;
+        if (GetFixedTimestep() < SMALL_NUMBER)
+        {
+            SetFixedTimestep(BATCH_DEFAULT_TIMESTEP);
+        }
+        if (pacer_.IsActive())
+        {
+            pacer_.Stop();
+            LOG("Batch mode: Real time factor ignored");
+        }
+        LOG("Batch mode: Run as fast as possible with fixed timestep %.2f", GetFixedTimestep());
+    }
+
+    perf_summary_ = opt.GetOptionSet("perf_summary");
+
+    if ((batch_mode_ || perf_summary_) && !SE_Profiler::GetPhaseTiming())
+    {
+        // phase times are accumulated only on request, keeping profile scopes idle otherwise
+        SE_Profiler::SetPhaseTiming(true);
+        phase_timing_ = true;
+    }
+
     if (opt.GetOptionArg("path") != "")
     {
         int counter = 0;
@@ -1660,6 +1958,11 @@ int ScenarioPlayer::Init()
     osiReporter->SetStationaryModelReference(scenarioEngine->getSceneGraphFilename());
     scenarioEngine->storyBoard.SetOSIReporter(osiReporter);
 
+    if (opt.GetOptionSet("osi_static_cache"))
+    {
+        osiReporter->SetStaticGroundTruthCacheDir(opt.GetOptionArg("osi_static_cache"));
+    }
+
     if (opt.GetOptionSet("osi_receiver_ip"))
     {
         osiReporter->OpenSocket(opt.GetOptionArg("osi_receiver_ip"));
@@ -1667,6 +1970,31 @@ int ScenarioPlayer::Init()
         {
             osi_freq_ = 1;
         }
+
+        if ((arg_str = opt.GetOptionArg("osi_udp_pacing")) != "")
+        {
+            std::vector<std::string> values = SplitString(arg_str, ',');
+            if (values.size() != 2)
+            {
+                LOG("Unexpected osi_udp_pacing argument %s, expected <packages,microseconds>", arg_str.c_str());
+                return -1;
+            }
+            osiReporter->SetUDPPacing(atoi(values[0].c_str()), atoi(values[1].c_str()));
+        }
+
+        if ((arg_str = opt.GetOptionArg("osi_udp_sndbuf")) != "")
+        {
+            osiReporter->SetUDPSendBufferSize(atoi(arg_str.c_str()));
+        }
+    }
+
+    if (opt.GetOptionSet("osi_shm"))
+    {
+        osiReporter->OpenSharedMemory(opt.GetOptionArg("osi_shm"));
+        if (osi_freq_ == 0)
+        {
+            osi_freq_ = 1;
+        }
     }
 
     std::string osi_filename;
@@ -1686,6 +2014,11 @@ int ScenarioPlayer::Init()
         osi_filename = SE_Env::Inst().GetOSIFilePath();
     }
 
+    if (opt.GetOptionSet("osi_file_compress"))
+    {
+        osiReporter->SetOSIFileCompression(true);
+    }
+
     if (!osi_filename.empty() || SE_Env::Inst().GetOSIFileEnabled())
     {
         SetOSIFileStatus(true, osi_filename.c_str());
@@ -1755,13 +2088,45 @@ int ScenarioPlayer::Init()
         scenarioGateway->RecordToFile(filename, scenarioEngine->getOdrFilename(), scenarioEngine->getSceneGraphFilename());
     }
 
+    if (opt.GetOptionSet("pipeline"))
+    {
+        int depth = SE_PIPELINE_DEFAULT_DEPTH;
+        if (opt.IsOptionArgumentSet("pipeline"))
+        {
+            depth = strtoi(opt.GetOptionArg("pipeline"));
+        }
+        output_pipeline_.Start(depth);
+        LOG("Pipelined output, recording and CSV log written max %d frames behind", MAX(1, depth));
+    }
+
+    if ((arg_str = opt.GetOptionArg("profile")) != "")
+    {
+        std::string trace_filename = opt.GetOptionArg("profile_trace");
+
+        if (dist.GetNumPermutations() > 0)
+        {
+            arg_str = dist.AddInfoToFilepath(arg_str);
+            if (!trace_filename.empty())
+            {
+                trace_filename = dist.AddInfoToFilepath(trace_filename);
+            }
+        }
+
+        LOG("Profiling frame phases, statistics will be written to %s", arg_str.c_str());
+        SE_Profiler::Inst().Enable(arg_str, trace_filename);
+    }
+
     if (launch_server)
     {
         // Launch UDP server to receive external Ego state
         StartServer(scenarioEngine);
     }
 
-    if (opt.GetOptionSet("player_server"))
+    if (opt.GetOptionSet("player_server") && batch_mode_)
+    {
+        LOG("Batch mode: Player server ignored");
+    }
+    else if (opt.GetOptionSet("player_server"))
     {
         LOG("Launch server to receive actions to inject");
 
@@ -1771,7 +2136,11 @@ int ScenarioPlayer::Init()
 
     player_init_semaphore.Set();
 
-    if (opt.IsInOriginalArgs("--window") || opt.IsInOriginalArgs("--borderless-window"))
+    if (batch_mode_ && (opt.IsInOriginalArgs("--window") || opt.IsInOriginalArgs("--borderless-window")))
+    {
+        LOG("Batch mode: Window ignored");
+    }
+    else if (opt.IsInOriginalArgs("--window") || opt.IsInOriginalArgs("--borderless-window"))
     {
 #ifdef _USE_OSG
 
@@ -1826,6 +2195,22 @@ int ScenarioPlayer::Init()
         PrintUsage();
     }
 
+    if (batch_mode_)
+    {
+        // avoid reallocations of per frame buffers, all entities are known at this point
+        size_t n_entities = scenarioEngine->entities_.object_.size();
+        scenarioGateway->Reserve(n_entities);
+        csv_entries_.reserve(n_entities);
+
+        // the accumulated phase times are shared by all players, so the statistics are based on the difference
+        batch_phase_times_.resize(static_cast<size_t>(SE_Profiler::Phase::N_PHASES));
+        for (size_t i = 0; i < batch_phase_times_.size(); i++)
+        {
+            batch_phase_times_[i] = SE_Profiler::GetPhaseTime(static_cast<SE_Profiler::Phase>(i));
+        }
+        batch_start_time_ = SE_Profiler::Now();
+    }
+
     Frame(0.0);
 
     if (opt.GetOptionSet("pause"))
@@ -1849,68 +2234,134 @@ void ScenarioPlayer::RegisterObjCallback(int id, ObjCallbackFunc func, void* dat
 
 void ScenarioPlayer::UpdateCSV_Log()
 {
-    // Flag for signalling end of data line, all vehicles reported
-    bool isendline = false;
+    GetCSV_LogEntries(csv_entries_);
+    WriteCSV_Log(scenarioEngine->getSimulationTime(), csv_entries_);
+}
 
-    // For each vehicle (entitity) stored in the ScenarioPlayer
-    for (size_t i = 0; i < scenarioEngine->entities_.object_.size(); i++)
-    {
-        // Create a pointer to the object at position i in the entities vector
-        Object* obj = scenarioEngine->entities_.object_[i];
+void ScenarioPlayer::LogBatchStatistics()
+{
+    double wall_time = MAX(SMALL_NUMBER, 1E-9 * static_cast<double>(SE_Profiler::Now() - batch_start_time_));
+    double sim_time  = scenarioEngine ? scenarioEngine->getSimulationTime() : 0.0;
 
-        // Create a Position object for extracting this vehicles XYZ coordinates
-        roadmanager::Position pos = obj->pos_;
+    std::vector<double> phase_times(batch_phase_times_.size());
+    for (size_t i = 0; i < phase_times.size(); i++)
+    {
+        phase_times[i] = static_cast<double>(SE_Profiler::GetPhaseTime(static_cast<SE_Profiler::Phase>(i)) - batch_phase_times_[i]);
+    }
+    double frame_time = phase_times.empty() ? 0.0 : phase_times[static_cast<size_t>(SE_Profiler::Phase::FRAME)];
 
-        // Extract the String name of the object and store in a compatable const char array
-        const char* name_ = &(*obj->name_.c_str());
+    LOG("Batch: %d frames, %.2f s simulated in %.3f s", GetCounter(), sim_time, wall_time);
+    LOG("Batch: %.1f simulated s per s, %.1f frames/s, peak RSS %.1f MB",
+        sim_time / wall_time,
+        GetCounter() / wall_time,
+        static_cast<double>(SE_getPeakMemoryUsage()) / (1024 * 1024));
 
-        if ((i + 1) == scenarioEngine->entities_.object_.size())
+    // share of frame time per phase, nested phases (e.g. parts of OSI) are included in their parent as well
+    for (size_t i = static_cast<size_t>(SE_Profiler::Phase::FRAME) + 1; frame_time > 0.0 && i < phase_times.size(); i++)
+    {
+        if (phase_times[i] > 0.0)
         {
-            isendline = true;
+            LOG("Batch:   %-20s %5.1f%%", SE_Profiler::PhaseName(static_cast<SE_Profiler::Phase>(i)), 100.0 * phase_times[i] / frame_time);
         }
+    }
+}
 
-        // Log the extracted data of ego vehicle and additonal scenario vehicles
-        std::string collision_ids;
+void ScenarioPlayer::GetCSV_LogEntries(std::vector<CSV_LogEntry>& entries)
+{
+    entries.resize(scenarioEngine->entities_.object_.size());
+
+    // For each vehicle (entitity) stored in the ScenarioPlayer
+    for (size_t i = 0; i < scenarioEngine->entities_.object_.size(); i++)
+    {
+        // Create a pointer to the object at position i in the entities vector
+        Object*       obj = scenarioEngine->entities_.object_[i];
+        CSV_LogEntry& e   = entries[i];
+
+        roadmanager::Position& pos = obj->pos_;
+
+        e.name                               = obj->name_;
+        e.id                                 = obj->id_;
+        e.speed                              = obj->speed_;
+        e.wheel_angle                        = obj->wheel_angle_;
+        e.wheel_rot                          = obj->wheel_rot_;
+        e.bb_x                               = obj->boundingbox_.center_.x_;
+        e.bb_y                               = obj->boundingbox_.center_.y_;
+        e.bb_z                               = obj->boundingbox_.center_.z_;
+        e.bb_length                          = obj->boundingbox_.dimensions_.length_;
+        e.bb_width                           = obj->boundingbox_.dimensions_.width_;
+        e.bb_height                          = obj->boundingbox_.dimensions_.height_;
+        e.pos_x                              = pos.GetX();
+        e.pos_y                              = pos.GetY();
+        e.pos_z                              = pos.GetZ();
+        e.vel_x                              = pos.GetVelX();
+        e.vel_y                              = pos.GetVelY();
+        e.vel_z                              = pos.GetVelZ();
+        e.acc_x                              = pos.GetAccX();
+        e.acc_y                              = pos.GetAccY();
+        e.acc_z                              = pos.GetAccZ();
+        e.s                                  = pos.GetS();
+        e.t                                  = pos.GetT();
+        e.lane_id                            = pos.GetLaneId();
+        e.lane_offset                        = pos.GetOffset();
+        e.heading                            = pos.GetH();
+        e.heading_rate                       = pos.GetHRate();
+        e.heading_relative                   = pos.GetHRelative();
+        e.heading_relative_driving_direction = pos.GetHRelativeDrivingDirection();
+        e.pitch                              = pos.GetP();
+        e.curvature                          = pos.GetCurvature();
+
+        // ids of any colliding objects, space separated
+        e.collision_ids.clear();
         if (SE_Env::Inst().GetCollisionDetection())
         {
             for (size_t j = 0; j < obj->collisions_.size(); j++)
             {
-                collision_ids += std::to_string(obj->collisions_[j]->GetId()) + " ";
+                e.collision_ids += std::to_string(obj->collisions_[j]->GetId()) + " ";
             }
         }
-        CSV_Log->LogVehicleData(isendline,
-                                scenarioEngine->getSimulationTime(),
-                                name_,
-                                obj->id_,
-                                obj->speed_,
-                                obj->wheel_angle_,
-                                obj->wheel_rot_,
-                                obj->boundingbox_.center_.x_,
-                                obj->boundingbox_.center_.y_,
-                                obj->boundingbox_.center_.z_,
-                                obj->boundingbox_.dimensions_.length_,
-                                obj->boundingbox_.dimensions_.width_,
-                                obj->boundingbox_.dimensions_.height_,
-                                pos.GetX(),
-                                pos.GetY(),
-                                pos.GetZ(),
-                                pos.GetVelX(),
-                                pos.GetVelY(),
-                                pos.GetVelZ(),
-                                pos.GetAccX(),
-                                pos.GetAccY(),
-                                pos.GetAccZ(),
-                                pos.GetS(),
-                                pos.GetT(),
-                                pos.GetLaneId(),
-                                pos.GetOffset(),
-                                pos.GetH(),
-                                pos.GetHRate(),
-                                pos.GetHRelative(),
-                                pos.GetHRelativeDrivingDirection(),
-                                pos.GetP(),
-                                pos.GetCurvature(),
-                                collision_ids.c_str());
+    }
+}
+
+void ScenarioPlayer::WriteCSV_Log(double time, const std::vector<CSV_LogEntry>& entries)
+{
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        const CSV_LogEntry& e = entries[i];
+
+        // Flag for signalling end of data line, all vehicles reported
+        CSV_Log->LogVehicleData(i + 1 == entries.size(),
+                                time,
+                                e.name.c_str(),
+                                e.id,
+                                e.speed,
+                                e.wheel_angle,
+                                e.wheel_rot,
+                                e.bb_x,
+                                e.bb_y,
+                                e.bb_z,
+                                e.bb_length,
+                                e.bb_width,
+                                e.bb_height,
+                                e.pos_x,
+                                e.pos_y,
+                                e.pos_z,
+                                e.vel_x,
+                                e.vel_y,
+                                e.vel_z,
+                                e.acc_x,
+                                e.acc_y,
+                                e.acc_z,
+                                e.s,
+                                e.t,
+                                e.lane_id,
+                                e.lane_offset,
+                                e.heading,
+                                e.heading_rate,
+                                e.heading_relative,
+                                e.heading_relative_driving_direction,
+                                e.pitch,
+                                e.curvature,
+                                e.collision_ids.c_str());
     }
 }
 
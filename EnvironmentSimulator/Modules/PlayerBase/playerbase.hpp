@@ -20,6 +20,9 @@
 #include "CommonMini.hpp"
 #include "Server.hpp"
 #include "IdealSensor.hpp"
+#include "Pacer.hpp"
+#include "Pipeline.hpp"
+#include "TripleBuffer.hpp"
 
 #ifdef _USE_OSI
 #include "OSIReporter.hpp"
@@ -31,6 +34,8 @@
 
 using namespace scenarioengine;
 
+#define BATCH_DEFAULT_TIMESTEP 0.05  // used by --batch when no fixed timestep is specified
+
 #ifdef _USE_OSG
 void ReportKeyEvent(viewer::KeyEvent *keyEvent, void *data);
 
@@ -46,6 +51,80 @@ void RegisterImageCallback(viewer::ImageCallbackFunc func, void *data);
 
 namespace scenarioengine
 {
+    // One line of the CSV log, i.e. state of one entity, see ScenarioPlayer::UpdateCSV_Log()
+    struct CSV_LogEntry
+    {
+        std::string name;
+        int         id;
+        double      speed;
+        double      wheel_angle;
+        double      wheel_rot;
+        double      bb_x;
+        double      bb_y;
+        double      bb_z;
+        double      bb_length;
+        double      bb_width;
+        double      bb_height;
+        double      pos_x;
+        double      pos_y;
+        double      pos_z;
+        double      vel_x;
+        double      vel_y;
+        double      vel_z;
+        double      acc_x;
+        double      acc_y;
+        double      acc_z;
+        double      s;
+        double      t;
+        int         lane_id;
+        double      lane_offset;
+        double      heading;
+        double      heading_rate;
+        double      heading_relative;
+        double      heading_relative_driving_direction;
+        double      pitch;
+        double      curvature;
+        std::string collision_ids;
+    };
+
+#ifdef _USE_OSG
+    // Entity state needed by the viewer, copied from the scenario engine each frame
+    struct ViewerObjectState
+    {
+        std::string                          name;
+        std::string                          model3d;
+        int                                  id;
+        double                               pos[3];  // x, y, z
+        double                               rot[3];  // h, p, r
+        double                               speed;
+        double                               odometer;
+        double                               wheel_angle;
+        double                               wheel_rot;
+        id_t                                 road_id;
+        int                                  lane_id;
+        double                               offset;
+        double                               s;
+        double                               bb_center_x;
+        double                               sensor_pos[3];
+        double                               trail_closest_pos[3];
+        double                               road_target[3];  // see viewer::Viewer::GetRoadSensorTargets()
+        double                               route_target[3];
+        double                               lane_target[3];
+        roadmanager::RMTrajectory           *trajectory;     // only for detecting changes
+        bool                                 has_route;
+        bool                                 route_changed;  // Object::DirtyBit::ROUTE set
+        std::vector<roadmanager::TrajVertex> trail;          // updated incrementally, see PublishViewerSnapshot()
+    };
+
+    // Immutable state of one frame, handed over from simulation to viewer without locking
+    struct ViewerSnapshot
+    {
+        double                           time = 0.0;
+        std::vector<ViewerObjectState>   objects;      // same order as entities
+        std::vector<std::vector<double>> sensor_hits;  // for each sensor x, y, z per detected object
+    };
+#endif  // _USE_OSG
+
     class ScenarioPlayer
     {
     public:
@@ -145,6 +224,9 @@ namespace scenarioengine
         }
         void        RegisterObjCallback(int id, ObjCallbackFunc func, void *data);
         void        UpdateCSV_Log();
+        void        LogBatchStatistics();
+        void        GetCSV_LogEntries(std::vector<CSV_LogEntry> &entries);
+        void        WriteCSV_Log(double time, const std::vector<CSV_LogEntry> &entries);
         int         GetNumberOfParameters();
         const char *GetParameterName(int index, OSCParameterDeclarations::ParameterType *type);
         int         SetParameterValue(const char *name, const void *value);
@@ -185,6 +267,10 @@ namespace scenarioengine
         {
             return GetState() == PlayerState::PLAYER_STATE_PAUSE;
         }
+        bool IsBatchMode()
+        {
+            return batch_mode_;
+        }
         int GetCounter()
         {
             return frame_counter_;
@@ -220,10 +306,12 @@ namespace scenarioengine
 #ifdef _USE_OSI
         viewer::OSISensorDetection *OSISensorDetection;
 #endif  // _USE_OSI
-        ViewerState viewerState_;
-        int         InitViewer();
-        void        CloseViewer();
-        void        ViewerFrame(bool init = false);
+        ViewerState                     viewerState_;
+        SE_TripleBuffer<ViewerSnapshot> viewerSnapshot_;
+        int                             InitViewer();
+        void                            CloseViewer();
+        void                            ViewerFrame(bool init = false);
+        void                            PublishViewerSnapshot();
 
         int SaveImagesToRAM(bool state);
         int SaveImagesToFile(int nrOfFrames);
@@ -238,6 +326,9 @@ namespace scenarioengine
 #endif
         roadmanager::OpenDrive     *odr_manager;
         std::vector<ObjectSensor *> sensor;
+        SensorObjectGrid            sensorGrid;        // positions of entities, shared by all sensors
+        SE_Pacer                    pacer_;            // real time pacing of fixed timesteps, see --realtime_factor
+        SE_Pipeline                 output_pipeline_;  // recording and CSV log written on worker thread, see --pipeline
         const double                maxStepSize;
         const double                minStepSize;
         std::vector<ObjCallback>    objCallback;
@@ -246,6 +337,15 @@ namespace scenarioengine
         SE_Semaphore                viewer_init_semaphore;
 
     private:
+        void SubmitFrameOutput();
+
+        std::vector<CSV_LogEntry> csv_entries_;        // reused each frame, see UpdateCSV_Log()
+        bool                      batch_mode_;         // see --batch
+        int64_t                   batch_start_time_;   // see LogBatchStatistics()
+        std::vector<int64_t>      batch_phase_times_;  // accumulated phase times at batch start, see LogBatchStatistics()
+        bool                      perf_summary_;       // see --perf_summary
+        bool                      phase_timing_;       // phase timing switched on by this player, for batch statistics or summary
+
         double      trail_dt;
         SE_Thread   thread;
         SE_Mutex    mutex;
@@ -58,6 +58,7 @@
 #include "odrSpiral.h"
 #include "pugixml.hpp"
 #include "CommonMini.hpp"
+#include "Profiler.hpp"
 
 using namespace std;
 using namespace roadmanager;
@@ -5314,6 +5315,8 @@ int RoadPath::Calculate(double& dist, bool bothDirections, double maxDist)
             }
         }
 
+        SE_Profiler::Count(SE_Profiler::Counter::ROAD_PATH_EXPANSIONS);
+
         link        = unvisited_[minIndex]->link;
         tmpDist     = unvisited_[minIndex]->dist;
         pivotRoad   = unvisited_[minIndex]->fromRoad;
@@ -6509,6 +6512,13 @@ bool Position::LoadOpenDrive(OpenDrive* odr)
 
 OpenDrive* Position::GetOpenDrive()
 {
+    OpenDrive* odr = SE_Env::Inst().GetRoadNetwork();
+    if (odr != nullptr)
+    {
+        // road network of a separate simulation instance, see SE_Env::Bind()
+        return odr;
+    }
+
     static OpenDrive od;
     return &od;
 }
@@ -7704,6 +7714,8 @@ Position::XYZ2TrackPos(double x3, double y3, double z3, int mode, bool connected
     bool              closestPointDirectlyConnected = false;
     std::vector<id_t> overlapping_roads_tmp;
 
+    SE_Profiler::Count(SE_Profiler::Counter::XYZ2TRACKPOS);
+
     if (mode == PosMode::UNDEFINED)
     {
         // mode "set" is default
@@ -7758,6 +7770,11 @@ Position::XYZ2TrackPos(double x3, double y3, double z3, int mode, bool connected
         // i == -2: Check limited point window around last known point
         // i == -1: Check current road
         // i > 0: Check all other roads
+        if (i == 0)
+        {
+            SE_Profiler::Count(SE_Profiler::Counter::XYZ2TRACKPOS_FULL_SCAN);
+        }
+
         if (i < 0)
         {
             // First check current road (from last known position).
@@ -10431,6 +10448,8 @@ bool Position::Delta(Position* pos_b, PositionDiff& diff, bool bothDirections, d
     bool   found;
     diff.dOppLane = false;
 
+    SE_Profiler::Count(SE_Profiler::Counter::DELTA);
+
     RoadPath* path = new RoadPath(this, pos_b);
     found          = (path->Calculate(dist, bothDirections, maxDist) == 0 && abs(dist) < maxDist);
     if (found)
@@ -11,6 +11,7 @@
  */
 
 #include "IdealSensor.hpp"
+#include <algorithm>
 
 using namespace scenarioengine;
 
@@ -57,104 +58,193 @@ ObjectSensor::~ObjectSensor()
     free(hitList_);
 }
 
-void ObjectSensor::Update()
+void SensorObjectGrid::Build(Entities *entities)
 {
-    nObj_ = 0;
-
-    for (size_t i = 0; i < entities_->object_.size(); i++)
+    double x_min = LARGE_NUMBER;
+    double x_max = -LARGE_NUMBER;
+    double y_min = LARGE_NUMBER;
+    double y_max = -LARGE_NUMBER;
+    int    n     = 0;
+
+    cell_.resize(entities->object_.size());
+    for (size_t i = 0; i < entities->object_.size(); i++)
     {
-        Object *obj = entities_->object_[i];
-        if (obj == host_ || obj->IsGhost())
+        Object *obj = entities->object_[i];
+        if (obj->IsGhost() || !(obj->visibilityMask_ & Object::Visibility::SENSORS))
         {
-            // skip own vehicle and any ghost vehicles
+            // ghosts and objects not visible for sensors will never be detected
+            cell_[i] = -1;
             continue;
         }
+        x_min = MIN(x_min, obj->pos_.GetX());
+        x_max = MAX(x_max, obj->pos_.GetX());
+        y_min = MIN(y_min, obj->pos_.GetY());
+        y_max = MAX(y_max, obj->pos_.GetY());
+        cell_[i] = 0;
+        n++;
+    }
 
-        if (!(obj->visibilityMask_ & Object::Visibility::SENSORS))
-        {
-            // Object is not visible for sensors
-            continue;
-        }
-
-        // Check whether object is within field of view
-
-        // find out angle between heading vector and line to object
-        double hx = 1.0;
-        double hy = 0.0;
-        double hx2, hy2;
-        RotateVec2D(hx, hy, host_->pos_.GetH(), hx2, hy2);
+    x_.resize(static_cast<unsigned int>(n));
+    y_.resize(static_cast<unsigned int>(n));
+    obj_.resize(static_cast<unsigned int>(n));
+    entity_idx_.resize(static_cast<unsigned int>(n));
 
-        double sensor_pos_x, sensor_pos_y;
-        RotateVec2D(pos_.x, pos_.y, host_->pos_.GetH(), sensor_pos_x, sensor_pos_y);
-        pos_.x_global = host_->pos_.GetX() + sensor_pos_x;
-        pos_.y_global = host_->pos_.GetY() + sensor_pos_y;
-        pos_.z_global = host_->pos_.GetZ() + pos_.z;
+    if (n == 0)
+    {
+        return;
+    }
 
-        // Find vector from host to object
-        double xo = obj->pos_.GetX() - pos_.x_global;
-        double yo = obj->pos_.GetY() - pos_.y_global;
+    // limit number of cells in relation to number of entities, e.g. for scattered entities
+    int max_cells = MAX(64, 4 * n);
+    x0_           = x_min;
+    y0_           = y_min;
+    size_         = cell_size_;
+    nx_           = static_cast<int>((x_max - x_min) / size_) + 1;
+    ny_           = static_cast<int>((y_max - y_min) / size_) + 1;
+    while (static_cast<double>(nx_) * ny_ > max_cells)
+    {
+        size_ *= 2.0;
+        nx_ = static_cast<int>((x_max - x_min) / size_) + 1;
+        ny_ = static_cast<int>((y_max - y_min) / size_) + 1;
+    }
 
-        // First check distance
-        double dist_sq = (xo * xo + yo * yo);
-        if (dist_sq < near_sq_ || dist_sq > far_sq_)
+    // counting sort of entities into cells
+    cell_start_.assign(static_cast<unsigned int>(nx_ * ny_ + 1), 0);
+    for (size_t i = 0; i < entities->object_.size(); i++)
+    {
+        if (cell_[i] < 0)
         {
-            // Not within near and far radius/distance
             continue;
         }
+        Object *obj = entities->object_[i];
+        int     cx  = MIN(nx_ - 1, static_cast<int>((obj->pos_.GetX() - x0_) / size_));
+        int     cy  = MIN(ny_ - 1, static_cast<int>((obj->pos_.GetY() - y0_) / size_));
+        cell_[i]    = cy * nx_ + cx;
+        cell_start_[static_cast<unsigned int>(cell_[i] + 1)]++;
+    }
 
-        double xon, yon;
-        NormalizeVec2D(xo, yo, xon, yon);
+    for (size_t i = 1; i < cell_start_.size(); i++)
+    {
+        cell_start_[i] += cell_start_[i - 1];
+    }
 
-        // Find angle to object
-        double angle     = acos(GetDotProduct2D(hx2, hy2, xon, yon));
-        double rel_angle = GetAbsAngleDifference(angle, pos_.h);
-        if (rel_angle < fovH_ / 2)
+    // use start index as insertion counter, then shift back
+    for (size_t i = 0; i < entities->object_.size(); i++)
+    {
+        if (cell_[i] < 0)
         {
-            hitList_[nObj_].obj_ = obj;
-
-            // Calculate hit object position in sensor local coordinates
-            double xl, yl;
-            RotateVec2D(xo, yo, -GetAngleSum(host_->pos_.GetH(), pos_.h), xl, yl);
-
-            hitList_[nObj_].x_ = xl;
-            hitList_[nObj_].y_ = yl;
-            hitList_[nObj_].z_ = obj->pos_.GetZ() - pos_.z_global + 0.7;
-
-            // Calculate hit object velocity in sensor local coordinates
-            double xVelTarget = obj->pos_.GetVelX();
-            double yVelTarget = obj->pos_.GetVelY();
-            double xVelHost   = host_->pos_.GetVelX();
-            double yVelHost   = host_->pos_.GetVelY();
-            double angleHost  = -GetAngleSum(host_->pos_.GetH(), pos_.h);
-            double targetVelXforHost, targetVelYforHost;
-            Global2LocalCoordinates(xVelTarget, yVelTarget, xVelHost, yVelHost, angleHost, targetVelXforHost, targetVelYforHost);
-            hitList_[nObj_].velX_ = targetVelXforHost;
-            hitList_[nObj_].velY_ = targetVelYforHost;
-
-            // Calculate hit object acceleration in sensor local coordinates
-            double xAccTarget = obj->pos_.GetAccX();
-            double yAccTarget = obj->pos_.GetAccY();
-            double xAccHost   = host_->pos_.GetAccX();
-            double yAccHost   = host_->pos_.GetAccY();
-            double targetAccXforHost, targetAccYforHost;
-            Global2LocalCoordinates(xAccTarget, yAccTarget, xAccHost, yAccHost, angleHost, targetAccXforHost, targetAccYforHost);
-            hitList_[nObj_].accX_ = targetAccXforHost;
-            hitList_[nObj_].accY_ = targetAccYforHost;
-
-            // Calculate hit object yaw, yaw rate and yaw acceleration in sensor local coordinates
-            double yawTarget     = obj->pos_.GetH();
-            double yawHost       = GetAngleSum(host_->pos_.GetH(), pos_.h);
-            hitList_[nObj_].yaw_ = GetAngleDifference(yawTarget, yawHost);
-
-            double yawRateTarget     = obj->pos_.GetHRate();
-            double yawRateHost       = host_->pos_.GetHRate();
-            hitList_[nObj_].yawRate_ = GetAngleDifference(yawRateTarget, yawRateHost);
-
-            double yawAccTarget     = obj->pos_.GetHAcc();
-            double yawAccHost       = host_->pos_.GetHAcc();
-            hitList_[nObj_].yawAcc_ = GetAngleDifference(yawAccTarget, yawAccHost);
-
-            nObj_++;
+            continue;
         }
+        unsigned int k = static_cast<unsigned int>(cell_start_[static_cast<unsigned int>(cell_[i])]++);
+        x_[k]          = entities->object_[i]->pos_.GetX();
+        y_[k]          = entities->object_[i]->pos_.GetY();
+        obj_[k]        = entities->object_[i];
+        entity_idx_[k] = static_cast<int>(i);
+    }
+
+    for (size_t i = cell_start_.size() - 1; i > 0; i--)
+    {
+        cell_start_[i] = cell_start_[i - 1];
     }
-}
\ No newline at end of file
+    cell_start_[0] = 0;
+}
+
+void ObjectSensor::Update()
+{
+    grid_.Build(entities_);
+    Update(grid_);
+}
+
+void ObjectSensor::Update(const SensorObjectGrid &grid)
+{
+    nObj_ = 0;
+
+    // Sensor pose in global coordinates, same for all objects
+    double h_host   = host_->pos_.GetH();
+    double h_sensor = GetAngleSum(h_host, pos_.h);
+    double sensor_pos_x, sensor_pos_y;
+    RotateVec2D(pos_.x, pos_.y, h_host, sensor_pos_x, sensor_pos_y);
+    pos_.x_global = host_->pos_.GetX() + sensor_pos_x;
+    pos_.y_global = host_->pos_.GetY() + sensor_pos_y;
+    pos_.z_global = host_->pos_.GetZ() + pos_.z;
+
+    // Object is within field of view if angle to sensor direction is at most half FOV, i.e.
+    // dot(dir, v) >= |v| * cos(fovH / 2), avoiding acos per object
+    double        dir_x    = cos(h_sensor);
+    double        dir_y    = sin(h_sensor);
+    double        cos_half = fovH_ < 2 * M_PI ? cos(fovH_ / 2) : -2.0;
+    double        sx       = pos_.x_global;
+    double        sy       = pos_.y_global;
+    double        near_sq  = near_sq_;
+    double        far_sq   = far_sq_;
+    const double *gx       = grid.GetX();
+    const double *gy       = grid.GetY();
+
+    candidates_.clear();
+    inside_.resize(static_cast<unsigned int>(grid.GetNumberOfEntries()));
+    grid.ForEachRange(sx,
+                      sy,
+                      far_,
+                      [&](int first, int last)
+                      {
+                          // branch free, for the compiler to vectorize
+                          for (int k = first; k < last; k++)
+                          {
+                              double xo      = gx[k] - sx;
+                              double yo      = gy[k] - sy;
+                              double dist_sq = xo * xo + yo * yo;
+                              double dot     = dir_x * xo + dir_y * yo;
+                              inside_[static_cast<unsigned int>(k)] =
+                                  static_cast<uint8_t>((dist_sq >= near_sq) & (dist_sq <= far_sq) & (dot >= cos_half * sqrt(dist_sq)));
+                          }
+                          for (int k = first; k < last; k++)
+                          {
+                              if (inside_[static_cast<unsigned int>(k)] && grid.GetObject(k) != host_)
+                              {
+                                  candidates_.push_back(k);
+                              }
+                          }
+                      });
+
+    // Report objects in same order as the entities list, up to max number of objects
+    std::sort(candidates_.begin(), candidates_.end(), [&grid](int a, int b) { return grid.GetEntityIdx(a) < grid.GetEntityIdx(b); });
+
+    double angleHost = -h_sensor;
+    double xVelHost  = host_->pos_.GetVelX();
+    double yVelHost  = host_->pos_.GetVelY();
+    double xAccHost  = host_->pos_.GetAccX();
+    double yAccHost  = host_->pos_.GetAccY();
+
+    for (size_t i = 0; i < candidates_.size() && nObj_ < maxObj_; i++)
+    {
+        Object *obj          = grid.GetObject(candidates_[i]);
+        hitList_[nObj_].obj_ = obj;
+
+        // Calculate hit object position in sensor local coordinates
+        double xl, yl;
+        RotateVec2D(obj->pos_.GetX() - sx, obj->pos_.GetY() - sy, angleHost, xl, yl);
+
+        hitList_[nObj_].x_ = xl;
+        hitList_[nObj_].y_ = yl;
+        hitList_[nObj_].z_ = obj->pos_.GetZ() - pos_.z_global + 0.7;
+
+        // Calculate hit object velocity in sensor local coordinates
+        double targetVelXforHost, targetVelYforHost;
+        Global2LocalCoordinates(obj->pos_.GetVelX(), obj->pos_.GetVelY(), xVelHost, yVelHost, angleHost, targetVelXforHost, targetVelYforHost);
+        hitList_[nObj_].velX_ = targetVelXforHost;
+        hitList_[nObj_].velY_ = targetVelYforHost;
+
+        // Calculate hit object acceleration in sensor local coordinates
+        double targetAccXforHost, targetAccYforHost;
+        Global2LocalCoordinates(obj->pos_.GetAccX(), obj->pos_.GetAccY(), xAccHost, yAccHost, angleHost, targetAccXforHost, targetAccYforHost);
+        hitList_[nObj_].accX_ = targetAccXforHost;
+        hitList_[nObj_].accY_ = targetAccYforHost;
+
+        // Calculate hit object yaw, yaw rate and yaw acceleration in sensor local coordinates
+        hitList_[nObj_].yaw_     = GetAngleDifference(obj->pos_.GetH(), h_sensor);
+        hitList_[nObj_].yawRate_ = GetAngleDifference(obj->pos_.GetHRate(), host_->pos_.GetHRate());
+        hitList_[nObj_].yawAcc_  = GetAngleDifference(obj->pos_.GetHAcc(), host_->pos_.GetHAcc());
+
+        nObj_++;
+    }
+}
@@ -14,8 +14,98 @@
 
 #include "ScenarioEngine.hpp"
 
+#define SENSOR_GRID_CELL_SIZE 25.0  // default size of spatial grid cells, in meters
+
 namespace scenarioengine
 {
+    /**
+        Spatial grid of entity positions, rebuilt once per frame and shared by all object sensors.
+        Ghosts and entities not visible for sensors are left out. Positions are stored in separate x and y arrays,
+        sorted row by row and cell by cell, so that the cells of one row within a search area form a single
+        contiguous range.
+    */
+    class SensorObjectGrid
+    {
+    public:
+        SensorObjectGrid(double cell_size = SENSOR_GRID_CELL_SIZE) : cell_size_(cell_size), x0_(0.0), y0_(0.0), size_(cell_size), nx_(0), ny_(0)
+        {
+        }
+
+        /**
+            Sort current positions of all relevant entities into the grid
+            @param entities Collection of scenario entities
+        */
+        void Build(Entities *entities);
+
+        /**
+            Call func(first, last) for each row of cells overlapping the square around given point
+            @param x X coordinate of center point
+            @param y Y coordinate of center point
+            @param radius Half side length of the square
+            @param func Function called with range [first, last) of entries
+        */
+        template <class F>
+        void ForEachRange(double x, double y, double radius, F func) const
+        {
+            if (obj_.empty())
+            {
+                return;
+            }
+
+            int cx0 = MAX(0, static_cast<int>(floor((x - radius - x0_) / size_)));
+            int cx1 = MIN(nx_ - 1, static_cast<int>(floor((x + radius - x0_) / size_)));
+            int cy0 = MAX(0, static_cast<int>(floor((y - radius - y0_) / size_)));
+            int cy1 = MIN(ny_ - 1, static_cast<int>(floor((y + radius - y0_) / size_)));
+
+            for (int cy = cy0; cy <= cy1 && cx0 <= cx1; cy++)
+            {
+                int first = cell_start_[static_cast<unsigned int>(cy * nx_ + cx0)];
+                int last  = cell_start_[static_cast<unsigned int>(cy * nx_ + cx1 + 1)];
+                if (first < last)
+                {
+                    func(first, last);
+                }
+            }
+        }
+
+        int GetNumberOfEntries() const
+        {
+            return static_cast<int>(obj_.size());
+        }
+        const double *GetX() const
+        {
+            return x_.data();
+        }
+        const double *GetY() const
+        {
+            return y_.data();
+        }
+        Object *GetObject(int i) const
+        {
+            return obj_[static_cast<unsigned int>(i)];
+        }
+
+        // Index of the entity in the entities list, for keeping detections in same order as entities
+        int GetEntityIdx(int i) const
+        {
+            return entity_idx_[static_cast<unsigned int>(i)];
+        }
+
+    private:
+        double                cell_size_;  // requested cell size
+        double                x0_;         // grid origin, i.e. lower left corner
+        double                y0_;
+        double                size_;  // actual cell size, might be larger than requested to limit number of cells
+        int                   nx_;
+        int                   ny_;
+        std::vector<int>      cell_start_;  // first entry of each cell, one extra at end
+        std::vector<double>   x_;
+        std::vector<double>   y_;
+        std::vector<Object *> obj_;
+        std::vector<int>      entity_idx_;
+        std::vector<int>      cell_;  // cell of each entity in entities order, temporary
+    };
+
     typedef struct
     {
         double x;
@@ -92,10 +182,23 @@ namespace scenarioengine
                      double    fovH,
                      int       maxObj);
         ~ObjectSensor();
+
+        /**
+            Update list of detected objects, based on a grid of its own
+        */
         void Update();
 
+        /**
+            Update list of detected objects
+            @param grid Spatial grid of entity positions, built for current frame
+        */
+        void Update(const SensorObjectGrid &grid);
+
     private:
-        Entities *entities_;  // Reference to the global collection of objects within the scenario
+        Entities            *entities_;    // Reference to the global collection of objects within the scenario
+        SensorObjectGrid     grid_;        // Used when no shared grid is given
+        std::vector<int>     candidates_;  // Grid entries within field of view
+        std::vector<uint8_t> inside_;      // Per entry result of field of view test, for one range at a time
     };
 
 }  // namespace scenarioengine
@@ -13,10 +13,13 @@
 #include "CommonMini.hpp"
 #include "OSIReporter.hpp"
 #include "OSITrafficCommand.hpp"
+#include "Profiler.hpp"
+#include "TaskPool.hpp"
 #include <cmath>
 #include <string>
 #include <utility>
 #include <array>
+#include <google/protobuf/arena.h>
 
 #ifdef _WIN32
 #include <winsock2.h>
@@ -29,36 +32,19 @@
 #include <unistd.h> /* Needed for close() */
 #endif
 
-#define OSI_OUT_PORT          48198
-#define OSI_MAX_UDP_DATA_SIZE 8192
-
-// Large OSI messages needs to be split for UDP transmission
-// This struct must be mached on receiver side
-static struct
-{
-    int          counter;
-    unsigned int datasize;
-    char         data[OSI_MAX_UDP_DATA_SIZE];
-} osi_udp_buf;
+#define OSI_OUT_PORT               48198
+#define OSI_MAX_UDP_DATA_SIZE      8192
+#define OSI_ARENA_START_BLOCK_SIZE (64 * 1024)
+#define OSI_ARENA_MAX_BLOCK_SIZE   (4 * 1024 * 1024)
+#define OSI_GT_BUFFER_INITIAL_SIZE (256 * 1024)
+#define OSI_STATIC_GT_CACHE_FORMAT 1  // increase when content of static ground truth changes, to invalidate cache files
 
 typedef struct
 {
-    std::string  ground_truth;
-    unsigned int size;
+    std::vector<char> buffer;  // serialized message, reused between frames and only grown when needed
+    unsigned int      size;
 } OSIGroundTruth;
 
-typedef struct
-{
-    std::string  osi_lane_info;
-    unsigned int size;
-} OSIRoadLane;
-
-typedef struct
-{
-    std::string  osi_lane_boundary_info;
-    unsigned int size;
-} OSIRoadLaneBoundary;
-
 typedef struct
 {
     std::string  traffic_command;
@@ -85,40 +71,50 @@ static struct
 
 using namespace scenarioengine;
 
-static OSIGroundTruth      osiGroundTruth;
-static OSIRoadLane         osiRoadLane;
-static OSIRoadLaneBoundary osiRoadLaneBoundary;
-static OSITrafficCommand   osiTrafficCommand;
+static OSIGroundTruth    osiGroundTruth;
+static OSITrafficCommand osiTrafficCommand;
+
+// All OSI messages are allocated on this arena, which is released at once when the reporter is deleted
+// Memory of deleted messages is not released until then, so removed repeated elements are kept for reuse instead
+static google::protobuf::Arena *osi_arena = nullptr;
+
+// Serialized static ground truth of the road network, identified by a hash key of the OpenDRIVE file
+// Kept when the reporter is deleted, for reuse in next scenario based on the same road network
+static struct
+{
+    uint64_t    key;
+    std::string data;
+} osi_road_gt_cache = {0, ""};
 
 // ScenarioGateway
 
 OSIReporter::OSIReporter(ScenarioEngine *scenarioengine)
 {
-    udp_client_      = nullptr;
-    scenario_engine_ = scenarioengine;
+    udp_sender_           = nullptr;
+    shm_writer_           = nullptr;
+    osi_file_compression_ = false;
+    scenario_engine_      = scenarioengine;
 
-    obj_osi_internal.gt = new osi3::GroundTruth();
-    obj_osi_external.gt = new osi3::GroundTruth();
-    obj_osi_external.sv = new osi3::SensorView();
-    obj_osi_external.tc = new osi3::TrafficCommand();
+    google::protobuf::ArenaOptions arena_options;
+    arena_options.start_block_size = OSI_ARENA_START_BLOCK_SIZE;
+    arena_options.max_block_size   = OSI_ARENA_MAX_BLOCK_SIZE;
 
-    obj_osi_internal.gt->mutable_version()->set_version_major(3);
-#ifdef _OSI_VERSION_3_3_1
-    obj_osi_internal.gt->mutable_version()->set_version_minor(3);
-    obj_osi_internal.gt->mutable_version()->set_version_patch(1);
-#else
-    obj_osi_internal.gt->mutable_version()->set_version_minor(5);
-    obj_osi_internal.gt->mutable_version()->set_version_patch(0);
-#endif
+    osi_arena = new google::protobuf::Arena(arena_options);
 
-    obj_osi_internal.gt->mutable_timestamp()->set_seconds(0);
-    obj_osi_internal.gt->mutable_timestamp()->set_nanos(0);
+    obj_osi_internal.gt = google::protobuf::Arena::CreateMessage<osi3::GroundTruth>(osi_arena);
+    obj_osi_external.gt = google::protobuf::Arena::CreateMessage<osi3::GroundTruth>(osi_arena);
+    obj_osi_external.sv = google::protobuf::Arena::CreateMessage<osi3::SensorView>(osi_arena);
+    obj_osi_external.tc = google::protobuf::Arena::CreateMessage<osi3::TrafficCommand>(osi_arena);
 
     obj_osi_external.tc->mutable_timestamp()->set_seconds(0);
     obj_osi_external.tc->mutable_timestamp()->set_nanos(0);
 
     // Sensor Data
-    obj_osi_internal.sd = new osi3::SensorData();
+    obj_osi_internal.sd = google::protobuf::Arena::CreateMessage<osi3::SensorData>(osi_arena);
+
+    // Preallocate serialization buffer, normally big enough for all frames but the first one including static data
+    osiGroundTruth.buffer.resize(OSI_GT_BUFFER_INITIAL_SIZE);
+    osiGroundTruth.size = 0;
 
     // Counter for OSI update
     osi_update_counter_ = 0;
@@ -128,56 +124,79 @@ OSIReporter::OSIReporter(ScenarioEngine *scenarioengine)
 
 OSIReporter::~OSIReporter()
 {
-    if (obj_osi_internal.gt)
-    {
-        obj_osi_internal.gt->Clear();
-        delete obj_osi_internal.gt;
-    }
-
-    if (obj_osi_external.gt)
-    {
-        obj_osi_external.gt->Clear();
-        delete obj_osi_external.gt;
-    }
+    // messages are owned by the arena
+    obj_osi_internal.gt = nullptr;
+    obj_osi_internal.sd = nullptr;
+    obj_osi_external.gt = nullptr;
+    obj_osi_external.sv = nullptr;
+    obj_osi_external.tc = nullptr;
+    delete osi_arena;
+    osi_arena = nullptr;
 
-    if (obj_osi_internal.sd)
-    {
-        obj_osi_internal.sd->Clear();
-        delete obj_osi_internal.sd;
-    }
+    obj_osi_internal.ln.clear();
+    obj_osi_internal.lnb.clear();
 
-    if (obj_osi_external.sv)
-    {
-        obj_osi_external.sv->Clear();
-        delete obj_osi_external.sv;
-    }
+    osiGroundTruth.size    = 0;
+    osiTrafficCommand.size = 0;
+    std::vector<char>().swap(osiGroundTruth.buffer);
 
-    if (obj_osi_external.tc)
+    if (udp_sender_ != nullptr)
     {
-        obj_osi_external.tc->Clear();
-        delete obj_osi_external.tc;
+        UDPFrameSender::Stats stats = udp_sender_->GetStats();
+        delete udp_sender_;  // waits for last frame to be sent
+        if (stats.frames_sent > 0)
+        {
+            LOG("OSI UDP: %llu frames sent, %llu dropped, %llu failed, send time avg %.3f ms max %.3f ms",
+                static_cast<unsigned long long>(stats.frames_sent),
+                static_cast<unsigned long long>(stats.frames_dropped),
+                static_cast<unsigned long long>(stats.frames_failed),
+                1E3 * stats.send_time_sum / static_cast<double>(stats.frames_sent),
+                1E3 * stats.send_time_max);
+        }
     }
+    delete shm_writer_;
 
-    obj_osi_internal.ln.clear();
-    obj_osi_internal.lnb.clear();
+    osi_file.Close();
+}
 
-    osiGroundTruth.size    = 0;
-    osiRoadLane.size       = 0;
-    osiTrafficCommand.size = 0;
+SE_SOCKET OSIReporter::OpenSocket(std::string ipaddr)
+{
+    // Large OSI messages are split in fragments for UDP transmission, see UDPFrameSender for format
+    delete udp_sender_;
+    udp_sender_ = new UDPFrameSender(OSI_OUT_PORT, ipaddr, OSI_MAX_UDP_DATA_SIZE);
 
-    delete udp_client_;
+    return udp_sender_->GetStatus();
+}
 
-    if (osi_file.is_open())
+void OSIReporter::SetUDPPacing(int burst_size, int gap_us)
+{
+    if (udp_sender_ != nullptr)
     {
-        osi_file.close();
+        udp_sender_->SetPacing(burst_size, gap_us);
     }
 }
 
-SE_SOCKET OSIReporter::OpenSocket(std::string ipaddr)
+int OSIReporter::SetUDPSendBufferSize(int size)
+{
+    return udp_sender_ != nullptr ? udp_sender_->SetSendBufferSize(size) : -1;
+}
+
+int OSIReporter::GetUDPStats(UDPFrameSender::Stats &stats)
 {
-    udp_client_ = new UDPClient(OSI_OUT_PORT, ipaddr);
+    if (udp_sender_ == nullptr)
+    {
+        return -1;
+    }
+    stats = udp_sender_->GetStats();
 
-    return udp_client_->GetStatus();
+    return 0;
+}
+
+void OSIReporter::OpenSharedMemory(std::string name)
+{
+    // the shared memory object is created on first write, when the frame size is known
+    delete shm_writer_;
+    shm_writer_ = new SharedMemoryWriter(name);
 }
 
 void OSIReporter::ReportSensors(std::vector<ObjectSensor *> sensor)
@@ -190,96 +209,135 @@ void OSIReporter::ReportSensors(std::vector<ObjectSensor *> sensor)
     {
         obj_osi_internal.sd->add_sensor_view();
     }
-    for (unsigned int i = 0; i < sensor.size(); i++)
-    {
-        // Clear history
-        obj_osi_internal.sd->mutable_sensor_view(static_cast<int>(i))->mutable_global_ground_truth()->clear_moving_object();
-        for (unsigned int j = 0; j < static_cast<unsigned int>(sensor[i]->nObj_); j++)
-        {
-            // Create moving object
-            osi3::MovingObject *mobj;
-            mobj = obj_osi_internal.sd->mutable_sensor_view(static_cast<int>(i))->mutable_global_ground_truth()->add_moving_object();
-
-            // Populate sensor data
-            mobj->mutable_id()->set_value(static_cast<unsigned int>(sensor[i]->hitList_[j].obj_->id_));
-            mobj->mutable_base()->mutable_position()->set_x(sensor[i]->hitList_[j].x_ +
-                                                            static_cast<double>(sensor[i]->hitList_[j].obj_->boundingbox_.center_.x_) *
-                                                                cos(sensor[i]->hitList_[j].yaw_));
-            mobj->mutable_base()->mutable_position()->set_y(sensor[i]->hitList_[j].y_ +
-                                                            static_cast<double>(sensor[i]->hitList_[j].obj_->boundingbox_.center_.x_) *
-                                                                sin(sensor[i]->hitList_[j].yaw_));
-            mobj->mutable_base()->mutable_position()->set_z(sensor[i]->hitList_[j].z_);
-            mobj->mutable_base()->mutable_velocity()->set_x(sensor[i]->hitList_[j].velX_);
-            mobj->mutable_base()->mutable_velocity()->set_y(sensor[i]->hitList_[j].velY_);
-            mobj->mutable_base()->mutable_velocity()->set_z(sensor[i]->hitList_[j].velZ_);
-            mobj->mutable_base()->mutable_acceleration()->set_x(sensor[i]->hitList_[j].accX_);
-            mobj->mutable_base()->mutable_acceleration()->set_y(sensor[i]->hitList_[j].accY_);
-            mobj->mutable_base()->mutable_acceleration()->set_z(sensor[i]->hitList_[j].accZ_);
-            mobj->mutable_base()->mutable_orientation()->set_yaw(sensor[i]->hitList_[j].yaw_);
-            mobj->mutable_base()->mutable_orientation_rate()->set_yaw(sensor[i]->hitList_[j].yawRate_);
-            mobj->mutable_base()->mutable_orientation_acceleration()->set_yaw(sensor[i]->hitList_[j].yawAcc_);
-            mobj->mutable_base()->mutable_dimension()->set_height(sensor[i]->hitList_[j].obj_->boundingbox_.dimensions_.height_);
-            mobj->mutable_base()->mutable_dimension()->set_length(sensor[i]->hitList_[j].obj_->boundingbox_.dimensions_.length_);
-            mobj->mutable_base()->mutable_dimension()->set_width(sensor[i]->hitList_[j].obj_->boundingbox_.dimensions_.width_);
-        }
-    }
+
+    // Sensors are independent, each one writing into its own sensor view, i.e. same order as sensor list
+    SE_TaskPool::Inst().ParallelFor(static_cast<int>(sensor.size()),
+                                    [&sensor](int i)
+                                    {
+                                        ObjectSensor      *s  = sensor[static_cast<unsigned int>(i)];
+                                        osi3::GroundTruth *gt = obj_osi_internal.sd->mutable_sensor_view(i)->mutable_global_ground_truth();
+
+                                        // Clear history, keeping allocated objects for reuse
+                                        gt->clear_moving_object();
+                                        for (unsigned int j = 0; j < static_cast<unsigned int>(s->nObj_); j++)
+                                        {
+                                            const ObjectSensor::ObjectHit &hit  = s->hitList_[j];
+                                            osi3::MovingObject            *mobj = gt->add_moving_object();
+                                            osi3::BaseMoving              *base = mobj->mutable_base();
+
+                                            // Populate sensor data
+                                            mobj->mutable_id()->set_value(static_cast<unsigned int>(hit.obj_->id_));
+                                            base->mutable_position()->set_x(hit.x_ + static_cast<double>(hit.obj_->boundingbox_.center_.x_) * cos(hit.yaw_));
+                                            base->mutable_position()->set_y(hit.y_ + static_cast<double>(hit.obj_->boundingbox_.center_.x_) * sin(hit.yaw_));
+                                            base->mutable_position()->set_z(hit.z_);
+                                            base->mutable_velocity()->set_x(hit.velX_);
+                                            base->mutable_velocity()->set_y(hit.velY_);
+                                            base->mutable_velocity()->set_z(hit.velZ_);
+                                            base->mutable_acceleration()->set_x(hit.accX_);
+                                            base->mutable_acceleration()->set_y(hit.accY_);
+                                            base->mutable_acceleration()->set_z(hit.accZ_);
+                                            base->mutable_orientation()->set_yaw(hit.yaw_);
+                                            base->mutable_orientation_rate()->set_yaw(hit.yawRate_);
+                                            base->mutable_orientation_acceleration()->set_yaw(hit.yawAcc_);
+                                            base->mutable_dimension()->set_height(hit.obj_->boundingbox_.dimensions_.height_);
+                                            base->mutable_dimension()->set_length(hit.obj_->boundingbox_.dimensions_.length_);
+                                            base->mutable_dimension()->set_width(hit.obj_->boundingbox_.dimensions_.width_);
+                                        }
+                                    });
 }
 
 bool OSIReporter::OpenOSIFile(const char *filename)
 {
-    osi_file.open(filename, std::ios_base::binary);
-    if (!osi_file.good())
+    // written by background thread, see TraceFileWriter
+    if (osi_file.Open(filename, osi_file_compression_) != 0)
     {
         LOG("Failed open OSI tracefile %s", filename);
         return false;
     }
-    LOG("OSI tracefile %s opened", filename);
+    LOG("OSI tracefile %s opened%s", filename, osi_file_compression_ ? " (compressed)" : "");
     return true;
 }
 
 void OSIReporter::CloseOSIFile()
 {
-    osi_file.close();
+    osi_file.Close();
 }
 
 bool OSIReporter::WriteOSIFile()
 {
-    if (!osi_file.good())
+    // write to file, first size of message
+    // then actual message - the groundtruth object including timestamp and moving objects
+    if (osi_file.Write(&osiGroundTruth.size, sizeof(osiGroundTruth.size)) != 0 || osi_file.Write(osiGroundTruth.buffer.data(), osiGroundTruth.size) != 0)
     {
+        LOG("Failed write osi file");
         return false;
     }
+    return true;
+}
 
-    // write to file, first size of message
-    osi_file.write(reinterpret_cast<char *>(&osiGroundTruth.size), sizeof(osiGroundTruth.size));
+void OSIReporter::FlushOSIFile()
+{
+    osi_file.Flush();
+}
 
-    // write to file, actual message - the groundtruth object including timestamp and moving objects
-    osi_file.write(osiGroundTruth.ground_truth.c_str(), osiGroundTruth.size);
+void OSIReporter::SerializeOSIGroundTruth()
+{
+    size_t static_size = 0;
 
-    // write to file, first size of message
-    // osi_file.write(reinterpret_cast<char *>(&osiTrafficCommand.size), sizeof(osiTrafficCommand.size));
+    if (static_gt_reported_)
+    {
+        // Static data has already been serialized. Move it out of the message while serializing the rest, and splice
+        // the cached bytes in front. Concatenated messages are equivalent to the merged message in protobuf wire format.
+        SwapOSIStaticGroundTruth();
+        static_size = static_gt_serialized_.size();
+    }
 
-    // write to file, actual message - the groundtruth object including timestamp and moving objects
-    // osi_file.write(osiTrafficCommand.traffic_command.c_str(), osiTrafficCommand.size);
+    // ByteSizeLong() calculates and caches the size of all sub messages, which is then reused by the serialization
+    size_t size = obj_osi_external.gt->ByteSizeLong();
 
-    if (!osi_file.good())
+    if (static_size + size > osiGroundTruth.buffer.size())
     {
-        LOG("Failed write osi file");
-        return false;
+        // grow with some margin to avoid reallocation (and a new data pointer) for small increases
+        osiGroundTruth.buffer.resize(static_size + size + (static_size + size) / 2);
     }
-    return true;
-}
 
-void OSIReporter::FlushOSIFile()
-{
-    if (osi_file.good())
+    if (static_size > 0)
+    {
+        memcpy(osiGroundTruth.buffer.data(), static_gt_serialized_.data(), static_size);
+    }
+    obj_osi_external.gt->SerializeWithCachedSizesToArray(reinterpret_cast<uint8_t *>(osiGroundTruth.buffer.data() + static_size));
+    osiGroundTruth.size = static_cast<unsigned int>(static_size + size);
+    SE_Profiler::Count(SE_Profiler::Counter::OSI_BYTES_SERIALIZED, static_cast<int64_t>(osiGroundTruth.size));
+
+    if (static_gt_reported_)
     {
-        osi_file.flush();
+        SwapOSIStaticGroundTruth();
     }
 }
 
+void OSIReporter::SwapOSIStaticGroundTruth()
+{
+    // Messages of both ground truth objects are allocated on the same arena, hence swap is just an exchange of pointers
+    obj_osi_external.gt->mutable_stationary_object()->Swap(obj_osi_internal.gt->mutable_stationary_object());
+    obj_osi_external.gt->mutable_lane()->Swap(obj_osi_internal.gt->mutable_lane());
+    obj_osi_external.gt->mutable_lane_boundary()->Swap(obj_osi_internal.gt->mutable_lane_boundary());
+    obj_osi_external.gt->mutable_traffic_sign()->Swap(obj_osi_internal.gt->mutable_traffic_sign());
+    obj_osi_external.gt->mutable_traffic_light()->Swap(obj_osi_internal.gt->mutable_traffic_light());
+    obj_osi_external.gt->mutable_road_marking()->Swap(obj_osi_internal.gt->mutable_road_marking());
+}
+
 int OSIReporter::ClearOSIGroundTruth()
 {
     obj_osi_external.gt->clear_moving_object();
+    moving_object_idx_.clear();
+    moving_object_reported_.clear();
+
+    if (static_gt_reported_)
+    {
+        // Hand back static data, keeping it for next report
+        SwapOSIStaticGroundTruth();
+        static_gt_reported_ = false;
+    }
     obj_osi_external.gt->clear_stationary_object();
     obj_osi_external.gt->clear_lane();
     obj_osi_external.gt->clear_lane_boundary();
@@ -310,45 +368,20 @@ int OSIReporter::UpdateOSIGroundTruth(const std::vector<std::unique_ptr<ObjectSt
 
     UpdateOSIDynamicGroundTruth(objectState);
 
-    if (GetUDPClientStatus() == 0 || IsFileOpen())
+    if (GetUDPClientStatus() == 0 || IsFileOpen() || GetSharedMemoryStatus() == 0)
     {
-        obj_osi_external.gt->SerializeToString(&osiGroundTruth.ground_truth);
-        osiGroundTruth.size = static_cast<unsigned int>(obj_osi_external.gt->ByteSizeLong());
+        SerializeOSIGroundTruth();
     }
 
-    if (GetUDPClientStatus() == 0)
+    if (GetSharedMemoryStatus() == 0)
     {
-        // send over udp - split large OSI messages in multiple transmissions
-        unsigned int sentDataBytes = 0;
-
-        for (osi_udp_buf.counter = 1; sentDataBytes < osiGroundTruth.size; osi_udp_buf.counter++)
-        {
-            osi_udp_buf.datasize = MIN(osiGroundTruth.size - sentDataBytes, OSI_MAX_UDP_DATA_SIZE);
-            memcpy(osi_udp_buf.data, &osiGroundTruth.ground_truth.c_str()[sentDataBytes], osi_udp_buf.datasize);
-            int packSize = static_cast<int>(sizeof(osi_udp_buf)) - static_cast<int>((OSI_MAX_UDP_DATA_SIZE - osi_udp_buf.datasize));
-
-            if (sentDataBytes + osi_udp_buf.datasize >= osiGroundTruth.size)
-            {
-                // Last package indicated by negative counter number
-                osi_udp_buf.counter = -osi_udp_buf.counter;
-            }
-
-            int sendResult = udp_client_->Send(reinterpret_cast<char *>(&osi_udp_buf), static_cast<unsigned int>(packSize));  // TODO: @Emil
+        shm_writer_->Write(osiGroundTruth.buffer.data(), osiGroundTruth.size);
+    }
 
-            if (sendResult != packSize)
-            {
-                LOG("Failed send osi package over UDP");
-#ifdef _WIN32
-                wprintf(L"send failed with error: %d\n", WSAGetLastError());
-#endif
-                // Give up
-                sentDataBytes = osiGroundTruth.size;
-            }
-            else
-            {
-                sentDataBytes += osi_udp_buf.datasize;
-            }
-        }
+    if (GetUDPClientStatus() == 0)
+    {
+        // hand over to sender thread, which splits large OSI messages in multiple transmissions
+        udp_sender_->Send(osiGroundTruth.buffer.data(), osiGroundTruth.size);
     }
 
     if (IsFileOpen())
@@ -364,24 +397,95 @@ int OSIReporter::UpdateOSIGroundTruth(const std::vector<std::unique_ptr<ObjectSt
 
 int OSIReporter::UpdateOSIStaticGroundTruth(const std::vector<std::unique_ptr<ObjectState>> &objectState)
 {
-    // First pick objects from the OpenSCENARIO description
-    static roadmanager::OpenDrive *opendrive = roadmanager::Position::GetOpenDrive();
-    for (size_t i = 0; i < static_cast<unsigned int>(opendrive->GetNumOfRoads()); i++)
+    SE_PROFILE_SCOPE(OSI_STATIC_GT);
+
+    if (!static_gt_built_)
+    {
+        BuildOSIStaticGroundTruth(objectState);
+        static_gt_built_ = true;
+    }
+
+    // Set GeoReference in OSI as map_reference
+    obj_osi_external.gt->set_map_reference(roadmanager::Position::GetOpenDrive()->GetGeoReferenceAsString());
+
+    obj_osi_external.gt->set_model_reference(stationary_model_reference);
+
+    if (!static_gt_reported_)
+    {
+        // Static data is built once and then moved into the external ground truth for as long as it's reported
+        SwapOSIStaticGroundTruth();
+        static_gt_reported_ = true;
+    }
+
+    return 0;
+}
+
+int OSIReporter::BuildOSIStaticGroundTruth(const std::vector<std::unique_ptr<ObjectState>> &objectState)
+{
+    roadmanager::OpenDrive *opendrive = roadmanager::Position::GetOpenDrive();
+    uint64_t                key       = GetOSIRoadGroundTruthKey();
+    bool                    cached    = false;
+
+    if (key != 0)
+    {
+        if (osi_road_gt_cache.key != key && !static_gt_cache_dir_.empty())
+        {
+            ReadOSIRoadGroundTruthCacheFile(key);
+        }
+
+        if (osi_road_gt_cache.key == key)
+        {
+            if (obj_osi_internal.gt->ParseFromString(osi_road_gt_cache.data))
+            {
+                IndexOSIRoadGroundTruth();
+                cached = true;
+            }
+            else
+            {
+                LOG("Failed to parse cached OSI static ground truth, rebuilding it");
+                obj_osi_internal.gt->Clear();
+            }
+        }
+    }
+
+    if (!cached)
     {
-        roadmanager::Road *road = opendrive->GetRoadByIdx(static_cast<int>(i));
-        if (road)
+        // First pick objects from the OpenDRIVE description
+        for (size_t i = 0; i < static_cast<unsigned int>(opendrive->GetNumOfRoads()); i++)
         {
-            for (size_t j = 0; j < static_cast<unsigned int>(road->GetNumberOfObjects()); j++)
+            roadmanager::Road *road = opendrive->GetRoadByIdx(static_cast<int>(i));
+            if (road)
             {
-                roadmanager::RMObject *object = road->GetRoadObject(static_cast<int>(j));
-                if (object)
+                for (size_t j = 0; j < static_cast<unsigned int>(road->GetNumberOfObjects()); j++)
                 {
-                    UpdateOSIStationaryObjectODR(road->GetId(), object);
+                    roadmanager::RMObject *object = road->GetRoadObject(static_cast<int>(j));
+                    if (object)
+                    {
+                        UpdateOSIStationaryObjectODR(road->GetId(), object);
+                    }
                 }
             }
         }
+
+        UpdateOSIRoadLane();
+        UpdateOSILaneBoundary();
+        UpdateOSIIntersection();
+        UpdateTrafficSignals();
+
+        if (key != 0)
+        {
+            osi_road_gt_cache.key = key;
+            obj_osi_internal.gt->SerializeToString(&osi_road_gt_cache.data);
+
+            if (!static_gt_cache_dir_.empty())
+            {
+                WriteOSIRoadGroundTruthCacheFile();
+            }
+        }
     }
 
+    IndexOSIRoadLanes();
+
     // Then pick objects from the OpenSCENARIO description
     for (size_t i = 0; i < objectState.size(); i++)
     {
@@ -401,49 +505,173 @@ int OSIReporter::UpdateOSIStaticGroundTruth(const std::vector<std::unique_ptr<Ob
         }
     }
 
-    UpdateOSIRoadLane();
-    UpdateOSILaneBoundary();
-    UpdateOSIIntersection();
-    UpdateTrafficSignals();
+    // Serialize once, to be spliced into outgoing messages
+    obj_osi_internal.gt->SerializeToString(&static_gt_serialized_);
 
-    // Set GeoReference in OSI as map_reference
-    obj_osi_external.gt->set_map_reference(opendrive->GetGeoReferenceAsString());
+    return 0;
+}
 
-    obj_osi_external.gt->mutable_stationary_object()->CopyFrom(*obj_osi_internal.gt->mutable_stationary_object());
-    obj_osi_external.gt->mutable_lane()->CopyFrom(*obj_osi_internal.gt->mutable_lane());
-    obj_osi_external.gt->mutable_lane_boundary()->CopyFrom(*obj_osi_internal.gt->mutable_lane_boundary());
-    obj_osi_external.gt->mutable_traffic_sign()->CopyFrom(*obj_osi_internal.gt->mutable_traffic_sign());
-    obj_osi_external.gt->mutable_traffic_light()->CopyFrom(*obj_osi_internal.gt->mutable_traffic_light());
-    obj_osi_external.gt->mutable_road_marking()->CopyFrom(*obj_osi_internal.gt->mutable_road_marking());
+uint64_t OSIReporter::GetOSIRoadGroundTruthKey()
+{
+    std::string filename = roadmanager::Position::GetOpenDrive()->GetOpenDriveFilename();
 
-    obj_osi_external.gt->set_model_reference(stationary_model_reference);
+    if (filename.empty())
+    {
+        return 0;
+    }
+
+    std::ifstream file(filename, std::ios_base::binary);
+    if (!file.is_open())
+    {
+        return 0;
+    }
+
+    // FNV-1a hash of the OpenDRIVE file content, cache format and OSI version
+    uint64_t hash = 14695981039346656037ULL;
+    char     buf[65536];
+
+    auto add_to_hash = [&hash](const char *data, size_t size)
+    {
+        for (size_t i = 0; i < size; i++)
+        {
+            hash ^= static_cast<unsigned char>(data[i]);
+            hash *= 1099511628211ULL;
+        }
+    };
+
+#ifdef _OSI_VERSION_3_3_1
+    std::string format = "osi3.3.1_" + std::to_string(OSI_STATIC_GT_CACHE_FORMAT);
+#else
+    std::string format = "osi3.5.0_" + std::to_string(OSI_STATIC_GT_CACHE_FORMAT);
+#endif
+    add_to_hash(format.c_str(), format.size());
+
+    while (file.read(buf, sizeof(buf)) || file.gcount() > 0)
+    {
+        add_to_hash(buf, static_cast<size_t>(file.gcount()));
+    }
+
+    return hash != 0 ? hash : 1;
+}
+
+std::string OSIReporter::GetOSIRoadGroundTruthCacheFilename(uint64_t key)
+{
+    char filename[64];
+    snprintf(filename, sizeof(filename), "osi_static_gt_%016llx.bin", static_cast<unsigned long long>(key));
+
+    return CombineDirectoryPathAndFilepath(static_gt_cache_dir_, filename);
+}
+
+int OSIReporter::ReadOSIRoadGroundTruthCacheFile(uint64_t key)
+{
+    std::string   filename = GetOSIRoadGroundTruthCacheFilename(key);
+    std::ifstream file(filename, std::ios_base::binary | std::ios_base::ate);
+
+    if (!file.is_open())
+    {
+        return -1;
+    }
+
+    osi_road_gt_cache.data.resize(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    if (!file.read(&osi_road_gt_cache.data[0], static_cast<std::streamsize>(osi_road_gt_cache.data.size())))
+    {
+        LOG("Failed to read OSI static ground truth cache file %s", filename.c_str());
+        osi_road_gt_cache.key = 0;
+        osi_road_gt_cache.data.clear();
+        return -1;
+    }
+    osi_road_gt_cache.key = key;
+
+    LOG("OSI static ground truth read from cache file %s", filename.c_str());
+
+    return 0;
+}
+
+int OSIReporter::WriteOSIRoadGroundTruthCacheFile()
+{
+    std::string   filename = GetOSIRoadGroundTruthCacheFilename(osi_road_gt_cache.key);
+    std::ofstream file(filename, std::ios_base::binary);
+
+    if (!file.is_open() || !file.write(osi_road_gt_cache.data.data(), static_cast<std::streamsize>(osi_road_gt_cache.data.size())))
+    {
+        LOG("Failed to write OSI static ground truth cache file %s", filename.c_str());
+        return -1;
+    }
+
+    LOG("OSI static ground truth cached in file %s", filename.c_str());
 
     return 0;
 }
 
+void OSIReporter::IndexOSIRoadGroundTruth()
+{
+    // Restore lookup lists of lanes and lane boundaries, as created when building road ground truth
+    obj_osi_internal.ln.clear();
+    obj_osi_internal.lnb.clear();
+
+    for (int i = 0; i < obj_osi_internal.gt->lane_size(); i++)
+    {
+        // intersections are not included, see UpdateOSIRoadLane() and UpdateOSIIntersection()
+        if (obj_osi_internal.gt->lane(i).classification().type() != osi3::Lane_Classification_Type::Lane_Classification_Type_TYPE_INTERSECTION)
+        {
+            obj_osi_internal.ln.push_back(obj_osi_internal.gt->mutable_lane(i));
+        }
+    }
+
+    for (int i = 0; i < obj_osi_internal.gt->lane_boundary_size(); i++)
+    {
+        obj_osi_internal.lnb.push_back(obj_osi_internal.gt->mutable_lane_boundary(i));
+    }
+}
+
+void OSIReporter::IndexOSIRoadLanes()
+{
+    // Lookup tables from OSI id to index in lane and lane boundary lists, for quick access by object lane queries
+    lane_idx_.clear();
+    lane_boundary_idx_.clear();
+
+    for (size_t i = 0; i < obj_osi_internal.ln.size(); i++)
+    {
+        lane_idx_[obj_osi_internal.ln[i]->id().value()] = static_cast<int>(i);
+    }
+
+    for (size_t i = 0; i < obj_osi_internal.lnb.size(); i++)
+    {
+        lane_boundary_idx_[obj_osi_internal.lnb[i]->id().value()] = static_cast<int>(i);
+    }
+
+    // road data does not change, so each message needs to be serialized only once
+    lane_serialized_.assign(obj_osi_internal.ln.size(), std::string());
+    lane_boundary_serialized_.assign(obj_osi_internal.lnb.size(), std::string());
+}
+
 int OSIReporter::UpdateOSIDynamicGroundTruth(const std::vector<std::unique_ptr<ObjectState>> &objectState, bool reportGhost)
 {
-    obj_osi_internal.gt->clear_moving_object();
-    obj_osi_internal.gt->clear_timestamp();
+    SE_PROFILE_SCOPE(OSI_DYNAMIC_GT);
+
+    // Moving objects are updated in place, directly in the externally shared ground truth. Objects not reported
+    // in this frame, e.g. despawned entities, are removed afterwards
+    obj_osi_external.gt->clear_timestamp();
 
     if (IsTimeStampSetExplicit())
     {
         // use excplicit timestamp
-        obj_osi_internal.gt->mutable_timestamp()->set_seconds(static_cast<int64_t>((nanosec_ / 1000000000)));
-        obj_osi_internal.gt->mutable_timestamp()->set_nanos(static_cast<uint32_t>((nanosec_ % 1000000000)));
+        obj_osi_external.gt->mutable_timestamp()->set_seconds(static_cast<int64_t>((nanosec_ / 1000000000)));
+        obj_osi_external.gt->mutable_timestamp()->set_nanos(static_cast<uint32_t>((nanosec_ % 1000000000)));
     }
     else if (objectState.size() > 0)
     {
         // use timstamp from object state
-        obj_osi_internal.gt->mutable_timestamp()->set_seconds(static_cast<int64_t>(objectState[0]->state_.info.timeStamp));
-        obj_osi_internal.gt->mutable_timestamp()->set_nanos(
+        obj_osi_external.gt->mutable_timestamp()->set_seconds(static_cast<int64_t>(objectState[0]->state_.info.timeStamp));
+        obj_osi_external.gt->mutable_timestamp()->set_nanos(
             static_cast<uint32_t>(((objectState[0]->state_.info.timeStamp - floor(objectState[0]->state_.info.timeStamp)) * 1e9)));
     }
     else
     {
         // report time = 0
-        obj_osi_internal.gt->mutable_timestamp()->set_seconds(static_cast<int64_t>(0));
-        obj_osi_internal.gt->mutable_timestamp()->set_nanos(static_cast<uint32_t>(0));
+        obj_osi_external.gt->mutable_timestamp()->set_seconds(static_cast<int64_t>(0));
+        obj_osi_external.gt->mutable_timestamp()->set_nanos(static_cast<uint32_t>(0));
     }
 
     for (size_t i = 0; i < objectState.size(); i++)
@@ -474,8 +702,7 @@ int OSIReporter::UpdateOSIDynamicGroundTruth(const std::vector<std::unique_ptr<O
         }
     }
 
-    obj_osi_external.gt->mutable_timestamp()->CopyFrom(*obj_osi_internal.gt->mutable_timestamp());
-    obj_osi_external.gt->mutable_moving_object()->CopyFrom(*obj_osi_internal.gt->mutable_moving_object());
+    RemoveUnreportedOSIMovingObjects();
 
     return 0;
 }
@@ -705,9 +932,133 @@ int OSIReporter::UpdateOSIStationaryObject(ObjectState *objectState)
 
 int OSIReporter::UpdateOSIMovingObject(ObjectState *objectState)
 {
-    // Create OSI Moving object
-    obj_osi_internal.mobj = obj_osi_internal.gt->add_moving_object();
+    // Moving objects are kept between frames, look up the one of this entity or create it if new
+    int                                idx = 0;
+    std::map<int, int>::const_iterator it  = moving_object_idx_.find(objectState->state_.info.id);
+
+    if (it == moving_object_idx_.end())
+    {
+        idx                                             = obj_osi_external.gt->moving_object_size();
+        obj_osi_internal.mobj                           = obj_osi_external.gt->add_moving_object();
+        moving_object_idx_[objectState->state_.info.id] = idx;
+        moving_object_reported_.push_back(true);
+        InitOSIMovingObject(objectState);
+    }
+    else
+    {
+        idx                                               = it->second;
+        obj_osi_internal.mobj                             = obj_osi_external.gt->mutable_moving_object(idx);
+        moving_object_reported_[static_cast<size_t>(idx)] = true;
+
+        // the bounding box normally stays the same, only rewrite it when changed
+        const OSCBoundingBox    &bb   = objectState->state_.info.boundingbox;
+        const osi3::Dimension3d &dim  = obj_osi_internal.mobj->base().dimension();
+        const osi3::Vector3d    &rear = obj_osi_internal.mobj->vehicle_attributes().bbcenter_to_rear();
+        if (!NEAR_NUMBERS(dim.length(), static_cast<double>(bb.dimensions_.length_)) ||
+            !NEAR_NUMBERS(dim.width(), static_cast<double>(bb.dimensions_.width_)) ||
+            !NEAR_NUMBERS(dim.height(), static_cast<double>(bb.dimensions_.height_)) ||
+            !NEAR_NUMBERS(rear.x(), (-static_cast<double>(bb.center_.x_))) ||
+            !NEAR_NUMBERS(rear.y(), (-static_cast<double>(bb.center_.y_))) ||
+            !NEAR_NUMBERS(rear.z(), (objectState->state_.info.rear_axle_z_pos - static_cast<double>(bb.center_.z_))))
+        {
+            UpdateOSIMovingObjectBoundingBox(objectState);
+        }
+    }
 
+    // Set OSI Moving Object Control Type
+    obj_osi_internal.mobj->mutable_vehicle_attributes()->mutable_driver_id()->set_value(static_cast<uint64_t>(objectState->state_.info.ctrl_type));
+
+    // Set OSI Moving Object Position
+    // As OSI defines the origin of the object coordinates in the center of the bounding box and esmini (as OpenSCENARIO)
+    // at the center of the rear axle, the position needs to be transformed.
+    // For the transformation the orientation of the object has to be taken into account.
+    double x_rel, y_rel, z_rel;
+    RotateVec3d(objectState->state_.pos.GetH(),
+                objectState->state_.pos.GetP(),
+                objectState->state_.pos.GetR(),
+                objectState->state_.info.boundingbox.center_.x_,
+                objectState->state_.info.boundingbox.center_.y_,
+                objectState->state_.info.boundingbox.center_.z_,
+                x_rel,
+                y_rel,
+                z_rel);
+
+    obj_osi_internal.mobj->mutable_base()->mutable_position()->set_x(objectState->state_.pos.GetX() + x_rel);
+    obj_osi_internal.mobj->mutable_base()->mutable_position()->set_y(objectState->state_.pos.GetY() + y_rel);
+    obj_osi_internal.mobj->mutable_base()->mutable_position()->set_z(objectState->state_.pos.GetZ() + z_rel);
+
+    // Set OSI Moving Object Orientation
+    obj_osi_internal.mobj->mutable_base()->mutable_orientation()->set_roll(GetAngleInIntervalMinusPIPlusPI(objectState->state_.pos.GetR()));
+    obj_osi_internal.mobj->mutable_base()->mutable_orientation()->set_pitch(GetAngleInIntervalMinusPIPlusPI(objectState->state_.pos.GetP()));
+    obj_osi_internal.mobj->mutable_base()->mutable_orientation()->set_yaw(GetAngleInIntervalMinusPIPlusPI(objectState->state_.pos.GetH()));
+    obj_osi_internal.mobj->mutable_base()->mutable_orientation_rate()->set_yaw(objectState->state_.pos.GetHRate());
+    obj_osi_internal.mobj->mutable_base()->mutable_orientation_rate()->set_pitch(objectState->state_.pos.GetPRate());
+    obj_osi_internal.mobj->mutable_base()->mutable_orientation_rate()->set_roll(objectState->state_.pos.GetRRate());
+    obj_osi_internal.mobj->mutable_base()->mutable_orientation_acceleration()->set_yaw(objectState->state_.pos.GetHAcc());
+    obj_osi_internal.mobj->mutable_base()->mutable_orientation_acceleration()->set_pitch(objectState->state_.pos.GetPAcc());
+    obj_osi_internal.mobj->mutable_base()->mutable_orientation_acceleration()->set_roll(objectState->state_.pos.GetRAcc());
+
+    // Set OSI Moving Object Velocity
+    obj_osi_internal.mobj->mutable_base()->mutable_velocity()->set_x(objectState->state_.pos.GetVelX());
+    obj_osi_internal.mobj->mutable_base()->mutable_velocity()->set_y(objectState->state_.pos.GetVelY());
+    obj_osi_internal.mobj->mutable_base()->mutable_velocity()->set_z(objectState->state_.pos.GetVelZ());
+
+    // Set OSI Moving Object Acceleration
+    obj_osi_internal.mobj->mutable_base()->mutable_acceleration()->set_x(objectState->state_.pos.GetAccX());
+    obj_osi_internal.mobj->mutable_base()->mutable_acceleration()->set_y(objectState->state_.pos.GetAccY());
+    obj_osi_internal.mobj->mutable_base()->mutable_acceleration()->set_z(objectState->state_.pos.GetAccZ());
+
+    // Set ego lane
+    if (obj_osi_internal.mobj->assigned_lane_id_size() == 0)
+    {
+        obj_osi_internal.mobj->add_assigned_lane_id();
+    }
+    obj_osi_internal.mobj->mutable_assigned_lane_id(0)->set_value(static_cast<unsigned int>(objectState->state_.pos.GetLaneGlobalId()));
+
+    // simplified wheel info, set nr wheels based on object type
+    // can be improved by considering axels and actual wheel configuration
+
+    if (objectState->state_.info.obj_type == static_cast<int>(Object::Type::VEHICLE))
+    {
+        // Set some data for each wheel, reusing wheel data messages of previous frame
+        int n_wheels = 0;
+        for (size_t i = 0; i < objectState->state_.info.wheel_data.size(); i++)
+        {
+            const WheelData &wheel = objectState->state_.info.wheel_data[i];
+
+            if (wheel.axle > -1)
+            {
+                if (n_wheels >= obj_osi_internal.mobj->vehicle_attributes().wheel_data_size())
+                {
+                    // create wheel data message
+                    obj_osi_internal.mobj->mutable_vehicle_attributes()->add_wheel_data();
+                }
+                osi3::MovingObject_VehicleAttributes_WheelData *wheel_data =
+                    obj_osi_internal.mobj->mutable_vehicle_attributes()->mutable_wheel_data(n_wheels++);
+
+                wheel_data->mutable_position()->set_x(wheel.x);
+                wheel_data->mutable_position()->set_y(wheel.y);
+                wheel_data->mutable_position()->set_z(wheel.z);
+                wheel_data->mutable_orientation()->set_yaw(wheel.h);
+                wheel_data->mutable_orientation()->set_pitch(wheel.p);
+                wheel_data->set_friction_coefficient(wheel.friction_coefficient);
+                wheel_data->set_axle(static_cast<unsigned int>(wheel.axle));
+                wheel_data->set_index(static_cast<unsigned int>(wheel.index));  // Index along axis
+            }
+        }
+
+        // remove surplus wheels, keeping their messages for reuse (see osi_arena)
+        while (n_wheels < obj_osi_internal.mobj->vehicle_attributes().wheel_data_size())
+        {
+            obj_osi_internal.mobj->mutable_vehicle_attributes()->mutable_wheel_data()->RemoveLast();
+        }
+    }
+
+    return 0;
+}
+
+int OSIReporter::InitOSIMovingObject(ObjectState *objectState)
+{
     // Set OSI Moving Object Mutable ID
     obj_osi_internal.mobj->mutable_id()->set_value(static_cast<unsigned int>(objectState->state_.info.id));
 
@@ -838,9 +1189,16 @@ int OSIReporter::UpdateOSIMovingObject(ObjectState *objectState)
         obj_osi_internal.mobj->set_type(osi3::MovingObject::Type::MovingObject_Type_TYPE_UNKNOWN);
     }
 
-    // Set OSI Moving Object Control Type
-    obj_osi_internal.mobj->mutable_vehicle_attributes()->mutable_driver_id()->set_value(static_cast<uint64_t>(objectState->state_.info.ctrl_type));
+    UpdateOSIMovingObjectBoundingBox(objectState);
+
+    // Set 3D model file as OSI model reference
+    obj_osi_internal.mobj->set_model_reference(objectState->state_.info.model3d);
+
+    return 0;
+}
 
+void OSIReporter::UpdateOSIMovingObjectBoundingBox(ObjectState *objectState)
+{
     // Set OSI Moving Object Boundingbox
     obj_osi_internal.mobj->mutable_vehicle_attributes()->mutable_bbcenter_to_rear()->set_x(
         static_cast<double>(-objectState->state_.info.boundingbox.center_.x_));
@@ -857,87 +1215,42 @@ int OSIReporter::UpdateOSIMovingObject(ObjectState *objectState)
     obj_osi_internal.mobj->mutable_base()->mutable_dimension()->set_height(objectState->state_.info.boundingbox.dimensions_.height_);
     obj_osi_internal.mobj->mutable_base()->mutable_dimension()->set_width(objectState->state_.info.boundingbox.dimensions_.width_);
     obj_osi_internal.mobj->mutable_base()->mutable_dimension()->set_length(objectState->state_.info.boundingbox.dimensions_.length_);
+}
 
-    // Set OSI Moving Object Position
-    // As OSI defines the origin of the object coordinates in the center of the bounding box and esmini (as OpenSCENARIO)
-    // at the center of the rear axle, the position needs to be transformed.
-    // For the transformation the orientation of the object has to be taken into account.
-    double x_rel, y_rel, z_rel;
-    RotateVec3d(objectState->state_.pos.GetH(),
-                objectState->state_.pos.GetP(),
-                objectState->state_.pos.GetR(),
-                objectState->state_.info.boundingbox.center_.x_,
-                objectState->state_.info.boundingbox.center_.y_,
-                objectState->state_.info.boundingbox.center_.z_,
-                x_rel,
-                y_rel,
-                z_rel);
-
-    obj_osi_internal.mobj->mutable_base()->mutable_position()->set_x(objectState->state_.pos.GetX() + x_rel);
-    obj_osi_internal.mobj->mutable_base()->mutable_position()->set_y(objectState->state_.pos.GetY() + y_rel);
-    obj_osi_internal.mobj->mutable_base()->mutable_position()->set_z(objectState->state_.pos.GetZ() + z_rel);
-
-    // Set OSI Moving Object Orientation
-    obj_osi_internal.mobj->mutable_base()->mutable_orientation()->set_roll(GetAngleInIntervalMinusPIPlusPI(objectState->state_.pos.GetR()));
-    obj_osi_internal.mobj->mutable_base()->mutable_orientation()->set_pitch(GetAngleInIntervalMinusPIPlusPI(objectState->state_.pos.GetP()));
-    obj_osi_internal.mobj->mutable_base()->mutable_orientation()->set_yaw(GetAngleInIntervalMinusPIPlusPI(objectState->state_.pos.GetH()));
-    obj_osi_internal.mobj->mutable_base()->mutable_orientation_rate()->set_yaw(objectState->state_.pos.GetHRate());
-    obj_osi_internal.mobj->mutable_base()->mutable_orientation_rate()->set_pitch(objectState->state_.pos.GetPRate());
-    obj_osi_internal.mobj->mutable_base()->mutable_orientation_rate()->set_roll(objectState->state_.pos.GetRRate());
-    obj_osi_internal.mobj->mutable_base()->mutable_orientation_acceleration()->set_yaw(objectState->state_.pos.GetHAcc());
-    obj_osi_internal.mobj->mutable_base()->mutable_orientation_acceleration()->set_pitch(objectState->state_.pos.GetPAcc());
-    obj_osi_internal.mobj->mutable_base()->mutable_orientation_acceleration()->set_roll(objectState->state_.pos.GetRAcc());
-
-    // Set OSI Moving Object Velocity
-    obj_osi_internal.mobj->mutable_base()->mutable_velocity()->set_x(objectState->state_.pos.GetVelX());
-    obj_osi_internal.mobj->mutable_base()->mutable_velocity()->set_y(objectState->state_.pos.GetVelY());
-    obj_osi_internal.mobj->mutable_base()->mutable_velocity()->set_z(objectState->state_.pos.GetVelZ());
-
-    // Set OSI Moving Object Acceleration
-    obj_osi_internal.mobj->mutable_base()->mutable_acceleration()->set_x(objectState->state_.pos.GetAccX());
-    obj_osi_internal.mobj->mutable_base()->mutable_acceleration()->set_y(objectState->state_.pos.GetAccY());
-    obj_osi_internal.mobj->mutable_base()->mutable_acceleration()->set_z(objectState->state_.pos.GetAccZ());
-
-    // Set ego lane
-    obj_osi_internal.mobj->add_assigned_lane_id()->set_value(static_cast<unsigned int>(objectState->state_.pos.GetLaneGlobalId()));
-
-    // simplified wheel info, set nr wheels based on object type
-    // can be improved by considering axels and actual wheel configuration
+void OSIReporter::RemoveUnreportedOSIMovingObjects()
+{
+    int n_reported = 0;
 
-    if (objectState->state_.info.obj_type == static_cast<int>(Object::Type::VEHICLE))
+    for (int i = 0; i < obj_osi_external.gt->moving_object_size(); i++)
     {
-        // Set some data for each wheel
-        for (int i = 0; i < static_cast<int>(objectState->state_.info.wheel_data.size()); i++)
+        if (moving_object_reported_[static_cast<size_t>(i)])
         {
-            if (objectState->state_.info.wheel_data[static_cast<unsigned int>(i)].axle > -1)
+            if (i != n_reported)
             {
-                // create wheel data message
-                obj_osi_internal.mobj->mutable_vehicle_attributes()->add_wheel_data();
-                obj_osi_internal.mobj->mutable_vehicle_attributes()->mutable_wheel_data(i)->mutable_position()->set_x(
-                    objectState->state_.info.wheel_data[static_cast<unsigned int>(i)].x);
-                obj_osi_internal.mobj->mutable_vehicle_attributes()->mutable_wheel_data(i)->mutable_position()->set_y(
-                    objectState->state_.info.wheel_data[static_cast<unsigned int>(i)].y);
-                obj_osi_internal.mobj->mutable_vehicle_attributes()->mutable_wheel_data(i)->mutable_position()->set_z(
-                    objectState->state_.info.wheel_data[static_cast<unsigned int>(i)].z);
-
-                obj_osi_internal.mobj->mutable_vehicle_attributes()->mutable_wheel_data(i)->mutable_orientation()->set_yaw(
-                    objectState->state_.info.wheel_data[static_cast<unsigned int>(i)].h);
-                obj_osi_internal.mobj->mutable_vehicle_attributes()->mutable_wheel_data(i)->mutable_orientation()->set_pitch(
-                    objectState->state_.info.wheel_data[static_cast<unsigned int>(i)].p);
-                obj_osi_internal.mobj->mutable_vehicle_attributes()->mutable_wheel_data(i)->set_friction_coefficient(
-                    objectState->state_.info.wheel_data[static_cast<unsigned int>(i)].friction_coefficient);
-                obj_osi_internal.mobj->mutable_vehicle_attributes()->mutable_wheel_data(i)->set_axle(
-                    static_cast<unsigned int>(objectState->state_.info.wheel_data[static_cast<unsigned int>(i)].axle));
-                obj_osi_internal.mobj->mutable_vehicle_attributes()->mutable_wheel_data(i)->set_index(
-                    static_cast<unsigned int>(objectState->state_.info.wheel_data[static_cast<unsigned int>(i)].index));  // Index along axis
+                // keep order of remaining objects
+                obj_osi_external.gt->mutable_moving_object()->SwapElements(i, n_reported);
             }
+            n_reported++;
         }
     }
 
-    // Set 3D model file as OSI model reference
-    obj_osi_internal.mobj->set_model_reference(objectState->state_.info.model3d);
+    if (n_reported < obj_osi_external.gt->moving_object_size())
+    {
+        // Entities despawned, remove their moving objects and reindex the remaining ones. RemoveLast() clears and keeps
+        // the messages for reuse by next add_moving_object(). Deleting them would not free their arena memory, growing
+        // it with every spawned entity.
+        while (obj_osi_external.gt->moving_object_size() > n_reported)
+        {
+            obj_osi_external.gt->mutable_moving_object()->RemoveLast();
+        }
+        moving_object_idx_.clear();
+        for (int i = 0; i < n_reported; i++)
+        {
+            moving_object_idx_[static_cast<int>(obj_osi_external.gt->moving_object(i).id().value())] = i;
+        }
+    }
 
-    return 0;
+    moving_object_reported_.assign(static_cast<size_t>(n_reported), false);
 }
 
 int OSIReporter::UpdateOSIIntersection()
@@ -981,7 +1294,7 @@ int OSIReporter::UpdateOSIIntersection()
     int                     g_id;
     roadmanager::OSIPoints *osipoints;
 
-    static roadmanager::OpenDrive *opendrive = roadmanager::Position::GetOpenDrive();
+    roadmanager::OpenDrive        *opendrive = roadmanager::Position::GetOpenDrive();
     osi3::Lane                    *osi_lane;
     for (int i = 0; i < opendrive->GetNumOfJunctions(); i++)
     {
@@ -1387,7 +1700,7 @@ int OSIReporter::UpdateOSIIntersection()
 int OSIReporter::UpdateOSILaneBoundary()
 {
     // Retrieve opendrive class from RoadManager
-    static roadmanager::OpenDrive *opendrive = roadmanager::Position::GetOpenDrive();
+    roadmanager::OpenDrive *opendrive = roadmanager::Position::GetOpenDrive();
 
     // Loop over all roads
     for (int i = 0; i < opendrive->GetNumOfRoads(); i++)
@@ -1648,7 +1961,7 @@ int OSIReporter::UpdateOSILaneBoundary()
 int OSIReporter::UpdateOSIRoadLane()
 {
     // Retrieve opendrive class from RoadManager
-    static roadmanager::OpenDrive *opendrive = roadmanager::Position::GetOpenDrive();
+    roadmanager::OpenDrive *opendrive = roadmanager::Position::GetOpenDrive();
 
     // Loop over all roads
     for (int i = 0; i < opendrive->GetNumOfRoads(); i++)
@@ -2229,7 +2542,7 @@ int OSIReporter::UpdateTrafficSignals()
     // obj_osi_internal.ts = obj_osi_internal.gt->add_traffic_sign();
 
     // Retrieve opendrive class from RoadManager
-    static roadmanager::OpenDrive *opendrive = roadmanager::Position::GetOpenDrive();
+    roadmanager::OpenDrive *opendrive = roadmanager::Position::GetOpenDrive();
 
     // Loop over all roads
     for (int i = 0; i < opendrive->GetNumOfRoads(); i++)
@@ -2459,14 +2772,13 @@ void OSIReporter::CreateLaneBoundaryFromSensordata(const osi3::SensorData &sd, i
 
 const char *OSIReporter::GetOSIGroundTruth(int *size)
 {
-    if (!(GetUDPClientStatus() == 0 || IsFileOpen()))
+    if (!(GetUDPClientStatus() == 0 || IsFileOpen() || GetSharedMemoryStatus() == 0))
     {
         // Data has not been serialized
-        obj_osi_external.gt->SerializeToString(&osiGroundTruth.ground_truth);
-        osiGroundTruth.size = static_cast<unsigned int>(obj_osi_external.gt->ByteSizeLong());
+        SerializeOSIGroundTruth();
     }
     *size = static_cast<int>(osiGroundTruth.size);
-    return osiGroundTruth.ground_truth.data();
+    return osiGroundTruth.buffer.data();
 }
 
 const char *OSIReporter::GetOSIGroundTruthRaw()
@@ -2479,77 +2791,73 @@ const char *OSIReporter::GetOSITrafficCommandRaw()
     return reinterpret_cast<char *>(obj_osi_external.tc);
 }
 
-const char *OSIReporter::GetOSIRoadLane(const std::vector<std::unique_ptr<ObjectState>> &objectState, int *size, int object_id)
+static const ObjectState *FindObjectState(const std::vector<std::unique_ptr<ObjectState>> &objectState, int object_id)
 {
-    // Check if object_id exists
-    if (static_cast<unsigned int>(object_id) >= objectState.size())
+    // object id normally equals index
+    if (object_id >= 0 && static_cast<size_t>(object_id) < objectState.size() && objectState[static_cast<size_t>(object_id)]->state_.info.id == object_id)
     {
-        LOG("Object %d not available, only %d registered", object_id, objectState.size());
-        *size = 0;
-        return 0;
+        return objectState[static_cast<size_t>(object_id)].get();
     }
 
-    // Find position of the object
-    roadmanager::Position pos;
     for (size_t i = 0; i < objectState.size(); i++)
     {
-        if (object_id == objectState[i]->state_.info.id)
+        if (objectState[i]->state_.info.id == object_id)
         {
-            pos = objectState[i]->state_.pos;
-            break;
+            return objectState[i].get();
         }
     }
 
-    // find the lane in the sensor view and save its index in the sensor view
-    int lane_id_of_vehicle = pos.GetLaneGlobalId();
-    int idx                = -1;
-    for (unsigned int i = 0; i < obj_osi_internal.ln.size(); i++)
+    return nullptr;
+}
+
+const char *OSIReporter::GetOSIRoadLane(const std::vector<std::unique_ptr<ObjectState>> &objectState, int *size, int object_id)
+{
+    *size = 0;
+
+    // Check if object_id exists
+    const ObjectState *obj_state = FindObjectState(objectState, object_id);
+    if (obj_state == nullptr)
     {
-        osi3::Identifier identifier = obj_osi_internal.ln[i]->id();
-        int              found_id   = static_cast<int>(identifier.value());
-        if (found_id == lane_id_of_vehicle)
-        {
-            idx = static_cast<int>(i);
-            break;
-        }
+        LOG("Object %d not available, only %d registered", object_id, objectState.size());
+        return 0;
     }
+
+    // find the lane of the object
+    int idx = GetLaneIdxfromIdOSI(obj_state->state_.pos.GetLaneGlobalId());
     if (idx < 0)
     {
         LOG("Failed to locate vehicle lane id!");
         return 0;
     }
-    // serialize to string the single lane
-    obj_osi_internal.ln[static_cast<unsigned int>(idx)]->SerializeToString(&osiRoadLane.osi_lane_info);
-    osiRoadLane.size = static_cast<unsigned int>(obj_osi_internal.ln[static_cast<unsigned int>(idx)]->ByteSizeLong());
-    *size            = static_cast<int>(osiRoadLane.size);
-    return osiRoadLane.osi_lane_info.data();
+
+    // serialize to string the single lane, unless done before
+    std::string &serialized = lane_serialized_[static_cast<unsigned int>(idx)];
+    if (serialized.empty())
+    {
+        obj_osi_internal.ln[static_cast<unsigned int>(idx)]->SerializeToString(&serialized);
+    }
+    *size = static_cast<int>(serialized.size());
+    return serialized.data();
 }
 
 const char *OSIReporter::GetOSIRoadLaneBoundary(int *size, int global_id)
 {
-    // find the lane bounday in the sensor view and save its index
-    int idx = -1;
-    for (unsigned int i = 0; i < obj_osi_internal.lnb.size(); i++)
-    {
-        osi3::Identifier identifier = obj_osi_internal.lnb[i]->id();
-        int              found_id   = static_cast<int>(identifier.value());
-        if (found_id == global_id)
-        {
-            idx = static_cast<int>(i);
-            break;
-        }
-    }
+    // find the lane bounday and its index
+    auto it = lane_boundary_idx_.find(static_cast<uint64_t>(global_id));
 
-    if (idx == -1)
+    if (global_id < 0 || it == lane_boundary_idx_.end())
     {
         return 0;
     }
 
-    // serialize to string the single lane
-    obj_osi_internal.lnb[static_cast<unsigned int>(idx)]->SerializeToString(&osiRoadLaneBoundary.osi_lane_boundary_info);
-    osiRoadLaneBoundary.size = static_cast<unsigned int>(obj_osi_internal.lnb[static_cast<unsigned int>(idx)]->ByteSizeLong());
-    *size                    = static_cast<int>(osiRoadLaneBoundary.size);
-    return osiRoadLaneBoundary.osi_lane_boundary_info.data();
+    // serialize to string the single lane boundary, unless done before
+    std::string &serialized = lane_boundary_serialized_[static_cast<unsigned int>(it->second)];
+    if (serialized.empty())
+    {
+        obj_osi_internal.lnb[static_cast<unsigned int>(it->second)]->SerializeToString(&serialized);
+    }
+    *size = static_cast<int>(serialized.size());
+    return serialized.data();
 }
 
 bool OSIReporter::IsCentralOSILane(int lane_idx)
@@ -2573,18 +2881,8 @@ bool OSIReporter::IsCentralOSILane(int lane_idx)
 
 int OSIReporter::GetLaneIdxfromIdOSI(int lane_id)
 {
-    int idx = -1;
-    for (unsigned int i = 0; i < obj_osi_internal.ln.size(); i++)
-    {
-        osi3::Identifier identifier = obj_osi_internal.ln[i]->id();
-        int              found_id   = static_cast<int>(identifier.value());
-        if (found_id == lane_id)
-        {
-            idx = static_cast<int>(i);
-            break;
-        }
-    }
-    return idx;
+    auto it = lane_idx_.find(static_cast<uint64_t>(lane_id));
+    return (lane_id < 0 || it == lane_idx_.end()) ? -1 : it->second;
 }
 
 void OSIReporter::GetOSILaneBoundaryIds(const std::vector<std::unique_ptr<ObjectState>> &objectState, std::vector<int> &ids, int object_id)
@@ -2595,27 +2893,22 @@ void OSIReporter::GetOSILaneBoundaryIds(const std::vector<std::unique_ptr<Object
     std::vector<int> final_lb_ids;
 
     // Check if object_id exists
-    if (static_cast<unsigned int>(object_id) >= objectState.size())
+    const ObjectState *obj_state = FindObjectState(objectState, object_id);
+    if (obj_state == nullptr)
     {
         LOG("Object %d not available, only %d registered", object_id, objectState.size());
         ids = {-1, -1, -1, -1};
         return;
     }
 
-    // Find position of the object
-    roadmanager::Position pos;
-    for (size_t i = 0; i < objectState.size(); i++)
+    // find the lane of the object and save its index
+    idx_central = GetLaneIdxfromIdOSI(obj_state->state_.pos.GetLaneGlobalId());
+    if (idx_central < 0)
     {
-        if (object_id == objectState[i]->state_.info.id)
-        {
-            pos = objectState[i]->state_.pos;
-        }
+        ids = {-1, -1, -1, -1};
+        return;
     }
 
-    // find the lane in the sensor view and save its index
-    int lane_id_of_vehicle = pos.GetLaneGlobalId();
-    idx_central            = GetLaneIdxfromIdOSI(lane_id_of_vehicle);
-
     // find left and right lane boundary ids of central lane
     if (obj_osi_internal.ln[static_cast<unsigned int>(idx_central)]->mutable_classification()->left_lane_boundary_id_size() == 0)
     {
@@ -2651,7 +2944,7 @@ void OSIReporter::GetOSILaneBoundaryIds(const std::vector<std::unique_ptr<Object
         idx_left         = GetLaneIdxfromIdOSI(left_lane_id);
 
         // save left boundary of left lane as far left lane boundary of central lane
-        if (obj_osi_internal.ln[static_cast<unsigned int>(idx_left)]->mutable_classification()->left_lane_boundary_id_size() == 0)
+        if (idx_left < 0 || obj_osi_internal.ln[static_cast<unsigned int>(idx_left)]->mutable_classification()->left_lane_boundary_id_size() == 0)
         {
             far_left_lb_id = -1;
         }
@@ -2676,7 +2969,7 @@ void OSIReporter::GetOSILaneBoundaryIds(const std::vector<std::unique_ptr<Object
         idx_right         = GetLaneIdxfromIdOSI(right_lane_id);
 
         // save right boundary of right lane as far right lane boundary of central lane
-        if (obj_osi_internal.ln[static_cast<unsigned int>(idx_right)]->mutable_classification()->right_lane_boundary_id_size() == 0)
+        if (idx_right < 0 || obj_osi_internal.ln[static_cast<unsigned int>(idx_right)]->mutable_classification()->right_lane_boundary_id_size() == 0)
         {
             far_right_lb_id = -1;
         }
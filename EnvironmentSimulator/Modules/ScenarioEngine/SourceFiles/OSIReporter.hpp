@@ -13,6 +13,8 @@
 #pragma once
 
 #include "UDP.hpp"
+#include "SharedMemory.hpp"
+#include "TraceFile.hpp"
 #include "IdealSensor.hpp"
 #include "ScenarioGateway.hpp"
 #include "ScenarioEngine.hpp"
@@ -29,6 +31,7 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <unordered_map>
 #include <math.h>
 
 #define DEFAULT_OSI_TRACE_FILENAME "ground_truth.osi"
@@ -54,6 +57,14 @@ public:
     */
     bool OpenOSIFile(const char* filename);
     /**
+    Compress osi files opened from now on, see TraceFile.hpp for format
+    @param value true = compressed, false = plain sequence of size and message (default)
+    */
+    void SetOSIFileCompression(bool value)
+    {
+        osi_file_compression_ = value;
+    }
+    /**
     Closes any open osi file
     */
     void CloseOSIFile();
@@ -74,7 +85,8 @@ public:
     */
     int UpdateOSIGroundTruth(const std::vector<std::unique_ptr<ObjectState>>& objectState);
     /**
-    Fills up the osi message with  static GroundTruth
+    Fills up the osi message with static GroundTruth
+    The static data is built only once, or fetched from cache if the same road network has been processed before.
     */
     int UpdateOSIStaticGroundTruth(const std::vector<std::unique_ptr<ObjectState>>& objectState);
     /**
@@ -95,9 +107,19 @@ public:
     int UpdateOSIHostVehicleData(ObjectState* objectState);
     /**
     Fills up the osi message with Moving Object
+    The moving object of each entity is kept between frames. It's created and initialized first time the entity is
+    reported, then only the dynamic properties are updated.
     */
     int UpdateOSIMovingObject(ObjectState* objectState);
     /**
+    Sets the static properties of a new Moving Object, e.g. type, classification and dimensions
+    */
+    int InitOSIMovingObject(ObjectState* objectState);
+    /**
+    Sets bounding box and dimensions of current Moving Object, at creation and whenever the entity bounding box changed
+    */
+    void UpdateOSIMovingObjectBoundingBox(ObjectState* objectState);
+    /**
     Fills up the osi message with Lane Boundary
     */
     int UpdateOSILaneBoundary();
@@ -130,11 +152,27 @@ public:
     */
     void SetStationaryModelReference(std::string model_reference);
 
+    /**
+    Set directory for cache files of static road network ground truth, identified by OpenDRIVE file content
+    @param directory Directory path. Set to empty string to disable cache files.
+    */
+    void SetStaticGroundTruthCacheDir(std::string directory)
+    {
+        static_gt_cache_dir_ = directory;
+    }
+
     /**
      Creates a SensorView from SensorData for plotting
     */
     int CreateSensorViewFromSensorData(const osi3::SensorData& sd);
 
+    /**
+    Get serialized ground truth of latest frame
+    The serialization buffer is reused between frames, so the returned pointer is normally the same for all frames
+    except the first one which includes static data. It's only reallocated if the message grows beyond buffer size.
+    @param size Size of the serialized message
+    @return Pointer to the serialized message
+    */
     const char*       GetOSIGroundTruth(int* size);
     const char*       GetOSIGroundTruthRaw();
     const char*       GetOSITrafficCommandRaw();
@@ -148,11 +186,41 @@ public:
     SE_SOCKET         OpenSocket(std::string ipaddr);
     int               GetUDPClientStatus()
     {
-        return (udp_client_ ? udp_client_->GetStatus() : -1);
+        return (udp_sender_ ? udp_sender_->GetStatus() : -1);
+    }
+
+    /**
+    Limit OSI UDP send rate, to avoid overflowing receiver buffers
+    @param burst_size Number of packages sent back to back, 0 = no limit
+    @param gap_us Pause between bursts, in microseconds
+    */
+    void SetUDPPacing(int burst_size, int gap_us);
+
+    /**
+    Set size of the OSI UDP socket send buffer
+    @param size Size in bytes
+    @return 0 if successful, -1 if not
+    */
+    int SetUDPSendBufferSize(int size);
+
+    /**
+    Get OSI UDP send statistics, e.g. send time and number of dropped frames
+    @param stats Statistics
+    @return 0 if successful, -1 if UDP not used
+    */
+    int GetUDPStats(UDPFrameSender::Stats& stats);
+    /**
+    Publish OSI ground truth in shared memory, for readers on the same host, see SharedMemoryReader
+    @param name Name of the shared memory object
+    */
+    void OpenSharedMemory(std::string name);
+    int  GetSharedMemoryStatus()
+    {
+        return (shm_writer_ ? 0 : -1);
     }
     bool IsFileOpen()
     {
-        return osi_file.is_open();
+        return osi_file.IsOpen();
     }
     void ReportSensors(std::vector<ObjectSensor*> sensor);
 
@@ -188,13 +256,36 @@ public:
     }
 
 private:
-    UDPClient*             udp_client_;
+    UDPFrameSender*        udp_sender_;
+    SharedMemoryWriter*    shm_writer_;
     ScenarioEngine*        scenario_engine_;
     unsigned long long int nanosec_;
-    std::ofstream          osi_file;
+    TraceFileWriter        osi_file;
+    bool                   osi_file_compression_;
     int                    osi_update_counter_;
     std::string            stationary_model_reference;
     void                   CreateMovingObjectFromSensorData(const osi3::SensorData& sd, int obj_nr);
     void                   CreateLaneBoundaryFromSensordata(const osi3::SensorData& sd, int lane_boundary_nr);
+    void                   RemoveUnreportedOSIMovingObjects();
+    void                   SerializeOSIGroundTruth();
+    int                    BuildOSIStaticGroundTruth(const std::vector<std::unique_ptr<ObjectState>>& objectState);
+    void                   SwapOSIStaticGroundTruth();
+    void                   IndexOSIRoadGroundTruth();
+    void                   IndexOSIRoadLanes();
+    uint64_t               GetOSIRoadGroundTruthKey();
+    std::string            GetOSIRoadGroundTruthCacheFilename(uint64_t key);
+    int                    ReadOSIRoadGroundTruthCacheFile(uint64_t key);
+    int                    WriteOSIRoadGroundTruthCacheFile();
     bool                   osi_updated_ = false;
+    std::map<int, int>     moving_object_idx_;       // object id -> index in ground truth moving object list
+    std::vector<bool>      moving_object_reported_;  // per moving object, whether updated in current frame
+    bool                   static_gt_built_    = false;  // static data built, stored in internal ground truth
+    bool                   static_gt_reported_ = false;  // static data moved to external ground truth
+    std::string            static_gt_serialized_;        // static data serialized once, spliced into outgoing messages
+    std::string            static_gt_cache_dir_;
+
+    std::unordered_map<uint64_t, int> lane_idx_;                  // OSI lane id -> index in lane list
+    std::unordered_map<uint64_t, int> lane_boundary_idx_;         // OSI lane boundary id -> index in lane boundary list
+    std::vector<std::string>          lane_serialized_;           // per lane, serialized on first request
+    std::vector<std::string>          lane_boundary_serialized_;  // per lane boundary, serialized on first request
 };
@@ -12,12 +12,14 @@
 
 #include "ScenarioEngine.hpp"
 #include "CommonMini.hpp"
+#include "Profiler.hpp"
 #include "ControllerFollowGhost.hpp"
 #include "ControllerExternal.hpp"
 #include "ControllerRel2Abs.hpp"
 #include "ControllerFollowRoute.hpp"
 #include "Entities.hpp"
 #include "OSCParameterDistribution.hpp"
+#include <utility>
 
 #define WHEEL_RADIUS          0.35
 #define STAND_STILL_THRESHOLD 1e-3  // meter per second
@@ -169,6 +171,8 @@ int ScenarioEngine::step(double deltaSimTime)
     }
     else
     {
+        SE_PROFILE_SCOPE(GATEWAY_SYNC);
+
         // reset update bits and indicators of applied control
         for (size_t i = 0; i < entities_.object_.size(); i++)
         {
@@ -250,13 +254,17 @@ int ScenarioEngine::step(double deltaSimTime)
         }
     }
 
-    storyBoard.Step(simulationTime_, deltaSimTime);
+    {
+        SE_PROFILE_SCOPE(STORYBOARD);
+        storyBoard.Step(simulationTime_, deltaSimTime);
+    }
 
     if (storyBoard.GetCurrentState() == StoryBoardElement::State::RUNNING)
     {
         // Check for collisions/overlap after first initialization
         if (SE_Env::Inst().GetCollisionDetection() && frame_nr_ == 0)
         {
+            SE_PROFILE_SCOPE(COLLISION_DETECTION);
             DetectCollisions();
         }
     }
@@ -269,6 +277,7 @@ int ScenarioEngine::step(double deltaSimTime)
     // Step any externally injected actions
     if (injected_actions_ && injected_actions_->size() > 0)
     {
+        SE_PROFILE_SCOPE(STORYBOARD);
         for (OSCAction* action : *injected_actions_)
         {
             if (action->GetCurrentState() == StoryBoardElement::State::INIT || action->GetCurrentState() == StoryBoardElement::State::STANDBY)
@@ -300,6 +309,19 @@ int ScenarioEngine::step(double deltaSimTime)
         trueTime_ = simulationTime_;
     }
 
+    // Time of gateway sync and default controller is summed over all objects and registered once per frame
+    bool    timing          = SE_Profiler::IsTiming();
+    int64_t loop_start      = timing ? SE_Profiler::Now() : 0;
+    int64_t lap_start       = loop_start;
+    int64_t gateway_time    = 0;
+    int64_t controller_time = 0;
+
+    auto lap = [&lap_start]()
+    {
+        int64_t start = std::exchange(lap_start, SE_Profiler::Now());
+        return lap_start - start;
+    };
+
     for (size_t i = 0; i < entities_.object_.size(); i++)
     {
         Object* obj = entities_.object_[i];
@@ -340,6 +362,11 @@ int ScenarioEngine::step(double deltaSimTime)
             o->clearDirtyBits();
         }
 
+        if (timing)
+        {
+            gateway_time += lap();
+        }
+
         // Do not move objects when speed is zero,
         // and only ghosts allowed to execute during ghost restart
         if (!(obj->IsControllerModeOnDomains(ControlOperationMode::MODE_OVERRIDE, static_cast<unsigned int>(ControlDomains::DOMAIN_LAT_AND_LONG))) &&
@@ -379,9 +406,20 @@ int ScenarioEngine::step(double deltaSimTime)
             obj->SetEndOfRoad(false);
         }
 
+        if (timing)
+        {
+            controller_time += lap();
+        }
+
         // Report updated state to the gateway
-        if (scenarioGateway.isObjectReported(obj->id_))
+        if (o != nullptr)
         {
+            // bounding box has no dirty bit, it's rarely changed after creation, e.g. by API or SUMO controller
+            if (memcmp(&o->state_.info.boundingbox, &obj->boundingbox_, sizeof(OSCBoundingBox)) != 0)
+            {
+                o->state_.info.boundingbox = obj->boundingbox_;
+            }
+
             if (obj->CheckDirtyBits(Object::DirtyBit::LONGITUDINAL | Object::DirtyBit::LATERAL))
             {
                 scenarioGateway.updateObjectPos(obj->id_, simulationTime_, &obj->pos_);
@@ -442,49 +480,66 @@ int ScenarioEngine::step(double deltaSimTime)
                 scenarioGateway.updateObjectWheelData(obj->id_, static_cast<Vehicle*>(obj)->GetWheelData());
             }
         }
+
+        if (timing)
+        {
+            gateway_time += lap();
+        }
+    }
+
+    if (timing)
+    {
+        SE_Profiler::AddPhase(SE_Profiler::Phase::GATEWAY_SYNC, loop_start, gateway_time);
+        SE_Profiler::AddPhase(SE_Profiler::Phase::DEFAULT_CONTROLLER, loop_start, controller_time);
     }
 
-    for (size_t i = 0; i < scenarioReader->controller_.size(); i++)
     {
-        if (scenarioReader->controller_[i]->Active())
+        SE_PROFILE_SCOPE(CONTROLLERS);
+        for (size_t i = 0; i < scenarioReader->controller_.size(); i++)
         {
-            if (SE_Env::Inst().GetGhostMode() != GhostMode::RESTARTING)
+            if (scenarioReader->controller_[i]->Active())
             {
-                scenarioReader->controller_[i]->Step(deltaSimTime);
+                if (SE_Env::Inst().GetGhostMode() != GhostMode::RESTARTING)
+                {
+                    scenarioReader->controller_[i]->Step(deltaSimTime);
+                }
             }
         }
     }
 
     // Update any trailers now that tow vehicles have been updated by Default or custom controllers
-    for (size_t i = 0; i < entities_.object_.size(); i++)
     {
-        Object*  obj     = entities_.object_[i];
-        Vehicle* trailer = static_cast<Vehicle*>(obj->TrailerVehicle());
-
-        if (!obj->TowVehicle() && obj->TrailerVehicle())
+        SE_PROFILE_SCOPE(TRAILERS);
+        for (size_t i = 0; i < entities_.object_.size(); i++)
         {
-            // Found a front tow vehicle, update trailers
-            Vehicle* tow_vehicle = static_cast<Vehicle*>(obj);
-            while (trailer)
+            Object*  obj     = entities_.object_[i];
+            Vehicle* trailer = static_cast<Vehicle*>(obj->TrailerVehicle());
+
+            if (!obj->TowVehicle() && obj->TrailerVehicle())
             {
-                // Calculate new trailer position and orientation
-                ObjectState* o = scenarioGateway.getObjectStatePtrById(tow_vehicle->id_);
-                SE_Vector    v0(tow_vehicle->trailer_hitch_->dx_, 0.0);
-
-                // Fetch updated state of tow vehicle from gateway
-                roadmanager::Position* tow_pos = &o->state_.pos;
-                v0                             = v0.Rotate(tow_pos->GetH()) + SE_Vector(tow_pos->GetX(), tow_pos->GetY());
-                SE_Vector v1                   = SE_Vector(trailer->pos_.GetX(), trailer->pos_.GetY()) - v0;
-                v1.SetLength(trailer->trailer_coupler_->dx_);
-                scenarioGateway.updateObjectWorldPosXYH(trailer->GetId(),
-                                                        getSimulationTime(),
-                                                        v0.x() + v1.x(),
-                                                        v0.y() + v1.y(),
-                                                        GetAngleInInterval2PI(atan2(v1.y(), v1.x()) + M_PI));
-                trailer->SetSpeed(tow_vehicle->GetSpeed());
-
-                tow_vehicle = trailer;
-                trailer     = static_cast<Vehicle*>(trailer->TrailerVehicle());
+                // Found a front tow vehicle, update trailers
+                Vehicle* tow_vehicle = static_cast<Vehicle*>(obj);
+                while (trailer)
+                {
+                    // Calculate new trailer position and orientation
+                    ObjectState* o = scenarioGateway.getObjectStatePtrById(tow_vehicle->id_);
+                    SE_Vector    v0(tow_vehicle->trailer_hitch_->dx_, 0.0);
+
+                    // Fetch updated state of tow vehicle from gateway
+                    roadmanager::Position* tow_pos = &o->state_.pos;
+                    v0                             = v0.Rotate(tow_pos->GetH()) + SE_Vector(tow_pos->GetX(), tow_pos->GetY());
+                    SE_Vector v1                   = SE_Vector(trailer->pos_.GetX(), trailer->pos_.GetY()) - v0;
+                    v1.SetLength(trailer->trailer_coupler_->dx_);
+                    scenarioGateway.updateObjectWorldPosXYH(trailer->GetId(),
+                                                            getSimulationTime(),
+                                                            v0.x() + v1.x(),
+                                                            v0.y() + v1.y(),
+                                                            GetAngleInInterval2PI(atan2(v1.y(), v1.x()) + M_PI));
+                    trailer->SetSpeed(tow_vehicle->GetSpeed());
+
+                    tow_vehicle = trailer;
+                    trailer     = static_cast<Vehicle*>(trailer->TrailerVehicle());
+                }
             }
         }
     }
@@ -524,6 +579,7 @@ int ScenarioEngine::step(double deltaSimTime)
     // Check for collisions
     if (SE_Env::Inst().GetCollisionDetection() && frame_nr_ > 0)
     {
+        SE_PROFILE_SCOPE(COLLISION_DETECTION);
         DetectCollisions();
     }
 
@@ -963,6 +1019,8 @@ void ScenarioEngine::prepareGroundTruth(double dt)
         obj->ClearDirtyBits(Object::DirtyBit::VELOCITY | Object::DirtyBit::ANGULAR_RATE | Object::DirtyBit::ACCELERATION |
                             Object::DirtyBit::ANGULAR_ACC | Object::DirtyBit::TELEPORT);
     }
+
+    scenarioGateway.UpdateStateTable();
 }
 
 void ScenarioEngine::ReplaceObjectInTrigger(Trigger* trigger, Object* obj1, Object* obj2, double timeOffset, Event* event)
@@ -1223,6 +1281,8 @@ void ScenarioEngine::ResetEvents()
 int ScenarioEngine::DetectCollisions()
 {
     collision_pair_.clear();
+    SE_Profiler::Count(SE_Profiler::Counter::COLLISION_PAIR_TESTS,
+                       static_cast<int64_t>(entities_.object_.size() * (MAX(entities_.object_.size(), 1) - 1) / 2));
     for (size_t i = 0; i < entities_.object_.size(); i++)
     {
         Object* obj0 = entities_.object_[i];
@@ -251,7 +251,7 @@ void ObjectState::Print()
 
 // ScenarioGateway
 
-ScenarioGateway::ScenarioGateway()
+ScenarioGateway::ScenarioGateway() : state_table_enabled_(false)
 {
 }
 
@@ -1092,42 +1092,117 @@ void ScenarioGateway::WriteStatesToFile()
     if (data_file_.is_open())
     {
         // Write status to file - for later replay
-        for (size_t i = 0; i < objectState_.size(); i++)
-        {
-            struct ObjectStateStructDat datState;
-
-            datState.info.boundingbox = objectState_[i]->state_.info.boundingbox;
-            datState.info.ctrl_type   = objectState_[i]->state_.info.ctrl_type;
-            datState.info.ctrl_type   = objectState_[i]->state_.info.ctrl_type;
-            datState.info.id          = objectState_[i]->state_.info.id;
-            datState.info.model_id    = objectState_[i]->state_.info.model_id;
-            memcpy(datState.info.name, objectState_[i]->state_.info.name, sizeof(datState.info.name));
-            datState.info.obj_category   = objectState_[i]->state_.info.obj_category;
-            datState.info.obj_type       = objectState_[i]->state_.info.ctrl_type;
-            datState.info.scaleMode      = objectState_[i]->state_.info.scaleMode;
-            datState.info.speed          = static_cast<float>(objectState_[i]->state_.info.speed);
-            datState.info.timeStamp      = static_cast<float>(objectState_[i]->state_.info.timeStamp);
-            datState.info.visibilityMask = objectState_[i]->state_.info.visibilityMask;
-
-            // assume first wheel is on front axle and steering
-            datState.info.wheel_angle =
-                objectState_[i]->state_.info.wheel_data.size() > 0 ? static_cast<float>(objectState_[i]->state_.info.wheel_data[0].h) : 0.0f;
-            datState.info.wheel_rot =
-                objectState_[i]->state_.info.wheel_data.size() > 0 ? static_cast<float>(objectState_[i]->state_.info.wheel_data[0].p) : 0.0f;
-
-            datState.pos.x      = static_cast<float>(objectState_[i]->state_.pos.GetX());
-            datState.pos.y      = static_cast<float>(objectState_[i]->state_.pos.GetY());
-            datState.pos.z      = static_cast<float>(objectState_[i]->state_.pos.GetZ());
-            datState.pos.h      = static_cast<float>(objectState_[i]->state_.pos.GetH());
-            datState.pos.p      = static_cast<float>(objectState_[i]->state_.pos.GetP());
-            datState.pos.r      = static_cast<float>(objectState_[i]->state_.pos.GetR());
-            datState.pos.roadId = objectState_[i]->state_.pos.GetTrackId();
-            datState.pos.laneId = objectState_[i]->state_.pos.GetLaneId();
-            datState.pos.offset = static_cast<float>(objectState_[i]->state_.pos.GetOffset());
-            datState.pos.t      = static_cast<float>(objectState_[i]->state_.pos.GetT());
-            datState.pos.s      = static_cast<float>(objectState_[i]->state_.pos.GetS());
-            data_file_.write(reinterpret_cast<char*>(&datState), sizeof(datState));
-        }
+        GetDatStates(dat_states_);
+        WriteDatStatesToFile(dat_states_);
+    }
+}
+
+void ScenarioGateway::GetDatStates(std::vector<ObjectStateStructDat>& states)
+{
+    states.resize(objectState_.size());
+
+    for (size_t i = 0; i < objectState_.size(); i++)
+    {
+        struct ObjectStateStructDat& datState = states[i];
+
+        datState.info.boundingbox = objectState_[i]->state_.info.boundingbox;
+        datState.info.ctrl_type   = objectState_[i]->state_.info.ctrl_type;
+        datState.info.ctrl_type   = objectState_[i]->state_.info.ctrl_type;
+        datState.info.id          = objectState_[i]->state_.info.id;
+        datState.info.model_id    = objectState_[i]->state_.info.model_id;
+        memcpy(datState.info.name, objectState_[i]->state_.info.name, sizeof(datState.info.name));
+        datState.info.obj_category   = objectState_[i]->state_.info.obj_category;
+        datState.info.obj_type       = objectState_[i]->state_.info.ctrl_type;
+        datState.info.scaleMode      = objectState_[i]->state_.info.scaleMode;
+        datState.info.speed          = static_cast<float>(objectState_[i]->state_.info.speed);
+        datState.info.timeStamp      = static_cast<float>(objectState_[i]->state_.info.timeStamp);
+        datState.info.visibilityMask = objectState_[i]->state_.info.visibilityMask;
+
+        // assume first wheel is on front axle and steering
+        datState.info.wheel_angle =
+            objectState_[i]->state_.info.wheel_data.size() > 0 ? static_cast<float>(objectState_[i]->state_.info.wheel_data[0].h) : 0.0f;
+        datState.info.wheel_rot =
+            objectState_[i]->state_.info.wheel_data.size() > 0 ? static_cast<float>(objectState_[i]->state_.info.wheel_data[0].p) : 0.0f;
+
+        datState.pos.x      = static_cast<float>(objectState_[i]->state_.pos.GetX());
+        datState.pos.y      = static_cast<float>(objectState_[i]->state_.pos.GetY());
+        datState.pos.z      = static_cast<float>(objectState_[i]->state_.pos.GetZ());
+        datState.pos.h      = static_cast<float>(objectState_[i]->state_.pos.GetH());
+        datState.pos.p      = static_cast<float>(objectState_[i]->state_.pos.GetP());
+        datState.pos.r      = static_cast<float>(objectState_[i]->state_.pos.GetR());
+        datState.pos.roadId = objectState_[i]->state_.pos.GetTrackId();
+        datState.pos.laneId = objectState_[i]->state_.pos.GetLaneId();
+        datState.pos.offset = static_cast<float>(objectState_[i]->state_.pos.GetOffset());
+        datState.pos.t      = static_cast<float>(objectState_[i]->state_.pos.GetT());
+        datState.pos.s      = static_cast<float>(objectState_[i]->state_.pos.GetS());
+    }
+}
+
+void ScenarioGateway::GetStateTableEntry(const ObjectStateStruct& state, ObjectStateTableEntry& entry)
+{
+    entry.id             = state.info.id;
+    entry.model_id       = state.info.model_id;
+    entry.ctrl_type      = state.info.ctrl_type;
+    entry.timestamp      = static_cast<float>(state.info.timeStamp);
+    entry.x              = static_cast<float>(state.pos.GetX());
+    entry.y              = static_cast<float>(state.pos.GetY());
+    entry.z              = static_cast<float>(state.pos.GetZ());
+    entry.h              = static_cast<float>(state.pos.GetH());
+    entry.p              = static_cast<float>(state.pos.GetP());
+    entry.r              = static_cast<float>(state.pos.GetR());
+    entry.speed          = static_cast<float>(state.info.speed);
+    entry.roadId         = state.pos.GetTrackId();
+    entry.junctionId     = state.pos.GetJunctionId();
+    entry.t              = static_cast<float>(state.pos.GetT());
+    entry.laneId         = state.pos.GetLaneId();
+    entry.s              = static_cast<float>(state.pos.GetS());
+    entry.laneOffset     = static_cast<float>(state.pos.GetOffset());
+    entry.centerOffsetX  = state.info.boundingbox.center_.x_;
+    entry.centerOffsetY  = state.info.boundingbox.center_.y_;
+    entry.centerOffsetZ  = state.info.boundingbox.center_.z_;
+    entry.width          = state.info.boundingbox.dimensions_.width_;
+    entry.length         = state.info.boundingbox.dimensions_.length_;
+    entry.height         = state.info.boundingbox.dimensions_.height_;
+    entry.objectType     = state.info.obj_type;
+    entry.objectCategory = state.info.obj_category;
+    // assume first wheel is on front axle and steering
+    entry.wheel_angle    = state.info.wheel_data.size() > 0 ? static_cast<float>(state.info.wheel_data[0].h) : 0.0f;
+    entry.wheel_rot      = state.info.wheel_data.size() > 0 ? static_cast<float>(state.info.wheel_data[0].p) : 0.0f;
+    entry.visibilityMask = state.info.visibilityMask;
+}
+
+void ScenarioGateway::UpdateStateTable()
+{
+    if (!state_table_enabled_)
+    {
+        return;
+    }
+
+    state_table_.resize(objectState_.size());
+    for (size_t i = 0; i < objectState_.size(); i++)
+    {
+        GetStateTableEntry(objectState_[i]->state_, state_table_[i]);
+    }
+}
+
+const ObjectStateTableEntry* ScenarioGateway::GetStateTable(int& n_entries)
+{
+    if (!state_table_enabled_)
+    {
+        state_table_enabled_ = true;
+        UpdateStateTable();
+    }
+
+    n_entries = static_cast<int>(state_table_.size());
+
+    return state_table_.empty() ? nullptr : state_table_.data();
+}
+
+void ScenarioGateway::WriteDatStatesToFile(const std::vector<ObjectStateStructDat>& states)
+{
+    if (data_file_.is_open() && !states.empty())
+    {
+        data_file_.write(reinterpret_cast<const char*>(states.data()), static_cast<std::streamsize>(states.size() * sizeof(ObjectStateStructDat)));
     }
 }
 
@@ -88,6 +88,39 @@ namespace scenarioengine
         struct ObjectPositionStructDat pos;
     };
 
+    // Compact object state, same layout as SE_ScenarioObjectState of esminiLib, see ScenarioGateway::GetStateTable()
+    struct ObjectStateTableEntry
+    {
+        int   id;
+        int   model_id;
+        int   ctrl_type;
+        float timestamp;
+        float x;
+        float y;
+        float z;
+        float h;
+        float p;
+        float r;
+        id_t  roadId;
+        id_t  junctionId;
+        float t;
+        int   laneId;
+        float laneOffset;
+        float s;
+        float speed;
+        float centerOffsetX;
+        float centerOffsetY;
+        float centerOffsetZ;
+        float width;
+        float length;
+        float height;
+        int   objectType;
+        int   objectCategory;
+        float wheel_angle;
+        float wheel_rot;
+        int   visibilityMask;
+    };
+
     typedef struct
     {
         int  version;
@@ -364,13 +397,61 @@ namespace scenarioengine
         ObjectState *getObjectStatePtrById(int id);
         int          getObjectStateById(int idx, ObjectState &objState);
         void         WriteStatesToFile();
+
+        /**
+        Copy current state of all objects in .dat file format, e.g. for writing on another thread
+        @param states Filled with one entry per object
+        */
+        void GetDatStates(std::vector<ObjectStateStructDat> &states);
+
+        /**
+        Write states to the .dat file, if recording
+        @param states States of all objects for one frame, see GetDatStates()
+        */
+        void WriteDatStatesToFile(const std::vector<ObjectStateStructDat> &states);
+        bool IsRecording()
+        {
+            return data_file_.is_open();
+        }
+
+        /**
+        Get table of all object states, in same order as objectState_. The table is maintained from first call on,
+        refreshed by UpdateStateTable() at end of each frame.
+        @param n_entries Number of entries in the table
+        @return Pointer to first entry, nullptr if no objects
+        */
+        const ObjectStateTableEntry *GetStateTable(int &n_entries);
+
+        /**
+        Refresh the state table from current object states, if maintained. See GetStateTable().
+        */
+        void UpdateStateTable();
+
+        /**
+        Convert one object state into state table format
+        */
+        static void GetStateTableEntry(const ObjectStateStruct &state, ObjectStateTableEntry &entry);
+
+        /**
+        Allocate object states and recording buffer for given number of objects up front
+        @param n_objects Expected max number of objects
+        */
+        void Reserve(size_t n_objects)
+        {
+            objectState_.reserve(n_objects);
+            dat_states_.reserve(n_objects);
+            state_table_.reserve(n_objects);
+        }
         int          RecordToFile(std::string filename, std::string odr_filename, std::string model_filename);
 
         std::vector<std::unique_ptr<ObjectState>> objectState_;
 
     private:
         int updateObjectInfo(ObjectState *obj_state, double timestamp, int visibilityMask, double speed, double wheel_angle, double wheel_rot);
-        std::ofstream data_file_;
+        std::ofstream                      data_file_;
+        std::vector<ObjectStateStructDat>  dat_states_;           // reused each frame, see WriteStatesToFile()
+        std::vector<ObjectStateTableEntry> state_table_;          // see GetStateTable()
+        bool                               state_table_enabled_;  // true once GetStateTable() has been called
     };
 
 }  // namespace scenarioengine
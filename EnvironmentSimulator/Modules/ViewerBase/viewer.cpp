@@ -595,34 +595,23 @@ SensorViewFrustum::~SensorViewFrustum()
     plines_.clear();
 }
 
-void SensorViewFrustum::Update()
+void SensorViewFrustum::Update(const double* hits, int n_hits)
 {
-    // Visualize hits by a "line of sight"
-    for (size_t i = 0; i < static_cast<unsigned int>(sensor_->nObj_); i++)
+    // Visualize hits by a "line of sight", reset additional lines possibly previously in use
+    for (int i = 0; i < sensor_->maxObj_; i++)
     {
-        (*plines_[i]->pline_vertex_data_)[1][0] = static_cast<float>(sensor_->hitList_[i].x_);
-        (*plines_[i]->pline_vertex_data_)[1][1] = static_cast<float>(sensor_->hitList_[i].y_);
+        osg::Vec3& target = (*plines_[static_cast<unsigned int>(i)]->pline_vertex_data_)[1];
 
-        // compensate z for vehicle pitch angle
-        double z_add = GetLengthOfLine2D(sensor_->hitList_[i].obj_->pos_.GetX(),
-                                         sensor_->hitList_[i].obj_->pos_.GetY(),
-                                         sensor_->host_->pos_.GetX(),
-                                         sensor_->host_->pos_.GetY()) *
-                       tan(sensor_->host_->pos_.GetP());
-
-        (*plines_[i]->pline_vertex_data_)[1][2] = static_cast<float>(sensor_->hitList_[i].z_ + z_add);
-
-        plines_[i]->Redraw();
-    }
-
-    // Reset additional lines possibly previously in use
-    for (size_t i = static_cast<unsigned int>(sensor_->nObj_); i < static_cast<unsigned int>(sensor_->maxObj_); i++)
-    {
-        (*plines_[i]->pline_vertex_data_)[1][0] = 0;
-        (*plines_[i]->pline_vertex_data_)[1][1] = 0;
-        (*plines_[i]->pline_vertex_data_)[1][2] = 0;
+        if (i < n_hits)
+        {
+            target.set(static_cast<float>(hits[3 * i]), static_cast<float>(hits[3 * i + 1]), static_cast<float>(hits[3 * i + 2]));
+        }
+        else
+        {
+            target.set(0.0f, 0.0f, 0.0f);
+        }
 
-        plines_[i]->Redraw();
+        plines_[static_cast<unsigned int>(i)]->Redraw();
     }
 }
 
@@ -3376,19 +3365,13 @@ PointSensor* Viewer::CreateSensor(float color[], bool create_ball, bool create_l
     return sensor;
 }
 
-void Viewer::UpdateRoadSensors(PointSensor* road_sensor, PointSensor* route_sensor, PointSensor* lane_sensor, roadmanager::Position* pos)
+void Viewer::GetRoadSensorTargets(roadmanager::Position* pos, double road_target[3], double route_target[3], double lane_target[3])
 {
-    if (road_sensor == 0 || route_sensor == 0 || lane_sensor == 0)
-    {
-        return;
-    }
-
     roadmanager::Position track_pos(*pos);
     track_pos.SetTrackPos(pos->GetTrackId(), pos->GetS(), 0);
-
-    SensorSetPivotPos(road_sensor, pos->GetX(), pos->GetY(), pos->GetZ());
-    SensorSetTargetPos(road_sensor, track_pos.GetX(), track_pos.GetY(), track_pos.GetZ());
-    UpdateSensor(road_sensor);
+    road_target[0] = track_pos.GetX();
+    road_target[1] = track_pos.GetY();
+    road_target[2] = track_pos.GetZ();
 
     roadmanager::Position route_pos(track_pos);
     roadmanager::Route*   r = pos->GetRoute();
@@ -3396,16 +3379,56 @@ void Viewer::UpdateRoadSensors(PointSensor* road_sensor, PointSensor* route_sens
     {
         route_pos.SetLanePos(r->GetTrackId(), r->GetLaneId(), r->GetTrackS(), 0.0);
     }
-
-    SensorSetPivotPos(route_sensor, pos->GetX(), pos->GetY(), pos->GetZ());
-    SensorSetTargetPos(route_sensor, route_pos.GetX(), route_pos.GetY(), route_pos.GetZ());
-    UpdateSensor(route_sensor);
+    route_target[0] = route_pos.GetX();
+    route_target[1] = route_pos.GetY();
+    route_target[2] = route_pos.GetZ();
 
     roadmanager::Position lane_pos(*pos);
     lane_pos.SetLanePos(pos->GetTrackId(), pos->GetLaneId(), pos->GetS(), 0);
+    lane_target[0] = lane_pos.GetX();
+    lane_target[1] = lane_pos.GetY();
+    lane_target[2] = lane_pos.GetZ();
+}
+
+void Viewer::UpdateRoadSensors(PointSensor* road_sensor, PointSensor* route_sensor, PointSensor* lane_sensor, roadmanager::Position* pos)
+{
+    if (road_sensor == 0 || route_sensor == 0 || lane_sensor == 0)
+    {
+        return;
+    }
+
+    double xyz[3] = {pos->GetX(), pos->GetY(), pos->GetZ()};
+    double road_target[3];
+    double route_target[3];
+    double lane_target[3];
+
+    GetRoadSensorTargets(pos, road_target, route_target, lane_target);
+    UpdateRoadSensors(road_sensor, route_sensor, lane_sensor, xyz, road_target, route_target, lane_target);
+}
+
+void Viewer::UpdateRoadSensors(PointSensor* road_sensor,
+                               PointSensor* route_sensor,
+                               PointSensor* lane_sensor,
+                               const double pos[3],
+                               const double road_target[3],
+                               const double route_target[3],
+                               const double lane_target[3])
+{
+    if (road_sensor == 0 || route_sensor == 0 || lane_sensor == 0)
+    {
+        return;
+    }
+
+    SensorSetPivotPos(road_sensor, pos[0], pos[1], pos[2]);
+    SensorSetTargetPos(road_sensor, road_target[0], road_target[1], road_target[2]);
+    UpdateSensor(road_sensor);
+
+    SensorSetPivotPos(route_sensor, pos[0], pos[1], pos[2]);
+    SensorSetTargetPos(route_sensor, route_target[0], route_target[1], route_target[2]);
+    UpdateSensor(route_sensor);
 
-    SensorSetPivotPos(lane_sensor, pos->GetX(), pos->GetY(), pos->GetZ());
-    SensorSetTargetPos(lane_sensor, lane_pos.GetX(), lane_pos.GetY(), lane_pos.GetZ());
+    SensorSetPivotPos(lane_sensor, pos[0], pos[1], pos[2]);
+    SensorSetTargetPos(lane_sensor, lane_target[0], lane_target[1], lane_target[2]);
     UpdateSensor(lane_sensor);
 }
 
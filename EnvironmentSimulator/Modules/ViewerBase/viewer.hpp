@@ -148,7 +148,13 @@ namespace viewer
 
         SensorViewFrustum(Viewer* viewer, ObjectSensor* sensor, osg::Group* parent);
         ~SensorViewFrustum();
-        void Update();
+
+        /**
+            Update lines of sight to detected objects
+            @param hits Target points, x, y and z for each detected object
+            @param n_hits Number of detected objects
+        */
+        void Update(const double* hits, int n_hits);
     };
 
     class Trajectory
@@ -508,6 +514,19 @@ namespace viewer
         void                     SensorSetPivotPos(PointSensor* sensor, double x, double y, double z);
         void                     SensorSetTargetPos(PointSensor* sensor, double x, double y, double z);
         void UpdateRoadSensors(PointSensor* road_sensor, PointSensor* route_sensor, PointSensor* lane_sensor, roadmanager::Position* pos);
+        void UpdateRoadSensors(PointSensor* road_sensor,
+                               PointSensor* route_sensor,
+                               PointSensor* lane_sensor,
+                               const double pos[3],
+                               const double road_target[3],
+                               const double route_target[3],
+                               const double lane_target[3]);
+
+        /**
+            Calculate target points of road sensors, i.e. reference line, route and lane center at same s as pos
+        */
+        static void GetRoadSensorTargets(roadmanager::Position* pos, double road_target[3], double route_target[3], double lane_target[3]);
+
         void setKeyUp(bool pressed)
         {
             keyUp_ = pressed;
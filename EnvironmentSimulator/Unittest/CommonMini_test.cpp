@@ -1,6 +1,18 @@
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <string.h>
+#include <sys/stat.h>
+
 #include "CommonMini.hpp"
+#include "MPSCQueue.hpp"
+#include "Pacer.hpp"
+#include "Pipeline.hpp"
+#include "SharedMemory.hpp"
+#include "TaskPool.hpp"
+#include "TraceFile.hpp"
+#include "TripleBuffer.hpp"
+#include "UDP.hpp"
 #include "esminiLib.hpp"
 
 struct Coordinate2D
@@ -201,6 +213,501 @@ TEST(MatrixOperations, TestMatrixInvert)
     EXPECT_NEAR(m3[2][2], 1.0, 1E-5);
 }
 
+TEST(TaskPool, TestParallelFor)
+{
+    std::vector<int> result(1000, 0);
+
+    SE_TaskPool::Inst().SetNumberOfThreads(4);
+    EXPECT_EQ(SE_TaskPool::Inst().GetNumberOfThreads(), 4);
+
+    for (int run = 0; run < 10; run++)
+    {
+        // each task writes only its own element
+        SE_TaskPool::Inst().ParallelFor(static_cast<int>(result.size()), [&](int i) { result[static_cast<size_t>(i)] += i; });
+    }
+    for (size_t i = 0; i < result.size(); i++)
+    {
+        ASSERT_EQ(result[i], 10 * static_cast<int>(i));
+    }
+
+    // nested jobs run sequentially within the task
+    std::atomic<int> count(0);
+    SE_TaskPool::Inst().ParallelFor(8, [&](int) { SE_TaskPool::Inst().ParallelFor(8, [&](int) { count++; }); });
+    EXPECT_EQ(count, 64);
+
+    // workers run with the environment bound to the calling thread
+    SE_Env           env;
+    std::atomic<int> n_bound(0);
+    SE_Env::Bind(&env);
+    SE_TaskPool::Inst().ParallelFor(100, [&](int) { n_bound += &SE_Env::Inst() == &env ? 1 : 0; });
+    SE_Env::Bind(nullptr);
+    EXPECT_EQ(n_bound, 100);
+    SE_TaskPool::Inst().ParallelFor(100, [&](int) { n_bound += SE_Env::Bound() == nullptr ? 1 : 0; });
+    EXPECT_EQ(n_bound, 200);
+
+    // sequential mode
+    std::thread::id caller = std::this_thread::get_id();
+    bool            same   = true;
+    SE_TaskPool::Inst().SetNumberOfThreads(1);
+    SE_TaskPool::Inst().ParallelFor(10, [&](int) { same = same && std::this_thread::get_id() == caller; });
+    EXPECT_TRUE(same);
+
+    SE_TaskPool::Inst().ParallelFor(0, [&](int) { FAIL(); });
+    SE_TaskPool::Inst().SetNumberOfThreads(0);
+}
+
+TEST(Pacer, TestPeriodAndOverruns)
+{
+    SE_Pacer pacer;
+
+    // not started, no waiting
+    pacer.Wait();
+    EXPECT_FALSE(pacer.IsActive());
+    EXPECT_EQ(pacer.GetNumberOfSteps(), 0);
+
+    // 2 ms steps at twice real time speed
+    pacer.Start(0.002, 2.0);
+    EXPECT_TRUE(pacer.IsActive());
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 51; i++)
+    {
+        pacer.Wait();
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // first wait returns immediately, then 50 periods of 1 ms
+    EXPECT_GE(elapsed, 0.050);
+    EXPECT_LT(elapsed, 0.5);
+    EXPECT_EQ(pacer.GetNumberOfSteps(), 51);
+    EXPECT_GE(pacer.GetMaxJitter(), 0.0);
+    EXPECT_GE(pacer.GetMeanJitter(), 0.0);
+
+    // steps slower than the period are counted as overruns
+    pacer.Start(0.001, 1.0, 0.0);
+    pacer.Wait();
+    for (int i = 0; i < 3; i++)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        pacer.Wait();
+    }
+    EXPECT_EQ(pacer.GetNumberOfOverruns(), 3);
+    EXPECT_GT(pacer.GetMaxOverrun(), 0.003);
+
+    pacer.Stop();
+    EXPECT_FALSE(pacer.IsActive());
+    EXPECT_EQ(pacer.GetNumberOfSteps(), 0);
+}
+
+TEST(TripleBuffer, TestHandover)
+{
+    SE_TripleBuffer<std::vector<int>> buffer;
+
+    // nothing published yet
+    EXPECT_FALSE(buffer.Update());
+    EXPECT_TRUE(buffer.GetReadBuffer().empty());
+
+    // only latest state is picked up
+    buffer.GetWriteBuffer().assign(3, 1);
+    buffer.Publish();
+    buffer.GetWriteBuffer().assign(3, 2);
+    buffer.Publish();
+    EXPECT_TRUE(buffer.Update());
+    EXPECT_EQ(buffer.GetReadBuffer(), std::vector<int>(3, 2));
+    EXPECT_FALSE(buffer.Update());
+    EXPECT_EQ(buffer.GetReadBuffer(), std::vector<int>(3, 2));
+
+    // producer and consumer in separate threads, consumer must always see complete and increasing states
+    const int   n_frames = 20000;
+    std::thread producer(
+        [&]()
+        {
+            for (int i = 3; i <= n_frames; i++)
+            {
+                buffer.GetWriteBuffer().assign(100, i);
+                buffer.Publish();
+            }
+        });
+
+    int  last       = 2;
+    bool consistent = true;
+    while (last < n_frames)
+    {
+        if (buffer.Update())
+        {
+            const std::vector<int>& state = buffer.GetReadBuffer();
+            consistent                    = consistent && state.size() == 100 && state.front() == state.back() && state.front() > last;
+            last                          = state.back();
+        }
+    }
+    producer.join();
+
+    EXPECT_TRUE(consistent);
+    EXPECT_EQ(last, n_frames);
+}
+
+TEST(MPSCQueue, TestOrderAndCapacity)
+{
+    SE_MPSCQueue<int> queue(5);
+    int               value = 0;
+
+    EXPECT_EQ(queue.GetCapacity(), 8);
+    EXPECT_FALSE(queue.Pop(value));
+
+    // full queue rejects elements, without affecting the ones already added
+    for (int i = 0; i < 8; i++)
+    {
+        EXPECT_TRUE(queue.Push(i));
+    }
+    EXPECT_FALSE(queue.Push(8));
+    EXPECT_EQ(queue.GetNumberOfRejected(), 1);
+    for (int i = 0; i < 8; i++)
+    {
+        EXPECT_TRUE(queue.Pop(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_FALSE(queue.Pop(value));
+
+    // several producers, elements of each producer must arrive once and in order
+    const int                n_producers = 4;
+    const int                n_elements  = 20000;
+    std::vector<std::thread> producers;
+    for (int p = 0; p < n_producers; p++)
+    {
+        producers.emplace_back(
+            [&queue, p]()
+            {
+                for (int i = 0; i < n_elements; i++)
+                {
+                    while (!queue.Push(p * n_elements + i))
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+    }
+
+    std::vector<int> last(n_producers, -1);
+    int              n_received = 0;
+    bool             in_order   = true;
+    while (n_received < n_producers * n_elements)
+    {
+        if (queue.Pop(value))
+        {
+            size_t p = static_cast<size_t>(value / n_elements);
+            in_order = in_order && value % n_elements == last[p] + 1;
+            last[p]  = value % n_elements;
+            n_received++;
+        }
+    }
+    for (auto& t : producers)
+    {
+        t.join();
+    }
+
+    EXPECT_TRUE(in_order);
+    EXPECT_FALSE(queue.Pop(value));
+}
+
+TEST(Pipeline, TestOrderAndDepth)
+{
+    SE_Pipeline      pipeline;
+    std::vector<int> result;
+
+    // not started, jobs run directly
+    pipeline.Submit([&result]() { result.push_back(-1); });
+    ASSERT_EQ(result.size(), 1);
+
+    // slow jobs, producer has to wait for the worker but order is kept
+    const int n_jobs = 20;
+    pipeline.Start(2);
+    EXPECT_TRUE(pipeline.IsActive());
+    for (int i = 0; i < n_jobs; i++)
+    {
+        pipeline.Submit(
+            [&result, i]()
+            {
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+                result.push_back(i);
+            });
+    }
+    pipeline.Flush();
+    ASSERT_EQ(result.size(), n_jobs + 1);
+    for (int i = 0; i < n_jobs; i++)
+    {
+        EXPECT_EQ(result[static_cast<unsigned int>(i + 1)], i);
+    }
+    EXPECT_EQ(pipeline.GetNumberOfJobs(), n_jobs + 1);
+    EXPECT_GT(pipeline.GetNumberOfStalls(), 0);
+
+    // jobs run with the environment bound to the submitting thread
+    SE_Env  env;
+    SE_Env* job_env[2] = {nullptr, nullptr};
+    SE_Env::Bind(&env);
+    pipeline.Submit([&job_env]() { job_env[0] = &SE_Env::Inst(); });
+    SE_Env::Bind(nullptr);
+    pipeline.Submit([&job_env]() { job_env[1] = SE_Env::Bound(); });
+    pipeline.Flush();
+    EXPECT_EQ(job_env[0], &env);
+    EXPECT_EQ(job_env[1], nullptr);
+
+    // remaining jobs are finished on stop
+    int last = n_jobs;
+    pipeline.Submit(
+        [&result, last]()
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            result.push_back(last);
+        });
+    pipeline.Stop();
+    EXPECT_FALSE(pipeline.IsActive());
+    EXPECT_EQ(result.back(), n_jobs);
+}
+
+static void FillFrame(std::vector<char>& frame, int frame_nr)
+{
+    for (size_t i = 0; i < frame.size(); i++)
+    {
+        frame[i] = static_cast<char>((static_cast<size_t>(frame_nr) + i) & 0xff);
+    }
+}
+
+TEST(TraceFile, TestCompressBlock)
+{
+    std::vector<char> data(200000);
+    std::vector<char> compressed(static_cast<size_t>(LZ4CompressBound(static_cast<int>(data.size()))));
+    std::vector<char> decompressed(data.size());
+
+    // mix of repeated patterns, long runs and noise
+    unsigned int rnd = 1;
+    for (size_t i = 0; i < data.size(); i++)
+    {
+        rnd = rnd * 1103515245 + 12345;
+        if (i < 50000)
+        {
+            data[i] = static_cast<char>("esmini OSI ground truth "[i % 24]);
+        }
+        else if (i < 100000)
+        {
+            data[i] = 0;
+        }
+        else
+        {
+            data[i] = static_cast<char>(rnd >> 16);
+        }
+    }
+
+    for (int size : {0, 1, 12, 13, 100, 50000, 100000, 200000})
+    {
+        int compressed_size = LZ4CompressBlock(data.data(), size, compressed.data());
+        EXPECT_LE(compressed_size, LZ4CompressBound(size));
+        ASSERT_EQ(LZ4DecompressBlock(compressed.data(), compressed_size, decompressed.data(), size), size);
+        EXPECT_EQ(memcmp(decompressed.data(), data.data(), static_cast<size_t>(size)), 0);
+        if (size == 100000)
+        {
+            EXPECT_LT(compressed_size, 1000);
+        }
+    }
+
+    // too small destination buffer is detected
+    int compressed_size = LZ4CompressBlock(data.data(), 50000, compressed.data());
+    EXPECT_EQ(LZ4DecompressBlock(compressed.data(), compressed_size, decompressed.data(), 49999), -1);
+}
+
+TEST(TraceFile, TestWriteRead)
+{
+    const int         n_records = 300;
+    std::vector<char> record(10000);
+    std::vector<char> buf;
+
+    for (bool compress : {false, true})
+    {
+        TraceFileWriter writer;
+        ASSERT_EQ(writer.Open("trace_test.bin", compress), 0);
+
+        // records of varying size, spanning several blocks
+        for (int i = 0; i < n_records; i++)
+        {
+            unsigned int size = 1000 + static_cast<unsigned int>(i * 37) % 9000;
+            FillFrame(record, i);
+            EXPECT_EQ(writer.Write(&size, sizeof(size)), 0);
+            EXPECT_EQ(writer.Write(record.data(), size), 0);
+        }
+        writer.Flush();
+
+        struct stat file_status;
+        ASSERT_EQ(stat("trace_test.bin", &file_status), 0);
+        if (compress)
+        {
+            EXPECT_LT(file_status.st_size, 500000);
+        }
+        else
+        {
+            EXPECT_EQ(file_status.st_size, 1456650);
+        }
+        writer.Close();
+
+        TraceFileReader reader;
+        ASSERT_EQ(reader.Open("trace_test.bin"), 0);
+        EXPECT_EQ(reader.IsCompressed(), compress);
+        for (int i = 0; i < n_records; i++)
+        {
+            unsigned int size = 0;
+            ASSERT_EQ(reader.Read(&size, sizeof(size)), sizeof(size));
+            ASSERT_EQ(size, 1000 + static_cast<unsigned int>(i * 37) % 9000);
+            buf.resize(size);
+            ASSERT_EQ(reader.Read(buf.data(), size), static_cast<int>(size));
+            FillFrame(record, i);
+            ASSERT_EQ(memcmp(buf.data(), record.data(), size), 0);
+        }
+        unsigned int size;
+        EXPECT_EQ(reader.Read(&size, sizeof(size)), 0);  // end of file
+        reader.Close();
+    }
+}
+
+#ifndef _WIN32
+TEST(SharedMemory, TestWriteRead)
+{
+    std::string        name = "esmini_test_" + std::to_string(SE_getSystemTime());
+    SharedMemoryWriter writer(name, 3);
+    SharedMemoryReader reader(name);
+    SharedMemoryFrame  frame;
+    std::vector<char>  data(1000);
+    std::vector<char>  buf;
+
+    // nothing published yet
+    EXPECT_EQ(reader.Open(), -1);
+
+    FillFrame(data, 1);
+    EXPECT_EQ(writer.Write(data.data(), data.size()), 1);
+    ASSERT_EQ(reader.Open(), 0);
+    EXPECT_EQ(reader.GetGeneration(), 1);
+
+    ASSERT_EQ(reader.GetLatest(frame), 0);
+    EXPECT_EQ(frame.frame, 1);
+    EXPECT_EQ(frame.size, 1000);
+    EXPECT_EQ(memcmp(frame.data, data.data(), data.size()), 0);
+    EXPECT_TRUE(reader.IsValid(frame));
+
+    // one more frame goes into another slot, the first is still valid
+    data.resize(500);
+    FillFrame(data, 2);
+    EXPECT_EQ(writer.Write(data.data(), data.size()), 2);
+    EXPECT_TRUE(reader.IsValid(frame));
+
+    ASSERT_EQ(reader.Read(buf, frame), 0);
+    EXPECT_EQ(frame.frame, 2);
+    EXPECT_EQ(frame.size, 500);
+    EXPECT_EQ(frame.data, buf.data());
+    EXPECT_EQ(memcmp(buf.data(), data.data(), data.size()), 0);
+
+    // fill the ring, first frame is overwritten
+    ASSERT_EQ(reader.GetLatest(frame), 0);
+    EXPECT_EQ(writer.Write(data.data(), data.size()), 3);
+    EXPECT_TRUE(reader.IsValid(frame));
+    EXPECT_EQ(writer.Write(data.data(), data.size()), 4);
+    EXPECT_TRUE(reader.IsValid(frame));
+    EXPECT_EQ(writer.Write(data.data(), data.size()), 5);
+    EXPECT_FALSE(reader.IsValid(frame));
+
+    // too large frame makes the writer re-create the shared memory with larger slots, the reader follows
+    data.resize(SHM_MIN_SLOT_SIZE + 1);
+    FillFrame(data, 6);
+    EXPECT_EQ(writer.Write(data.data(), data.size()), 6);
+    EXPECT_EQ(reader.GetGeneration(), 6);
+    ASSERT_EQ(reader.Read(buf, frame), 0);
+    EXPECT_EQ(frame.frame, 6);
+    EXPECT_EQ(frame.size, SHM_MIN_SLOT_SIZE + 1);
+    EXPECT_EQ(memcmp(buf.data(), data.data(), data.size()), 0);
+
+    // frames of the original size still fit
+    data.resize(500);
+    FillFrame(data, 7);
+    EXPECT_EQ(writer.Write(data.data(), data.size()), 7);
+    ASSERT_EQ(reader.GetLatest(frame), 0);
+    EXPECT_EQ(frame.frame, 7);
+    EXPECT_EQ(memcmp(frame.data, data.data(), data.size()), 0);
+    EXPECT_TRUE(reader.IsValid(frame));
+}
+
+static int ReceiveFrame(UDPServer& server, std::vector<char>& frame)
+{
+    struct
+    {
+        UDPFrameSender::UDPFragmentHeader header;
+        char                              data[UDP_DEFAULT_FRAGMENT_SIZE];
+    } buf;
+
+    size_t received = 0;
+    do
+    {
+        if (server.Receive(reinterpret_cast<char*>(&buf), sizeof(buf)) <= 0)
+        {
+            return -1;
+        }
+        if (buf.header.counter == 1 || buf.header.counter == -1)
+        {
+            received = 0;  // new frame
+        }
+        frame.resize(received + buf.header.datasize);
+        memcpy(&frame[received], buf.data, buf.header.datasize);
+        received += buf.header.datasize;
+    } while (buf.header.counter > 0);
+
+    return 0;
+}
+
+TEST(UDP, TestFrameSender)
+{
+    UDPServer         server(48211, 1000);
+    std::vector<char> data(50000);
+    std::vector<char> frame;
+
+    {
+        UDPFrameSender sender(48211, "127.0.0.1");
+        ASSERT_EQ(sender.GetStatus(), 0);
+        EXPECT_EQ(sender.SetSendBufferSize(256 * 1024), 0);
+
+        for (int i = 0; i < 3; i++)
+        {
+            data.resize(static_cast<size_t>(50000 + i * 1000));
+            FillFrame(data, i);
+            EXPECT_EQ(sender.Send(data.data(), data.size()), 0);
+            sender.Flush();
+            ASSERT_EQ(ReceiveFrame(server, frame), 0);
+            ASSERT_EQ(frame.size(), data.size());
+            EXPECT_EQ(memcmp(frame.data(), data.data(), data.size()), 0);
+        }
+
+        UDPFrameSender::Stats stats = sender.GetStats();
+        EXPECT_EQ(stats.frames_sent, 3);
+        EXPECT_EQ(stats.frames_dropped, 0);
+        EXPECT_EQ(stats.frames_failed, 0);
+        EXPECT_GT(stats.send_time_max, 0.0);
+
+        // with slow pacing, frames queued while sending are replaced by later ones
+        sender.SetPacing(2, 20000);
+        for (int i = 0; i < 3; i++)
+        {
+            FillFrame(data, 10 + i);
+            EXPECT_EQ(sender.Send(data.data(), data.size()), 0);
+        }
+        sender.Flush();
+        stats = sender.GetStats();
+        EXPECT_GE(stats.frames_dropped, 1);
+        EXPECT_EQ(stats.frames_sent + stats.frames_dropped, 6);
+
+        // the latest frame is always sent
+        for (uint64_t i = 3; i < stats.frames_sent; i++)
+        {
+            ASSERT_EQ(ReceiveFrame(server, frame), 0);
+        }
+        EXPECT_EQ(memcmp(frame.data(), data.data(), data.size()), 0);
+    }
+}
+#endif  // _WIN32
+
 int main(int argc, char **argv)
 {
     // testing::GTEST_FLAG(filter) = "*TestIsPointWithinSectorBetweenTwoLines*";
@@ -9,11 +9,15 @@
 #endif  // _USE_OSI
 #include "Replay.hpp"
 #include "CommonMini.hpp"
+#include "Profiler.hpp"
 #include "esminiLib.hpp"
 #include "RoadManager.hpp"
 #include <vector>
 #include <stdexcept>
 #include <fstream>
+#include <sstream>
+#include <atomic>
+#include <thread>
 
 #define _USE_MATH_DEFINES
 #include <math.h>
@@ -106,6 +110,42 @@ TEST(GetOSILaneBoundaryIdsTest, lane_boundary_ids)
     SE_Close();
 }
 
+TEST(GetOSILaneBoundaryIdsTest, static_ground_truth_cache)
+{
+    std::string              scenario_file = "../../../EnvironmentSimulator/Unittest/xosc/full_e6mini.xosc";
+    std::vector<std::string> gt_data;
+
+    // second run will fetch static ground truth from cache instead of building it
+    for (int i = 0; i < 2; i++)
+    {
+        ASSERT_EQ(SE_Init(scenario_file.c_str(), 0, 0, 0, 0), 0);
+        SE_StepDT(0.001f);
+        SE_UpdateOSIGroundTruth();
+        SE_UpdateOSIStaticGroundTruth();  // should not add static data twice
+
+        int         size = 0;
+        const char* data = SE_GetOSIGroundTruth(&size);
+        gt_data.push_back(std::string(data, static_cast<size_t>(size)));
+
+        SE_LaneBoundaryId ids;
+        SE_GetOSILaneBoundaryIds(0, &ids);
+        EXPECT_EQ(ids.far_left_lb_id, 12);
+        EXPECT_EQ(ids.left_lb_id, 13);
+        EXPECT_EQ(ids.right_lb_id, 14);
+        EXPECT_EQ(ids.far_right_lb_id, -1);
+
+        SE_Close();
+    }
+
+    EXPECT_EQ(gt_data[0], gt_data[1]);
+
+    osi3::GroundTruth osi_gt;
+    EXPECT_TRUE(osi_gt.ParseFromString(gt_data[1]));
+    EXPECT_EQ(osi_gt.moving_object_size(), 14);
+    EXPECT_GT(osi_gt.lane_size(), 0);
+    EXPECT_GT(osi_gt.lane_boundary_size(), 0);
+}
+
 TEST(GetOSILaneBoundaryIdsTest, lane_boundary_ids_no_obj)
 {
     std::string scenario_file = "../../../resources/xosc/cut-in.xosc";
@@ -385,6 +425,47 @@ TEST(GetOSIRoadLaneTest, lane_id)
     SE_Close();
 }
 
+TEST(GetOSIRoadLaneTest, lane_lookup_cached)
+{
+    ASSERT_EQ(SE_Init("../../../EnvironmentSimulator/Unittest/xosc/full_e6mini.xosc", 0, 0, 0, 0), 0);
+    SE_StepDT(0.001f);
+    SE_UpdateOSIGroundTruth();
+
+    int                road_lane_size  = 0;
+    int                road_lane_size2 = 0;
+    int                boundary_size   = 0;
+    osi3::Lane         osi_lane;
+    osi3::LaneBoundary osi_lane_boundary;
+    SE_LaneBoundaryId  ids;
+
+    // each lane is serialized only once, repeated requests return the same data
+    const char* road_lane = SE_GetOSIRoadLane(&road_lane_size, 0);
+    ASSERT_NE(road_lane, nullptr);
+    SE_StepDT(0.001f);
+    SE_UpdateOSIGroundTruth();
+    EXPECT_EQ(SE_GetOSIRoadLane(&road_lane_size2, 0), road_lane);
+    EXPECT_EQ(road_lane_size2, road_lane_size);
+    ASSERT_TRUE(osi_lane.ParseFromArray(road_lane, road_lane_size));
+    EXPECT_EQ(osi_lane.id().value(), 14);
+
+    // lane boundaries of the lane are found by id
+    SE_GetOSILaneBoundaryIds(0, &ids);
+    ASSERT_EQ(osi_lane.classification().right_lane_boundary_id_size(), 1);
+    EXPECT_EQ(ids.right_lb_id, 14);
+    EXPECT_EQ(ids.right_lb_id, static_cast<int>(osi_lane.classification().right_lane_boundary_id(0).value()));
+    const char* boundary = SE_GetOSILaneBoundary(&boundary_size, ids.right_lb_id);
+    ASSERT_NE(boundary, nullptr);
+    ASSERT_TRUE(osi_lane_boundary.ParseFromArray(boundary, boundary_size));
+    EXPECT_EQ(static_cast<int>(osi_lane_boundary.id().value()), ids.right_lb_id);
+
+    // unknown ids
+    EXPECT_EQ(SE_GetOSILaneBoundary(&boundary_size, -1), nullptr);
+    EXPECT_EQ(SE_GetOSIRoadLane(&road_lane_size, 100), nullptr);
+    EXPECT_EQ(road_lane_size, 0);
+
+    SE_Close();
+}
+
 TEST(GetOSIRoadLaneTest, left_lane_id)
 {
     std::string scenario_file = "../../../EnvironmentSimulator/Unittest/xosc/full_e6mini.xosc";
@@ -2602,6 +2683,71 @@ TEST(TestOsiReporter, AssignRoleTest)
 }
 #endif
 
+TEST(TestOsiReporter, MovingObjectsAddDelete)
+{
+    ASSERT_EQ(SE_Init("../../../EnvironmentSimulator/Unittest/xosc/add_delete_entity.xosc", 0, 0, 0, 0), 0);
+
+    const osi3::GroundTruth* osi_gt = reinterpret_cast<const osi3::GroundTruth*>(SE_GetOSIGroundTruthRaw());
+    ASSERT_NE(osi_gt, nullptr);
+
+    int max_n_objects = 0;
+    while (SE_GetSimulationTime() < 16.0f && SE_GetQuitFlag() == 0)
+    {
+        SE_StepDT(0.1f);
+        SE_UpdateOSIGroundTruth();
+
+        // moving objects are kept between frames, check that they follow entities being added and deleted
+        ASSERT_EQ(osi_gt->moving_object_size(), SE_GetNumberOfObjects());
+        for (int i = 0; i < SE_GetNumberOfObjects(); i++)
+        {
+            SE_ScenarioObjectState state;
+            SE_GetObjectState(SE_GetId(i), &state);
+            EXPECT_EQ(osi_gt->moving_object(i).id().value(), static_cast<uint64_t>(SE_GetId(i)));
+            EXPECT_NEAR(osi_gt->moving_object(i).base().orientation().yaw(), GetAngleInIntervalMinusPIPlusPI(state.h), 1E-3);
+            EXPECT_EQ(osi_gt->moving_object(i).assigned_lane_id_size(), 1);
+        }
+        max_n_objects = MAX(max_n_objects, SE_GetNumberOfObjects());
+    }
+    EXPECT_EQ(max_n_objects, 2);
+
+    SE_Close();
+}
+
+TEST(TestOsiReporter, GroundTruthBufferReuse)
+{
+    ASSERT_EQ(SE_Init("../../../resources/xosc/cut-in_simple.xosc", 0, 0, 0, 0), 0);
+
+    int n_scenario_objects = SE_GetNumberOfObjects();
+    for (int i = 0; i < 100; i++)
+    {
+        int id = SE_AddObject(("obj" + std::to_string(i)).c_str(), 1, 0, 0, 0);
+        ASSERT_GE(id, 0);
+        SE_ReportObjectPosXYH(id, 0.0f, 5.0f + 0.45f * static_cast<float>(i), -1.535f, 0.0f);
+    }
+
+    const char* data      = nullptr;
+    const char* prev_data = nullptr;
+    int         size      = 0;
+    for (int frame = 0; frame < 10; frame++)
+    {
+        SE_StepDT(0.05f);
+        SE_UpdateOSIGroundTruth();
+        data = SE_GetOSIGroundTruth(&size);
+        ASSERT_GT(size, 0);
+        if (frame > 1)
+        {
+            // serialization buffer is reused, except possibly after first frame including static data
+            EXPECT_EQ(data, prev_data);
+        }
+        prev_data = data;
+    }
+
+    const osi3::GroundTruth* osi_gt = reinterpret_cast<const osi3::GroundTruth*>(SE_GetOSIGroundTruthRaw());
+    EXPECT_EQ(osi_gt->moving_object_size(), n_scenario_objects + 100);
+
+    SE_Close();
+}
+
 #endif  // _USE_OSI
 
 TEST(ParameterTest, GetTypedParameterValues)
@@ -3827,10 +3973,349 @@ TEST(ReplayTest, TestMultiReplayDifferentTimeSteps)
             EXPECT_NEAR(replay->data_[4201].state.info.id, 1, 1E-3);
         }
 
+        // Merged file is written directly while merging, check that it holds the same data
+        scenarioengine::Replay* merger = new scenarioengine::Replay(".", "multirep_test", "multirep_merged.dat");
+        EXPECT_EQ(merger->data_.size(), 0);
+        delete merger;
+
+        scenarioengine::Replay* merged = new scenarioengine::Replay("multirep_merged.dat", false);
+        ASSERT_EQ(merged->data_.size(), replay->data_.size());
+        EXPECT_EQ(merged->data_[2015].state.info.id, replay->data_[2015].state.info.id);
+        EXPECT_NEAR(merged->data_[2015].state.info.timeStamp, replay->data_[2015].state.info.timeStamp, 1E-5);
+        EXPECT_NEAR(merged->data_[2015].state.pos.y, replay->data_[2015].state.pos.y, 1E-5);
+        delete merged;
+
         delete replay;
     }
 }
 
+static void WriteMergeTestRecording(const std::string filename, std::vector<scenarioengine::ReplayEntry>& entries)
+{
+    scenarioengine::DatHeader header = {DAT_FILE_FORMAT_VERSION, "merge_test.xodr", ""};
+    std::ofstream             file(filename, std::ios::binary);
+    file.write(reinterpret_cast<char*>(&header), sizeof(header));
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        file.write(reinterpret_cast<char*>(&entries[i].state), sizeof(entries[i].state));
+    }
+}
+
+static scenarioengine::ReplayEntry MergeTestEntry(int id, float timestamp, float x)
+{
+    scenarioengine::ReplayEntry entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.state.info.id        = id;
+    entry.state.info.timeStamp = timestamp;
+    entry.state.pos.x          = x;
+    return entry;
+}
+
+// Merge as done before streaming k-way merge was introduced, all recordings cleaned and kept in memory
+static std::vector<scenarioengine::ReplayEntry> MergeRecordingsReference(std::vector<std::vector<scenarioengine::ReplayEntry>> scenarios)
+{
+    std::vector<scenarioengine::ReplayEntry> data;
+    std::vector<int>                         cur_idx(scenarios.size(), 0);
+    std::vector<int>                         next_idx(scenarios.size(), 0);
+
+    for (size_t j = 0; j < scenarios.size(); j++)
+    {
+        for (size_t k = 0; k < scenarios[j].size(); k++)
+        {
+            scenarios[j][k].state.info.id += static_cast<int>(j) * 100;
+        }
+    }
+
+    double cur_timestamp = static_cast<double>(scenarios[0][0].state.info.timeStamp);
+    while (cur_timestamp < LARGE_NUMBER - SMALL_NUMBER)
+    {
+        double min_time_stamp = LARGE_NUMBER;
+        for (size_t j = 0; j < scenarios.size(); j++)
+        {
+            if (next_idx[j] != -1)
+            {
+                unsigned int k = static_cast<unsigned int>(cur_idx[j]);
+                for (; k < scenarios[j].size() && static_cast<double>(scenarios[j][k].state.info.timeStamp) < cur_timestamp + 1e-6; k++)
+                {
+                    scenarios[j][k].state.info.timeStamp = static_cast<float>(cur_timestamp);
+                    data.push_back(scenarios[j][k]);
+                }
+
+                if (k < scenarios[j].size())
+                {
+                    next_idx[j] = static_cast<int>(k);
+                    if (static_cast<double>(scenarios[j][k].state.info.timeStamp) < min_time_stamp)
+                    {
+                        min_time_stamp = static_cast<double>(scenarios[j][k].state.info.timeStamp);
+                    }
+                }
+                else
+                {
+                    next_idx[j] = -1;
+                }
+            }
+        }
+
+        if (min_time_stamp < LARGE_NUMBER - SMALL_NUMBER)
+        {
+            for (size_t j = 0; j < scenarios.size(); j++)
+            {
+                if (next_idx[j] > 0 && static_cast<double>(scenarios[j][static_cast<unsigned int>(next_idx[j])].state.info.timeStamp) <
+                                           min_time_stamp + SMALL_NUMBER)
+                {
+                    cur_idx[j] = next_idx[j];
+                }
+            }
+        }
+
+        cur_timestamp = min_time_stamp;
+    }
+
+    return data;
+}
+
+TEST(ReplayTest, TestMergeOverlappingRecordings)
+{
+    // three overlapping recordings with different start times, end times and time steps
+    std::vector<std::vector<scenarioengine::ReplayEntry>> recordings(3);
+    for (int i = 0; i <= 30; i++)
+    {
+        for (int id = 0; id < 2; id++)
+        {
+            recordings[0].push_back(MergeTestEntry(id, 0.1f * static_cast<float>(i), static_cast<float>(i)));
+        }
+    }
+    for (int i = 0; i <= 30; i++)
+    {
+        recordings[1].push_back(MergeTestEntry(0, 0.5f + 0.05f * static_cast<float>(i), static_cast<float>(1000 + i)));
+    }
+    for (int i = 0; i <= 60; i++)
+    {
+        for (int id = 0; id < 3; id++)
+        {
+            recordings[2].push_back(MergeTestEntry(id, -0.3f + 0.03f * static_cast<float>(i), static_cast<float>(2000 + i)));
+        }
+    }
+
+    // duplicate object within a frame, latest instance is kept
+    recordings[0].insert(recordings[0].begin() + 22, MergeTestEntry(1, 1.0f, 10.5f));
+    // restart with decreasing timestamps, skipped
+    recordings[1].insert(recordings[1].begin() + 20, MergeTestEntry(0, 0.6f, 999.0f));
+    recordings[1].insert(recordings[1].begin() + 21, MergeTestEntry(0, 0.65f, 999.0f));
+
+    WriteMergeTestRecording("kway_merge_test_a.dat", recordings[0]);
+    WriteMergeTestRecording("kway_merge_test_b.dat", recordings[1]);
+    WriteMergeTestRecording("kway_merge_test_c.dat", recordings[2]);
+
+    scenarioengine::Replay* replay = new scenarioengine::Replay(".", "kway_merge_test", "");
+    ASSERT_EQ(replay->GetNumberOfScenarios(), 3);
+
+    // reference expects recordings cleaned and sorted on start time, as the merge does
+    std::vector<std::vector<scenarioengine::ReplayEntry>> sorted = {recordings[2], recordings[0], recordings[1]};
+    for (size_t j = 0; j < sorted.size(); j++)
+    {
+        replay->CleanEntries(sorted[j]);
+    }
+    std::vector<scenarioengine::ReplayEntry> reference = MergeRecordingsReference(sorted);
+
+    ASSERT_EQ(replay->data_.size(), reference.size());
+    for (size_t i = 0; i < reference.size(); i++)
+    {
+        ASSERT_EQ(replay->data_[i].state.info.id, reference[i].state.info.id) << "entry " << i;
+        ASSERT_NEAR(replay->data_[i].state.info.timeStamp, reference[i].state.info.timeStamp, 1E-5) << "entry " << i;
+        ASSERT_NEAR(replay->data_[i].state.pos.x, reference[i].state.pos.x, 1E-5) << "entry " << i;
+    }
+
+    // spot check, at 1.0 all three scenarios are ongoing
+    replay->GoToTime(1.0);
+    ASSERT_NE(replay->GetState(1), nullptr);
+    EXPECT_NEAR(replay->GetState(1)->pos.x, 2043.0, 1E-5);
+    ASSERT_NE(replay->GetState(101), nullptr);
+    EXPECT_NEAR(replay->GetState(101)->pos.x, 10.5, 1E-5);
+    ASSERT_NE(replay->GetState(200), nullptr);
+    EXPECT_NEAR(replay->GetState(200)->pos.x, 1010.0, 1E-5);
+    EXPECT_EQ(replay->GetState(102), nullptr);
+
+    delete replay;
+}
+
+TEST(ReplayTest, TestFrameIndexSeek)
+{
+    const char* args[] = {"--osc", "../../../resources/xosc/cut-in.xosc", "--record", "frame_index_test.dat", "--fixed_timestep", "0.05"};
+
+    ASSERT_EQ(SE_InitWithArgs(sizeof(args) / sizeof(char*), args), 0);
+    for (int i = 0; i < 100; i++)
+    {
+        SE_StepDT(0.05f);
+    }
+    SE_Close();
+
+    scenarioengine::Replay* replay = new scenarioengine::Replay("frame_index_test.dat", true);
+
+    // two objects per frame
+    EXPECT_EQ(replay->GetNumberOfFrames() * 2, replay->data_.size());
+    EXPECT_NEAR(replay->GetStartTime(), 0.0, 1E-3);
+    EXPECT_NEAR(replay->GetStopTime(), 5.0, 1E-3);
+
+    replay->GoToTime(2.5);
+    EXPECT_NEAR(replay->data_[static_cast<unsigned int>(replay->GetIndex())].state.info.timeStamp, 2.5, 1E-3);
+    EXPECT_EQ(replay->data_[static_cast<unsigned int>(replay->GetIndex())].state.info.id, 0);
+
+    scenarioengine::ObjectStateStructDat* state = replay->GetState(1);
+    ASSERT_NE(state, nullptr);
+    EXPECT_EQ(state->info.id, 1);
+    EXPECT_NEAR(state->info.timeStamp, 2.5, 1E-3);
+    EXPECT_EQ(replay->GetState(2), nullptr);
+    EXPECT_EQ(replay->GetState(-1), nullptr);
+
+    // next frame
+    EXPECT_NEAR(replay->data_[replay->FindNextTimestamp()].state.info.timeStamp, 2.55, 1E-3);
+
+    // timestamp in between frames will pick following frame
+    replay->GoToTime(2.52);
+    EXPECT_NEAR(replay->data_[static_cast<unsigned int>(replay->GetIndex())].state.info.timeStamp, 2.55, 1E-3);
+    EXPECT_NEAR(replay->GetState(0)->info.timeStamp, 2.55, 1E-3);
+    EXPECT_EQ(replay->data_[replay->FindPreviousTimestamp()].state.info.id, 0);
+    EXPECT_NEAR(replay->data_[replay->FindPreviousTimestamp()].state.info.timeStamp, 2.5, 1E-3);
+
+    // step frame by frame through the end
+    replay->GoToTime(4.9);
+    EXPECT_NEAR(replay->data_[static_cast<unsigned int>(replay->GoToNextFrame())].state.info.timeStamp, 4.95, 1E-3);
+    EXPECT_NEAR(replay->data_[static_cast<unsigned int>(replay->GoToNextFrame())].state.info.timeStamp, 5.0, 1E-3);
+    EXPECT_EQ(replay->GoToNextFrame(), -1);
+    EXPECT_EQ(replay->FindNextTimestamp(true), 0);
+
+    delete replay;
+}
+
+TEST(ReplayTest, TestStreamingReplay)
+{
+    const char* args[] = {"--osc", "../../../resources/xosc/cut-in.xosc", "--record", "streaming_test.dat", "--fixed_timestep", "0.01"};
+
+    ASSERT_EQ(SE_InitWithArgs(sizeof(args) / sizeof(char*), args), 0);
+    for (int i = 0; i < 1000; i++)
+    {
+        SE_StepDT(0.01f);
+    }
+    SE_Close();
+
+    scenarioengine::Replay* replay = new scenarioengine::Replay("streaming_test.dat", false);
+    scenarioengine::Replay* stream = new scenarioengine::Replay("streaming_test.dat", false, scenarioengine::Replay::ReadMode::STREAM);
+
+    EXPECT_FALSE(replay->IsStreaming());
+    EXPECT_TRUE(stream->IsStreaming());
+    EXPECT_EQ(stream->data_.size(), 0);
+    ASSERT_EQ(stream->GetNumberOfEntries(), replay->GetNumberOfEntries());
+    EXPECT_EQ(stream->GetNumberOfFrames(), replay->GetNumberOfFrames());
+    EXPECT_NEAR(stream->GetStartTime(), replay->GetStartTime(), 1E-5);
+    EXPECT_NEAR(stream->GetStopTime(), replay->GetStopTime(), 1E-5);
+
+    // sequential access through the window cache
+    for (unsigned int i = 0; i < stream->GetNumberOfEntries(); i++)
+    {
+        ASSERT_EQ(stream->GetEntryByIndex(i)->state.info.id, replay->data_[i].state.info.id);
+        ASSERT_NEAR(stream->GetEntryByIndex(i)->state.info.timeStamp, replay->data_[i].state.info.timeStamp, 1E-5);
+        ASSERT_NEAR(stream->GetEntryByIndex(i)->state.pos.x, replay->data_[i].state.pos.x, 1E-5);
+    }
+
+    // random access by time, backwards and forwards
+    double times[] = {9.5, 0.0, 3.333, 7.0, 1.005, 10.0};
+    for (size_t i = 0; i < sizeof(times) / sizeof(double); i++)
+    {
+        replay->GoToTime(times[i]);
+        stream->GoToTime(times[i]);
+        EXPECT_EQ(stream->GetIndex(), replay->GetIndex());
+        for (int id = 0; id < 2; id++)
+        {
+            ASSERT_NE(stream->GetState(id), nullptr);
+            EXPECT_NEAR(stream->GetState(id)->info.timeStamp, replay->GetState(id)->info.timeStamp, 1E-5);
+            EXPECT_NEAR(stream->GetState(id)->pos.y, replay->GetState(id)->pos.y, 1E-5);
+        }
+        EXPECT_EQ(stream->FindNextTimestamp(), replay->FindNextTimestamp());
+        EXPECT_EQ(stream->FindPreviousTimestamp(), replay->FindPreviousTimestamp());
+    }
+
+    // stop index is looked up on first use when streaming
+    replay->GoToEnd();
+    stream->GoToEnd();
+    EXPECT_EQ(stream->GetIndex(), replay->GetIndex());
+
+    delete stream;
+    delete replay;
+
+    // recording with decreasing timestamps, second half moved first, must give same frames in both modes
+    std::ifstream     src("streaming_test.dat", std::ios::binary);
+    std::vector<char> bytes((std::istreambuf_iterator<char>(src)), std::istreambuf_iterator<char>());
+    src.close();
+    size_t        header    = sizeof(scenarioengine::DatHeader);
+    size_t        n_entries = (bytes.size() - header) / sizeof(scenarioengine::ObjectStateStructDat);
+    size_t        half      = (n_entries / 2) * sizeof(scenarioengine::ObjectStateStructDat);
+    std::ofstream dst("streaming_unsorted_test.dat", std::ios::binary);
+    dst.write(bytes.data(), static_cast<std::streamsize>(header));
+    dst.write(bytes.data() + header + half, static_cast<std::streamsize>(bytes.size() - header - half));
+    dst.write(bytes.data() + header, static_cast<std::streamsize>(half));
+    dst.close();
+
+    replay = new scenarioengine::Replay("streaming_unsorted_test.dat", false);
+    stream = new scenarioengine::Replay("streaming_unsorted_test.dat", false, scenarioengine::Replay::ReadMode::STREAM);
+
+    ASSERT_EQ(stream->GetNumberOfEntries(), replay->GetNumberOfEntries());
+    EXPECT_EQ(stream->GetNumberOfFrames(), replay->GetNumberOfFrames());
+    for (size_t i = 0; i < sizeof(times) / sizeof(double); i++)
+    {
+        replay->GoToTime(times[i]);
+        stream->GoToTime(times[i]);
+        EXPECT_EQ(stream->GetIndex(), replay->GetIndex());
+        EXPECT_EQ(stream->FindNextTimestamp(), replay->FindNextTimestamp());
+        EXPECT_EQ(stream->FindPreviousTimestamp(), replay->FindPreviousTimestamp());
+    }
+
+    // stop index is looked up on first use when streaming
+    replay->GoToEnd();
+    stream->GoToEnd();
+    EXPECT_EQ(stream->GetIndex(), replay->GetIndex());
+
+    delete stream;
+    delete replay;
+}
+
+TEST(ProfilerTest, TestFrameProfiling)
+{
+    const char* args[] =
+        {"--osc", "../../../resources/xosc/cut-in.xosc", "--headless", "--profile", "profile.json", "--profile_trace", "profile_trace.json"};
+
+    ASSERT_EQ(SE_InitWithArgs(sizeof(args) / sizeof(char*), args), 0);
+    for (int i = 0; i < 50; i++)
+    {
+        SE_StepDT(0.05f);
+    }
+    SE_Close();
+
+    std::ifstream file("profile.json");
+    ASSERT_TRUE(file.is_open());
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    std::string content = buffer.str();
+    // one initial frame is executed by SE_Init
+    EXPECT_NE(content.find("\"frames\": 51,"), std::string::npos);
+    EXPECT_NE(content.find("{\"name\": \"frame\", \"frames\": 51,"), std::string::npos);
+    EXPECT_NE(content.find("{\"name\": \"storyboard\", \"frames\": 51,"), std::string::npos);
+    EXPECT_NE(content.find("\"p99\""), std::string::npos);
+    file.close();
+
+    file.open("profile_trace.json");
+    ASSERT_TRUE(file.is_open());
+    buffer.str("");
+    buffer << file.rdbuf();
+    content = buffer.str();
+    EXPECT_EQ(content.find("{\"displayTimeUnit\": \"ms\", \"traceEvents\": ["), 0);
+    EXPECT_NE(content.find("\"name\": \"default_controller\", \"cat\": \"esmini\", \"ph\": \"X\""), std::string::npos);
+    file.close();
+
+    // profiling stops when player is closed, scopes are idle again
+    EXPECT_FALSE(SE_Profiler::IsEnabled());
+    EXPECT_FALSE(SE_Profiler::IsTiming());
+}
+
 void ConditionCallbackInstance1(const char* element_name, double timestamp)
 {
     EXPECT_STREQ(element_name, "act_start_condition");
@@ -4394,6 +4879,297 @@ TEST(APITest, TestWheelData)
     SE_Close();
 }
 
+TEST(GetFunctionsTest, TestGetAllObjectStates)
+{
+    ASSERT_EQ(SE_Init("../../../resources/xosc/lane_change.xosc", 0, 0, 0, 0), 0);
+    SE_StepDT(0.1f);
+
+    int n = SE_GetNumberOfObjects();
+    ASSERT_EQ(n, 4);
+
+    std::vector<SE_ScenarioObjectState> states(static_cast<unsigned int>(n));
+    EXPECT_EQ(SE_GetAllObjectStates(states.data(), n), n);
+    EXPECT_EQ(SE_GetAllObjectStates(states.data(), 2), 2);
+
+    std::vector<int>   id(static_cast<unsigned int>(n));
+    std::vector<float> x(static_cast<unsigned int>(n));
+    std::vector<float> speed(static_cast<unsigned int>(n));
+    SE_ObjectStatesSoA soa = {};
+    soa.id                 = id.data();
+    soa.x                  = x.data();
+    soa.speed              = speed.data();
+    EXPECT_EQ(SE_GetAllObjectStatesSoA(&soa, n), n);
+
+    int                           n_table = 0;
+    const SE_ScenarioObjectState* table   = SE_GetObjectStateTable(&n_table);
+    ASSERT_NE(table, nullptr);
+    ASSERT_EQ(n_table, n);
+
+    for (int i = 0; i < n; i++)
+    {
+        SE_ScenarioObjectState state;
+        ASSERT_EQ(SE_GetObjectState(SE_GetId(i), &state), 0);
+        EXPECT_EQ(states[static_cast<unsigned int>(i)].id, state.id);
+        EXPECT_EQ(states[static_cast<unsigned int>(i)].x, state.x);
+        EXPECT_EQ(states[static_cast<unsigned int>(i)].s, state.s);
+        EXPECT_EQ(table[i].id, state.id);
+        EXPECT_EQ(table[i].y, state.y);
+        EXPECT_EQ(table[i].laneId, state.laneId);
+        EXPECT_EQ(id[static_cast<unsigned int>(i)], state.id);
+        EXPECT_EQ(x[static_cast<unsigned int>(i)], state.x);
+        EXPECT_EQ(speed[static_cast<unsigned int>(i)], state.speed);
+    }
+
+    // table is refreshed by the step, not by the call
+    SE_StepDT(0.1f);
+    SE_ScenarioObjectState state;
+    ASSERT_EQ(SE_GetObjectState(SE_GetId(0), &state), 0);
+    EXPECT_EQ(table[0].x, state.x);
+    EXPECT_EQ(table[0].timestamp, state.timestamp);
+    EXPECT_EQ(SE_GetObjectStateTable(&n_table), table);
+
+    SE_Close();
+
+    EXPECT_EQ(SE_GetAllObjectStates(states.data(), n), -1);
+    EXPECT_EQ(SE_GetObjectStateTable(&n_table), nullptr);
+    EXPECT_EQ(n_table, 0);
+}
+
+static std::vector<SE_ScenarioObjectState> RunScenario(const char* filename, int n_steps)
+{
+    std::vector<SE_ScenarioObjectState> states;
+    SE_ScenarioObjectState              state;
+
+    if (SE_Init(filename, 0, 0, 0, 0) != 0)
+    {
+        return states;
+    }
+
+    for (int i = 0; i < n_steps; i++)
+    {
+        SE_StepDT(0.05f);
+        for (int j = 0; j < SE_GetNumberOfObjects(); j++)
+        {
+            SE_GetObjectState(SE_GetId(j), &state);
+            states.push_back(state);
+        }
+    }
+    SE_Close();
+
+    return states;
+}
+
+static void StepContext(SE_Context* ctx, int n_steps, std::vector<SE_ScenarioObjectState>& states)
+{
+    SE_ScenarioObjectState state;
+
+    for (int i = 0; i < n_steps; i++)
+    {
+        SE_StepDTCtx(ctx, 0.05f);
+        for (int j = 0; j < SE_GetNumberOfObjectsCtx(ctx); j++)
+        {
+            SE_GetObjectStateCtx(ctx, SE_GetIdCtx(ctx, j), &state);
+            states.push_back(state);
+        }
+    }
+}
+
+TEST(GetFunctionsTest, TestPerfCounters)
+{
+    SE_PerfCounters counters;
+
+    SE_CollisionDetection(true);
+    ASSERT_EQ(SE_Init("../../../resources/xosc/lane_change.xosc", 0, 0, 0, 0), 0);
+    SE_ResetPerfCounters();
+    ASSERT_EQ(SE_GetPerfCounters(&counters), 0);
+    EXPECT_EQ(counters.frames, 0);
+    EXPECT_EQ(counters.phase_time[0], 0.0);
+
+    // counters are always on, phase times only when requested
+    SE_StepDT(0.1f);
+    ASSERT_EQ(SE_GetPerfCounters(&counters), 0);
+    EXPECT_EQ(counters.frames, 1);
+    EXPECT_EQ(counters.phase_time[0], 0.0);
+
+    SE_PerfPhaseTiming(true);
+    SE_ResetPerfCounters();
+    for (int i = 0; i < 10; i++)
+    {
+        SE_StepDT(0.1f);
+    }
+
+    ASSERT_EQ(SE_GetPerfCounters(&counters), 0);
+    EXPECT_EQ(counters.frames, 10);
+    EXPECT_EQ(counters.entities, 4);
+    EXPECT_GT(counters.xyz2trackpos_calls, 0);
+    EXPECT_LE(counters.xyz2trackpos_full_scans, counters.xyz2trackpos_calls);
+    EXPECT_EQ(counters.collision_pair_tests, 10 * 6);  // 4 objects = 6 pairs per frame
+
+    // frame phase includes all others
+    EXPECT_STREQ(SE_GetPerfPhaseName(0), "frame");
+    EXPECT_EQ(SE_GetPerfPhaseName(SE_PERF_N_PHASES), nullptr);
+    EXPECT_GT(counters.phase_time[0], 0.0);
+    for (int i = 1; i < SE_PERF_N_PHASES; i++)
+    {
+        EXPECT_LE(counters.phase_time[i], counters.phase_time[0]);
+    }
+
+    SE_ResetPerfCounters();
+    ASSERT_EQ(SE_GetPerfCounters(&counters), 0);
+    EXPECT_EQ(counters.frames, 0);
+    EXPECT_EQ(counters.xyz2trackpos_calls, 0);
+
+    SE_PerfPhaseTiming(false);
+    SE_CollisionDetection(false);
+    SE_Close();
+}
+
+TEST(InjectActionTest, TestInjectFromOtherThread)
+{
+    SE_ScenarioObjectState state;
+
+    ASSERT_EQ(SE_Init("../../../resources/xosc/lane_change.xosc", 0, 0, 0, 0), 0);
+    SE_StepDT(0.1f);
+    ASSERT_EQ(SE_GetObjectState(0, &state), 0);
+    EXPECT_NEAR(state.speed, 20.0f, 1e-5);
+    EXPECT_FALSE(SE_InjectedActionOngoing(-1));
+
+    // actions are only queued by the calling thread, then added to the scenario by next step
+    std::thread producer(
+        []()
+        {
+            SE_SpeedActionStruct action = {0, 5.0f, 3, 2, 0.0f};
+            EXPECT_EQ(SE_InjectSpeedAction(&action), 0);
+        });
+    producer.join();
+    EXPECT_TRUE(SE_InjectedActionOngoing(-1));
+    ASSERT_EQ(SE_GetObjectState(0, &state), 0);
+    EXPECT_NEAR(state.speed, 20.0f, 1e-5);
+
+    SE_StepDT(0.1f);
+    ASSERT_EQ(SE_GetObjectState(0, &state), 0);
+    EXPECT_NEAR(state.speed, 5.0f, 1e-5);
+
+    SE_StepDT(0.1f);
+    EXPECT_FALSE(SE_InjectedActionOngoing(-1));
+
+    // queue is bounded, full queue is reported instead of blocking
+    SE_SpeedActionStruct action = {0, 10.0f, 3, 2, 0.0f};
+    int                  n      = 0;
+    while (n < 1024 && SE_InjectSpeedAction(&action) == 0)
+    {
+        n++;
+    }
+    EXPECT_GT(n, 0);
+    EXPECT_LT(n, 1024);
+
+    SE_Close();
+    EXPECT_EQ(SE_InjectSpeedAction(&action), -1);
+
+    // injection while another thread closes and reloads the scenario
+    std::atomic<bool> done(false);
+    std::thread       injector(
+        [&done]()
+        {
+            SE_LaneOffsetActionStruct offset = {0, 0.5f, 3.0f, 0};
+            while (!done)
+            {
+                SE_InjectLaneOffsetAction(&offset);
+            }
+        });
+    for (int i = 0; i < 5; i++)
+    {
+        ASSERT_EQ(SE_Init("../../../resources/xosc/lane_change.xosc", 0, 0, 0, 0), 0);
+        SE_StepDT(0.1f);
+        SE_Close();
+    }
+    done = true;
+    injector.join();
+}
+
+static void ExpectEqualStates(const std::vector<SE_ScenarioObjectState>& a, const std::vector<SE_ScenarioObjectState>& b)
+{
+    ASSERT_EQ(a.size(), b.size());
+    for (size_t i = 0; i < a.size(); i++)
+    {
+        EXPECT_EQ(a[i].id, b[i].id);
+        EXPECT_DOUBLE_EQ(a[i].timestamp, b[i].timestamp);
+        EXPECT_DOUBLE_EQ(a[i].x, b[i].x);
+        EXPECT_DOUBLE_EQ(a[i].y, b[i].y);
+        EXPECT_DOUBLE_EQ(a[i].h, b[i].h);
+        EXPECT_DOUBLE_EQ(a[i].speed, b[i].speed);
+    }
+}
+
+TEST(ContextTest, TestMultipleInstances)
+{
+    const char* scenario[2] = {"../../../resources/xosc/cut-in.xosc", "../../../resources/xosc/lane_change.xosc"};
+    const int   n_steps     = 100;
+
+    std::vector<SE_ScenarioObjectState> ref[2] = {RunScenario(scenario[0], n_steps), RunScenario(scenario[1], n_steps)};
+    ASSERT_GT(ref[0].size(), 0);
+    ASSERT_GT(ref[1].size(), 0);
+
+    SE_Context* ctx[2] = {SE_CreateContext(), SE_CreateContext()};
+    ASSERT_NE(ctx[0], nullptr);
+    ASSERT_NE(ctx[1], nullptr);
+    ASSERT_EQ(SE_InitCtx(ctx[0], scenario[0], 0, 0), 0);
+    ASSERT_EQ(SE_InitCtx(ctx[1], scenario[1], 0, 0), 0);
+    EXPECT_EQ(SE_GetNumberOfObjectsCtx(ctx[0]), 2);
+    EXPECT_EQ(SE_GetNumberOfObjectsCtx(ctx[1]), 4);
+
+    // default instance is not affected by the contexts
+    EXPECT_EQ(SE_GetNumberOfObjects(), -1);
+
+    // interleaved stepping
+    std::vector<SE_ScenarioObjectState> states[2];
+    for (int i = 0; i < n_steps; i++)
+    {
+        StepContext(ctx[0], 1, states[0]);
+        StepContext(ctx[1], 1, states[1]);
+    }
+    ExpectEqualStates(ref[0], states[0]);
+    ExpectEqualStates(ref[1], states[1]);
+    EXPECT_NEAR(SE_GetSimulationTimeDoubleCtx(ctx[0]), n_steps * 0.05, 1e-5);
+
+    // parameters are separated as well
+    double value = 0.0;
+    EXPECT_EQ(SE_SetParameterDoubleCtx(ctx[0], "EgoStartS", 10.0), 0);
+    EXPECT_EQ(SE_GetParameterDoubleCtx(ctx[0], "EgoStartS", &value), 0);
+    EXPECT_DOUBLE_EQ(value, 10.0);
+    EXPECT_EQ(SE_GetParameterDoubleCtx(ctx[1], "EgoStartS", &value), 0);
+    EXPECT_DOUBLE_EQ(value, 50.0);
+    EXPECT_EQ(SE_GetParameterDoubleCtx(ctx[0], "DummyParameter", &value), -1);
+    EXPECT_EQ(SE_GetParameterDoubleCtx(ctx[1], "DummyParameter", &value), 0);
+
+    SE_DestroyContext(ctx[0]);
+    SE_DestroyContext(ctx[1]);
+
+    // contexts and default instance used from separate threads, calls are serialized
+    ctx[0] = SE_CreateContext();
+    ctx[1] = SE_CreateContext();
+    ASSERT_EQ(SE_InitCtx(ctx[0], scenario[0], 0, 0), 0);
+    ASSERT_EQ(SE_InitCtx(ctx[1], scenario[1], 0, 0), 0);
+    states[0].clear();
+    states[1].clear();
+    std::vector<SE_ScenarioObjectState> default_states;
+    std::thread                         thread0(StepContext, ctx[0], n_steps, std::ref(states[0]));
+    std::thread                         thread1(StepContext, ctx[1], n_steps, std::ref(states[1]));
+    std::thread                         thread2([&]() { default_states = RunScenario(scenario[1], n_steps); });
+    thread0.join();
+    thread1.join();
+    thread2.join();
+    ExpectEqualStates(ref[0], states[0]);
+    ExpectEqualStates(ref[1], states[1]);
+    ExpectEqualStates(ref[1], default_states);
+
+    SE_DestroyContext(ctx[0]);
+    SE_DestroyContext(ctx[1]);
+
+    EXPECT_EQ(SE_InitCtx(nullptr, scenario[0], 0, 0), -1);
+    EXPECT_EQ(SE_StepCtx(nullptr), -1);
+}
+
 TEST(RoutingTest, TestRouteStatus)
 {
     std::string scenario_file = "../../../EnvironmentSimulator/Unittest/xosc/route_detour.xosc";
@@ -3,8 +3,11 @@
 #include <gmock/gmock.h>
 #include <vector>
 #include <stdexcept>
+#include <fstream>
+#include <sstream>
 
 #include "playerbase.hpp"
+#include "Profiler.hpp"
 
 using namespace roadmanager;
 using namespace scenarioengine;
@@ -224,6 +227,65 @@ TEST(SensorTest, TestSensorFunctionsReturnValuesAndCounters)
     delete player;
 }
 
+TEST(SensorTest, TestDetectionsWithinFieldOfView)
+{
+    const char*     args[] = {"esmini", "--osc", "../../../resources/xosc/cut-in.xosc", "--headless", "--disable_stdout"};
+    int             argc   = sizeof(args) / sizeof(char*);
+    ScenarioPlayer* player = new ScenarioPlayer(argc, const_cast<char**>(args));
+
+    ASSERT_NE(player, nullptr);
+    int retval = player->Init();
+    ASSERT_EQ(retval, 0);
+
+    Object* ego    = player->scenarioEngine->entities_.object_[0];
+    Object* target = player->scenarioEngine->entities_.object_[1];
+
+    // forward, rearward and left looking sensors on ego
+    EXPECT_EQ(player->AddObjectSensor(ego, 2.0, 0.0, 1.0, 0.0, 1.0, 200.0, 0.7, 10), 0);
+    EXPECT_EQ(player->AddObjectSensor(ego, -1.0, 0.0, 1.0, M_PI, 1.0, 200.0, 0.7, 10), 1);
+    EXPECT_EQ(player->AddObjectSensor(ego, 1.0, 1.0, 1.0, M_PI_2, 1.0, 200.0, 1.0, 10), 2);
+
+    // place target ahead of ego, slightly to the right
+    target->pos_.SetInertiaPos(ego->pos_.GetX() + 50.0 * cos(ego->pos_.GetH()) + 3.0 * sin(ego->pos_.GetH()),
+                               ego->pos_.GetY() + 50.0 * sin(ego->pos_.GetH()) - 3.0 * cos(ego->pos_.GetH()),
+                               ego->pos_.GetH());
+    player->ScenarioPostFrame();
+
+    ASSERT_EQ(player->sensor[0]->nObj_, 1);
+    EXPECT_EQ(player->sensor[0]->hitList_[0].obj_, target);
+    EXPECT_NEAR(player->sensor[0]->hitList_[0].x_, 48.0, 1e-3);
+    EXPECT_NEAR(player->sensor[0]->hitList_[0].y_, -3.0, 1e-3);
+    EXPECT_EQ(player->sensor[1]->nObj_, 0);
+    EXPECT_EQ(player->sensor[2]->nObj_, 0);
+
+    // same result when sensor uses a grid of its own
+    player->sensor[0]->Update();
+    ASSERT_EQ(player->sensor[0]->nObj_, 1);
+    EXPECT_NEAR(player->sensor[0]->hitList_[0].x_, 48.0, 1e-3);
+
+    // place target to the right of ego, not seen by the left looking sensor
+    target->pos_.SetInertiaPos(ego->pos_.GetX() + 1.0 * cos(ego->pos_.GetH()) + 20.0 * sin(ego->pos_.GetH()),
+                               ego->pos_.GetY() + 1.0 * sin(ego->pos_.GetH()) - 20.0 * cos(ego->pos_.GetH()),
+                               ego->pos_.GetH());
+    player->ScenarioPostFrame();
+    EXPECT_EQ(player->sensor[0]->nObj_, 0);
+    EXPECT_EQ(player->sensor[1]->nObj_, 0);
+    EXPECT_EQ(player->sensor[2]->nObj_, 0);
+
+    // and to the left
+    target->pos_.SetInertiaPos(ego->pos_.GetX() + 1.0 * cos(ego->pos_.GetH()) - 20.0 * sin(ego->pos_.GetH()),
+                               ego->pos_.GetY() + 1.0 * sin(ego->pos_.GetH()) + 20.0 * cos(ego->pos_.GetH()),
+                               ego->pos_.GetH());
+    player->ScenarioPostFrame();
+    EXPECT_EQ(player->sensor[0]->nObj_, 0);
+    EXPECT_EQ(player->sensor[1]->nObj_, 0);
+    ASSERT_EQ(player->sensor[2]->nObj_, 1);
+    EXPECT_NEAR(player->sensor[2]->hitList_[0].x_, 19.0, 1e-3);
+    EXPECT_NEAR(player->sensor[2]->hitList_[0].y_, 0.0, 1e-3);
+
+    delete player;
+}
+
 TEST(AlignmentTest, TestPosMode)
 {
     const char* args[] = {"esmini", "--headless", "--osc", "../../../EnvironmentSimulator/Unittest/xosc/curve_slope_simple.xosc", "--disable_stdout"};
@@ -442,6 +504,130 @@ TEST(Controllers, TestSeparateControllersOnLatLong)
     delete player;
 }
 
+static std::string ReadFileContent(std::string filename)
+{
+    std::ifstream     file(filename, std::ios::binary);
+    std::stringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+static void RunRecording(bool pipelined, std::string dat_filename, std::string csv_filename)
+{
+    std::vector<const char*> args = {"esmini",
+                                     "--osc",
+                                     "../../../resources/xosc/cut-in.xosc",
+                                     "--headless",
+                                     "--disable_stdout",
+                                     "--fixed_timestep",
+                                     "0.05",
+                                     "--record",
+                                     dat_filename.c_str(),
+                                     "--csv_logger",
+                                     csv_filename.c_str()};
+    if (pipelined)
+    {
+        args.push_back("--pipeline");
+        args.push_back("2");
+    }
+
+    ScenarioPlayer* player = new ScenarioPlayer(static_cast<int>(args.size()), const_cast<char**>(args.data()));
+    ASSERT_EQ(player->Init(), 0);
+    EXPECT_EQ(player->output_pipeline_.IsActive(), pipelined);
+
+    while (!player->IsQuitRequested())
+    {
+        player->Frame(player->GetFixedTimestep());
+    }
+
+    if (pipelined)
+    {
+        EXPECT_EQ(player->output_pipeline_.GetNumberOfJobs(), static_cast<unsigned int>(player->GetCounter()));
+    }
+
+    delete player;
+}
+
+TEST(Pipeline, TestPipelinedOutputEqualsDirectOutput)
+{
+    RunRecording(false, "direct.dat", "direct.csv");
+    RunRecording(true, "pipelined.dat", "pipelined.csv");
+
+    std::string csv = ReadFileContent("direct.csv");
+    EXPECT_GT(csv.size(), 10000);
+    EXPECT_EQ(csv, ReadFileContent("pipelined.csv"));
+
+    // compare .dat states field by field, header and unused parts of names are not initialized
+    std::string dat[2] = {ReadFileContent("direct.dat"), ReadFileContent("pipelined.dat")};
+    ASSERT_EQ(dat[0].size(), dat[1].size());
+    ASSERT_GT(dat[0].size(), sizeof(DatHeader) + 100 * sizeof(ObjectStateStructDat));
+
+    size_t n_states = (dat[0].size() - sizeof(DatHeader)) / sizeof(ObjectStateStructDat);
+    for (size_t i = 0; i < n_states; i++)
+    {
+        ObjectStateStructDat state[2];
+        for (int j = 0; j < 2; j++)
+        {
+            memcpy(&state[j], dat[j].data() + sizeof(DatHeader) + i * sizeof(ObjectStateStructDat), sizeof(ObjectStateStructDat));
+        }
+        ASSERT_EQ(state[0].info.id, state[1].info.id);
+        ASSERT_EQ(state[0].info.timeStamp, state[1].info.timeStamp);
+        ASSERT_EQ(state[0].info.speed, state[1].info.speed);
+        ASSERT_EQ(state[0].pos.x, state[1].pos.x);
+        ASSERT_EQ(state[0].pos.y, state[1].pos.y);
+        ASSERT_EQ(state[0].pos.h, state[1].pos.h);
+        ASSERT_EQ(state[0].pos.laneId, state[1].pos.laneId);
+    }
+}
+
+TEST(BatchMode, TestBatchModeRunsToEnd)
+{
+    const char*     args[]  = {"esmini", "--osc", "../../../resources/xosc/cut-in.xosc", "--batch", "--disable_stdout", "--realtime_factor", "1.0"};
+    int             argc    = sizeof(args) / sizeof(char*);
+    ScenarioPlayer* player  = new ScenarioPlayer(argc, const_cast<char**>(args));
+    int64_t         frames  = SE_Profiler::GetCounter(SE_Profiler::Counter::FRAMES);
+    int64_t         sb_time = SE_Profiler::GetPhaseTime(SE_Profiler::Phase::STORYBOARD);
+    int64_t         vw_time = SE_Profiler::GetPhaseTime(SE_Profiler::Phase::VIEWER);
+
+    ASSERT_EQ(player->Init(), 0);
+    EXPECT_TRUE(player->IsBatchMode());
+    EXPECT_NEAR(player->GetFixedTimestep(), BATCH_DEFAULT_TIMESTEP, SMALL_NUMBER);
+    EXPECT_FALSE(player->pacer_.IsActive());
+    EXPECT_EQ(player->viewer_, nullptr);
+    EXPECT_FALSE(SE_Profiler::IsEnabled());  // statistics are based on the accumulated phase times
+    EXPECT_TRUE(SE_Profiler::GetPhaseTiming());
+
+    while (!player->IsQuitRequested())
+    {
+        player->Frame(player->GetFixedTimestep());
+    }
+    EXPECT_GT(player->scenarioEngine->getSimulationTime(), 10.0);
+    // including initial zero step, excluding the last one ending the scenario
+    EXPECT_EQ(SE_Profiler::GetCounter(SE_Profiler::Counter::FRAMES) - frames, player->GetCounter());
+    EXPECT_GT(SE_Profiler::GetPhaseTime(SE_Profiler::Phase::STORYBOARD), sb_time);
+    EXPECT_GT(SE_getPeakMemoryUsage(), 1024 * 1024);
+    EXPECT_EQ(SE_Profiler::GetPhaseTime(SE_Profiler::Phase::VIEWER), vw_time);
+
+    delete player;
+    EXPECT_FALSE(SE_Profiler::IsEnabled());
+    EXPECT_FALSE(SE_Profiler::GetPhaseTiming());
+
+    // ghost restarts are stepped within the frame, without any viewer update either
+    const char* args_ghost[] = {"esmini", "--osc", "../../../EnvironmentSimulator/Unittest/xosc/ghost_restart.xosc", "--batch", "--disable_stdout"};
+    player                   = new ScenarioPlayer(sizeof(args_ghost) / sizeof(char*), const_cast<char**>(args_ghost));
+    frames                   = SE_Profiler::GetCounter(SE_Profiler::Counter::FRAMES);
+
+    ASSERT_EQ(player->Init(), 0);
+    while (!player->IsQuitRequested())
+    {
+        player->Frame(player->GetFixedTimestep());
+    }
+    EXPECT_GT(SE_Profiler::GetCounter(SE_Profiler::Counter::FRAMES) - frames, player->GetCounter());  // ghost solo frames
+    EXPECT_EQ(SE_Profiler::GetPhaseTime(SE_Profiler::Phase::VIEWER), vw_time);
+
+    delete player;
+}
+
 #ifdef _USE_OSI
 
 TEST(OSI, TestOrientation)
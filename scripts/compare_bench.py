@@ -0,0 +1,73 @@
+import argparse
+import json
+import sys
+
+'''
+Compare two esmini-bench result files, e.g. a stored baseline and a new run.
+Benchmarks with a median time increased more than the threshold are reported as regressions.
+Exit code is 1 if any regression was found, else 0.
+
+Example:
+  ./bin/esmini-bench --json baseline.json
+  <make changes, rebuild>
+  ./bin/esmini-bench --json current.json
+  python3 scripts/compare_bench.py baseline.json current.json --threshold 10
+'''
+
+def selected(name, filter):
+    # filter is a sequence of whole /-separated name parts, '*' matching any part
+    parts = name.split('/')
+    pattern = [p for p in filter.split('/') if p]
+    return any(all(f in ('*', parts[start + i]) for i, f in enumerate(pattern)) for start in range(len(parts) - len(pattern) + 1))
+
+def load(filename):
+    with open(filename) as f:
+        data = json.load(f)
+    return data.get('esmini_git_rev', 'N/A'), {b['name']: b for b in data['benchmarks']}
+
+if __name__ == "__main__":
+    # Create the parser
+    parser = argparse.ArgumentParser(description='Compare esmini-bench results against a baseline')
+
+    # Add the arguments
+    parser.add_argument('baseline', help='baseline result file (json)')
+    parser.add_argument('current', help='current result file (json)')
+    parser.add_argument('--threshold', '-t', type=float, default=10.0, help='max accepted increase of median, in percent (default 10)')
+    parser.add_argument('--filter', '-f', default='', help='compare only benchmarks with matching /-separated name parts, * = any, e.g. "rm" or "frame/generated_10"')
+
+    # Execute the parse_args() method
+    args = parser.parse_args()
+
+    base_rev, baseline = load(args.baseline)
+    cur_rev, current = load(args.current)
+
+    print('baseline: {} ({})\ncurrent:  {} ({})\n'.format(args.baseline, base_rev, args.current, cur_rev))
+    print('{:<48} {:>14} {:>14} {:>9}'.format('benchmark', 'baseline', 'current', 'change'))
+
+    regressions = []
+    for name, cur in current.items():
+        if not selected(name, args.filter):
+            continue
+        if name not in baseline:
+            print('{:<48} {:>14} {:>14.1f} {:>9}'.format(name, '-', cur['median'], 'new'))
+            continue
+
+        base = baseline[name]
+        change = 100.0 * (cur['median'] - base['median']) / base['median'] if base['median'] > 0 else 0.0
+        flag = ''
+        if change > args.threshold:
+            flag = '  REGRESSION'
+            regressions.append(name)
+        elif change < -args.threshold:
+            flag = '  improved'
+        print('{:<48} {:>14.1f} {:>14.1f} {:>8.1f}%{}'.format(name, base['median'], cur['median'], change, flag))
+
+    for name in baseline:
+        if selected(name, args.filter) and name not in current:
+            print('{:<48} {:>14.1f} {:>14} {:>9}'.format(name, baseline[name]['median'], '-', 'missing'))
+
+    if regressions:
+        print('\n{} regression(s) above {:.1f}%: {}'.format(len(regressions), args.threshold, ', '.join(regressions)))
+        sys.exit(1)
+
+    print('\nNo regressions above {:.1f}%'.format(args.threshold))
@@ -0,0 +1,466 @@
+import argparse
+import math
+import os
+import random
+import xml.etree.ElementTree as ET
+
+'''
+Generate a parametric road network (OpenDRIVE) and a scenario (OpenSCENARIO) with many vehicles,
+e.g. as reproducible input for esmini-bench and scaling tests.
+
+Networks:
+  grid     nx * ny four-way junctions, connected by two-way roads. Junction density is given by the spacing.
+  highway  long multi-lane two-way road of linked road segments, alternating curves.
+
+Examples:
+  python3 scripts/generate_scaling_scenario.py grid_50x50 --network grid --grid 50 50 --spacing 150 --vehicles 2000
+  python3 scripts/generate_scaling_scenario.py highway --network highway --length 20000 --lanes 3 --spirals --elevation 10
+  ./bin/esmini-bench --osc grid_50x50.xosc
+'''
+
+DIRECTIONS = [(1, 0), (0, 1), (-1, 0), (0, -1)]  # E, N, W, S
+CAR_LENGTH = 5.0
+
+
+class Primitive:
+    '''Part of a road reference line: line (k0 = k1 = 0), arc (k0 = k1) or spiral'''
+    def __init__(self, length, k0=0.0, k1=None):
+        self.length = length
+        self.k0 = k0
+        self.k1 = k0 if k1 is None else k1
+
+    def end(self, x, y, h):
+        '''Integrate along the primitive (Simpson's rule), return end point and heading'''
+        def heading(s):
+            return h + self.k0 * s + (self.k1 - self.k0) * s * s / (2 * self.length)
+
+        n = 64 if self.k0 != self.k1 else 1
+        if self.k0 == self.k1 and self.k0 != 0.0:
+            # arc, exact solution
+            h1 = heading(self.length)
+            return x + (math.sin(h1) - math.sin(h)) / self.k0, y - (math.cos(h1) - math.cos(h)) / self.k0, h1
+        if self.k0 == 0.0 and self.k1 == 0.0:
+            return x + self.length * math.cos(h), y + self.length * math.sin(h), h
+
+        ds = self.length / (2 * n)
+        sx = sy = 0.0
+        for i in range(2 * n + 1):
+            w = 1 if i in (0, 2 * n) else (4 if i % 2 else 2)
+            sx += w * math.cos(heading(i * ds))
+            sy += w * math.sin(heading(i * ds))
+        return x + sx * ds / 3, y + sy * ds / 3, heading(self.length)
+
+
+class Road:
+    def __init__(self, id, x, y, h, primitives, lanes, lane_width, type, junction=-1):
+        self.id = id
+        self.type = type
+        self.x = x
+        self.y = y
+        self.h = h
+        self.primitives = primitives
+        self.length = sum(p.length for p in primitives)
+        self.lanes = lanes  # lanes per side, or for connecting roads number of right lanes
+        self.lane_width = lane_width
+        self.junction = junction
+        self.left = junction == -1  # connecting roads have right lanes only
+        self.predecessor = None  # (element type, id, contact point)
+        self.successor = None
+        self.lane_links = {}  # lane id -> (predecessor lane id, successor lane id), None if no link
+        self.elevation = [(0.0, 0.0, 0.0, 0.0, 0.0)]  # (s, a, b, c, d)
+
+    def set_elevation(self, z0, z1):
+        '''Smooth cubic from z0 to z1 with zero slope at both ends'''
+        dz = z1 - z0
+        self.elevation = [(0.0, z0, 0.0, 3 * dz / self.length**2, -2 * dz / self.length**3)]
+
+    def to_xml(self, parent):
+        road = ET.SubElement(parent, 'road', name='road_{}'.format(self.id), length=fmt(self.length), id=str(self.id),
+                             junction=str(self.junction))
+        link = ET.SubElement(road, 'link')
+        for tag, ref in (('predecessor', self.predecessor), ('successor', self.successor)):
+            if ref is not None:
+                attrib = {'elementType': ref[0], 'elementId': str(ref[1])}
+                if ref[2] is not None:
+                    attrib['contactPoint'] = ref[2]
+                ET.SubElement(link, tag, attrib)
+        ET.SubElement(road, 'type', s='0', type=self.type)
+
+        plan_view = ET.SubElement(road, 'planView')
+        s, x, y, h = 0.0, self.x, self.y, self.h
+        for p in self.primitives:
+            geom = ET.SubElement(plan_view, 'geometry', s=fmt(s), x=fmt(x), y=fmt(y), hdg=fmt(h), length=fmt(p.length))
+            if p.k0 != p.k1:
+                ET.SubElement(geom, 'spiral', curvStart=fmt(p.k0), curvEnd=fmt(p.k1))
+            elif p.k0 != 0.0:
+                ET.SubElement(geom, 'arc', curvature=fmt(p.k0))
+            else:
+                ET.SubElement(geom, 'line')
+            x, y, h = p.end(x, y, h)
+            s += p.length
+
+        elevation = ET.SubElement(road, 'elevationProfile')
+        for e in self.elevation:
+            ET.SubElement(elevation, 'elevation', s=fmt(e[0]), a=fmt(e[1]), b=fmt(e[2]), c=fmt(e[3]), d=fmt(e[4]))
+
+        lanes = ET.SubElement(road, 'lanes')
+        section = ET.SubElement(lanes, 'laneSection', s='0')
+        if self.left:
+            left = ET.SubElement(section, 'left')
+            for i in range(self.lanes, 0, -1):
+                self.lane_to_xml(left, i)
+        center = ET.SubElement(section, 'center')
+        lane = ET.SubElement(center, 'lane', id='0', type='none', level='false')
+        if self.junction == -1:
+            ET.SubElement(lane, 'roadMark', sOffset='0', type='solid' if self.lanes > 1 else 'broken', weight='standard',
+                          color='standard', width='0.12')
+        right = ET.SubElement(section, 'right')
+        for i in range(1, self.lanes + 1):
+            self.lane_to_xml(right, -i)
+
+    def lane_to_xml(self, parent, id):
+        lane = ET.SubElement(parent, 'lane', id=str(id), type='driving', level='false')
+        if id in self.lane_links:
+            link = ET.SubElement(lane, 'link')
+            for tag, linked_id in zip(('predecessor', 'successor'), self.lane_links[id]):
+                if linked_id is not None:
+                    ET.SubElement(link, tag, id=str(linked_id))
+        ET.SubElement(lane, 'width', sOffset='0', a=fmt(self.lane_width), b='0', c='0', d='0')
+        if self.junction == -1:
+            ET.SubElement(lane, 'roadMark', sOffset='0', type='solid' if abs(id) == self.lanes else 'broken',
+                          weight='standard', color='standard', width='0.12')
+
+
+def fmt(value):
+    return '{:.12g}'.format(value)
+
+
+def s_curve(length, spiral_length, max_heading=0.15):
+    '''
+    Reference line of given length that wiggles sideways by means of spirals, ending at same lateral
+    position and heading as it started. Falls back to a line if too short.
+    '''
+    spiral_length = min(spiral_length, (length - 20.0) / 8)
+    if spiral_length < 5.0:
+        return [Primitive(length)]
+
+    k = max_heading / spiral_length
+    half = [Primitive(spiral_length, 0.0, k), Primitive(spiral_length, k, 0.0),
+            Primitive(spiral_length, 0.0, -k), Primitive(spiral_length, -k, 0.0)]
+    mirror = [Primitive(p.length, -p.k0, -p.k1) for p in half]
+
+    # the mirrored half cancels the lateral offset, fill remaining length with straight lines
+    x, y, h = 0.0, 0.0, 0.0
+    for p in half:
+        x, y, h = p.end(x, y, h)
+    forward = x
+    line = (length - 2 * forward) / 2
+    return [Primitive(line)] + half + mirror + [Primitive(line)]
+
+
+class Network:
+    def __init__(self, args):
+        self.args = args
+        self.roads = []
+        self.junctions = []  # (id, [connections]), connection = (incoming road, connecting road, [(from lane, to lane)])
+        self.next_id = 0
+
+    def new_id(self):
+        self.next_id += 1
+        return self.next_id - 1
+
+    def lane_ids(self, road):
+        '''Driving lane ids of a road available for placing vehicles'''
+        return [i for i in range(1, road.lanes + 1)] + [-i for i in range(1, road.lanes + 1)]
+
+    def write(self, filename, name):
+        root = ET.Element('OpenDRIVE')
+        ET.SubElement(root, 'header', revMajor='1', revMinor='4', name=name, version='1.00')
+        for road in self.roads:
+            road.to_xml(root)
+        for id, connections in self.junctions:
+            junction = ET.SubElement(root, 'junction', id=str(id), name='junction_{}'.format(id))
+            for i, (incoming, connecting, lane_links) in enumerate(connections):
+                connection = ET.SubElement(junction, 'connection', id=str(i), incomingRoad=str(incoming),
+                                           connectingRoad=str(connecting), contactPoint='start')
+                for from_lane, to_lane in lane_links:
+                    ET.SubElement(connection, 'laneLink', attrib={'from': str(from_lane), 'to': str(to_lane)})
+        write_xml(root, filename)
+
+
+class Grid(Network):
+    def __init__(self, args):
+        super().__init__(args)
+        nx, ny = args.grid
+        lanes = args.lanes
+        width = args.lane_width
+        spacing = args.spacing
+        h = max(args.junction_size / 2, lanes * width + 2.0)  # room for right turns of all lanes
+
+        if spacing < 2 * h + 10.0:
+            raise ValueError('spacing {} too small for junction size {}'.format(spacing, 2 * h))
+
+        rnd = random.Random(args.seed)
+        elevation = [[args.elevation * rnd.uniform(-1, 1) for _ in range(ny)] for _ in range(nx)]
+        arms = [[[] for _ in range(ny)] for _ in range(nx)]  # per junction: list of (direction index, road, contact point)
+
+        # roads between neighbouring junctions, towards east and north
+        for ix in range(nx):
+            for iy in range(ny):
+                for d, (dx, dy) in enumerate(DIRECTIONS[:2]):
+                    jx, jy = ix + dx, iy + dy
+                    if jx >= nx or jy >= ny:
+                        continue
+                    length = spacing - 2 * h
+                    primitives = s_curve(length, args.spiral_length) if args.spirals else [Primitive(length)]
+                    road = Road(self.new_id(), ix * spacing + h * dx, iy * spacing + h * dy, math.atan2(dy, dx),
+                                primitives, lanes, width, 'town')
+                    road.set_elevation(elevation[ix][iy], elevation[jx][jy])
+                    self.roads.append(road)
+                    arms[ix][iy].append((d, road, 'start'))
+                    arms[jx][jy].append((d + 2, road, 'end'))
+
+        self.arm_roads = list(self.roads)
+
+        # junctions, with connecting roads from every incoming arm to every other arm
+        for ix in range(nx):
+            for iy in range(ny):
+                junction_id = self.new_id()
+                connections = []
+                for d_in, road_in, contact_in in arms[ix][iy]:
+                    for d_out, road_out, contact_out in arms[ix][iy]:
+                        if d_out == d_in:
+                            continue
+                        turn = (d_out - d_in) % 4  # 1 = right, 2 = straight, 3 = left
+                        ux, uy = DIRECTIONS[d_in]
+                        if turn == 2:
+                            primitives = [Primitive(2 * h)]
+                        else:
+                            primitives = [Primitive(h * math.pi / 2, 1 / h if turn == 3 else -1 / h)]
+                        road = Road(self.new_id(), ix * spacing + h * ux, iy * spacing + h * uy,
+                                    math.atan2(uy, ux) + math.pi, primitives, lanes, width, 'town', junction_id)
+                        road.elevation = [(0.0, elevation[ix][iy], 0.0, 0.0, 0.0)]
+                        road.predecessor = ('road', road_in.id, contact_in)
+                        road.successor = ('road', road_out.id, contact_out)
+                        lane_links = []
+                        for k in range(1, lanes + 1):
+                            from_lane = k if contact_in == 'start' else -k
+                            to_lane = -k if contact_out == 'start' else k
+                            road.lane_links[-k] = (from_lane, to_lane)
+                            lane_links.append((from_lane, -k))
+                        self.roads.append(road)
+                        connections.append((road_in.id, road.id, lane_links))
+
+                for d, road, contact in arms[ix][iy]:
+                    if contact == 'start':
+                        road.predecessor = ('junction', junction_id, None)
+                    else:
+                        road.successor = ('junction', junction_id, None)
+                self.junctions.append((junction_id, connections))
+
+    def destination(self, rnd, road, lane_id):
+        '''Random destination on another road, all roads are reachable'''
+        dest = rnd.choice([r for r in self.arm_roads if r is not road])
+        return dest, rnd.choice(self.lane_ids(dest)), dest.length / 2
+
+
+class Highway(Network):
+    def __init__(self, args):
+        super().__init__(args)
+        segment_length = args.segment_length
+        n_segments = max(1, int(round(args.length / segment_length)))
+        rnd = random.Random(args.seed)
+
+        x, y, h = 0.0, 0.0, 0.0
+        z = 0.0
+        for i in range(n_segments):
+            # straight part followed by a curve, alternating left and right
+            k = (1 if i % 2 == 0 else -1) / args.radius
+            curve = min(segment_length / 2, args.radius * 0.35)  # max about 20 degrees
+            if args.spirals:
+                spiral = min(curve / 3, args.spiral_length)
+                primitives = [Primitive(segment_length - curve - spiral), Primitive(spiral, 0.0, k), Primitive(curve - spiral, k),
+                              Primitive(spiral, k, 0.0)]
+            else:
+                primitives = [Primitive(segment_length - curve), Primitive(curve, k)]
+
+            road = Road(self.new_id(), x, y, h, primitives, args.lanes, args.lane_width, 'motorway')
+            z_next = args.elevation * rnd.uniform(-1, 1)
+            road.set_elevation(z, z_next)
+            z = z_next
+            if self.roads:
+                road.predecessor = ('road', self.roads[-1].id, 'end')
+                self.roads[-1].successor = ('road', road.id, 'start')
+                for k in self.lane_ids(road):
+                    road.lane_links[k] = (k, None)
+                    self.roads[-1].lane_links[k] = (self.roads[-1].lane_links.get(k, (None, None))[0], k)
+            self.roads.append(road)
+
+            for p in primitives:
+                x, y, h = p.end(x, y, h)
+
+    def destination(self, rnd, road, lane_id):
+        '''Far end of the highway in driving direction'''
+        dest = self.roads[-1] if lane_id < 0 else self.roads[0]
+        return dest, lane_id, dest.length / 2
+
+
+def write_xml(root, filename):
+    tree = ET.ElementTree(root)
+    if hasattr(ET, 'indent'):
+        ET.indent(tree, space='   ')
+    tree.write(filename, encoding='utf-8', xml_declaration=True)
+
+
+def parse_controller_mix(text):
+    mix = []
+    for item in text.split(','):
+        name, share = item.split('=')
+        if name not in ('default', 'acc', 'follow_route'):
+            raise ValueError('Unknown controller {}, expected default, acc or follow_route'.format(name))
+        mix.append((name, float(share)))
+    total = sum(share for _, share in mix)
+    return [(name, share / total) for name, share in mix]
+
+
+def position(parent, road, lane_id, s):
+    pos = ET.SubElement(parent, 'Position')
+    ET.SubElement(pos, 'LanePosition', roadId=str(road.id), laneId=str(lane_id), offset='0', s=fmt(s))
+
+
+def write_scenario(filename, odr_filename, network, args):
+    rnd = random.Random(args.seed)
+    mix = parse_controller_mix(args.controllers)
+
+    # free slots along all lanes, keeping distance to road ends (junctions) and other vehicles
+    slots = []
+    for road in network.roads:
+        if road.junction != -1:
+            continue
+        for lane_id in network.lane_ids(road):
+            s = 15.0
+            while s < road.length - 15.0:
+                slots.append((road, lane_id, s))
+                s += args.vehicle_spacing
+    if len(slots) < args.vehicles:
+        raise ValueError('Room for only {} vehicles, increase network size or decrease --vehicle_spacing'.format(len(slots)))
+    rnd.shuffle(slots)
+
+    # assign controllers by share, in order of slots
+    controllers = []
+    for name, share in mix:
+        controllers += [name] * int(round(share * args.vehicles))
+    controllers = (controllers + ['default'] * args.vehicles)[:args.vehicles]
+    rnd.shuffle(controllers)
+
+    root = ET.Element('OpenSCENARIO')
+    ET.SubElement(root, 'FileHeader', revMajor='1', revMinor='2', date='2024-01-01T00:00:00',
+                  description='Generated by generate_scaling_scenario.py', author='esmini')
+    ET.SubElement(root, 'ParameterDeclarations')
+    ET.SubElement(root, 'CatalogLocations')
+    road_network = ET.SubElement(root, 'RoadNetwork')
+    ET.SubElement(road_network, 'LogicFile', filepath=odr_filename)
+
+    entities = ET.SubElement(root, 'Entities')
+    for i in range(args.vehicles):
+        obj = ET.SubElement(entities, 'ScenarioObject', name='V{}'.format(i))
+        vehicle = ET.SubElement(obj, 'Vehicle', name='car', vehicleCategory='car')
+        ET.SubElement(vehicle, 'ParameterDeclarations')
+        bb = ET.SubElement(vehicle, 'BoundingBox')
+        ET.SubElement(bb, 'Center', x='1.4', y='0.0', z='0.75')
+        ET.SubElement(bb, 'Dimensions', width='2.0', length=fmt(CAR_LENGTH), height='1.5')
+        ET.SubElement(vehicle, 'Performance', maxSpeed='70', maxAcceleration='10', maxDeceleration='10')
+        axles = ET.SubElement(vehicle, 'Axles')
+        ET.SubElement(axles, 'FrontAxle', maxSteering='0.5', wheelDiameter='0.8', trackWidth='1.7', positionX='2.9',
+                      positionZ='0.4')
+        ET.SubElement(axles, 'RearAxle', maxSteering='0', wheelDiameter='0.8', trackWidth='1.7', positionX='0',
+                      positionZ='0.4')
+        properties = ET.SubElement(vehicle, 'Properties')
+        ET.SubElement(properties, 'Property', name='model_id', value='0')
+
+        if controllers[i] != 'default':
+            controller = ET.SubElement(ET.SubElement(obj, 'ObjectController'), 'Controller', name=controllers[i])
+            ET.SubElement(controller, 'ParameterDeclarations')
+            properties = ET.SubElement(controller, 'Properties')
+            if controllers[i] == 'acc':
+                ET.SubElement(properties, 'Property', name='esminiController', value='ACCController')
+                ET.SubElement(properties, 'Property', name='timeGap', value='1.5')
+                ET.SubElement(properties, 'Property', name='mode', value='override')
+            else:
+                ET.SubElement(properties, 'Property', name='esminiController', value='FollowRouteController')
+
+    storyboard = ET.SubElement(root, 'Storyboard')
+    actions = ET.SubElement(ET.SubElement(storyboard, 'Init'), 'Actions')
+
+    if args.swarm > 0:
+        swarm = ET.SubElement(ET.SubElement(ET.SubElement(actions, 'GlobalAction'), 'TrafficAction'), 'TrafficSwarmAction',
+                              innerRadius='100', semiMajorAxis='300', semiMinorAxis='300', numberOfVehicles=str(args.swarm),
+                              velocity=fmt(args.speed))
+        ET.SubElement(swarm, 'CentralObject', entityRef='V0')
+
+    for i in range(args.vehicles):
+        road, lane_id, s = slots[i]
+        private = ET.SubElement(actions, 'Private', entityRef='V{}'.format(i))
+
+        if controllers[i] == 'follow_route':
+            route = ET.SubElement(ET.SubElement(ET.SubElement(ET.SubElement(private, 'PrivateAction'), 'RoutingAction'),
+                                                'AssignRouteAction'), 'Route', name='route_V{}'.format(i), closed='false')
+            ET.SubElement(route, 'ParameterDeclarations')
+            position(ET.SubElement(route, 'Waypoint', routeStrategy='shortest'), road, lane_id, s)
+            position(ET.SubElement(route, 'Waypoint', routeStrategy='shortest'), *network.destination(rnd, road, lane_id))
+
+        position(ET.SubElement(ET.SubElement(private, 'PrivateAction'), 'TeleportAction'), road, lane_id, s)
+
+        speed = args.speed * rnd.uniform(0.8, 1.2)
+        speed_action = ET.SubElement(ET.SubElement(ET.SubElement(private, 'PrivateAction'), 'LongitudinalAction'), 'SpeedAction')
+        ET.SubElement(speed_action, 'SpeedActionDynamics', dynamicsShape='step', dynamicsDimension='time', value='0')
+        ET.SubElement(ET.SubElement(speed_action, 'SpeedActionTarget'), 'AbsoluteTargetSpeed', value=fmt(speed))
+
+        if controllers[i] != 'default':
+            ET.SubElement(ET.SubElement(ET.SubElement(private, 'PrivateAction'), 'ControllerAction'), 'ActivateControllerAction',
+                          longitudinal='true', lateral='true' if controllers[i] == 'follow_route' else 'false')
+
+    stop = ET.SubElement(ET.SubElement(ET.SubElement(storyboard, 'StopTrigger'), 'ConditionGroup'), 'Condition',
+                         name='stop', delay='0', conditionEdge='rising')
+    ET.SubElement(ET.SubElement(stop, 'ByValueCondition'), 'SimulationTimeCondition', value=fmt(args.duration),
+                  rule='greaterThan')
+
+    write_xml(root, filename)
+
+
+if __name__ == "__main__":
+    # Create the parser
+    parser = argparse.ArgumentParser(description='Generate road network and scenario for scaling tests')
+
+    # Add the arguments
+    parser.add_argument('name', help='base filename of generated .xodr and .xosc files')
+    parser.add_argument('--network', choices=['grid', 'highway'], default='grid', help='type of road network')
+    parser.add_argument('--grid', type=int, nargs=2, default=[4, 4], metavar=('NX', 'NY'), help='number of junctions (grid)')
+    parser.add_argument('--spacing', type=float, default=200.0, help='distance between junctions (grid)')
+    parser.add_argument('--junction_size', type=float, default=20.0, help='junction width (grid)')
+    parser.add_argument('--length', type=float, default=10000.0, help='total length (highway)')
+    parser.add_argument('--segment_length', type=float, default=500.0, help='length of each road (highway)')
+    parser.add_argument('--radius', type=float, default=800.0, help='curve radius (highway)')
+    parser.add_argument('--lanes', type=int, default=1, help='number of lanes in each direction')
+    parser.add_argument('--lane_width', type=float, default=3.5, help='lane width')
+    parser.add_argument('--spirals', action='store_true', help='use spirals, S-curves between junctions or curve transitions')
+    parser.add_argument('--spiral_length', type=float, default=40.0, help='max spiral length')
+    parser.add_argument('--elevation', type=float, default=0.0, help='max elevation, random per junction or road segment')
+    parser.add_argument('--vehicles', type=int, default=100, help='number of vehicles')
+    parser.add_argument('--vehicle_spacing', type=float, default=30.0, help='min distance between vehicles at start')
+    parser.add_argument('--controllers', default='default=1', help='controller mix, e.g. default=0.5,acc=0.3,follow_route=0.2')
+    parser.add_argument('--speed', type=float, default=15.0, help='mean initial speed (m/s)')
+    parser.add_argument('--swarm', type=int, default=0, help='number of swarm vehicles around first vehicle, 0 = no swarm')
+    parser.add_argument('--duration', type=float, default=60.0, help='scenario duration (s)')
+    parser.add_argument('--seed', type=int, default=0, help='random seed, same seed gives same files')
+
+    # Execute the parse_args() method
+    args = parser.parse_args()
+
+    network = Grid(args) if args.network == 'grid' else Highway(args)
+    odr_filename = args.name + '.xodr'
+    network.write(odr_filename, os.path.basename(args.name))
+    write_scenario(args.name + '.xosc', os.path.basename(odr_filename), network, args)
+
+    print('Created {} ({} roads, {} junctions) and {}.xosc ({} vehicles)'.format(
+        odr_filename, len(network.roads), len(network.junctions), args.name, args.vehicles))
@@ -5,6 +5,84 @@ import math
 
 from osi3.osi_groundtruth_pb2 import *
 
+try:
+    import lz4.block
+except ImportError:
+    lz4 = None
+
+COMPRESSED_MAGIC = b'ESZ1'  # see esmini CommonMini/TraceFile.hpp
+
+def lz4_decompress_block(src, size):
+    # Decompress data in LZ4 block format, pure Python fallback when lz4 module is not available
+    if lz4 is not None:
+        return lz4.block.decompress(src, uncompressed_size=size)
+
+    dst = bytearray()
+    i = 0
+    while i < len(src):
+        token = src[i]
+        i += 1
+        length = token >> 4
+        if length == 15:
+            while True:
+                b = src[i]
+                i += 1
+                length += b
+                if b != 255:
+                    break
+        dst += src[i:i + length]
+        i += length
+        if i >= len(src):
+            break  # last sequence has no match part
+        offset = src[i] | (src[i + 1] << 8)
+        i += 2
+        length = token & 0xf
+        if length == 15:
+            while True:
+                b = src[i]
+                i += 1
+                length += b
+                if b != 255:
+                    break
+        length += 4
+        start = len(dst) - offset
+        if offset >= length:
+            dst += dst[start:start + length]
+        else:
+            for j in range(length):  # overlapping copy
+                dst.append(dst[start + j])
+    if len(dst) != size:
+        raise ValueError('Corrupt compressed block')
+    return bytes(dst)
+
+class CompressedFile():
+    # Reads the original byte stream from a compressed trace file, i.e. sequence of blocks with header
+    # (compressed size, uncompressed size) where equal sizes means stored uncompressed
+    def __init__(self, file):
+        self.file = file
+        self.block = b''
+        self.pos = 0
+
+    def read(self, n):
+        data = b''
+        while len(data) < n:
+            if self.pos >= len(self.block):
+                header = self.file.read(8)
+                if len(header) < 8:
+                    break
+                compressed_size, size = struct.unpack('II', header)
+                block = self.file.read(compressed_size)
+                self.block = block if compressed_size == size else lz4_decompress_block(block, size)
+                self.pos = 0
+                continue
+            chunk = self.block[self.pos:self.pos + n - len(data)]
+            self.pos += len(chunk)
+            data += chunk
+        return data
+
+    def close(self):
+        self.file.close()
+
 class OSIFile():
     def __init__(self, filename):
         try:
@@ -13,6 +91,12 @@ class OSIFile():
             print('ERROR: Could not open file {} for reading'.format(filename))
             raise
 
+        # detect compressed trace files, e.g. esmini --osi_file_compress
+        if self.file.read(4) == COMPRESSED_MAGIC:
+            self.file = CompressedFile(self.file)
+        else:
+            self.file.seek(0)
+
         self.filename = filename
         self.osi_msg = GroundTruth()
 
@@ -5,6 +5,7 @@ from test_common import *
 import unittest
 import argparse
 import os.path
+import shutil
 
 ESMINI_PATH = '../'
 COMMON_ESMINI_ARGS = '--headless --fixed_timestep 0.01 --record sim.dat '
@@ -1833,6 +1834,45 @@ class TestSuite(unittest.TestCase):
         self.assertTrue(re.search('^19.600, 2, object_2, 463.889, -1.500, 0.000, 0.000, 0.000, 0.000, 27.778, 0.000, 0.000', csv, re.MULTILINE))
         self.assertTrue(re.search('^19.600, 3, object_3, 422.222, -1.500, 0.000, 0.000, 0.000, 0.000, 27.778, 0.000, 0.000', csv, re.MULTILINE))
 
+    def test_dat2csv_kpi(self):
+        # record two scenarios with collisions, then convert both in parallel and calculate KPIs with respect to ego
+        run_scenario(os.path.join(ESMINI_PATH, 'resources/xosc/cut-in.xosc'), '--headless --fixed_timestep 0.01 --record kpi_cut-in.dat')
+        run_scenario(os.path.join(ESMINI_PATH, 'resources/xosc/pedestrian_collision.xosc'), '--headless --fixed_timestep 0.01 --record kpi_ped.dat')
+        os.makedirs('kpi_csv', exist_ok=True)
+
+        log = run_dat2csv('--kpi kpi.csv --ego 0 --threads 2 --output_dir kpi_csv kpi_cut-in.dat kpi_ped.dat')
+        self.assertTrue(re.search('Processed 2 files \\(0 failed\\) using 2 threads', log)  is not None)
+
+        with open('kpi.csv', 'r') as f:
+            kpi = f.read()
+        self.assertTrue(re.search('^file, status, entries, frames, start_time, stop_time, collisions, min_gap, min_gap_time, min_ttc, min_ttc_time\n', kpi))
+        self.assertTrue(re.search('\nkpi_cut-in.dat, 0, 4350, 2175, 0.000, 21.740, 1, 0.000, 12.440, 0.007, 12.430\n', kpi))
+        self.assertTrue(re.search('\nkpi_ped.dat, 0, 1852, 926, 0.000, 9.250, 1, 0.000, 5.430, 0.000, 5.430\n', kpi))
+
+        # CSV files are written to the output directory
+        with open(os.path.join('kpi_csv', 'kpi_ped.csv'), 'r') as f:
+            csv = f.read()
+        self.assertTrue(re.search('\ntime, id, name, x, y, z, h, p, r, speed, wheel_angle, wheel_rot\n', csv))
+        self.assertEqual(len(csv.splitlines()), 1852 + 2)
+        self.assertTrue(os.path.exists(os.path.join('kpi_csv', 'kpi_cut-in.csv')))
+
+    def test_dat2csv_pattern(self):
+        run_scenario(os.path.join(ESMINI_PATH, 'resources/xosc/pedestrian_collision.xosc'), '--headless --fixed_timestep 0.01 --record pattern_1.dat')
+        shutil.copyfile('pattern_1.dat', 'pattern_2.dat')
+        open('pattern_10.dat', 'w').close()  # not matching, would fail to read
+        if os.path.exists('pattern_1.csv'):
+            os.remove('pattern_1.csv')
+
+        # '?' matches exactly one character, files are processed in sorted order
+        run_dat2csv('--kpi kpi_pattern.csv --no_csv pattern_?.dat')
+
+        with open('kpi_pattern.csv', 'r') as f:
+            kpi = f.read().splitlines()
+        self.assertEqual(len(kpi), 3)
+        self.assertTrue(re.search('^(./)?pattern_1.dat, 0, 1852, 926, 0.000, 9.250, 1, 0.000, 5.430, 0.000, 5.430$', kpi[1]))
+        self.assertTrue(re.search('^(./)?pattern_2.dat, 0, 1852, 926, 0.000, 9.250, 1, 0.000, 5.430, 0.000, 5.430$', kpi[2]))
+        self.assertFalse(os.path.exists('pattern_1.csv'))
+
 if __name__ == "__main__":
     # execute only if run as a script
 
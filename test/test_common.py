@@ -108,6 +108,16 @@ def run_replayer(replayer_arguments = None):
 
     assert False, 'No log file'
 
+def run_dat2csv(dat2csv_arguments = None):
+
+    app = os.path.join(ESMINI_PATH,'bin','dat2csv')
+    args = [app] + dat2csv_arguments.split()
+    process = subprocess.run(args, cwd=os.path.dirname(os.path.realpath(__file__)), stdout=subprocess.PIPE, env=env, timeout=TIMEOUT)
+    log = process.stdout.decode()
+    assert process.returncode == 0, log
+
+    return log
+
 def generate_csv(filename=DAT_FILENAME):
 
     # Below is one/the old way of converting dat to csv. Keeping the lines for reference.